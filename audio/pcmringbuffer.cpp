@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/pcmringbuffer.h"
+
+#include "common/util.h"
+
+namespace Audio {
+
+// The positions must only become visible to the other side after the data
+// they cover has been copied (or consumed). m68k machines have a single,
+// in order CPU, so keeping the compiler from reordering is sufficient there.
+#if defined(__GNUC__) && (defined(__m68k__) || defined(__mc68000__))
+#define PCM_MEMORY_BARRIER() __asm__ __volatile__("" : : : "memory")
+#elif defined(__GNUC__)
+#define PCM_MEMORY_BARRIER() __sync_synchronize()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define PCM_MEMORY_BARRIER() _ReadWriteBarrier()
+#else
+#define PCM_MEMORY_BARRIER()
+#endif
+
+PCMRingBuffer::PCMRingBuffer(uint32 frames, uint frameSize)
+	: _frameSize(frameSize), _readPos(0), _writePos(0), _underruns(0), _overruns(0) {
+	assert(frames > 0 && frames <= 0x40000000);
+	assert(frameSize > 0);
+
+	_capacity = 1;
+	while (_capacity < frames)
+		_capacity <<= 1;
+	_mask = _capacity - 1;
+
+	_buffer = new byte[_capacity * _frameSize];
+	memset(_buffer, 0, _capacity * _frameSize);
+}
+
+PCMRingBuffer::~PCMRingBuffer() {
+	delete[] _buffer;
+}
+
+uint32 PCMRingBuffer::getAvailable() const {
+	return _writePos - _readPos;
+}
+
+uint32 PCMRingBuffer::write(const void *src, uint32 frames) {
+	const uint32 writePos = _writePos;
+	const uint32 count = MIN(frames, _capacity - (writePos - _readPos));
+	PCM_MEMORY_BARRIER();
+
+	// Copy in up to two parts, the second one wrapping around.
+	const uint32 offset = writePos & _mask;
+	const uint32 first = MIN(count, _capacity - offset);
+	memcpy(_buffer + offset * _frameSize, src, first * _frameSize);
+	memcpy(_buffer, (const byte *)src + first * _frameSize, (count - first) * _frameSize);
+
+	PCM_MEMORY_BARRIER();
+	_writePos = writePos + count;
+
+	if (count < frames)
+		++_overruns;
+	return count;
+}
+
+uint32 PCMRingBuffer::read(void *dst, uint32 frames) {
+	const uint32 readPos = _readPos;
+	const uint32 count = MIN(frames, _writePos - readPos);
+	PCM_MEMORY_BARRIER();
+
+	const uint32 offset = readPos & _mask;
+	const uint32 first = MIN(count, _capacity - offset);
+	memcpy(dst, _buffer + offset * _frameSize, first * _frameSize);
+	memcpy((byte *)dst + first * _frameSize, _buffer, (count - first) * _frameSize);
+
+	PCM_MEMORY_BARRIER();
+	_readPos = readPos + count;
+
+	if (count < frames)
+		++_underruns;
+	return count;
+}
+
+void PCMRingBuffer::reset() {
+	_readPos = _writePos = 0;
+	_underruns = _overruns = 0;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,104 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_PCMRINGBUFFER_H
+#define AUDIO_PCMRINGBUFFER_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Audio {
+
+/**
+ * A ring buffer for PCM frames which one thread fills while another one
+ * drains it, without any locking.
+ *
+ * This lets a backend mix ahead of the audio device: a producer calls the
+ * mixer whenever there is room (and may block on the mixer mutex while
+ * doing so), while the device callback only ever copies out of the ring,
+ * so it never waits for the main thread.
+ *
+ * Exactly one thread may call write() and exactly one thread may call
+ * read(). The read and write positions are free running counters, each
+ * only modified by its own side, and published with a memory barrier
+ * after the data they cover has been copied.
+ */
+class PCMRingBuffer : Common::NonCopyable {
+public:
+	/**
+	 * @param frames	the capacity in frames, rounded up to a power of two
+	 * @param frameSize	the size of one frame in bytes, e.g. 4 for 16 bit stereo
+	 */
+	PCMRingBuffer(uint32 frames, uint frameSize);
+	~PCMRingBuffer();
+
+	/**
+	 * Append frames to the buffer. Producer side only.
+	 *
+	 * @return	the number of frames stored; if this is less than requested,
+	 *			the buffer was full and an overrun is counted
+	 */
+	uint32 write(const void *src, uint32 frames);
+
+	/**
+	 * Take frames out of the buffer. Consumer side only.
+	 *
+	 * @return	the number of frames copied to dst; if this is less than
+	 *			requested, the buffer ran dry and an underrun is counted
+	 */
+	uint32 read(void *dst, uint32 frames);
+
+	/** Number of frames read() could return right now. */
+	uint32 getAvailable() const;
+
+	/** Number of frames write() could store right now. */
+	uint32 getFree() const { return _capacity - getAvailable(); }
+
+	uint32 getCapacity() const { return _capacity; }
+	uint getFrameSize() const { return _frameSize; }
+
+	uint32 getUnderruns() const { return _underruns; }
+	uint32 getOverruns() const { return _overruns; }
+
+	/**
+	 * Discard all frames and reset the counters. Neither side may use the
+	 * buffer at the same time.
+	 */
+	void reset();
+
+private:
+	byte *_buffer;
+	uint32 _capacity;
+	uint32 _mask;
+	uint _frameSize;
+
+	volatile uint32 _readPos;
+	volatile uint32 _writePos;
+
+	// Each counter is only modified by one side.
+	volatile uint32 _underruns;
+	volatile uint32 _overruns;
+};
+
+} // End of namespace Audio
+
+#endif
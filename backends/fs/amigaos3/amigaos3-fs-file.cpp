@@ -26,20 +26,19 @@
 #include <proto/dos.h>
 #include <dos/stdio.h>
 
-AmigaOS3File::AmigaOS3File(BPTR handle) : _handle(handle), _size(0), _error(0), _eof(false) {
+AmigaOS3File::AmigaOS3File(BPTR handle) : _handle(handle), _pos(0), _size(0), _error(0), _eof(false) {
 	assert(_handle);
 
-	// remember current position
+	// Seek returns the previous position, so going to the end and back
+	// yields both the current position and the size.
 	LONG oldpos = Seek(_handle, 0, OFFSET_END);
+	assert(oldpos != -1);
 
-	//determine size
-	LONG end = Seek(_handle, 0, OFFSET_CURRENT);
+	LONG end = Seek(_handle, oldpos, OFFSET_BEGINNING);
 	assert(end != -1);
-	_size = end;
 
-	// rewind
-	oldpos = Seek(_handle, oldpos, OFFSET_BEGINNING);
-	assert(oldpos != -1);
+	_pos = oldpos;
+	_size = end;
 }
 
 AmigaOS3File::~AmigaOS3File() {
@@ -59,8 +58,7 @@ bool AmigaOS3File::eos() const {
 }
 
 int32 AmigaOS3File::pos() const {
-	LONG pos = Seek(_handle, 0, OFFSET_CURRENT);
-	return pos;
+	return _pos;
 }
 
 int32 AmigaOS3File::size() const {
@@ -68,24 +66,35 @@ int32 AmigaOS3File::size() const {
 }
 
 bool AmigaOS3File::seek(int32 offs, int whence) {
-	LONG mode = whence == SEEK_SET ? OFFSET_BEGINNING
-			  : whence == SEEK_CUR ? OFFSET_CURRENT
-								   : OFFSET_END;
-	LONG success = Seek(_handle, offs, mode);
+	LONG newPos = whence == SEEK_SET ? offs
+				: whence == SEEK_CUR ? _pos + offs
+									 : _size + offs;
+	_eof = false;
+
+	// The position is known, so only bother DOS if it actually changes.
+	if (newPos == _pos)
+		return true;
+
+	LONG success = Seek(_handle, newPos, OFFSET_BEGINNING);
 	if (success == -1) {
 		_error = IoErr();
+		return false;
 	}
-	_eof = false;
-	return success != -1;
+	_pos = newPos;
+	return true;
 }
 
 uint32 AmigaOS3File::read(void *ptr, uint32 len) {
-	LONG bytesRead = FRead(_handle, ptr, 1, len);
-	if (bytesRead == 0) {
+	// Reads are unbuffered, AmigaOS3FilesystemNode::createReadStream puts
+	// a block cache in front of the file.
+	LONG bytesRead = Read(_handle, ptr, len);
+	if (bytesRead == -1) {
 		_error = IoErr();
-		_eof = true;
 		return 0;
 	}
+	_pos += bytesRead;
+	if ((uint32)bytesRead < len)
+		_eof = true;
 	return bytesRead;
 }
 
@@ -96,6 +105,9 @@ uint32 AmigaOS3File::write(const void *ptr, uint32 len) {
 		return 0;
 	}
 	assert(blocksWritten == 1);
+	_pos += len;
+	if (_pos > _size)
+		_size = _pos;
 	return len;
 }
 
@@ -108,10 +120,6 @@ AmigaOS3File *AmigaOS3File::makeFromPath(const Common::String &path, bool writeM
 
 	BPTR handle = Open(path.c_str(), writeMode ? MODE_NEWFILE : MODE_OLDFILE);
 
-	if (handle && !writeMode) {
-		SetVBuf(handle, NULL, BUF_FULL, 8192);
-	}
-
 	if (handle)
 		return new AmigaOS3File(handle);
 	return 0;
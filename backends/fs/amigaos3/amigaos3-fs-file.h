@@ -35,6 +35,8 @@ public:
 protected:
 	/** File handle to the actual file. */
 	BPTR _handle;
+	/** Current position, tracked here to avoid asking DOS for it. */
+	LONG _pos;
 	LONG _error;
 	LONG _size;
 	bool _eof;
@@ -27,6 +27,7 @@
 #include "backends/fs/amigaos3/amigaos3-fs-file.h"
 #include "backends/fs/stdiostream.h"
 
+#include "common/bufferedstream.h"
 #include "common/debug.h"
 
 #ifndef PATH_MAX
@@ -525,7 +526,14 @@ bool AmigaOS3FilesystemNode::isWritable() const {
 }
 
 Common::SeekableReadStream *AmigaOS3FilesystemNode::createReadStream() {
-	return AmigaOS3File::makeFromPath(getPath().c_str(), false);
+	// Engines parse resources with lots of small reads and short seeks,
+	// which the cache keeps away from DOS.
+	const uint32 READ_BLOCK_SIZE = 4096;
+	const uint READ_BLOCK_COUNT = 8;
+
+	Common::SeekableReadStream *stream = AmigaOS3File::makeFromPath(getPath().c_str(), false);
+
+	return Common::wrapBlockCachedReadStream(stream, READ_BLOCK_SIZE, READ_BLOCK_COUNT, DisposeAfterUse::YES);
 }
 
 Common::WriteStream *AmigaOS3FilesystemNode::createWriteStream() {
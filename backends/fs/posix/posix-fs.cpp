@@ -35,6 +35,7 @@
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/stdiostream.h"
 #include "common/algorithm.h"
+#include "common/bufferedstream.h"
 
 #include <sys/param.h>
 #include <sys/stat.h>
@@ -292,7 +293,12 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 }
 
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
-	return StdioStream::makeFromPath(getPath(), false);
+	const uint32 READ_BLOCK_SIZE = 4096;
+	const uint READ_BLOCK_COUNT = 8;
+
+	Common::SeekableReadStream *stream = StdioStream::makeFromPath(getPath(), false);
+
+	return Common::wrapBlockCachedReadStream(stream, READ_BLOCK_SIZE, READ_BLOCK_COUNT, DisposeAfterUse::YES);
 }
 
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
@@ -24,6 +24,7 @@
  */
 
 #include "backends/mixer/amigaos3/amigaos3-mixer.h"
+#include "audio/pcmringbuffer.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/system.h"
@@ -36,6 +37,7 @@
 #include <proto/exec.h>
 
 #define SAMPLES_PER_SEC 11025
+#define MIX_AHEAD_MSECS 150
 
 static struct MsgPort *ahiPort = NULL;
 ;
@@ -49,8 +51,14 @@ static uint32 _mixingFrequency = 0;
 static uint32 _sampleCount = 0;
 static uint32 _sampleBufferSize = 0;
 
+static uint32 _mixChunkSize = 0;
+static BYTE *mixBuffer = NULL;
+
 static Audio::MixerImpl *g_mixer = NULL;
+static Audio::PCMRingBuffer *g_ringBuffer = NULL;
+static volatile bool g_mixerIdle = true;
 static struct Task *g_soundThread = NULL;
+static struct Task *g_mixerThread = NULL;
 static struct Task *g_mainThread = NULL;
 
 AmigaOS3MixerManager::AmigaOS3MixerManager() {
@@ -73,6 +81,20 @@ AmigaOS3MixerManager::~AmigaOS3MixerManager() {
 			g_soundThread = NULL;
 		}
 
+		if (g_mixerThread) {
+			Signal(g_mixerThread, SIGBREAKF_CTRL_C);
+			Wait(SIGBREAKF_CTRL_F);
+			g_mixerThread = NULL;
+		}
+
+		debug(1, "AHI mixer: %u underruns, %u overruns", g_ringBuffer->getUnderruns(), g_ringBuffer->getOverruns());
+
+		delete g_ringBuffer;
+		g_ringBuffer = NULL;
+
+		FreeVec(mixBuffer);
+		mixBuffer = NULL;
+
 		delete g_mixer;
 		g_mixer = NULL;
 	}
@@ -167,9 +189,19 @@ void __stdargs __saveds scummvm_sound_thread() {
 
 //			ahiReq[_currentSoundBuffer]->ahir_Std.io_Length = _sampleBufferSize;
 
-			int mixedSamples = g_mixer->mixCallback((byte *)soundBuffer[_currentSoundBuffer], _sampleBufferSize);
+			// Only the mixer process calls into the mixer, so this never waits
+			// for the main thread. Running dry while the mixer is busy is an
+			// underrun, running dry while nothing plays is not.
+			uint32 mixedSamples = 0;
+			if (g_ringBuffer->getAvailable() || !g_mixerIdle) {
+				mixedSamples = g_ringBuffer->read(soundBuffer[_currentSoundBuffer], _sampleCount);
+				Signal(g_mixerThread, SIGBREAKF_CTRL_E);
+			}
+
 			if (mixedSamples) {
-				ahiReq[_currentSoundBuffer]->ahir_Std.io_Length = mixedSamples * 4;
+				if (mixedSamples < _sampleCount)
+					memset(soundBuffer[_currentSoundBuffer] + mixedSamples * 4, 0, (_sampleCount - mixedSamples) * 4);
+				ahiReq[_currentSoundBuffer]->ahir_Std.io_Length = _sampleBufferSize;
 				SendIO((struct IORequest *)ahiReq[_currentSoundBuffer]);
 				ahiReqSent[_currentSoundBuffer] = true;
 				// Flip.
@@ -208,6 +240,34 @@ exit_thread:
 	Signal(g_mainThread, SIGBREAKF_CTRL_F);
 }
 
+/**
+ * Keeps the ring buffer filled, so that the sound thread has something to
+ * play while the main thread holds the mixer mutex.
+ */
+void __stdargs __saveds scummvm_mixer_thread() {
+	for (;;) {
+		while (g_ringBuffer->getFree() >= _mixChunkSize) {
+			if (!g_mixer->mixCallback((byte *)mixBuffer, _mixChunkSize * 4)) {
+				g_mixerIdle = true;
+				break;
+			}
+			g_mixerIdle = false;
+			g_ringBuffer->write(mixBuffer, _mixChunkSize);
+		}
+
+		if (g_mixerIdle) {
+			// Poll until something starts playing.
+			Delay(1);
+			if (SetSignal(0L, 0L) & SIGBREAKF_CTRL_C)
+				break;
+		} else if (Wait(SIGBREAKF_CTRL_C | SIGBREAKF_CTRL_E) & SIGBREAKF_CTRL_C) {
+			break;
+		}
+	}
+
+	Signal(g_mainThread, SIGBREAKF_CTRL_F);
+}
+
 void AmigaOS3MixerManager::init(int priority) {
 #ifndef NDEBUG
 	debug(9, "AmigaOS3MixerManager::init()");
@@ -231,6 +291,21 @@ void AmigaOS3MixerManager::init(int priority) {
 		_sampleCount >>= 1;
 	}
 
+	// The mixer process mixes up to audio_mix_ahead milliseconds ahead of
+	// what AHI is playing, in chunks of a quarter AHI buffer.
+	uint32 mixAhead = MIX_AHEAD_MSECS;
+	if (ConfMan.hasKey("audio_mix_ahead")) {
+		mixAhead = ConfMan.getInt("audio_mix_ahead");
+	}
+
+	_mixChunkSize = MAX<uint32>(_sampleCount / 4, 256);
+	mixBuffer = (BYTE *)AllocVec(_mixChunkSize * 4, MEMF_PUBLIC);
+	if (!mixBuffer) {
+		error("Could not allocate the mixing buffer");
+	}
+
+	g_ringBuffer = new Audio::PCMRingBuffer(_sampleCount + _mixingFrequency * mixAhead / 1000, 4);
+
 	// Create the mixer instance and start the sound processing.
 	assert(!g_mixer);
 	g_mixer = new Audio::MixerImpl(g_system, _mixingFrequency);
@@ -239,6 +314,16 @@ void AmigaOS3MixerManager::init(int priority) {
 
 	g_mainThread=FindTask(NULL);
 
+	// Mixing may wait for the main thread, so it runs at its priority and
+	// relies on the ring buffer to bridge the gap.
+	g_mixerThread =
+	  (Task *)CreateNewProcTags(NP_Name, (ULONG) "ScummVM Mixer", NP_CloseOutput, FALSE, NP_CloseInput, FALSE,
+								NP_StackSize, 20000, NP_Entry, (ULONG)&scummvm_mixer_thread, TAG_DONE);
+
+	if (!g_mixerThread) {
+		error("Could not create the mixer thread");
+	}
+
 	g_soundThread =
 	  (Task *)CreateNewProcTags(NP_Name, (ULONG) "ScummVM MixerThread", NP_CloseOutput, FALSE, NP_CloseInput, FALSE,
 								NP_StackSize, 20000, NP_Entry, (ULONG)&scummvm_sound_thread, TAG_DONE);
@@ -50,7 +50,7 @@ extern struct timerequest *TimerIOReq;
 
 static struct timeval t0;
 
-OSystem_AmigaOS3::OSystem_AmigaOS3() {
+OSystem_AmigaOS3::OSystem_AmigaOS3() : _cursorLayer(NUM_SCREENBUFFERS) {
 	// gDebugLevel = 11;
 
 	_inited = false;
@@ -117,11 +117,8 @@ OSystem_AmigaOS3::~OSystem_AmigaOS3() {
 		_currentPalette = NULL;
 	}
 
-	_mouseCursor.surface.free();
-	_mouseCursorMask.surface.free();
-
 	if (_overlayColorMap) {
-		free(_overlayColorMap);
+		delete _overlayColorMap;
 		_overlayColorMap = NULL;
 	}
 
@@ -243,8 +240,6 @@ void OSystem_AmigaOS3::initBackend() {
 
 	_screenChangeCount = 0;
 
-	memset(&_mouseCursorMask, 0, sizeof(_mouseCursorMask));
-
 	// allocate palette storage
 	_currentPalette = (byte *)calloc(PALETTE_SIZE, sizeof(byte));
 	_gamePalette = (byte *)calloc(PALETTE_SIZE, sizeof(byte));
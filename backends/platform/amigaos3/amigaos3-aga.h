@@ -35,6 +35,9 @@
 
 #include "common/scummsys.h"
 #include "common/system.h"
+#include "graphics/colormap16.h"
+#include "graphics/cursor_layer.h"
+#include "graphics/dirty_rects.h"
 #include "graphics/palette.h"
 #include "graphics/surface.h"
 
@@ -106,6 +109,7 @@ public:
 	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h);
 	virtual inline Graphics::Surface *lockScreen() { return &_screen; }
 	virtual void unlockScreen() { _screenDirty = true; }
+	virtual void unlockScreenRect(int x, int y, int w, int h) { addDirtyRect(x, y, w, h); }
 	virtual void fillScreen(uint32 col);
 	virtual void updateScreen();
 	virtual void setShakePos(int shakeOffset);
@@ -186,7 +190,7 @@ protected:
 	Graphics::Surface _overlayscreen16;
 	bool _overlayVisible;
 	Graphics::PixelFormat _overlayFormat;
-	byte *_overlayColorMap;
+	Graphics::ColorMap16 *_overlayColorMap;
 
 	enum { kTransactionNone = 0, kTransactionActive = 1, kTransactionRollback = 2 };
 
@@ -222,32 +226,15 @@ protected:
 	bool _overlayDirty;
 	bool _mouseDirty;
 
-	// Mouse data.
-	struct MouseCursor {
-		MouseCursor() : visible(false), keyColor(0), w(0), h(0), x(0), y(0), hotX(0), hotY(0) {}
-		uint32 keyColor;
-		uint16 w, h;
-		// The mouse position.
-		uint16 x, y;
-		int16 hotX, hotY;
-		bool visible;
-
-		Graphics::Surface surface;
-	};
-
-	MouseCursor _mouseCursor;
-
-	struct MouseCursorMask {
-		// The mouse position.
-		uint x, y;
-
-		// The size of the cursor image.
-		uint w, h;
-
-		Graphics::Surface surface;
-	};
+	/**
+	 * Areas changed since each screen buffer was last written to. Every
+	 * change is recorded in all lists, and a list is only cleared once its
+	 * buffer has been brought up to date.
+	 */
+	Graphics::DirtyRectList _dirtyRects[NUM_SCREENBUFFERS];
 
-	MouseCursorMask _mouseCursorMask;
+	/** The mouse cursor, composited while presenting the dirty areas. */
+	Graphics::CursorLayer _cursorLayer;
 
 	// Palette data
 	byte *_currentPalette;
@@ -279,8 +266,8 @@ protected:
 	void loadOverlayPalette();
 	void loadOverlayColorMap();
 
-	void drawMouse();
-	void undrawMouse();
+	void addDirtyRect(int x, int y, int w, int h);
+	void markAllDirty();
 
 	// UBYTE *scaleScreen();
 
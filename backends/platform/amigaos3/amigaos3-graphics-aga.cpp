@@ -51,6 +51,10 @@ bool OSystem_AmigaOS3::hasFeature(OSystem::Feature f) {
 		return true;
 	}
 
+	if (f == OSystem::kFeaturePartialScreenUnlock) {
+		return true;
+	}
+
 	return false;
 }
 
@@ -147,8 +151,7 @@ OSystem::TransactionError OSystem_AmigaOS3::endGFXTransaction() {
 		SetPointer(_hardwareWindow, emptypointer, 1, 16, 0, 0);
 
 		// Set current cursor position.
-		_mouseCursor.x = _hardwareWindow->MouseX;
-		_mouseCursor.y = _hardwareWindow->MouseY;
+		_cursorLayer.setPosition(_hardwareWindow->MouseX, _hardwareWindow->MouseY);
 
 		if (!_overlayPalette) {
 			_overlayPalette = (byte *)calloc(3 * 256, sizeof(byte));
@@ -158,7 +161,7 @@ OSystem::TransactionError OSystem_AmigaOS3::endGFXTransaction() {
 		setPalette((byte *)_overlayPalette, 0, 256);
 
 		if (!_overlayColorMap) {
-			_overlayColorMap = (byte *)calloc(65536, sizeof(byte));
+			_overlayColorMap = new Graphics::ColorMap16();
 			loadOverlayColorMap();
 		}
 
@@ -284,6 +287,12 @@ bool OSystem_AmigaOS3::loadGFXMode() {
 	// 0 is shown, 1 is the new backbuffer
 	_currentScreenBuffer = 1;
 
+	// Neither buffer holds anything useful yet.
+	for (unsigned s = 0; s < NUM_SCREENBUFFERS; ++s) {
+		_dirtyRects[s].setBounds(_videoMode.screenWidth, _videoMode.overlayScreenHeight);
+	}
+	_cursorLayer.reset();
+
 	// Create the hardware window.
 	_hardwareWindow = createHardwareWindow(_videoMode.screenWidth, _videoMode.overlayScreenHeight, _hardwareScreen);
 	if (!_hardwareWindow) {
@@ -449,6 +458,8 @@ void OSystem_AmigaOS3::copyRectToScreen(const void *buf, int pitch, int x, int y
 	assert(w > 0 && x + w <= _videoMode.screenWidth);
 #endif
 
+	addDirtyRect(x, y, w, h);
+
 	byte *dst = (byte *)_screen.getBasePtr(x, y);
 
 	if (_videoMode.screenWidth == pitch && pitch == w) {
@@ -466,47 +477,90 @@ void OSystem_AmigaOS3::copyRectToScreen(const void *buf, int pitch, int x, int y
 void OSystem_AmigaOS3::fillScreen(uint32 col) {
 	if (_screen.getPixels()) {
 		memset(_screen.getPixels(), (int)col, ((unsigned)_videoMode.screenWidth * _videoMode.screenHeight));
+		markAllDirty();
+	}
+}
+
+void OSystem_AmigaOS3::addDirtyRect(int x, int y, int w, int h) {
+	for (unsigned s = 0; s < NUM_SCREENBUFFERS; ++s) {
+		_dirtyRects[s].addRect(x, y, w, h);
+	}
+}
+
+void OSystem_AmigaOS3::markAllDirty() {
+	for (unsigned s = 0; s < NUM_SCREENBUFFERS; ++s) {
+		_dirtyRects[s].markAll();
 	}
 }
 
+/**
+ * Writes the presented areas into a screen buffer.
+ */
+class RastPortPresenter : public Graphics::CursorPresenter {
+public:
+	RastPortPresenter(struct RastPort *rastPort) : _rastPort(rastPort) {}
+
+	virtual void presentRect(const Common::Rect &r, const byte *pixels, uint pitch) {
+		WriteChunkyPixels(_rastPort, r.left, r.top, r.right - 1, r.bottom - 1, (UBYTE *)pixels, pitch);
+	}
+
+private:
+	struct RastPort *_rastPort;
+};
+
 void OSystem_AmigaOS3::updateScreen() {
 #ifndef NDEBUG
 	debug(9, "OSystem_AmigaOS3::updateScreen()");
 #endif
 
-	static UBYTE *src;
-
-	if (_mouseCursor.visible) {
-		drawMouse();
+	// The screen was locked, so anything could have changed.
+	if (_screenDirty) {
+		markAllDirty();
+		_screenDirty = false;
 	}
 
+	Graphics::DirtyRectList &dirtyRects = _dirtyRects[_currentScreenBuffer];
+
+	const Graphics::Surface *src;
+	bool shaken = false;
+
 	if (_overlayVisible) {
-		src = (UBYTE *)_overlayscreen8.getPixels();
+		src = &_overlayscreen8;
 		assert(_videoMode.overlayWidth <= _videoMode.screenWidth);
 		assert(_videoMode.overlayHeight <= _videoMode.overlayScreenHeight);
-		WriteChunkyPixels(&_screenRastPorts[_currentScreenBuffer], 0, 0, _videoMode.overlayWidth - 1,
-						  _videoMode.overlayHeight - 1, src, _videoMode.overlayWidth);
 	} else {
 		if (_currentShakePos != _newShakePos) {
 			// Set the 'dirty area' to black.
 			memset(_tmpscreen.getBasePtr(0, (_videoMode.screenHeight - _newShakePos)), 0,
 				   (_videoMode.screenWidth * _newShakePos));
 
-			src = (UBYTE *)_screen.getBasePtr(0, _newShakePos);
+			UBYTE *shakeSrc = (UBYTE *)_screen.getBasePtr(0, _newShakePos);
 			byte *dst = (byte *)_tmpscreen.getBasePtr(0, 0);
 
-			CopyMemQuick(src, dst, (_videoMode.screenWidth * (_videoMode.screenHeight - _newShakePos)));
+			CopyMemQuick(shakeSrc, dst, (_videoMode.screenWidth * (_videoMode.screenHeight - _newShakePos)));
 
 			// Reset.
 			_currentShakePos = _newShakePos;
 
-			src = (UBYTE *)_tmpscreen.getPixels();
+			// Every buffer ends up showing a shifted image.
+			markAllDirty();
+			shaken = true;
+
+			src = &_tmpscreen;
 		} else {
-			src = (UBYTE *)_screen.getPixels();
+			src = &_screen;
 		}
+	}
 
-		WriteChunkyPixels(&_screenRastPorts[_currentScreenBuffer], 0, 0, _videoMode.screenWidth - 1,
-						  _videoMode.screenHeight - 1, src, _videoMode.screenWidth);
+	// This also adds the areas the cursor moved from and to.
+	RastPortPresenter presenter(&_screenRastPorts[_currentScreenBuffer]);
+	_cursorLayer.present(*src, dirtyRects, _currentScreenBuffer, presenter);
+
+	dirtyRects.clear();
+
+	// The next frame is drawn unshifted again, so this buffer needs a full update.
+	if (shaken) {
+		dirtyRects.markAll();
 	}
 
 	// Check whether the palette was changed.
@@ -514,10 +568,6 @@ void OSystem_AmigaOS3::updateScreen() {
 		updatePalette();
 	}
 
-	if (_mouseCursor.visible) {
-		undrawMouse();
-	}
-
 	if (ChangeScreenBuffer(_hardwareScreen, _hardwareScreenBuffer[_currentScreenBuffer])) {
 		// Flip.
 		_currentScreenBuffer = (_currentScreenBuffer + 1) % NUM_SCREENBUFFERS;
@@ -569,27 +619,25 @@ void OSystem_AmigaOS3::loadOverlayPalette() {
 
 void OSystem_AmigaOS3::loadOverlayColorMap() {
 #ifndef NDEBUG
-	debug(4, "generateOverlayColorMap()");
+	debug(4, "loadOverlayColorMap()");
 #endif
 
-	int color8;
-
-	// Load overlay map file.
-	FILE *mapFile;
-
-	mapFile = fopen("overlay.map", "r");
-	if (mapFile == NULL) {
-		error("Could not load the overlay map file");
-	}
+	// Load the precomputed map, see devtools/create_overlaymap.
+	AmigaOS3FilesystemNode node("overlay.map");
 
-	int i = 0;
+	Common::SeekableReadStream *mapFile = node.createReadStream();
+	if (mapFile) {
+		bool loaded = _overlayColorMap->load(_overlayFormat, *mapFile);
+		delete mapFile;
 
-	while (fscanf(mapFile, "%d", &color8) != EOF) {
-		_overlayColorMap[i] = color8;
-		i++;
+		if (loaded) {
+			return;
+		}
 	}
 
-	fclose(mapFile);
+	// Computing it takes a moment, but still beats not having a GUI.
+	warning("Could not load the overlay map file, computing it from the overlay palette");
+	_overlayColorMap->build(_overlayFormat, _overlayPalette, 256);
 }
 
 void OSystem_AmigaOS3::showOverlay() {
@@ -608,6 +656,8 @@ void OSystem_AmigaOS3::showOverlay() {
 
 	// Set the overlay palette.
 	setPalette((byte *)_overlayPalette, 0, 256);
+
+	markAllDirty();
 }
 
 void OSystem_AmigaOS3::hideOverlay() {
@@ -635,6 +685,8 @@ void OSystem_AmigaOS3::hideOverlay() {
 
 	// Reset the game palette.
 	setPalette((byte *)_gamePalette, 0, 256);
+
+	markAllDirty();
 }
 
 void OSystem_AmigaOS3::clearOverlay() {
@@ -645,6 +697,8 @@ void OSystem_AmigaOS3::clearOverlay() {
 	// Set the background to black.
 	byte *src = (byte *)_overlayscreen8.getPixels();
 	memset(src, 0, (_videoMode.screenWidth * _videoMode.overlayScreenHeight));
+
+	markAllDirty();
 }
 
 void OSystem_AmigaOS3::grabOverlay(void *buf, int pitch) {
@@ -664,8 +718,7 @@ void OSystem_AmigaOS3::copyRectToOverlay(const void *buf, int _pitch, int _x, in
 	assert(_transactionMode == kTransactionNone);
 #endif
 
-	//FIXME: we're not using pitch
-	uint16 pitch = _pitch, x = _x, y = _y, w = _w, h = _h;
+	uint16 x = _x, y = _y, w = _w, h = _h;
 
 	// Clip the coordinates
 	if (x + w > _videoMode.screenWidth) {
@@ -680,29 +733,11 @@ void OSystem_AmigaOS3::copyRectToOverlay(const void *buf, int _pitch, int _x, in
 		return;
 	}
 
-	const OverlayColor *src = (const OverlayColor *)buf;
-	byte *dst = (byte *)_overlayscreen8.getBasePtr(x, y);
-
-	OverlayColor color16;
-	byte color8;
-
-	for (uint16 r = 0; r < h; r++) {
-		for (uint16 c = 0; c < w; c++) {
-			color16 = *src;
-
-			color8 = _overlayColorMap[color16];
-
-			*dst = color8;
+	addDirtyRect(x, y, w, h);
 
-			// Add a column.
-			src++;
-			dst++;
-		}
+	byte *dst = (byte *)_overlayscreen8.getBasePtr(x, y);
 
-		// add a row.
-		dst += (_videoMode.screenWidth - w);
-		src += (_videoMode.screenWidth - w);
-	}
+	_overlayColorMap->convertRect(buf, _pitch, dst, _overlayscreen8.pitch, w, h);
 }
 
 #pragma mark -
@@ -710,14 +745,7 @@ void OSystem_AmigaOS3::copyRectToOverlay(const void *buf, int _pitch, int _x, in
 #pragma mark -
 
 bool OSystem_AmigaOS3::showMouse(bool visible) {
-	if (_mouseCursor.visible == visible) {
-		return visible;
-	}
-
-	bool last = _mouseCursor.visible;
-	_mouseCursor.visible = visible;
-
-	return last;
+	return _cursorLayer.setVisible(visible);
 }
 
 void OSystem_AmigaOS3::warpMouse(int x, int y) {
@@ -749,135 +777,11 @@ void OSystem_AmigaOS3::setMouseCursor(const void *buf, uint w, uint h, int hotsp
 		return;
 	}
 
-	// Check to see if we need to recreate the surfaces.
-	if (w != _mouseCursor.w || h != _mouseCursor.h) {
-		_mouseCursor.surface.create(w, h, Graphics::PixelFormat::createFormatCLUT8());
-		_mouseCursorMask.surface.create(w, h, Graphics::PixelFormat::createFormatCLUT8());
-	}
-
-	_mouseCursor.w = w;
-	_mouseCursor.h = h;
-	_mouseCursor.hotX = hotspot_x;
-	_mouseCursor.hotY = hotspot_y;
-	_mouseCursor.keyColor = keycolor;
-
-	CopyMem((void *)buf, _mouseCursor.surface.getPixels(), (unsigned)w * h);
+	_cursorLayer.setCursor((const byte *)buf, w, h, hotspot_x, hotspot_y, keycolor);
 }
 
 void OSystem_AmigaOS3::setMouseCursorPosition(uint16 x, uint16 y) {
-	_mouseCursor.x = x;
-	_mouseCursor.y = y;
-}
-
-void OSystem_AmigaOS3::drawMouse() {
-#ifndef NDEBUG
-	debug(4, "OSystem_AmigaOS3::drawMouse()");
-#endif
-
-	int16 w = _mouseCursor.w;
-	int16 h = _mouseCursor.h;
-
-	int16 x = (_mouseCursor.x - _mouseCursor.hotX);
-	int16 y = (_mouseCursor.y - _mouseCursor.hotY);
-
-	byte *mousePixels = (byte *)_mouseCursor.surface.getPixels();
-
-	// Clip the coordinates
-	if (x < 0) {
-		w += x;
-		mousePixels -= x;
-		x = 0;
-	}
-
-	if (y < 0) {
-		h += y;
-		mousePixels -= ((unsigned)y * _mouseCursor.surface.pitch);
-		y = 0;
-	}
-
-	if (x + w > _videoMode.screenWidth) {
-		w = _videoMode.screenWidth - x;
-	}
-
-	if (_overlayVisible) {
-		if (y + h > _videoMode.overlayScreenHeight) {
-			h = _videoMode.overlayScreenHeight - y;
-		}
-	} else {
-		if (y + h > _videoMode.screenHeight) {
-			h = _videoMode.screenHeight - y;
-		}
-	}
-
-	if (w <= 0 || h <= 0) {
-		// Nothing to do.
-		return;
-	}
-
-	// Setup the cursor mask.
-	_mouseCursorMask.x = x;
-	_mouseCursorMask.y = y;
-	_mouseCursorMask.w = w;
-	_mouseCursorMask.h = h;
-
-	byte *maskPixels = (byte *)_mouseCursorMask.surface.getPixels();
-
-	// Set the starting point of the screen we will be drawing to.
-	byte *screenPixels = NULL;
-
-	if (_overlayVisible) {
-		screenPixels = (byte *)_overlayscreen8.getBasePtr(x, y);
-	} else {
-		screenPixels = (byte *)_screen.getBasePtr(x, y);
-	}
-
-	// Draw it.
-	byte color;
-
-	do {
-		// Save a copy of this row before it's overwritten.
-		CopyMem(screenPixels, maskPixels, w);
-
-		for (uint16 c = 0; c < w; c++) {
-			color = *mousePixels;
-
-			if (color != _mouseCursor.keyColor) {
-				// Set the color.
-				*screenPixels = color;
-			}
-
-			// Add a column.
-			mousePixels++;
-			screenPixels++;
-		}
-
-		// add a row.
-		maskPixels += w;
-		mousePixels += (_mouseCursor.surface.pitch - w);
-		screenPixels += (_videoMode.screenWidth - w);
-	} while (--h);
-}
-
-void OSystem_AmigaOS3::undrawMouse() {
-#ifndef NDEBUG
-	debug(4, "OSystem_AmigaOS3::undrawMouse()");
-#endif
-
-	byte *dst = NULL;
-
-	if (_overlayVisible) {
-		dst = (byte *)_overlayscreen8.getBasePtr(_mouseCursorMask.x, _mouseCursorMask.y);
-	} else {
-		dst = (byte *)_screen.getBasePtr(_mouseCursorMask.x, _mouseCursorMask.y);
-	}
-
-	byte *src = (byte *)_mouseCursorMask.surface.getPixels();
-
-	for (uint16 i = 0; i < _mouseCursorMask.h; i++) {
-		CopyMem(src, dst, _mouseCursorMask.w);
-		dst += _videoMode.screenWidth;
-		src += _mouseCursorMask.w;
-	}
+	_cursorLayer.setPosition(x, y);
 }
 
 /*UBYTE *OSystem_AmigaOS3::scaleScreen() {
@@ -50,6 +50,19 @@ ReadStream *wrapBufferedReadStream(ReadStream *parentStream, uint32 bufSize, Dis
  */
 SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
 
+/**
+ * Take an arbitrary SeekableReadStream and wrap it in a custom stream which
+ * keeps a cache of numBlocks blocks of blockSize bytes each, loading several
+ * blocks at once while the stream is read sequentially.
+ * Unlike wrapBufferedSeekableReadStream, the wrapper keeps track of the
+ * position itself, so pos() and seeks within the cached blocks never reach
+ * the parent stream. The parent must not change size while it is wrapped.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ */
+SeekableReadStream *wrapBlockCachedReadStream(SeekableReadStream *parentStream, uint32 blockSize, uint numBlocks, DisposeAfterUse::Flag disposeParentStream);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which
  * transparently provides buffering.
@@ -441,6 +441,240 @@ SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStr
 
 namespace {
 
+/**
+ * Wrapper class which keeps a small cache of fixed size blocks of any given
+ * SeekableReadStream.
+ *
+ * The position is tracked here, so pos() and seek() never reach the parent
+ * stream, and the parent is only repositioned when a block has to be loaded
+ * from somewhere else than where the last load ended. Blocks are replaced
+ * round robin. Misses on the block following the previously loaded ones
+ * double the number of blocks loaded at once, up to half the cache, so
+ * sequential reads turn into few large parent reads.
+ */
+class BlockCachedReadStream : public SeekableReadStream {
+protected:
+	struct Block {
+		int32 start;	///< file offset of the block, or -1 if unused
+		uint32 size;	///< number of valid bytes
+	};
+
+	DisposablePtr<SeekableReadStream> _parentStream;
+	const uint32 _blockSize;
+	const uint _numBlocks;
+	const uint _maxReadAhead;
+	byte *_buf;
+	Block *_blocks;
+
+	uint _current;		///< slot of the most recently used block
+	uint _nextSlot;		///< slot to be replaced next
+	uint _readAhead;	///< blocks to load on the next sequential miss
+	int32 _nextSequential;
+	int32 _parentPos;
+	int32 _pos;
+	int32 _size;
+	bool _eos;
+	bool _err;
+
+	bool contains(uint slot, int32 offset) const {
+		return _blocks[slot].start >= 0 && offset >= _blocks[slot].start && offset < _blocks[slot].start + (int32)_blocks[slot].size;
+	}
+
+	bool findBlock(int32 offset);
+	bool loadBlocks(int32 offset);
+	uint32 readDirect(void *dataPtr, uint32 dataSize);
+
+public:
+	BlockCachedReadStream(SeekableReadStream *parentStream, uint32 blockSize, uint numBlocks, DisposeAfterUse::Flag disposeParentStream);
+	virtual ~BlockCachedReadStream();
+
+	virtual bool eos() const { return _eos; }
+	virtual bool err() const { return _err || _parentStream->err(); }
+	virtual void clearErr() { _eos = _err = false; _parentStream->clearErr(); }
+
+	virtual int32 pos() const { return _pos; }
+	virtual int32 size() const { return _size; }
+
+	virtual bool seek(int32 offset, int whence = SEEK_SET);
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+};
+
+BlockCachedReadStream::BlockCachedReadStream(SeekableReadStream *parentStream, uint32 blockSize, uint numBlocks, DisposeAfterUse::Flag disposeParentStream)
+	: _parentStream(parentStream, disposeParentStream),
+	_blockSize(blockSize),
+	_numBlocks(numBlocks),
+	_maxReadAhead(MAX<uint>(numBlocks / 2, 1)),
+	_current(0),
+	_nextSlot(0),
+	_readAhead(1),
+	_nextSequential(-1),
+	_eos(false),
+	_err(false) {
+
+	assert(parentStream);
+	assert(blockSize > 0 && numBlocks > 0);
+
+	_buf = new byte[blockSize * numBlocks];
+	_blocks = new Block[numBlocks];
+	for (uint i = 0; i < numBlocks; ++i) {
+		_blocks[i].start = -1;
+		_blocks[i].size = 0;
+	}
+
+	_size = parentStream->size();
+	_parentPos = _pos = parentStream->pos();
+}
+
+BlockCachedReadStream::~BlockCachedReadStream() {
+	delete[] _blocks;
+	delete[] _buf;
+}
+
+bool BlockCachedReadStream::findBlock(int32 offset) {
+	for (uint i = 0; i < _numBlocks; ++i) {
+		if (contains(i, offset)) {
+			_current = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BlockCachedReadStream::loadBlocks(int32 offset) {
+	const int32 start = offset - offset % _blockSize;
+
+	if (start == _nextSequential)
+		_readAhead = MIN(_readAhead * 2, _maxReadAhead);
+	else
+		_readAhead = 1;
+
+	// Stop at the end of the file and in front of blocks which are cached
+	// already. The blocks have to end up in consecutive slots.
+	uint count = 1;
+	while (count < _readAhead && start + (int32)(count * _blockSize) < _size) {
+		const int32 next = start + count * _blockSize;
+		bool cached = false;
+		for (uint i = 0; i < _numBlocks && !cached; ++i)
+			cached = contains(i, next);
+		if (cached)
+			break;
+		++count;
+	}
+	if (_nextSlot + count > _numBlocks)
+		_nextSlot = 0;
+
+	if (_parentPos != start) {
+		if (!_parentStream->seek(start)) {
+			_err = true;
+			return false;
+		}
+	}
+
+	const uint32 bytesRead = _parentStream->read(_buf + _nextSlot * _blockSize, MIN<uint32>(count * _blockSize, _size - start));
+	_parentPos = start + bytesRead;
+	if (!bytesRead)
+		return false;
+
+	for (uint i = 0; i < count; ++i) {
+		Block &block = _blocks[_nextSlot + i];
+		const uint32 blockOffset = i * _blockSize;
+		block.start = start + blockOffset;
+		block.size = bytesRead > blockOffset ? MIN(bytesRead - blockOffset, _blockSize) : 0;
+		if (!block.size)
+			block.start = -1;
+	}
+
+	_current = _nextSlot;
+	_nextSlot += count;
+	_nextSequential = start + count * _blockSize;
+	return true;
+}
+
+uint32 BlockCachedReadStream::readDirect(void *dataPtr, uint32 dataSize) {
+	if (_parentPos != _pos) {
+		if (!_parentStream->seek(_pos)) {
+			_err = true;
+			return 0;
+		}
+	}
+
+	const uint32 bytesRead = _parentStream->read(dataPtr, dataSize);
+	_parentPos = _pos + bytesRead;
+	_pos += bytesRead;
+	if (bytesRead < dataSize)
+		_eos = true;
+	return bytesRead;
+}
+
+uint32 BlockCachedReadStream::read(void *dataPtr, uint32 dataSize) {
+	uint32 alreadyRead = 0;
+
+	while (dataSize) {
+		if (_pos >= _size) {
+			_eos = true;
+			break;
+		}
+
+		if (!contains(_current, _pos) && !findBlock(_pos)) {
+			// Reads spanning whole blocks are not worth caching.
+			if (dataSize >= _blockSize)
+				return alreadyRead + readDirect(dataPtr, dataSize);
+
+			if (!loadBlocks(_pos)) {
+				_eos = !_err;
+				break;
+			}
+		}
+
+		const Block &block = _blocks[_current];
+		const uint32 blockPos = _pos - block.start;
+		const uint32 n = MIN(dataSize, block.size - blockPos);
+
+		memcpy(dataPtr, _buf + _current * _blockSize + blockPos, n);
+		dataPtr = (byte *)dataPtr + n;
+		dataSize -= n;
+		alreadyRead += n;
+		_pos += n;
+	}
+
+	return alreadyRead;
+}
+
+bool BlockCachedReadStream::seek(int32 offset, int whence) {
+	int32 newPos;
+	switch (whence) {
+	case SEEK_END:
+		newPos = _size + offset;
+		break;
+	case SEEK_CUR:
+		newPos = _pos + offset;
+		break;
+	case SEEK_SET:
+	default:
+		newPos = offset;
+		break;
+	}
+
+	if (newPos < 0 || newPos > _size)
+		return false;
+
+	_pos = newPos;
+	_eos = false;
+	return true;
+}
+
+} // End of anonymous namespace
+
+SeekableReadStream *wrapBlockCachedReadStream(SeekableReadStream *parentStream, uint32 blockSize, uint numBlocks, DisposeAfterUse::Flag disposeParentStream) {
+	if (parentStream)
+		return new BlockCachedReadStream(parentStream, blockSize, numBlocks, disposeParentStream);
+	return nullptr;
+}
+
+#pragma mark -
+
+namespace {
+
 /**
  * Wrapper class which adds buffering to any WriteStream.
  */
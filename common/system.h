@@ -423,7 +423,14 @@ public:
 		* Supports for using the native system file browser dialog
 		* through the DialogManager.
 		*/
-		kFeatureSystemBrowserDialog
+		kFeatureSystemBrowserDialog,
+
+		/**
+		 * unlockScreenRect() only marks the given area of the screen as
+		 * dirty, so that drawing a small area through lockScreen() is
+		 * not more expensive than copyRectToScreen().
+		 */
+		kFeaturePartialScreenUnlock
 
 	};
 
@@ -879,6 +886,15 @@ public:
 	 */
 	virtual void unlockScreen() = 0;
 
+	/**
+	 * Unlock the screen framebuffer after only the given area has been
+	 * modified. Backends with kFeaturePartialScreenUnlock then update just
+	 * that area, all others treat this like unlockScreen().
+	 *
+	 * @see kFeaturePartialScreenUnlock
+	 */
+	virtual void unlockScreenRect(int x, int y, int w, int h) { unlockScreen(); }
+
 	/**
 	 * Fills the screen with a given color value.
 	 *
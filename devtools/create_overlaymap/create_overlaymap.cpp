@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * This is a utility for creating the table the AmigaOS3 backend uses to
+ * show the 16 bit (RGB565) overlay on its 8 bit screen. It maps every 16
+ * bit color to the closest entry of the overlay palette, a JASC-PAL file.
+ *
+ * The output is read by Graphics::ColorMap16::load(), and matches what
+ * Graphics::ColorMap16::build() computes at runtime.
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+// HACK to allow building with the SDL backend on MinGW
+// see bug #1800764 "TOOLS: MinGW tools building broken"
+#ifdef main
+#undef main
+#endif // main
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/scummsys.h"
+
+#define TABLE_VERSION 1
+
+static int loadPalette(const char *filename, uint8 *palette) {
+	FILE *file = fopen(filename, "r");
+	if (!file) {
+		fprintf(stderr, "Could not open %s\n", filename);
+		return -1;
+	}
+
+	char line[100];
+	int numColors = 0;
+
+	// Header: "JASC-PAL", version, number of colors.
+	if (!fgets(line, sizeof(line), file) || strncmp(line, "JASC-PAL", 8) != 0 ||
+	    !fgets(line, sizeof(line), file) || fscanf(file, "%d", &numColors) != 1 ||
+	    numColors < 1 || numColors > 256) {
+		fprintf(stderr, "%s is not a valid palette file\n", filename);
+		fclose(file);
+		return -1;
+	}
+
+	for (int i = 0; i < numColors; ++i) {
+		int r, g, b;
+		if (fscanf(file, "%d %d %d", &r, &g, &b) != 3) {
+			fprintf(stderr, "%s: color %d is missing\n", filename, i);
+			fclose(file);
+			return -1;
+		}
+		palette[i * 3 + 0] = r;
+		palette[i * 3 + 1] = g;
+		palette[i * 3 + 2] = b;
+	}
+
+	fclose(file);
+	return numColors;
+}
+
+static void writeUint32BE(FILE *fp, uint32 value) {
+	uint8 b[4] = { (uint8)(value >> 24), (uint8)(value >> 16), (uint8)(value >> 8), (uint8)value };
+	fwrite(b, 1, 4, fp);
+}
+
+int main(int argc, char *argv[]) {
+	if (argc != 3) {
+		printf("Usage: %s <overlay.pal> <overlay.map>\n", argv[0]);
+		return 1;
+	}
+
+	uint8 palette[256 * 3];
+	const int numColors = loadPalette(argv[1], palette);
+	if (numColors < 0)
+		return 1;
+
+	static uint8 table[65536];
+
+	for (int color = 0; color < 65536; ++color) {
+		// Expand the components the same way Graphics::PixelFormat does.
+		const int r5 = (color >> 11) & 31, g6 = (color >> 5) & 63, b5 = color & 31;
+		const int r = (r5 << 3) | (r5 >> 2);
+		const int g = (g6 << 2) | (g6 >> 4);
+		const int b = (b5 << 3) | (b5 >> 2);
+
+		// The first of several equally close entries wins.
+		int best = 0;
+		int bestDistance = 0x7FFFFFFF;
+		for (int i = 0; i < numColors; ++i) {
+			const int dr = palette[i * 3 + 0] - r;
+			const int dg = palette[i * 3 + 1] - g;
+			const int db = palette[i * 3 + 2] - b;
+			const int distance = dr * dr + dg * dg + db * db;
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				best = i;
+			}
+		}
+
+		table[color] = best;
+	}
+
+	FILE *out = fopen(argv[2], "wb");
+	if (!out) {
+		fprintf(stderr, "Could not create %s\n", argv[2]);
+		return 1;
+	}
+
+	fwrite("OMAP", 1, 4, out);
+	writeUint32BE(out, TABLE_VERSION);
+	fwrite(table, 1, sizeof(table), out);
+	fclose(out);
+
+	return 0;
+}
@@ -0,0 +1,10 @@
+MODULE := devtools/create_overlaymap
+
+MODULE_OBJS := \
+	create_overlaymap.o
+
+# Set the name of the executable
+TOOL_EXECUTABLE := create_overlaymap
+
+# Include common rules
+include $(srcdir)/rules.mk
@@ -35,6 +35,7 @@
 #include "sci/engine/gc.h"
 #include "sci/engine/features.h"
 #include "sci/engine/scriptdebug.h"
+#include "sci/engine/script_patches.h"
 #include "sci/sound/midiparser_sci.h"
 #include "sci/sound/music.h"
 #include "sci/sound/drivers/mididriver.h"
@@ -99,6 +100,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("selector",			WRAP_METHOD(Console, cmdSelector));
 	registerCmd("selectors",			WRAP_METHOD(Console, cmdSelectors));
 	registerCmd("functions",			WRAP_METHOD(Console, cmdKernelFunctions));
+	registerCmd("kernel_checks",		WRAP_METHOD(Console, cmdKernelChecks));
+	registerCmd("kernel_stats",		WRAP_METHOD(Console, cmdKernelStats));
 	registerCmd("class_table",		WRAP_METHOD(Console, cmdClassTable));
 	// Parser
 	registerCmd("suffixes",			WRAP_METHOD(Console, cmdSuffixes));
@@ -115,6 +118,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_lru",		WRAP_METHOD(Console, cmdResourceLRU));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
@@ -230,6 +234,11 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
 	registerCmd("scrs",             WRAP_METHOD(Console, cmdScriptStrings));
 	registerCmd("script_said",      WRAP_METHOD(Console, cmdScriptSaid));
+	registerCmd("script_patches",   WRAP_METHOD(Console, cmdScriptPatches));
+	registerCmd("selector_cache",   WRAP_METHOD(Console, cmdSelectorCache));
+	registerCmd("vm_bench",         WRAP_METHOD(Console, cmdVMBench));
+	registerCmd("vm_decode",        WRAP_METHOD(Console, cmdVMDecode));
+	registerCmd("vm_histogram",     WRAP_METHOD(Console, cmdVMHistogram));
 	registerCmd("vm_varlist",			WRAP_METHOD(Console, cmdVMVarlist));
 	registerCmd("vmvarlist",			WRAP_METHOD(Console, cmdVMVarlist));				// alias
 	registerCmd("vl",					WRAP_METHOD(Console, cmdVMVarlist));				// alias
@@ -318,6 +327,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" selectors - Lists the selector names\n");
 	debugPrintf(" selector - Attempts to find the requested selector by name\n");
 	debugPrintf(" functions - Lists the kernel functions\n");
+	debugPrintf(" kernel_checks - Shows or changes how kernel call signatures are checked\n");
+	debugPrintf(" kernel_stats - Counts the kernel calls and the time spent in them\n");
 	debugPrintf(" class_table - Shows the available classes\n");
 	debugPrintf("\n");
 	debugPrintf("Parser:\n");
@@ -336,6 +347,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_lru - Shows or changes how unlocked resources are kept in memory\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
@@ -424,6 +436,11 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" script_patches - Shows or changes how script patches are searched, and measures loading scripts\n");
+	debugPrintf(" selector_cache - Shows or changes how selectors are cached\n");
+	debugPrintf(" vm_bench - Records sends and measures how fast they are looked up\n");
+	debugPrintf(" vm_decode - Shows or changes how script code is decoded\n");
+	debugPrintf(" vm_histogram - Counts the executed opcodes and opcode pairs\n");
 	debugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	debugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	debugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -606,6 +623,96 @@ bool Console::cmdKernelFunctions(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdKernelChecks(int argc, const char **argv) {
+	Kernel *kernel = _engine->getKernel();
+	Kernel::SignatureStats &stats = kernel->getSignatureStats();
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "full")) {
+			kernel->setSignatureCheckMode(kSignatureCheckFull);
+		} else if (!strcmp(argv[1], "workarounds")) {
+			kernel->setSignatureCheckMode(kSignatureCheckWorkarounds);
+		} else if (!strcmp(argv[1], "reset")) {
+			stats.reset();
+			debugPrintf("Signature check statistics reset\n");
+			return true;
+		} else {
+			debugPrintf("Usage: %s [full | workarounds | reset]\n", argv[0]);
+			return true;
+		}
+	}
+
+	static const char *const modeNames[] = {
+		"checked for every call",
+		"only checked for functions with workarounds"
+	};
+	debugPrintf("Kernel call signatures are %s\n", modeNames[kernel->getSignatureCheckMode()]);
+	debugPrintf("%u calls checked, %u not checked\n", stats.checked, stats.skipped);
+	debugPrintf("%u arguments checked, %u of them needed a full type lookup\n", stats.arguments, stats.lookups);
+	return true;
+}
+
+bool Console::cmdKernelStats(int argc, const char **argv) {
+	Kernel *kernel = _engine->getKernel();
+
+	if (argc > 1 && !strcmp(argv[1], "on")) {
+		kernel->setProfiling(true);
+		debugPrintf("Measuring the time spent in kernel functions\n");
+		return true;
+	} else if (argc > 1 && !strcmp(argv[1], "off")) {
+		kernel->setProfiling(false);
+		debugPrintf("Stopped measuring the time spent in kernel functions\n");
+		return true;
+	} else if (argc > 1 && !strcmp(argv[1], "reset")) {
+		kernel->resetCallStats();
+		debugPrintf("Kernel call statistics reset\n");
+		return true;
+	}
+
+	const int count = argc > 1 ? atoi(argv[1]) : 0;
+	if (count <= 0) {
+		debugPrintf("Counts the calls of each kernel function. While measuring, the time\n");
+		debugPrintf("spent in a function includes the scripts it runs.\n");
+		debugPrintf("Usage: %s on | off | reset | <count>\n", argv[0]);
+		debugPrintf("Measuring is %s\n", kernel->isProfiling() ? "on" : "off");
+		return true;
+	}
+
+	// Functions and subfunctions, by the number of calls
+	Common::Array<const KernelCallStats *> stats;
+	Common::Array<Common::String> names;
+	for (uint i = 0; i < kernel->_kernelFuncs.size(); i++) {
+		const KernelFunction &function = kernel->_kernelFuncs[i];
+		if (function.stats.calls) {
+			stats.push_back(&function.stats);
+			names.push_back(kernel->getKernelName(i));
+		}
+		for (uint16 j = 0; j < function.subFunctionCount; j++) {
+			if (function.subFunctions[j].stats.calls) {
+				stats.push_back(&function.subFunctions[j].stats);
+				names.push_back(Common::String::format(" %s", kernel->getKernelName(i, j).c_str()));
+			}
+		}
+	}
+
+	debugPrintf("%-28s %10s %10s\n", "Function", "Calls", "ms");
+	for (int n = 0; n < count && !stats.empty(); n++) {
+		uint best = 0;
+		for (uint i = 1; i < stats.size(); i++) {
+			if (stats[i]->calls > stats[best]->calls)
+				best = i;
+		}
+		debugPrintf("%-28s %10u %10u\n", names[best].c_str(), stats[best]->calls, stats[best]->millis);
+		stats.remove_at(best);
+		names.remove_at(best);
+	}
+
+	const Kernel::SignatureStats &signatureStats = kernel->getSignatureStats();
+	debugPrintf("Signatures: %u calls checked, %u arguments, %u full type lookups\n",
+		signatureStats.checked, signatureStats.arguments, signatureStats.lookups);
+	return true;
+}
+
 bool Console::cmdSuffixes(int argc, const char **argv) {
 	_engine->getVocabulary()->printSuffixes();
 
@@ -1100,6 +1207,48 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceLRU(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+	ResourceManager::LRUStats &stats = resMan->getLRUStats();
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "budget") && argc == 4) {
+			if (atoi(argv[3]) < 0) {
+				debugPrintf("The budget can't be negative\n");
+				return true;
+			}
+			for (int i = 0; i < ResourceManager::kLRUClassCount; i++) {
+				if (!strcmp(argv[2], ResourceManager::getLRUClassName((ResourceManager::LRUClass)i))) {
+					resMan->setBudgetLRU((ResourceManager::LRUClass)i, atoi(argv[3]) * 1024);
+					return true;
+				}
+			}
+			debugPrintf("Unknown class '%s'\n", argv[2]);
+		} else if (!strcmp(argv[1], "prefetch") && argc == 3) {
+			resMan->prefetchRoom(atoi(argv[2]));
+			debugPrintf("The resources of room %d will be read while the game waits\n", atoi(argv[2]));
+		} else if (!strcmp(argv[1], "reset")) {
+			stats.reset();
+			debugPrintf("Resource statistics reset\n");
+		} else {
+			debugPrintf("Usage: %s [budget <class> <KB> | prefetch <room> | reset]\n", argv[0]);
+			debugPrintf("The classes are views, pics, audio, scripts and other\n");
+		}
+		return true;
+	}
+
+	debugPrintf("Unlocked resources: %d of %d KB, locked resources: %d KB\n",
+		resMan->getMemoryLRU() / 1024, resMan->getMaxMemoryLRU() / 1024, resMan->getMemoryLocked() / 1024);
+	for (int i = 0; i < ResourceManager::kLRUClassCount; i++) {
+		const ResourceManager::LRUClass lruClass = (ResourceManager::LRUClass)i;
+		debugPrintf(" %-8s %4u resources, %5d of %5d KB\n", ResourceManager::getLRUClassName(lruClass),
+			resMan->getCountLRU(lruClass), resMan->getMemoryLRU(lruClass) / 1024, resMan->getBudgetLRU(lruClass) / 1024);
+	}
+	debugPrintf("%u found in memory, %u read, %u read ahead of time\n", stats.hits, stats.misses, stats.prefetches);
+	debugPrintf("%u freed, %u KB\n", stats.evictions, stats.evictedBytes / 1024);
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -3270,6 +3419,321 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+	SelectorLookupCache::Stats &stats = cache.getStats();
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			cache.setEnabled(true);
+			debugPrintf("Selector cache enabled\n");
+		} else if (!strcmp(argv[1], "off")) {
+			cache.setEnabled(false);
+			debugPrintf("Selector cache disabled\n");
+		} else if (!strcmp(argv[1], "reset")) {
+			stats.reset();
+			debugPrintf("Selector cache statistics reset\n");
+		} else {
+			debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	debugPrintf("The selector cache is %s, %u classes indexed\n", cache.isEnabled() ? "enabled" : "disabled", cache.getClassCount());
+	debugPrintf("%u lookups: %u recent, %u from the class indexes, %u resolved, %u not cached\n",
+		stats.lookups, stats.hits, stats.indexHits, stats.indexBuilds, stats.bypassed);
+	debugPrintf("Dropped %u times as scripts were loaded or unloaded\n", stats.invalidations);
+	return true;
+}
+
+/**
+ * Load every script of a list, and return the time it took in milliseconds.
+ */
+static uint32 loadScripts(ResourceManager *resMan, ScriptPatcher *scriptPatcher, const Common::Array<int> &scripts,
+                          bool applyScriptPatches, int repeat) {
+	const uint32 start = g_system->getMillis();
+	for (int i = 0; i < repeat; ++i) {
+		for (uint j = 0; j < scripts.size(); ++j) {
+			Script script;
+			script.load(scripts[j], resMan, scriptPatcher, applyScriptPatches);
+		}
+	}
+	return g_system->getMillis() - start;
+}
+
+bool Console::cmdScriptPatches(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+	ScriptPatcher *scriptPatcher = _engine->getScriptPatcher();
+	ScriptPatcher::Stats &stats = scriptPatcher->getStats();
+
+	if (argc > 1 && !strcmp(argv[1], "linear")) {
+		scriptPatcher->setScanMode(ScriptPatcher::kScanLinear);
+		debugPrintf("Searching the whole script once for every signature\n");
+		return true;
+	} else if (argc > 1 && !strcmp(argv[1], "multi")) {
+		scriptPatcher->setScanMode(ScriptPatcher::kScanMultiPattern);
+		debugPrintf("Searching the script once for all of its signatures\n");
+		return true;
+	} else if (argc > 2 && !strcmp(argv[1], "memo")) {
+		scriptPatcher->setMemo(!strcmp(argv[2], "on"));
+		debugPrintf("The patches of loaded scripts are %s\n", scriptPatcher->isMemoEnabled() ? "remembered" : "searched every time");
+		return true;
+	} else if (argc > 1 && !strcmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Script patcher statistics reset\n");
+		return true;
+	} else if (argc > 1 && strcmp(argv[1], "bench")) {
+		debugPrintf("Usage: %s [linear | multi | memo on|off | reset | bench [<repeat>]]\n", argv[0]);
+		return true;
+	}
+
+	if (argc < 2) {
+		debugPrintf("Searching %s, patches of loaded scripts %s\n",
+			scriptPatcher->getScanMode() == ScriptPatcher::kScanLinear ? "once for every signature" : "once for all signatures",
+			scriptPatcher->isMemoEnabled() ? "remembered" : "not remembered");
+		debugPrintf("%u scripts with patches loaded, %u of them patched from memory, %u remembered now\n",
+			stats.scripts, stats.remembered, scriptPatcher->getPatchedScriptCount());
+		debugPrintf("%u searches, %u magic DWORDs found, %u patches applied\n", stats.scans, stats.candidates, stats.applied);
+		return true;
+	}
+
+	// SCI1.1 - SCI2.1 scripts cannot be loaded without their heap
+	const bool needsHeap = getSciVersion() >= SCI_VERSION_1_1
+#ifdef ENABLE_SCI32
+		&& getSciVersion() <= SCI_VERSION_2_1_LATE
+#endif
+		;
+	Common::List<ResourceId> resources = resMan->listResources(kResourceTypeScript);
+	Common::Array<int> scripts;
+	Common::Array<Resource *> locked;
+	for (Common::List<ResourceId>::iterator it = resources.begin(); it != resources.end(); ++it) {
+		const ResourceId heapId(kResourceTypeHeap, it->getNumber());
+		if (needsHeap && !resMan->testResource(heapId))
+			continue;
+
+		// Keep the scripts in memory, so that only loading them is measured
+		Resource *resource = resMan->findResource(*it, true);
+		if (!resource)
+			continue;
+		locked.push_back(resource);
+		if (needsHeap)
+			locked.push_back(resMan->findResource(heapId, true));
+		scripts.push_back(it->getNumber());
+	}
+
+	const int repeat = argc > 2 ? MAX(atoi(argv[2]), 1) : 10;
+	const ScriptPatcher::ScanMode scanMode = scriptPatcher->getScanMode();
+	const bool memo = scriptPatcher->isMemoEnabled();
+	const ScriptPatcher::Stats oldStats = stats;
+
+	debugPrintf("Loading %u scripts %d times\n", scripts.size(), repeat);
+	scriptPatcher->setMemo(false);
+	debugPrintf("Without patches:            %6u ms\n", loadScripts(resMan, scriptPatcher, scripts, false, repeat));
+	scriptPatcher->setScanMode(ScriptPatcher::kScanLinear);
+	debugPrintf("Searching every signature:  %6u ms\n", loadScripts(resMan, scriptPatcher, scripts, true, repeat));
+	scriptPatcher->setScanMode(ScriptPatcher::kScanMultiPattern);
+	debugPrintf("Searching all signatures:   %6u ms\n", loadScripts(resMan, scriptPatcher, scripts, true, repeat));
+	scriptPatcher->setMemo(true);
+	debugPrintf("First time, remembering:    %6u ms\n", loadScripts(resMan, scriptPatcher, scripts, true, 1));
+	debugPrintf("Patched from memory:        %6u ms\n", loadScripts(resMan, scriptPatcher, scripts, true, repeat));
+
+	scriptPatcher->setScanMode(scanMode);
+	scriptPatcher->setMemo(memo);
+	stats = oldStats;
+	for (uint i = 0; i < locked.size(); ++i)
+		resMan->unlockResource(locked[i]);
+	return true;
+}
+
+bool Console::cmdVMBench(int argc, const char **argv) {
+	SegManager *segMan = _engine->_gamestate->_segMan;
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	Common::Array<SelectorLookupCache::Send> &sends = cache.getRecordedSends();
+
+	if (argc < 2) {
+		debugPrintf("Records the sends of the running game, and looks them up again\n");
+		debugPrintf("with and without the selector cache.\n");
+		debugPrintf("Usage: %s record | stop | clear | run [<repeat>]\n", argv[0]);
+		debugPrintf("%u sends recorded%s\n", sends.size(), cache.isRecording() ? ", recording" : "");
+		return true;
+	}
+
+	if (!strcmp(argv[1], "record")) {
+		cache.setRecording(true);
+		debugPrintf("Recording sends, continue the game and use \"%s stop\" when done\n", argv[0]);
+		return true;
+	} else if (!strcmp(argv[1], "stop")) {
+		cache.setRecording(false);
+		debugPrintf("%u sends recorded\n", sends.size());
+		return true;
+	} else if (!strcmp(argv[1], "clear")) {
+		sends.clear();
+		debugPrintf("Recorded sends cleared\n");
+		return true;
+	} else if (strcmp(argv[1], "run")) {
+		debugPrintf("Unknown argument '%s'\n", argv[1]);
+		return true;
+	}
+
+	// Objects which were disposed since cannot be sent to anymore.
+	Common::Array<SelectorLookupCache::Send> replay;
+	for (uint i = 0; i < sends.size(); ++i) {
+		if (segMan->isHeapObject(sends[i].obj))
+			replay.push_back(sends[i]);
+	}
+	if (replay.empty()) {
+		debugPrintf("None of the recorded sends are to objects which still exist\n");
+		return true;
+	}
+
+	const int repeat = argc > 2 ? MAX(atoi(argv[2]), 1) : 10;
+	const bool wasEnabled = cache.isEnabled();
+	const bool wasRecording = cache.isRecording();
+	const SelectorLookupCache::Stats stats = cache.getStats();
+	cache.setRecording(false);
+
+	debugPrintf("Looking up %u of %u recorded sends %d times\n", replay.size(), sends.size(), repeat);
+	for (int pass = 0; pass < 2; ++pass) {
+		cache.setEnabled(pass == 1);
+		ObjVarRef varp;
+		reg_t funcp;
+		const uint32 start = g_system->getMillis();
+		for (int i = 0; i < repeat; ++i) {
+			for (uint j = 0; j < replay.size(); ++j)
+				lookupSelector(segMan, replay[j].obj, replay[j].selector, &varp, &funcp);
+		}
+		const uint32 ms = MAX<uint32>(g_system->getMillis() - start, 1);
+		debugPrintf("%-18s %6u ms, %10u sends per second\n", pass ? "With the cache:" : "Without the cache:",
+			ms, (uint32)((uint64)replay.size() * repeat * 1000 / ms));
+	}
+
+	cache.setEnabled(wasEnabled);
+	cache.setRecording(wasRecording);
+	cache.getStats() = stats;
+	return true;
+}
+
+bool Console::cmdVMDecode(int argc, const char **argv) {
+	PMachineDecoder &decoder = _engine->_gamestate->_decoder;
+	PMachineDecoder::Stats &stats = decoder.getStats();
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			decoder.setMode(PMachineDecoder::kModeOn);
+			debugPrintf("Executing decoded instructions\n");
+		} else if (!strcmp(argv[1], "off")) {
+			decoder.setMode(PMachineDecoder::kModeOff);
+			debugPrintf("Reading every instruction while executing it\n");
+		} else if (!strcmp(argv[1], "verify")) {
+			decoder.setMode(PMachineDecoder::kModeVerify);
+			debugPrintf("Comparing every decoded instruction and superinstruction with the interpreter loop\n");
+		} else if (!strcmp(argv[1], "fuse") && argc > 2) {
+			decoder.setFusion(!strcmp(argv[2], "on"));
+			debugPrintf("Superinstructions %s\n", decoder.isFusionEnabled() ? "enabled" : "disabled");
+		} else if (!strcmp(argv[1], "reset")) {
+			SegManager *segMan = _engine->_gamestate->_segMan;
+			for (uint i = 0; i < segMan->_heap.size(); i++) {
+				if (segMan->_heap[i] && segMan->_heap[i]->getType() == SEG_TYPE_SCRIPT)
+					static_cast<Script *>(segMan->_heap[i])->getDecodedScript().clear();
+			}
+			stats.reset();
+			debugPrintf("Decoded instructions dropped\n");
+		} else {
+			debugPrintf("Usage: %s [on | off | verify | fuse on | fuse off | reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	static const char *const modeNames[] = { "off", "on", "verify" };
+	debugPrintf("Decoding is %s, superinstructions are %s\n", modeNames[decoder.getMode()],
+		decoder.isFusionEnabled() ? "enabled" : "disabled");
+	debugPrintf("%u instructions decoded, %u of them followed by a push or branch\n", stats.decoded, stats.fused);
+	debugPrintf("%u instructions verified, %u changed after they were decoded\n", stats.verified, stats.mismatches);
+	debugPrintf("%u superinstructions verified, %u did not match the interpreter loop\n", stats.fusedVerified, stats.fusedMismatches);
+
+	SegManager *segMan = _engine->_gamestate->_segMan;
+	uint instructions = 0;
+	uint32 memory = 0;
+	for (uint i = 0; i < segMan->_heap.size(); i++) {
+		if (segMan->_heap[i] && segMan->_heap[i]->getType() == SEG_TYPE_SCRIPT) {
+			const DecodedScript &code = static_cast<Script *>(segMan->_heap[i])->getDecodedScript();
+			instructions += code.size();
+			memory += code.getMemoryUsage();
+		}
+	}
+	debugPrintf("%u instructions of the loaded scripts decoded, using %u KB\n", instructions, memory / 1024);
+	return true;
+}
+
+bool Console::cmdVMHistogram(int argc, const char **argv) {
+	PMachineDecoder &decoder = _engine->_gamestate->_decoder;
+
+	if (argc > 1 && !strcmp(argv[1], "on")) {
+		decoder.setHistogram(true);
+		debugPrintf("Counting opcodes\n");
+		return true;
+	} else if (argc > 1 && !strcmp(argv[1], "off")) {
+		decoder.setHistogram(false);
+		debugPrintf("Stopped counting opcodes\n");
+		return true;
+	} else if (argc > 1 && !strcmp(argv[1], "clear")) {
+		decoder.clearHistogram();
+		debugPrintf("Opcode counts cleared\n");
+		return true;
+	}
+
+	int count = argc > 1 ? atoi(argv[1]) : 0;
+	if (count <= 0) {
+		debugPrintf("Counts the opcodes the VM executes, and which opcodes follow each other.\n");
+		debugPrintf("Usage: %s on | off | clear | <count>\n", argv[0]);
+		debugPrintf("Counting is %s\n", decoder.isHistogramEnabled() ? "on" : "off");
+		return true;
+	}
+
+	// Each list is sorted by a selection of the largest remaining count.
+	Common::Array<uint32> opcodes;
+	uint64 total = 0;
+	for (uint i = 0; i < PMachineDecoder::kOpcodeCount; i++) {
+		total += decoder.getOpcodeCount(i);
+		if (decoder.getOpcodeCount(i))
+			opcodes.push_back(i);
+	}
+	debugPrintf("Most executed of %u opcodes:\n", (uint32)total);
+	for (int n = 0; n < count && !opcodes.empty(); n++) {
+		uint best = 0;
+		for (uint i = 1; i < opcodes.size(); i++) {
+			if (decoder.getOpcodeCount(opcodes[i]) > decoder.getOpcodeCount(opcodes[best]))
+				best = i;
+		}
+		const uint32 opcode = opcodes[best];
+		debugPrintf(" %-8s %10u  %5.1f%%\n", opcodeNames[opcode], decoder.getOpcodeCount(opcode),
+			decoder.getOpcodeCount(opcode) * 100.0 / total);
+		opcodes.remove_at(best);
+	}
+
+	Common::Array<uint32> pairs;
+	for (uint i = 0; i < PMachineDecoder::kOpcodeCount * PMachineDecoder::kOpcodeCount; i++) {
+		if (decoder.getPairCount(i / PMachineDecoder::kOpcodeCount, i % PMachineDecoder::kOpcodeCount))
+			pairs.push_back(i);
+	}
+	debugPrintf("Most executed opcode pairs:\n");
+	for (int n = 0; n < count && !pairs.empty(); n++) {
+		uint best = 0;
+		uint32 bestCount = 0;
+		for (uint i = 0; i < pairs.size(); i++) {
+			const uint32 pairCount = decoder.getPairCount(pairs[i] / PMachineDecoder::kOpcodeCount, pairs[i] % PMachineDecoder::kOpcodeCount);
+			if (pairCount > bestCount) {
+				best = i;
+				bestCount = pairCount;
+			}
+		}
+		debugPrintf(" %-8s %-8s %10u  %5.1f%%\n", opcodeNames[pairs[best] / PMachineDecoder::kOpcodeCount],
+			opcodeNames[pairs[best] % PMachineDecoder::kOpcodeCount], bestCount, bestCount * 100.0 / total);
+		pairs.remove_at(best);
+	}
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	int curScriptNr = -1;
 
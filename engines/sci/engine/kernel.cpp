@@ -36,7 +36,9 @@ namespace Sci {
 Kernel::Kernel(ResourceManager *resMan, SegManager *segMan)	:
 	_resMan(resMan),
 	_segMan(segMan),
-	_invalid("<invalid>") {
+	_invalid("<invalid>"),
+	_signatureCheckMode(kSignatureCheckFull),
+	_profiling(false) {
 	loadSelectorNames();
 	mapSelectors();
 }
@@ -161,6 +163,35 @@ void Kernel::loadSelectorNames() {
 	}
 }
 
+// Checks the number of arguments of a call against a parsed signature, like
+// signatureMatch() does once it has run out of arguments
+static bool signatureAcceptsArgCount(const uint16 *sig, int argc) {
+	uint16 nextSig = *sig;
+	uint16 curSig = nextSig;
+	while (nextSig && argc) {
+		curSig = nextSig;
+		if (!(curSig & SIG_MORE_MAY_FOLLOW)) {
+			sig++;
+			nextSig = *sig;
+		} else {
+			nextSig |= SIG_IS_OPTIONAL;
+		}
+		argc--;
+	}
+
+	// Too many arguments?
+	if (argc)
+		return false;
+	// Signature end reached?
+	if (nextSig == 0)
+		return true;
+	// current parameter is optional? then nothing more may be required
+	if (curSig & SIG_IS_OPTIONAL)
+		return !(curSig & SIG_NEEDS_MORE);
+	// otherwise the next parameter has to be optional
+	return (nextSig & SIG_IS_OPTIONAL) != 0;
+}
+
 // this parses a written kernel signature into an internal memory format
 // [io] -> either integer or object
 // (io) -> optionally integer AND an object
@@ -171,7 +202,7 @@ void Kernel::loadSelectorNames() {
 // .* -> at least one parameter of any type and more parameters of any type may follow
 // (.*) -> any parameters afterwards (or none)
 // * -> means "more of the last parameter may follow (or none at all)", must be at the end of a signature. Is not valid anywhere else.
-static uint16 *parseKernelSignature(const char *kernelName, const char *writtenSig) {
+static uint16 *parseKernelSignature(const char *kernelName, const char *writtenSig, KernelSignatureCounts &counts) {
 	const char *curPos;
 	char curChar;
 	uint16 *result = NULL;
@@ -367,6 +398,21 @@ static uint16 *parseKernelSignature(const char *kernelName, const char *writtenS
 	// Write terminator
 	*writePos = 0;
 
+	// Work out which argument counts match, the way signatureMatch() does
+	counts.length = size;
+	counts.accepted = 0;
+	counts.more = false;
+	if (size >= 32)
+		error("signature for k%s: too many parameters", kernelName);
+	for (int argc = 0; argc <= size + 1; argc++) {
+		if (signatureAcceptsArgCount(result, argc)) {
+			if (argc <= size)
+				counts.accepted |= 1U << argc;
+			else
+				counts.more = true;
+		}
+	}
+
 	return result;
 }
 
@@ -552,6 +598,79 @@ bool Kernel::signatureMatch(const uint16 *sig, int argc, const reg_t *argv) {
 	return false;
 }
 
+// The types findRegType() can find for a pointer into a segment of each type,
+// apart from SIG_IS_INVALID
+static const uint16 s_segmentSignatureTypes[SEG_TYPE_MAX] = {
+	SIG_TYPE_ERROR,								// SEG_TYPE_INVALID
+	SIG_TYPE_OBJECT | SIG_TYPE_REFERENCE,		// SEG_TYPE_SCRIPT
+	SIG_TYPE_OBJECT,							// SEG_TYPE_CLONES
+	SIG_TYPE_REFERENCE,							// SEG_TYPE_LOCALS
+	SIG_TYPE_REFERENCE,							// SEG_TYPE_STACK
+	SIG_TYPE_ERROR,								// 5, obsolete
+	SIG_TYPE_LIST,								// SEG_TYPE_LISTS
+	SIG_TYPE_NODE,								// SEG_TYPE_NODES
+	SIG_TYPE_REFERENCE,							// SEG_TYPE_HUNK
+	SIG_TYPE_REFERENCE,							// SEG_TYPE_DYNMEM
+#ifdef ENABLE_SCI32
+	SIG_TYPE_ERROR,								// 10, obsolete
+	SIG_TYPE_REFERENCE,							// SEG_TYPE_ARRAY
+	SIG_TYPE_ERROR,								// 12, obsolete
+	SIG_TYPE_REFERENCE							// SEG_TYPE_BITMAP
+#endif
+};
+
+bool Kernel::argumentMatches(uint16 sig, reg_t reg) {
+	// Integers and uninitialized values are known from the segment alone
+	if (!reg.getSegment())
+		return sig & (SIG_TYPE_INTEGER | (reg.getOffset() ? 0 : SIG_TYPE_NULL));
+	if (reg.getSegment() == kUninitializedSegment)
+		return sig & SIG_TYPE_UNINITIALIZED;
+
+	SegmentObj *mobj = _segMan->findSegmentObj(reg.getSegment());
+	const uint16 types = mobj ? s_segmentSignatureTypes[mobj->getType()] : SIG_TYPE_ERROR;
+	if (types == SIG_TYPE_ERROR)
+		return sig & (SIG_TYPE_ERROR | SIG_IS_INVALID);
+	if (!(types & sig))
+		return false;
+	if (!(sig & SIG_IS_INVALID) && !mobj->isValidOffset(reg.getOffset()))
+		return false;
+	if ((types & sig) == types)
+		return true;
+
+	// Only script segments hold both objects and references, which tell
+	// apart by the offset
+	_signatureStats.lookups++;
+	return (findRegType(reg) & ~SIG_IS_INVALID) & sig;
+}
+
+bool Kernel::checkSignature(const uint16 *sig, const KernelSignatureCounts &counts, const SciWorkaroundEntry *workarounds, int argc, const reg_t *argv) {
+	if (_signatureCheckMode == kSignatureCheckWorkarounds && !workarounds) {
+		_signatureStats.skipped++;
+		return true;
+	}
+
+	_signatureStats.checked++;
+	if (argc <= counts.length ? !(counts.accepted & (1U << argc)) : !counts.more)
+		return false;
+
+	_signatureStats.arguments += argc;
+	for (int i = 0; i < argc; i++) {
+		// The last entry repeats, if more may follow
+		if (!argumentMatches(sig[MIN<int>(i, counts.length - 1)], argv[i]))
+			return false;
+	}
+	return true;
+}
+
+void Kernel::resetCallStats() {
+	for (KernelFunctionArray::iterator it = _kernelFuncs.begin(); it != _kernelFuncs.end(); ++it) {
+		memset(&it->stats, 0, sizeof(KernelCallStats));
+		for (uint16 i = 0; i < it->subFunctionCount; i++)
+			memset(&it->subFunctions[i].stats, 0, sizeof(KernelCallStats));
+	}
+	_signatureStats.reset();
+}
+
 void Kernel::mapFunctions() {
 	int mapped = 0;
 	int ignored = 0;
@@ -592,10 +711,12 @@ void Kernel::mapFunctions() {
 		// Reset the table entry
 		_kernelFuncs[id].function = NULL;
 		_kernelFuncs[id].signature = NULL;
+		memset(&_kernelFuncs[id].signatureCounts, 0, sizeof(KernelSignatureCounts));
 		_kernelFuncs[id].name = NULL;
 		_kernelFuncs[id].workarounds = NULL;
 		_kernelFuncs[id].subFunctions = NULL;
 		_kernelFuncs[id].subFunctionCount = 0;
+		memset(&_kernelFuncs[id].stats, 0, sizeof(KernelCallStats));
 		if (kernelName.empty()) {
 			// No name was given -> must be an unknown opcode
 			warning("Kernel function %x unknown", id);
@@ -613,7 +734,7 @@ void Kernel::mapFunctions() {
 		// else seems to use)!
 		if (g_sci->getPlatform() == Common::kPlatformMacintosh && g_sci->getGameId() == GID_PHANTASMAGORIA && kernelName == "DoSound") {
 			_kernelFuncs[id].function = kDoSoundPhantasmagoriaMac;
-			_kernelFuncs[id].signature = parseKernelSignature("DoSoundPhantasmagoriaMac", "i.*");
+			_kernelFuncs[id].signature = parseKernelSignature("DoSoundPhantasmagoriaMac", "i.*", _kernelFuncs[id].signatureCounts);
 			_kernelFuncs[id].name = "DoSoundPhantasmagoriaMac";
 			continue;
 		}
@@ -638,7 +759,7 @@ void Kernel::mapFunctions() {
 			// A match was found
 			_kernelFuncs[id].function = kernelMap->function;
 			_kernelFuncs[id].name = kernelMap->name;
-			_kernelFuncs[id].signature = parseKernelSignature(kernelMap->name, kernelMap->signature);
+			_kernelFuncs[id].signature = parseKernelSignature(kernelMap->name, kernelMap->signature, _kernelFuncs[id].signatureCounts);
 			_kernelFuncs[id].workarounds = kernelMap->workarounds;
 			if (kernelMap->subFunctions) {
 				// Get version for subfunction identification
@@ -672,7 +793,7 @@ void Kernel::mapFunctions() {
 								subFunctions[subId].name = kernelSubMap->name;
 								subFunctions[subId].workarounds = kernelSubMap->workarounds;
 								if (kernelSubMap->signature) {
-									subFunctions[subId].signature = parseKernelSignature(kernelSubMap->name, kernelSubMap->signature);
+									subFunctions[subId].signature = parseKernelSignature(kernelSubMap->name, kernelSubMap->signature, subFunctions[subId].signatureCounts);
 								} else {
 									// we go back the submap to find the previous signature for that kernel call
 									const SciKernelMapSubEntry *kernelSubMapBack = kernelSubMap;
@@ -682,7 +803,7 @@ void Kernel::mapFunctions() {
 										kernelSubMapBack--;
 										if (kernelSubMapBack->name == kernelSubMap->name) {
 											if (kernelSubMapBack->signature) {
-												subFunctions[subId].signature = parseKernelSignature(kernelSubMap->name, kernelSubMapBack->signature);
+												subFunctions[subId].signature = parseKernelSignature(kernelSubMap->name, kernelSubMapBack->signature, subFunctions[subId].signatureCounts);
 												break;
 											}
 										}
@@ -127,22 +127,53 @@ enum {
 /* Generic description: */
 typedef reg_t KernelFunctionCall(EngineState *s, int argc, reg_t *argv);
 
+/** How often a kernel function was called, for the kernel_stats console command. */
+struct KernelCallStats {
+	uint32 calls;
+	uint32 millis;	///< time spent in the function while profiling, including the scripts it ran
+};
+
+/**
+ * The argument counts a parsed kernel signature accepts. They are worked out
+ * when the signature is parsed, so that a call only has to test each of its
+ * arguments against the signature entry for its position.
+ */
+struct KernelSignatureCounts {
+	uint16 length;		///< entries of the signature, the last one repeats if more may follow
+	uint32 accepted;	///< bit n is set if a call with n arguments matches, for n up to length
+	bool more;			///< whether calls with more than length arguments match
+};
+
 struct KernelSubFunction {
 	KernelFunctionCall *function;
 	const char *name;
 	uint16 *signature;
+	KernelSignatureCounts signatureCounts;
 	const SciWorkaroundEntry *workarounds;
 	bool debugLogging;
 	bool debugBreakpoint;
+	KernelCallStats stats;
 };
 
 struct KernelFunction {
 	KernelFunctionCall *function;
 	const char *name;
 	uint16 *signature;
+	KernelSignatureCounts signatureCounts;
 	const SciWorkaroundEntry *workarounds;
 	KernelSubFunction *subFunctions;
 	uint16 subFunctionCount;
+	KernelCallStats stats;
+};
+
+enum SignatureCheckMode {
+	kSignatureCheckFull,	///< check the type of every argument of every call
+	/**
+	 * Only check functions which have workarounds, which need the check to
+	 * be applied. Calls with wrong arguments are not caught before the
+	 * kernel function runs.
+	 */
+	kSignatureCheckWorkarounds
 };
 
 class Kernel {
@@ -189,6 +220,45 @@ public:
 	 */
 	bool signatureMatch(const uint16 *sig, int argc, const reg_t *argv);
 
+	/**
+	 * Determines whether the arguments of a kernel call match the signature
+	 * of the function, the way the signature check mode asks for. This gives
+	 * the same result as signatureMatch(), but only works out the type of an
+	 * argument as far as the signature entry needs it.
+	 *
+	 * @param sig			signature to test against
+	 * @param counts		the argument counts the signature accepts
+	 * @param workarounds	the workarounds of the function
+	 * @param argc			number of arguments to test
+	 * @param argv			argument list
+	 * @return true if the signature was matched, false otherwise
+	 */
+	bool checkSignature(const uint16 *sig, const KernelSignatureCounts &counts, const SciWorkaroundEntry *workarounds, int argc, const reg_t *argv);
+
+	SignatureCheckMode getSignatureCheckMode() const { return _signatureCheckMode; }
+	void setSignatureCheckMode(SignatureCheckMode mode) { _signatureCheckMode = mode; }
+
+	struct SignatureStats {
+		uint32 checked, skipped;
+		uint32 arguments;	///< arguments of the checked calls
+		uint32 lookups;		///< arguments which needed findRegType()
+
+		SignatureStats() { reset(); }
+
+		void reset() {
+			checked = skipped = 0;
+			arguments = lookups = 0;
+		}
+	};
+
+	SignatureStats &getSignatureStats() { return _signatureStats; }
+
+	bool isProfiling() const { return _profiling; }
+	void setProfiling(bool profiling) { _profiling = profiling; }
+
+	/** Reset the call statistics of all kernel functions and of the signature checks. */
+	void resetCallStats();
+
 	// Prints out debug information in case a signature check fails
 	void signatureDebug(Common::String &signatureDetails, const uint16 *sig, int argc, const reg_t *argv);
 
@@ -252,6 +322,12 @@ private:
 	 */
 	void mapFunctions();
 
+	/**
+	 * Determines whether an argument may be passed for a signature entry,
+	 * the way signatureMatch() decides it for one argument.
+	 */
+	bool argumentMatches(uint16 sig, reg_t reg);
+
 	ResourceManager *_resMan;
 	SegManager *_segMan;
 
@@ -260,6 +336,10 @@ private:
 	Common::StringArray _kernelNames;
 
 	const Common::String _invalid;
+
+	SignatureCheckMode _signatureCheckMode;
+	SignatureStats _signatureStats;
+	bool _profiling;
 };
 
 /******************** Kernel functions ********************/
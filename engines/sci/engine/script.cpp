@@ -79,6 +79,8 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_numObjects = 0;
 #endif
 
+	_decoded.clear();
+
 	_offsetLookupArray.clear();
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
@@ -149,6 +151,11 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 
 	SciSpan<byte> outBuffer = _buf->allocate(bufSize, script->name() + " buffer");
 	script->copyDataTo(outBuffer);
+	// Clear the rest of the buffer (the alignment byte before the heap and
+	// the extra locals), so that the script patcher sees the same data every
+	// time the script is loaded
+	if (bufSize > script->size())
+		memset(outBuffer.getUnsafeDataAt(script->size(), bufSize - script->size()), 0, bufSize - script->size());
 	// The word-aligned script size is used here because other parts of the code
 	// currently rely on finding the start of the heap by reading the script
 	// size
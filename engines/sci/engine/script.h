@@ -27,6 +27,7 @@
 #include "sci/util.h"
 #include "sci/engine/segment.h"
 #include "sci/engine/script_patches.h"
+#include "sci/engine/vm_decode.h"
 
 namespace Sci {
 
@@ -114,6 +115,7 @@ private:
 	LocalVariables *_localsBlock;
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
+	DecodedScript _decoded; /**< Instructions decoded for the VM, filled as they are executed */
 #ifndef ENABLE_SCI32
 	Offset _numObjects; /**< number of live objects in 'objects' */
 #endif
@@ -153,6 +155,7 @@ public:
 	void syncLocalsBlock(SegManager *segMan);
 	ObjMap &getObjectMap() { return _objects; }
 	const ObjMap &getObjectMap() const { return _objects; }
+	DecodedScript &getDecodedScript() { return _decoded; }
 
 	inline bool offsetIsObject(uint32 offset) const {
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
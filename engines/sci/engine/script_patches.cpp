@@ -16288,8 +16288,11 @@ ScriptPatcher::ScriptPatcher() {
 	for (selectorNr = 0; selectorNr < selectorCount; selectorNr++)
 		_selectorIdTable[selectorNr] = -1;
 
+	_signatureTable = NULL;
 	_runtimeTable = NULL;
 	_isMacSci11 = false;
+	_scanMode = kScanMultiPattern;
+	_memo = true;
 }
 
 ScriptPatcher::~ScriptPatcher() {
@@ -16703,10 +16706,162 @@ void ScriptPatcher::enablePatch(const SciScriptPatcherEntry *patchTable, const c
 		error("Script-Patcher: no patch found to enable");
 }
 
+// This method groups the active patches by script, so that processScript() does not have to go through the
+//  whole table for every script, and collects the magic DWORDs to search each script for
+void ScriptPatcher::initScriptSignatures(const SciScriptPatcherEntry *patchTable) {
+	const SciScriptPatcherEntry *curEntry = patchTable;
+	uint16 entryNr = 0;
+
+	_signatureTable = patchTable;
+	_scriptSignatures.clear();
+	_patchedScripts.clear();
+
+	for (; curEntry->signatureData; curEntry++, entryNr++) {
+		const SciScriptPatcherRuntimeEntry &runtimeEntry = _runtimeTable[entryNr];
+		if (!runtimeEntry.active)
+			continue;
+
+		ScriptSignatures &signatures = _scriptSignatures[curEntry->scriptNr];
+		uint16 magicIndex = 0;
+		while (magicIndex < signatures.magicDWords.size() && signatures.magicDWords[magicIndex] != runtimeEntry.magicDWord)
+			magicIndex++;
+		if (magicIndex == signatures.magicDWords.size()) {
+			// the magic DWORD is in platform-specific byte order, so its first byte in memory is the first one in the script
+			byte magicBytes[4];
+			WRITE_UINT32(magicBytes, runtimeEntry.magicDWord);
+			signatures.firstBytes[magicBytes[0] >> 3] |= 1 << (magicBytes[0] & 7);
+			signatures.magicDWords.push_back(runtimeEntry.magicDWord);
+		}
+
+		signatures.entries.push_back(entryNr);
+		signatures.magicIndexes.push_back(magicIndex);
+	}
+}
+
+void ScriptPatcher::setMemo(bool memo) {
+	_memo = memo;
+	if (!memo)
+		_patchedScripts.clear();
+}
+
+// FNV-1a hash of the unpatched script data, to tell if a script is the same one that was patched before
+uint32 ScriptPatcher::hashScript(const SciSpan<const byte> &scriptData) {
+	const byte *data = scriptData.getUnsafeDataAt(0, scriptData.size());
+	uint32 hash = 2166136261U;
+	for (uint32 i = 0; i < scriptData.size(); ++i) {
+		hash ^= data[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+// A single pass over the script which looks up every DWORD in the magic DWORDs of the patches of the script.
+//  A bit set of their first bytes skips most positions without comparing anything.
+void ScriptPatcher::findCandidates(const ScriptSignatures &signatures, const SciSpan<const byte> &scriptData, Common::Array<SignatureCandidate> &candidates) {
+	candidates.clear();
+	_stats.scans++;
+	if (scriptData.size() < 4) // we need to find a DWORD, so less than 4 bytes is not okay
+		return;
+
+	const byte *data = scriptData.getUnsafeDataAt(0, scriptData.size());
+	const uint32 searchLimit = scriptData.size() - 3;
+	const uint magicCount = signatures.magicDWords.size();
+
+	for (uint32 DWordOffset = 0; DWordOffset < searchLimit; DWordOffset++) {
+		const byte firstByte = data[DWordOffset];
+		if (!(signatures.firstBytes[firstByte >> 3] & (1 << (firstByte & 7))))
+			continue;
+
+		const uint32 DWord = READ_UINT32(data + DWordOffset);
+		for (uint magicIndex = 0; magicIndex < magicCount; magicIndex++) {
+			if (signatures.magicDWords[magicIndex] == DWord) {
+				SignatureCandidate candidate;
+				candidate.offset = DWordOffset;
+				candidate.magicIndex = magicIndex;
+				candidates.push_back(candidate);
+				break;
+			}
+		}
+	}
+	_stats.candidates += candidates.size();
+}
+
+// Matches the same offsets as applyPatchesLinear(): the candidates of a signature are verified in ascending
+//  order, and the script is searched again after each patch, as the patch may have changed the magic DWORDs.
+void ScriptPatcher::applyPatchesMultiPattern(uint16 scriptNr, const ScriptSignatures &signatures, SciSpan<byte> scriptData, PatchedScript *patched) {
+	Common::Array<SignatureCandidate> candidates;
+	findCandidates(signatures, scriptData, candidates);
+
+	for (uint i = 0; i < signatures.entries.size(); i++) {
+		const uint16 entryNr = signatures.entries[i];
+		const uint16 magicIndex = signatures.magicIndexes[i];
+		const SciScriptPatcherEntry *curEntry = &_signatureTable[entryNr];
+		const SciScriptPatcherRuntimeEntry *curRuntimeEntry = &_runtimeTable[entryNr];
+		int16 applyCount = curEntry->applyCount;
+		uint candidateNr = 0;
+		int32 foundOffset;
+
+		do {
+			foundOffset = -1;
+			for (; candidateNr < candidates.size(); candidateNr++) {
+				if (candidates[candidateNr].magicIndex != magicIndex)
+					continue;
+				uint32 offset = candidates[candidateNr].offset + curRuntimeEntry->magicOffset;
+				if (verifySignature(offset, curEntry->signatureData, curEntry->description, scriptData)) {
+					foundOffset = offset;
+					break;
+				}
+			}
+			if (foundOffset != -1) {
+				// found, so apply the patch
+				debugC(kDebugLevelScriptPatcher, "Script-Patcher: '%s' on script %d offset %d", curEntry->description, scriptNr, foundOffset);
+				applyPatch(curEntry, scriptData, foundOffset);
+				_stats.applied++;
+				if (patched) {
+					AppliedPatch patch;
+					patch.entry = entryNr;
+					patch.offset = foundOffset;
+					patched->patches.push_back(patch);
+				}
+				findCandidates(signatures, scriptData, candidates);
+				candidateNr = 0;
+			}
+			applyCount--;
+		} while ((foundOffset != -1) && (applyCount));
+	}
+}
+
+void ScriptPatcher::applyPatchesLinear(uint16 scriptNr, const ScriptSignatures &signatures, SciSpan<byte> scriptData, PatchedScript *patched) {
+	for (uint i = 0; i < signatures.entries.size(); i++) {
+		const uint16 entryNr = signatures.entries[i];
+		const SciScriptPatcherEntry *curEntry = &_signatureTable[entryNr];
+		const SciScriptPatcherRuntimeEntry *curRuntimeEntry = &_runtimeTable[entryNr];
+		int32 foundOffset = 0;
+		int16 applyCount = curEntry->applyCount;
+
+		do {
+			foundOffset = findSignature(curEntry, curRuntimeEntry, scriptData);
+			_stats.scans++;
+			if (foundOffset != -1) {
+				// found, so apply the patch
+				debugC(kDebugLevelScriptPatcher, "Script-Patcher: '%s' on script %d offset %d", curEntry->description, scriptNr, foundOffset);
+				applyPatch(curEntry, scriptData, foundOffset);
+				_stats.applied++;
+				if (patched) {
+					AppliedPatch patch;
+					patch.entry = entryNr;
+					patch.offset = foundOffset;
+					patched->patches.push_back(patch);
+				}
+			}
+			applyCount--;
+		} while ((foundOffset != -1) && (applyCount));
+	}
+}
+
 void ScriptPatcher::processScript(uint16 scriptNr, SciSpan<byte> scriptData) {
 	const SciScriptPatcherEntry *signatureTable = NULL;
 	const SciScriptPatcherEntry *curEntry = NULL;
-	SciScriptPatcherRuntimeEntry *curRuntimeEntry = NULL;
 	const Sci::SciGameId gameId = g_sci->getGameId();
 
 	switch (gameId) {
@@ -16938,27 +17093,42 @@ void ScriptPatcher::processScript(uint16 scriptNr, SciSpan<byte> scriptData) {
 			default:
 				break;
 			}
+
+			initScriptSignatures(signatureTable);
 		}
 
-		curEntry = signatureTable;
-		curRuntimeEntry = _runtimeTable;
-
-		while (curEntry->signatureData) {
-			if ((scriptNr == curEntry->scriptNr) && (curRuntimeEntry->active)) {
-				int32 foundOffset = 0;
-				int16 applyCount = curEntry->applyCount;
-				do {
-					foundOffset = findSignature(curEntry, curRuntimeEntry, scriptData);
-					if (foundOffset != -1) {
-						// found, so apply the patch
-						debugC(kDebugLevelScriptPatcher, "Script-Patcher: '%s' on script %d offset %d", curEntry->description, scriptNr, foundOffset);
-						applyPatch(curEntry, scriptData, foundOffset);
-					}
-					applyCount--;
-				} while ((foundOffset != -1) && (applyCount));
+		ScriptSignaturesMap::const_iterator signatures = _scriptSignatures.find(scriptNr);
+		if (signatures == _scriptSignatures.end())
+			return;
+
+		_stats.scripts++;
+		PatchedScript *patched = NULL;
+		if (_memo) {
+			const uint32 hash = hashScript(scriptData);
+			PatchedScriptMap::iterator it = _patchedScripts.find(scriptNr);
+			if (it != _patchedScripts.end() && it->_value.size == scriptData.size() && it->_value.hash == hash) {
+				// Same script as before, so the same patches match at the same offsets
+				const Common::Array<AppliedPatch> &patches = it->_value.patches;
+				for (uint i = 0; i < patches.size(); ++i) {
+					curEntry = &_signatureTable[patches[i].entry];
+					debugC(kDebugLevelScriptPatcher, "Script-Patcher: '%s' on script %d offset %d", curEntry->description, scriptNr, patches[i].offset);
+					applyPatch(curEntry, scriptData, patches[i].offset);
+				}
+				_stats.remembered++;
+				_stats.applied += patches.size();
+				return;
 			}
-			curEntry++; curRuntimeEntry++;
+
+			patched = &_patchedScripts[scriptNr];
+			patched->size = scriptData.size();
+			patched->hash = hash;
+			patched->patches.clear();
 		}
+
+		if (_scanMode == kScanMultiPattern)
+			applyPatchesMultiPattern(scriptNr, signatures->_value, scriptData, patched);
+		else
+			applyPatchesLinear(scriptNr, signatures->_value, scriptData, patched);
 	}
 }
 
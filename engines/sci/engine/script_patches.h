@@ -23,6 +23,9 @@
 #ifndef SCI_ENGINE_SCRIPT_PATCHES_H
 #define SCI_ENGINE_SCRIPT_PATCHES_H
 
+#include "common/array.h"
+#include "common/hashmap.h"
+
 #include "sci/sci.h"
 
 namespace Sci {
@@ -89,6 +92,28 @@ struct SciScriptPatcherRuntimeEntry {
  */
 class ScriptPatcher {
 public:
+	/**
+	 * How processScript() searches a script for the signatures of its patches.
+	 */
+	enum ScanMode {
+		kScanLinear,		///< search the whole script once for every signature
+		/**
+		 * Find the magic DWORDs of all signatures of the script in one pass,
+		 * and only verify the signatures where their magic DWORD was found.
+		 */
+		kScanMultiPattern
+	};
+
+	struct Stats {
+		uint32 scripts, remembered, scans, candidates, applied;
+
+		Stats() { reset(); }
+
+		void reset() {
+			scripts = remembered = scans = candidates = applied = 0;
+		}
+	};
+
 	ScriptPatcher();
 	~ScriptPatcher();
 
@@ -106,13 +131,73 @@ public:
 	// returns -1 in case it was not found or an offset to the matching data
 	int32 findSignature(uint32 magicDWord, int magicOffset, const uint16 *signatureData, const char *patchDescription, const SciSpan<const byte> &scriptData);
 
+	ScanMode getScanMode() const { return _scanMode; }
+	void setScanMode(ScanMode scanMode) { _scanMode = scanMode; }
+
+	// Whether the patches found in a script are remembered, so that they can be
+	// applied without searching when the same script is loaded again
+	bool isMemoEnabled() const { return _memo; }
+	void setMemo(bool memo);
+	void forgetPatchedScripts() { _patchedScripts.clear(); }
+	uint getPatchedScriptCount() const { return _patchedScripts.size(); }
+
+	Stats &getStats() { return _stats; }
+	const Stats &getStats() const { return _stats; }
+
 private:
+	// The active patches of one script, in the order of the patch table
+	struct ScriptSignatures {
+		Common::Array<uint16> entries;		///< indexes into the patch table
+		Common::Array<uint16> magicIndexes;	///< index into magicDWords for each entry
+		Common::Array<uint32> magicDWords;	///< distinct magic DWORDs of the entries
+		byte firstBytes[32];				///< bit set of the first bytes of the magic DWORDs
+
+		ScriptSignatures() { memset(firstBytes, 0, sizeof(firstBytes)); }
+	};
+
+	// A position of a script where one of the magic DWORDs was found
+	struct SignatureCandidate {
+		uint32 offset;
+		uint16 magicIndex;
+	};
+
+	struct AppliedPatch {
+		uint16 entry;
+		int32 offset;
+	};
+
+	// The patches applied to a script, and the size and hash of the script
+	// before they were applied
+	struct PatchedScript {
+		uint32 size;
+		uint32 hash;
+		Common::Array<AppliedPatch> patches;
+	};
+
+	typedef Common::HashMap<uint16, ScriptSignatures> ScriptSignaturesMap;
+	typedef Common::HashMap<uint16, PatchedScript> PatchedScriptMap;
+
+
 	// Initializes a patch table and creates run time information for it (for enabling/disabling), also calculates magic DWORD)
 	void initSignature(const SciScriptPatcherEntry *patchTable);
 
 	// Enables a patch inside the patch table (used for optional patches like CD+Text support for KQ6 & LB2)
 	void enablePatch(const SciScriptPatcherEntry *patchTable, const char *searchDescription);
 
+	// Groups the active patches of the patch table by script
+	void initScriptSignatures(const SciScriptPatcherEntry *patchTable);
+
+	// Finds all positions of a script where the magic DWORD of one of its patches is
+	void findCandidates(const ScriptSignatures &signatures, const SciSpan<const byte> &scriptData, Common::Array<SignatureCandidate> &candidates);
+
+	// Applies the patches of a script, verifying their signatures only where their magic DWORD was found
+	void applyPatchesMultiPattern(uint16 scriptNr, const ScriptSignatures &signatures, SciSpan<byte> scriptData, PatchedScript *patched);
+
+	// Applies the patches of a script, searching the whole script for every signature
+	void applyPatchesLinear(uint16 scriptNr, const ScriptSignatures &signatures, SciSpan<byte> scriptData, PatchedScript *patched);
+
+	static uint32 hashScript(const SciSpan<const byte> &scriptData);
+
 	// Searches for a given signature entry inside script data
 	// returns -1 in case it was not found or an offset to the matching data
 	int32 findSignature(const SciScriptPatcherEntry *patchEntry, const SciScriptPatcherRuntimeEntry *runtimeEntry, const SciSpan<const byte> &scriptData);
@@ -121,8 +206,15 @@ private:
 	void applyPatch(const SciScriptPatcherEntry *patchEntry, SciSpan<byte> scriptData, int32 signatureOffset);
 
 	Selector *_selectorIdTable;
+	const SciScriptPatcherEntry *_signatureTable;
 	SciScriptPatcherRuntimeEntry *_runtimeTable;
 	bool _isMacSci11;
+
+	ScriptSignaturesMap _scriptSignatures;
+	PatchedScriptMap _patchedScripts;
+	ScanMode _scanMode;
+	bool _memo;
+	Stats _stats;
 };
 
 } // End of namespace Sci
@@ -326,6 +326,39 @@ SelectorType lookupSelector(SegManager *segMan, const reg_t &obj_location, Selec
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x, %s", PRINT_REG(obj_location), origin.toString().c_str());
 	}
 
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	if (cache.isRecording())
+		cache.recordSend(obj_location, selectorId);
+
+	// SCI3 objects carry their own variable tables, which the cache does not
+	// account for.
+	if (cache.isEnabled() && getSciVersion() != SCI_VERSION_3) {
+		SelectorLookupCache::Result result;
+		if (cache.lookup(segMan, obj->isClass() ? obj->getPos() : obj->getSuperClassSelector(), selectorId, result)) {
+			if (result.type == kSelectorVariable) {
+				if (varp) {
+					varp->obj = obj_location;
+					varp->varindex = result.varIndex;
+				}
+				return kSelectorVariable;
+			}
+
+			// Methods of the instance itself come before those of its class
+			if (!obj->isClass()) {
+				const int16 index = obj->funcSelectorPosition(selectorId);
+				if (index >= 0) {
+					if (fptr)
+						*fptr = obj->getFunction(index);
+					return kSelectorMethod;
+				}
+			}
+
+			if (result.type == kSelectorMethod && fptr)
+				*fptr = result.func;
+			return result.type;
+		}
+	}
+
 	int16 index = obj->locateVarSelector(segMan, selectorId);
 
 	if (index >= 0) {
@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "sci/engine/object.h"
+#include "sci/engine/seg_manager.h"
+#include "sci/engine/selector_lookup.h"
+
+namespace Sci {
+
+SelectorLookupCache::SelectorLookupCache() : _enabled(true), _recording(false) {
+	memset(_recent, 0, sizeof(_recent));
+}
+
+SelectorLookupCache::~SelectorLookupCache() {
+	invalidate();
+}
+
+void SelectorLookupCache::setEnabled(bool enabled) {
+	_enabled = enabled;
+	invalidate();
+}
+
+bool SelectorLookupCache::lookup(SegManager *segMan, reg_t classPos, Selector selector, Result &result) {
+	const uint32 classKey = makeClassKey(classPos);
+	Recent &recent = _recent[(classKey * 31 + (uint16)selector) % kRecentSize];
+
+	_stats.lookups++;
+	if (recent.classKey == classKey && recent.selector == selector) {
+		_stats.hits++;
+		result = recent.result;
+		return true;
+	}
+
+	ClassMap::iterator it = _classes.find(classKey);
+	ClassIndex *index;
+	if (it != _classes.end()) {
+		index = it->_value;
+		ClassIndex::const_iterator entry = index->find(selector);
+		if (entry != index->end()) {
+			_stats.indexHits++;
+			result = entry->_value;
+			recent.classKey = classKey;
+			recent.selector = selector;
+			recent.result = result;
+			return true;
+		}
+	} else {
+		index = 0;
+	}
+
+	if (!resolve(segMan, classPos, selector, result)) {
+		_stats.bypassed++;
+		return false;
+	}
+
+	if (!index) {
+		index = new ClassIndex();
+		_classes[classKey] = index;
+	}
+	_stats.indexBuilds++;
+	(*index)[selector] = result;
+	recent.classKey = classKey;
+	recent.selector = selector;
+	recent.result = result;
+	return true;
+}
+
+bool SelectorLookupCache::resolve(SegManager *segMan, reg_t classPos, Selector selector, Result &result) {
+	const Object *obj = segMan->getObject(classPos);
+	if (!obj || !obj->isClass())
+		return false;
+
+	result.type = kSelectorNone;
+	result.varIndex = -1;
+	result.func = NULL_REG;
+
+	// The same order as lookupSelector(): variables first, then the methods
+	// of the class and its superclasses.
+	result.varIndex = obj->locateVarSelector(segMan, selector);
+	if (result.varIndex >= 0) {
+		result.type = kSelectorVariable;
+		return true;
+	}
+
+	while (obj) {
+		const int16 index = obj->funcSelectorPosition(selector);
+		if (index >= 0) {
+			result.type = kSelectorMethod;
+			result.func = obj->getFunction(index);
+			return true;
+		}
+		obj = segMan->getObject(obj->getSuperClassSelector());
+	}
+
+	return true;
+}
+
+void SelectorLookupCache::recordSend(reg_t obj, Selector selector) {
+	if (_sends.size() >= kMaxRecordedSends) {
+		_recording = false;
+		return;
+	}
+
+	Send send;
+	send.obj = obj;
+	send.selector = selector;
+	_sends.push_back(send);
+}
+
+void SelectorLookupCache::invalidate() {
+	if (!_classes.empty())
+		_stats.invalidations++;
+
+	for (ClassMap::iterator it = _classes.begin(); it != _classes.end(); ++it)
+		delete it->_value;
+	_classes.clear();
+	memset(_recent, 0, sizeof(_recent));
+}
+
+} // End of namespace Sci
@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_SELECTOR_LOOKUP_H
+#define SCI_ENGINE_SELECTOR_LOOKUP_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+
+#include "sci/engine/vm.h"
+#include "sci/engine/vm_types.h"
+
+namespace Sci {
+
+class SegManager;
+
+/**
+ * Remembers what selectors resolve to for each class, so that sending to an
+ * object does not have to search the variables of its class and then the
+ * methods of every superclass.
+ *
+ * Each class gets a hash index of the selectors sent to it or to its
+ * instances, which is filled as selectors are resolved for the first time,
+ * including those the class does not understand. In front of the indexes
+ * sits a small direct mapped cache of recent (class, selector) pairs, which
+ * most sends hit, as a call site usually sends the same selector to objects
+ * of the same class over and over.
+ *
+ * Methods an instance defines itself are not part of the index of its class
+ * and are still searched by lookupSelector(). The indexes refer to the code
+ * and layout of loaded scripts, so the SegManager drops them whenever a
+ * script is instantiated, uninstantiated or freed.
+ */
+class SelectorLookupCache {
+public:
+	struct Result {
+		SelectorType type;
+		int16 varIndex;	///< index of the variable, for kSelectorVariable
+		reg_t func;		///< address of the method, for kSelectorMethod
+	};
+
+	/** A send recorded for the VM benchmark of the console. */
+	struct Send {
+		reg_t obj;
+		Selector selector;
+	};
+
+	enum {
+		/** Number of sends recorded at most. */
+		kMaxRecordedSends = 1000000
+	};
+
+	struct Stats {
+		uint32 lookups, hits, indexHits, indexBuilds, bypassed, invalidations;
+
+		Stats() { reset(); }
+
+		void reset() {
+			lookups = hits = indexHits = indexBuilds = bypassed = invalidations = 0;
+		}
+	};
+
+	SelectorLookupCache();
+	~SelectorLookupCache();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return _enabled; }
+
+	/**
+	 * Resolve a selector of a class.
+	 *
+	 * @param classPos	the address of the class
+	 * @return	false if the class could not be found; the caller then has to
+	 *			look up the selector itself
+	 */
+	bool lookup(SegManager *segMan, reg_t classPos, Selector selector, Result &result);
+
+	/** Forget all classes. */
+	void invalidate();
+
+	uint getClassCount() const { return _classes.size(); }
+
+	void setRecording(bool recording) { _recording = recording; }
+	bool isRecording() const { return _recording; }
+	void recordSend(reg_t obj, Selector selector);
+	Common::Array<Send> &getRecordedSends() { return _sends; }
+
+	Stats &getStats() { return _stats; }
+	const Stats &getStats() const { return _stats; }
+
+private:
+	enum {
+		kRecentSize = 512
+	};
+
+	struct Recent {
+		uint32 classKey;	///< 0 while unused
+		Selector selector;
+		Result result;
+	};
+
+	typedef Common::HashMap<Selector, Result> ClassIndex;
+	typedef Common::HashMap<uint32, ClassIndex *> ClassMap;
+
+	static uint32 makeClassKey(reg_t classPos) {
+		return ((uint32)classPos.getSegment() << 16) | (classPos.getOffset() & 0xFFFF);
+	}
+
+	static bool resolve(SegManager *segMan, reg_t classPos, Selector selector, Result &result);
+
+	bool _enabled;
+	bool _recording;
+	Common::Array<Send> _sends;
+	Recent _recent[kRecentSize];
+	ClassMap _classes;
+	Stats _stats;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_SELECTOR_LOOKUP_H
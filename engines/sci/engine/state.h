@@ -36,6 +36,7 @@ class WriteStream;
 #include "sci/sci.h"
 #include "sci/engine/file.h"
 #include "sci/engine/seg_manager.h"
+#include "sci/engine/vm_decode.h"
 
 #include "sci/parser/vocabulary.h"
 
@@ -175,6 +176,8 @@ public:
 	int scriptStepCounter; // Counts the number of steps executed
 	int scriptGCInterval; // Number of steps in between gcs
 
+	PMachineDecoder _decoder; /**< Decodes script code for the VM */
+
 	uint16 currentRoomNumber() const;
 	void setRoomNumber(uint16 roomNumber);
 
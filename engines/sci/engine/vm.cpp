@@ -23,6 +23,7 @@
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/system.h"
 
 #include "sci/sci.h"
 #include "sci/console.h"
@@ -206,6 +207,13 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 		if (type == VAR_TEMP && value.getSegment() == kUninitializedSegment)
 			value.setSegment(0);
 
+		// The game is going to change rooms at the start of its next cycle,
+		// so the resources of the new room can be read while it waits for
+		// the current one to end.
+		if (index == kGlobalVarNewRoomNo && type == VAR_GLOBAL && !value.getSegment() &&
+			value != s->variables[type][index])
+			g_sci->getResMan()->prefetchRoom(value.getOffset());
+
 		s->variables[type][index] = value;
 
 		g_sci->_guestAdditions->writeVarHook(type, index, value);
@@ -353,11 +361,12 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 	if (kernelCallNr >= (int)kernel->_kernelFuncs.size())
 		error("Invalid kernel function 0x%x requested", kernelCallNr);
 
-	const KernelFunction &kernelCall = kernel->_kernelFuncs[kernelCallNr];
+	KernelFunction &kernelCall = kernel->_kernelFuncs[kernelCallNr];
 	reg_t *argv = s->xs->sp + 1;
 
+	kernelCall.stats.calls++;
 	if (kernelCall.signature
-			&& !kernel->signatureMatch(kernelCall.signature, argc, argv)) {
+			&& !kernel->checkSignature(kernelCall.signature, kernelCall.signatureCounts, kernelCall.workarounds, argc, argv)) {
 		// signature mismatch, check if a workaround is available
 		SciCallOrigin originReply;
 		SciWorkaroundSolution solution = trackOriginAndFindWorkaround(0, kernelCall.workarounds, &originReply);
@@ -385,7 +394,12 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 	if (!kernelCall.subFunctionCount) {
 		argv[-1] = make_reg(0, argc); // The first argument is argc
 		addKernelCallToExecStack(s, kernelCallNr, -1, argc, argv);
+		// The console may switch profiling on while the function runs.
+		const bool profiling = kernel->isProfiling();
+		const uint32 startTime = profiling ? g_system->getMillis() : 0;
 		s->r_acc = kernelCall.function(s, argc, argv);
+		if (profiling)
+			kernelCall.stats.millis += g_system->getMillis() - startTime;
 
 		if (g_sci->checkKernelBreakpoint(kernelCall.name))
 			logKernelCall(&kernelCall, NULL, s, argc, argv, s->r_acc);
@@ -416,8 +430,9 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 		argv++;
 		if (subId >= kernelCall.subFunctionCount)
 			error("[VM] k%s: subfunction ID %d requested, but not available", kernelCall.name, subId);
-		const KernelSubFunction &kernelSubCall = kernelCall.subFunctions[subId];
-		if (kernelSubCall.signature && !kernel->signatureMatch(kernelSubCall.signature, argc, argv)) {
+		KernelSubFunction &kernelSubCall = kernelCall.subFunctions[subId];
+		kernelSubCall.stats.calls++;
+		if (kernelSubCall.signature && !kernel->checkSignature(kernelSubCall.signature, kernelSubCall.signatureCounts, kernelSubCall.workarounds, argc, argv)) {
 			// Signature mismatch
 			SciCallOrigin originReply;
 			SciWorkaroundSolution solution = trackOriginAndFindWorkaround(0, kernelSubCall.workarounds, &originReply);
@@ -452,7 +467,14 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 			error("[VM] k%s: subfunction ID %d requested, but not available", kernelCall.name, subId);
 		argv[-1] = make_reg(0, argc); // The first argument is argc
 		addKernelCallToExecStack(s, kernelCallNr, subId, argc, argv);
+		const bool profiling = kernel->isProfiling();
+		const uint32 startTime = profiling ? g_system->getMillis() : 0;
 		s->r_acc = kernelSubCall.function(s, argc, argv);
+		if (profiling) {
+			const uint32 millis = g_system->getMillis() - startTime;
+			kernelCall.stats.millis += millis;
+			kernelSubCall.stats.millis += millis;
+		}
 
 		if (g_sci->checkKernelBreakpoint(kernelSubCall.name))
 			logKernelCall(&kernelCall, &kernelSubCall, s, argc, argv, s->r_acc);
@@ -576,6 +598,52 @@ uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffse
 	return offset;
 }
 
+/**
+ * Check the second instruction of a superinstruction, which was just
+ * executed, against what the interpreter loop would have done: read it with
+ * readPMachineInstruction(), run the checks at the top of the loop and
+ * execute it on its own.
+ *
+ * @param pc	the offset of the instruction
+ * @param sp	the stack pointer before the instruction
+ * @param acc	the accumulator before the instruction
+ */
+static void verifySuperinstruction(EngineState *s, Script *scr, uint32 pc, StackPtr sp, reg_t acc) {
+	PMachineDecoder::Stats &stats = s->_decoder.getStats();
+	stats.fusedVerified++;
+
+	bool valid = s->abortScriptProcessing == kAbortNone && sp >= s->xs->fp && pc < scr->getBufSize();
+	byte extOpcode = 0;
+	if (valid) {
+		int16 opparams[4];
+		pc += readPMachineInstruction(scr->getBuf(pc), extOpcode, opparams);
+		switch (extOpcode >> 1) {
+		case op_push:
+			sp++;
+			valid = sp[-1] == acc;
+			break;
+		case op_bt:
+			if (!acc.isNull())
+				pc += opparams[0];
+			break;
+		case op_bnt:
+			if (acc.isNull())
+				pc += opparams[0];
+			break;
+		default:
+			valid = false;
+			break;
+		}
+	}
+
+	if (!valid || s->xs->addr.pc.getOffset() != pc || s->xs->sp != sp || s->r_acc != acc) {
+		warning("[VM] Superinstruction %02x in script %d went to %04x with sp %d instead of %04x with sp %d",
+			extOpcode, scr->getScriptNumber(), s->xs->addr.pc.getOffset(), (int)(s->xs->sp - s->stack_base),
+			pc, (int)(sp - s->stack_base));
+		stats.fusedMismatches++;
+	}
+}
+
 void run_vm(EngineState *s) {
 	assert(s);
 
@@ -677,8 +745,23 @@ void run_vm(EngineState *s) {
 
 		// Get opcode
 		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		// The decoded instruction is copied, as executing it may decode more
+		// instructions of the same script, which moves the decoded ones
+		bool fused = false;
+		if (s->_decoder.getMode() != PMachineDecoder::kModeOff) {
+			const DecodedInstruction &insn = s->_decoder.fetch(scr->getDecodedScript(), scr, s->xs->addr.pc.getOffset());
+			extOpcode = insn.extOpcode;
+			opparams[0] = insn.opparams[0];
+			opparams[1] = insn.opparams[1];
+			opparams[2] = insn.opparams[2];
+			fused = insn.fused;
+			s->xs->addr.pc.incOffset(insn.length);
+		} else {
+			s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		}
 		const byte opcode = extOpcode >> 1;
+		if (s->_decoder.isHistogramEnabled())
+			s->_decoder.countOpcode(opcode);
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
 #ifdef ABORT_ON_INFINITE_LOOP
@@ -1458,6 +1541,67 @@ void run_vm(EngineState *s) {
 		}
 #endif
 		++s->scriptStepCounter;
+
+		// Superinstructions: a push or a conditional branch after a load or
+		// a comparison is executed right away, without going through the
+		// checks at the top of the loop again. The debugger has to see every
+		// instruction, so this is only done while it is not stepping through
+		// the code or waiting for a breakpoint.
+		//
+		// For the push or branch, this skips checking abortScriptProcessing,
+		// calling the console's onFrame(), updating the debugger's old
+		// pc and sp, and checking that the program counter is inside the
+		// script. The first instruction can neither abort the scripts nor
+		// move the program counter, and instructions are only fused when the
+		// one after them is inside the script. The comparisons pop from the
+		// stack, so the stack underflow check is repeated. Verify mode
+		// checks the result against the interpreter loop.
+		if (fused && s->_decoder.isFusionEnabled() &&
+			!g_sci->_debugState.debugging && !g_sci->_debugState._activeBreakpointTypes) {
+#ifndef NDEBUG
+			if (s->xs->sp < s->xs->fp) {
+				error("run_vm(): stack underflow, sp: %04x:%04x, fp: %04x:%04x",
+					  PRINT_REG(*s->xs->sp),
+					  PRINT_REG(*s->xs->fp));
+			}
+#endif
+			const uint32 pcBefore = s->xs->addr.pc.getOffset();
+			const StackPtr spBefore = s->xs->sp;
+			const reg_t accBefore = s->r_acc;
+			const DecodedInstruction &next = s->_decoder.fetch(scr->getDecodedScript(), scr, s->xs->addr.pc.getOffset());
+			const byte nextOpcode = next.extOpcode >> 1;
+			s->xs->addr.pc.incOffset(next.length);
+			if (s->_decoder.isHistogramEnabled())
+				s->_decoder.countOpcode(nextOpcode);
+
+			switch (nextOpcode) {
+			case op_push:
+				PUSH32(s->r_acc);
+				break;
+
+			case op_bt:
+			case op_bnt:
+				if (!(s->r_acc.getOffset() || s->r_acc.getSegment()) == (nextOpcode == op_bnt))
+					s->xs->addr.pc.incOffset(next.opparams[0]);
+
+				if (s->xs->addr.pc.getOffset() >= local_script->getScriptSize())
+					error("[VM] %s: request to jump past the end of script %d (offset %d, script is %d bytes)",
+						nextOpcode == op_bt ? "op_bt" : "op_bnt", local_script->getScriptNumber(),
+						s->xs->addr.pc.getOffset(), local_script->getScriptSize());
+				break;
+
+			default:
+				error("run_vm(): opcode %x cannot be part of a superinstruction", nextOpcode);
+			}
+
+			if (s->_decoder.getMode() == PMachineDecoder::kModeVerify)
+				verifySuperinstruction(s, scr, pcBefore, spBefore, accBefore);
+
+#ifdef ABORT_ON_INFINITE_LOOP
+			prevOpcode = nextOpcode;
+#endif
+			++s->scriptStepCounter;
+		}
 	}
 }
 
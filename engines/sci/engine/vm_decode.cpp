@@ -0,0 +1,161 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "sci/engine/script.h"
+#include "sci/engine/vm.h"
+#include "sci/engine/vm_decode.h"
+
+namespace Sci {
+
+void DecodedScript::clear() {
+	_pages.clear();
+	_slots.clear();
+	_instructions.clear();
+}
+
+uint32 DecodedScript::getMemoryUsage() const {
+	return _pages.size() * sizeof(uint16) + _slots.size() * sizeof(uint16) +
+		_instructions.size() * sizeof(DecodedInstruction);
+}
+
+DecodedInstruction &DecodedScript::add(uint32 offset, uint32 bufSize, const DecodedInstruction &insn) {
+	if (_pages.empty())
+		_pages.resize((bufSize + kPageSize - 1) >> kPageBits);
+
+	uint16 &page = _pages[offset >> kPageBits];
+	if (!page) {
+		for (uint i = 0; i < kPageSize; ++i)
+			_slots.push_back(0);
+		page = _slots.size() >> kPageBits;
+	}
+
+	_instructions.push_back(insn);
+	_slots[(page - 1) * kPageSize + (offset & (kPageSize - 1))] = _instructions.size();
+	return _instructions.back();
+}
+
+PMachineDecoder::PMachineDecoder()
+	: _mode(kModeOff), _fusion(true), _histogram(false), _lastOpcode(0xFF) {
+	memset(_opcodeCounts, 0, sizeof(_opcodeCounts));
+}
+
+void PMachineDecoder::setHistogram(bool histogram) {
+	_histogram = histogram;
+	if (histogram && _pairCounts.empty())
+		_pairCounts.resize(kOpcodeCount * kOpcodeCount);
+	_lastOpcode = 0xFF;
+}
+
+void PMachineDecoder::clearHistogram() {
+	memset(_opcodeCounts, 0, sizeof(_opcodeCounts));
+	for (uint i = 0; i < _pairCounts.size(); ++i)
+		_pairCounts[i] = 0;
+	_lastOpcode = 0xFF;
+}
+
+/**
+ * Whether an instruction leaves the program counter and the execution stack
+ * alone, so that the instruction after it can be executed right away.
+ */
+static bool canStartSuperinstruction(byte opcode) {
+	switch (opcode) {
+	case op_not:
+	case op_eq_:
+	case op_ne_:
+	case op_gt_:
+	case op_ge_:
+	case op_lt_:
+	case op_le_:
+	case op_ugt_:
+	case op_uge_:
+	case op_ult_:
+	case op_ule_:
+	case op_ldi:
+	case op_selfID:
+	case op_pToa:
+	case op_lofsa:
+	case op_lag:
+	case op_lal:
+	case op_lat:
+	case op_lap:
+	case op_lagi:
+	case op_lali:
+	case op_lati:
+	case op_lapi:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void PMachineDecoder::decodeInstruction(const Script *scr, uint32 offset, DecodedInstruction &insn) {
+	int16 opparams[4] = { 0, 0, 0, 0 };
+	insn.length = readPMachineInstruction(scr->getBuf(offset), insn.extOpcode, opparams);
+	insn.opparams[0] = opparams[0];
+	insn.opparams[1] = opparams[1];
+	insn.opparams[2] = opparams[2];
+
+	// Only the first byte of the next instruction is looked at, as the
+	// bytes after the last instruction of a method need not be code. The
+	// branches read up to two more bytes.
+	const uint32 next = offset + insn.length;
+	insn.fused = false;
+	if (canStartSuperinstruction(insn.extOpcode >> 1) && next + 3 <= scr->getBufSize()) {
+		const byte nextOpcode = *scr->getBuf(next) >> 1;
+		insn.fused = nextOpcode == op_push || nextOpcode == op_bt || nextOpcode == op_bnt;
+	}
+}
+
+const DecodedInstruction &PMachineDecoder::decode(DecodedScript &code, const Script *scr, uint32 offset) {
+	if (offset >= scr->getBufSize())
+		error("[VM] Request to execute offset %d past the end of script %d (%d bytes)",
+			offset, scr->getScriptNumber(), scr->getBufSize());
+
+	DecodedInstruction fresh;
+	decodeInstruction(scr, offset, fresh);
+
+	DecodedInstruction *insn = code.find(offset);
+	if (!insn) {
+		_stats.decoded++;
+		if (fresh.fused)
+			_stats.fused++;
+		if (code.size() >= DecodedScript::kMaxInstructions) {
+			_uncached = fresh;
+			return _uncached;
+		}
+		return code.add(offset, scr->getBufSize(), fresh);
+	}
+
+	// Verify mode
+	_stats.verified++;
+	if (fresh.length != insn->length || fresh.extOpcode != insn->extOpcode || fresh.fused != insn->fused ||
+		fresh.opparams[0] != insn->opparams[0] || fresh.opparams[1] != insn->opparams[1] ||
+		fresh.opparams[2] != insn->opparams[2]) {
+		warning("[VM] Decoded instruction %02x at %04x of script %d changed to %02x, the script was modified after it was decoded",
+			insn->extOpcode, offset, scr->getScriptNumber(), fresh.extOpcode);
+		_stats.mismatches++;
+		*insn = fresh;
+	}
+	return *insn;
+}
+
+} // End of namespace Sci
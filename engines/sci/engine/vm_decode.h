@@ -0,0 +1,192 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_VM_DECODE_H
+#define SCI_ENGINE_VM_DECODE_H
+
+#include "common/array.h"
+
+namespace Sci {
+
+class Script;
+
+/**
+ * A P-Machine instruction with its operands read, so that the VM does not
+ * have to look up the operand formats of the opcode and read the operands
+ * every time it is executed.
+ */
+struct DecodedInstruction {
+	uint16 length;		///< length of the instruction in bytes
+	byte extOpcode;		///< the opcode, including the operand size bit
+	/**
+	 * The instruction is followed by a push or a conditional branch, which
+	 * the VM may execute right after it as one superinstruction.
+	 */
+	bool fused;
+	int16 opparams[3];
+};
+
+/**
+ * The decoded instructions of a script. Entries are added the first time the
+ * instruction at an offset is executed, so that data between the code, the
+ * heap of SCI1.1 scripts and code which never runs are not decoded. The
+ * table refers to the bytes of the script after the script patches were
+ * applied, and is dropped by Script::freeScript() whenever the script is
+ * loaded again.
+ *
+ * The instructions are kept packed, in the order they were decoded. They are
+ * found by their offset through pages of 16 bit slot numbers, which only
+ * exist for the parts of the script that contain decoded code.
+ */
+class DecodedScript {
+public:
+	void clear();
+
+	/** Number of decoded instructions. */
+	uint size() const { return _instructions.size(); }
+
+	/** Number of bytes taken by the instructions and the index over them. */
+	uint32 getMemoryUsage() const;
+
+private:
+	friend class PMachineDecoder;
+
+	enum {
+		kPageBits = 6,
+		kPageSize = 1 << kPageBits,
+		/** Instructions beyond this are decoded every time they are executed. */
+		kMaxInstructions = 0xFFFF
+	};
+
+	DecodedInstruction *find(uint32 offset) {
+		const uint32 page = offset >> kPageBits;
+		if (page >= _pages.size() || !_pages[page])
+			return 0;
+		const uint16 slot = _slots[(_pages[page] - 1) * kPageSize + (offset & (kPageSize - 1))];
+		return slot ? &_instructions[slot - 1] : 0;
+	}
+
+	DecodedInstruction &add(uint32 offset, uint32 bufSize, const DecodedInstruction &insn);
+
+	/** For each page of offsets, 1 + its page in _slots, 0 while none of its offsets was decoded. */
+	Common::Array<uint16> _pages;
+	/** For each offset on a page in use, 1 + the index of its instruction, 0 while not decoded. */
+	Common::Array<uint16> _slots;
+	Common::Array<DecodedInstruction> _instructions;
+};
+
+/**
+ * Decodes script code for run_vm() and keeps the opcode statistics of the
+ * debugger.
+ */
+class PMachineDecoder {
+public:
+	enum Mode {
+		kModeOff,		///< read every instruction with readPMachineInstruction()
+		kModeOn,		///< execute decoded instructions
+		/**
+		 * Execute decoded instructions, but read every instruction again with
+		 * readPMachineInstruction() before it is executed and compare the two,
+		 * to find scripts which changed after they were decoded. The second
+		 * instruction of each superinstruction is also checked against the
+		 * program counter and stack the interpreter loop would have left
+		 * when executing it on its own.
+		 */
+		kModeVerify
+	};
+
+	struct Stats {
+		uint32 decoded, fused, verified, mismatches, fusedVerified, fusedMismatches;
+
+		Stats() { reset(); }
+
+		void reset() {
+			decoded = fused = verified = mismatches = fusedVerified = fusedMismatches = 0;
+		}
+	};
+
+	enum {
+		kOpcodeCount = 128
+	};
+
+	PMachineDecoder();
+
+	Mode getMode() const { return _mode; }
+	void setMode(Mode mode) { _mode = mode; }
+
+	bool isFusionEnabled() const { return _fusion; }
+	void setFusion(bool fusion) { _fusion = fusion; }
+
+	/**
+	 * Get the decoded instruction at an offset of a script.
+	 *
+	 * @param code	the decoded instructions of the script
+	 * @return	the instruction, which stays valid until the next instruction
+	 *			of the script is decoded
+	 */
+	const DecodedInstruction &fetch(DecodedScript &code, const Script *scr, uint32 offset) {
+		if (_mode != kModeVerify) {
+			const DecodedInstruction *insn = code.find(offset);
+			if (insn)
+				return *insn;
+		}
+		return decode(code, scr, offset);
+	}
+
+	bool isHistogramEnabled() const { return _histogram; }
+	void setHistogram(bool histogram);
+	void clearHistogram();
+
+	/** Count an executed opcode, and the pair it forms with the one before. */
+	void countOpcode(byte opcode) {
+		_opcodeCounts[opcode]++;
+		if (_lastOpcode < kOpcodeCount)
+			_pairCounts[_lastOpcode * kOpcodeCount + opcode]++;
+		_lastOpcode = opcode;
+	}
+
+	uint32 getOpcodeCount(byte opcode) const { return _opcodeCounts[opcode]; }
+	uint32 getPairCount(byte first, byte second) const {
+		return _pairCounts.empty() ? 0 : _pairCounts[first * kOpcodeCount + second];
+	}
+
+	Stats &getStats() { return _stats; }
+	const Stats &getStats() const { return _stats; }
+
+private:
+	const DecodedInstruction &decode(DecodedScript &code, const Script *scr, uint32 offset);
+	static void decodeInstruction(const Script *scr, uint32 offset, DecodedInstruction &insn);
+
+	Mode _mode;
+	bool _fusion;
+	/** Instruction decoded when the table of its script is full. */
+	DecodedInstruction _uncached;
+	bool _histogram;
+	byte _lastOpcode;
+	uint32 _opcodeCounts[kOpcodeCount];
+	Common::Array<uint32> _pairCounts;
+	Stats _stats;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_VM_DECODE_H
@@ -35,11 +35,13 @@ MODULE_OBJS := \
 	engine/scriptdebug.o \
 	engine/script_patches.o \
 	engine/selector.o \
+	engine/selector_lookup.o \
 	engine/seg_manager.o \
 	engine/segment.o \
 	engine/state.o \
 	engine/static_selectors.o \
 	engine/vm.o \
+	engine/vm_decode.o \
 	engine/vm_types.o \
 	engine/workarounds.o \
 	graphics/animate.o \
@@ -25,6 +25,7 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
@@ -207,6 +208,9 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
+	_lruPrev = nullptr;
+	_lruNext = nullptr;
+	_lruStamp = 0;
 }
 
 Resource::~Resource() {
@@ -971,7 +975,10 @@ void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
-	_LRU.clear();
+	memset(_lru, 0, sizeof(_lru));
+	_lruStamp = 0;
+	_lruStats.reset();
+	_prefetchQueue.clear();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1028,6 +1035,12 @@ void ResourceManager::init() {
 	}
 #endif
 
+	// Each class may use all of the memory, except for audio, which tends to
+	// be large and is rarely played twice in a row.
+	for (int i = 0; i < kLRUClassCount; i++)
+		_lru[i].budget = _maxMemoryLRU;
+	_lru[kLRUAudio].budget = _maxMemoryLRU / 2;
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -1069,12 +1082,63 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+ResourceManager::LRUClass ResourceManager::getLRUClass(ResourceType type) {
+	switch (type) {
+	case kResourceTypeView:
+	case kResourceTypeFont:
+	case kResourceTypeCursor:
+	case kResourceTypePalette:
+		return kLRUViews;
+	case kResourceTypePic:
+		return kLRUPics;
+	case kResourceTypeSound:
+	case kResourceTypePatch:
+	case kResourceTypeAudio:
+	case kResourceTypeSync:
+	case kResourceTypeAudio36:
+	case kResourceTypeSync36:
+	case kResourceTypeRave:
+		return kLRUAudio;
+	case kResourceTypeScript:
+	case kResourceTypeHeap:
+	case kResourceTypeText:
+	case kResourceTypeMessage:
+	case kResourceTypeVocab:
+		return kLRUScripts;
+	default:
+		return kLRUOther;
+	}
+}
+
+const char *ResourceManager::getLRUClassName(LRUClass lruClass) {
+	static const char *const names[kLRUClassCount] = {
+		"views", "pics", "audio", "scripts", "other"
+	};
+	return names[lruClass];
+}
+
+void ResourceManager::setBudgetLRU(LRUClass lruClass, int budget) {
+	_lru[lruClass].budget = budget;
+	freeOldResources();
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+	LRUList &list = _lru[getLRUClass(res->getType())];
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		list.first = res->_lruNext;
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		list.last = res->_lruPrev;
+	res->_lruPrev = res->_lruNext = nullptr;
+	list.count--;
+	list.memory -= res->size();
 	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
@@ -1084,7 +1148,17 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
+	LRUList &list = _lru[getLRUClass(res->getType())];
+	res->_lruPrev = nullptr;
+	res->_lruNext = list.first;
+	if (list.first)
+		list.first->_lruPrev = res;
+	else
+		list.last = res;
+	list.first = res;
+	list.count++;
+	list.memory += res->size();
+	res->_lruStamp = ++_lruStamp;
 	_memoryLRU += res->size();
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
@@ -1094,32 +1168,88 @@ void ResourceManager::addToLRU(Resource *res) {
 	res->_status = kResStatusEnqueued;
 }
 
+void ResourceManager::evictFromLRU(Resource *res) {
+	_lruStats.evictions++;
+	_lruStats.evictedBytes += res->size();
+	removeFromLRU(res);
+	res->unalloc();
+#ifdef SCI_VERBOSE_RESMAN
+	debug("resMan-debug: LRU: Freeing %s (%d bytes)", res->_id.toString().c_str(), res->size);
+#endif
+}
+
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
-
-	while (it != _LRU.end()) {
-		res = *it;
-		debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
-		mem += res->size();
-		++entries;
-		++it;
+
+	for (int i = 0; i < kLRUClassCount; i++) {
+		for (Resource *res = _lru[i].first; res; res = res->_lruNext) {
+			debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
+			mem += res->size();
+			++entries;
+		}
 	}
 
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
 }
 
 void ResourceManager::freeOldResources() {
+	for (int i = 0; i < kLRUClassCount; i++) {
+		while (_lru[i].last && _lru[i].budget < _lru[i].memory)
+			evictFromLRU(_lru[i].last);
+	}
+
 	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
-		removeFromLRU(goner);
-		goner->unalloc();
-#ifdef SCI_VERBOSE_RESMAN
-		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
-#endif
+		// The least recently used resource of all classes
+		Resource *goner = nullptr;
+		for (int i = 0; i < kLRUClassCount; i++) {
+			Resource *last = _lru[i].last;
+			if (last && (!goner || (int32)(last->_lruStamp - goner->_lruStamp) < 0))
+				goner = last;
+		}
+		assert(goner);
+		evictFromLRU(goner);
+	}
+}
+
+void ResourceManager::queuePrefetch(ResourceId id) {
+	Resource *res = testResource(id);
+	if (!res || res->_status != kResStatusNoMalloc)
+		return;
+
+	for (Common::List<ResourceId>::const_iterator it = _prefetchQueue.begin(); it != _prefetchQueue.end(); ++it) {
+		if (*it == id)
+			return;
+	}
+	_prefetchQueue.push_back(id);
+}
+
+void ResourceManager::prefetchRoom(uint16 roomNumber) {
+	queuePrefetch(ResourceId(kResourceTypeScript, roomNumber));
+	queuePrefetch(ResourceId(kResourceTypeHeap, roomNumber));
+	queuePrefetch(ResourceId(kResourceTypePic, roomNumber));
+}
+
+void ResourceManager::prefetch(uint32 deadline) {
+	while (!_prefetchQueue.empty() && (int32)(g_system->getMillis() - deadline) < 0) {
+		Resource *res = testResource(_prefetchQueue.front());
+		_prefetchQueue.pop_front();
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		loadResource(res);
+		if (res->_status != kResStatusAllocated)
+			continue;
+
+		// The size of a resource is only known once it was read, and a
+		// resource read ahead of time must not push out one in use.
+		const LRUList &list = _lru[getLRUClass(res->getType())];
+		if (list.memory + (int)res->size() > list.budget || _memoryLRU + (int)res->size() > _maxMemoryLRU) {
+			res->unalloc();
+			continue;
+		}
+		addToLRU(res);
+		_lruStats.prefetches++;
 	}
 }
 
@@ -1148,9 +1278,14 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		_lruStats.misses++;
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
+	} else {
+		_lruStats.hits++;
+	}
+
+	if (retval->_status == kResStatusEnqueued)
 		// The resource is removed from its current position
 		// in the LRU list because it has been requested
 		// again. Below, it will either be locked, or it
@@ -302,6 +302,9 @@ protected:
 	uint16 _lockers; /**< Number of places where this resource was locked */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
+	Resource *_lruPrev; /**< The more recently used resource in the LRU list, while enqueued */
+	Resource *_lruNext; /**< The less recently used resource in the LRU list, while enqueued */
+	uint32 _lruStamp; /**< When the resource was enqueued, to compare LRU lists */
 
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
@@ -384,6 +387,73 @@ public:
 	 */
 	Resource *testResource(ResourceId id);
 
+	/**
+	 * The unlocked resources are kept in separate LRU lists for the kinds of
+	 * resources, so that each kind can be given a budget of its own. For
+	 * example, a few large audio resources should not push all the views of
+	 * a room out of memory.
+	 */
+	enum LRUClass {
+		kLRUViews,		///< views, fonts, cursors and palettes
+		kLRUPics,
+		kLRUAudio,		///< sounds, digital audio and lip sync data
+		kLRUScripts,	///< scripts, heaps, texts, messages and vocabularies
+		kLRUOther,
+		kLRUClassCount
+	};
+
+	struct LRUStats {
+		uint32 hits;		///< resources found in memory
+		uint32 misses;		///< resources which had to be read
+		uint32 evictions;
+		uint32 evictedBytes;
+		uint32 prefetches;	///< resources read ahead of time
+
+		LRUStats() { reset(); }
+
+		void reset() {
+			hits = misses = evictions = evictedBytes = prefetches = 0;
+		}
+	};
+
+	static LRUClass getLRUClass(ResourceType type);
+	static const char *getLRUClassName(LRUClass lruClass);
+
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMemoryLocked() const { return _memoryLocked; }
+	int getMemoryLRU(LRUClass lruClass) const { return _lru[lruClass].memory; }
+	uint getCountLRU(LRUClass lruClass) const { return _lru[lruClass].count; }
+
+	/**
+	 * Gets the number of bytes the unlocked resources of a class may use.
+	 * Resources of all classes together are also limited by the total budget.
+	 */
+	int getBudgetLRU(LRUClass lruClass) const { return _lru[lruClass].budget; }
+	void setBudgetLRU(LRUClass lruClass, int budget);
+
+	LRUStats &getLRUStats() { return _lruStats; }
+
+	/**
+	 * Queues a resource to be read while the engine waits, so that it is
+	 * already in memory when it is needed.
+	 */
+	void queuePrefetch(ResourceId id);
+
+	/**
+	 * Queues the resources a room is known to use: its script and its
+	 * picture, which share the number of the room.
+	 */
+	void prefetchRoom(uint16 roomNumber);
+
+	/**
+	 * Reads queued resources until the given time. Resources are only kept
+	 * if they fit into the budgets without evicting anything.
+	 *
+	 * @param deadline	the time to stop at, as returned by OSystem::getMillis()
+	 */
+	void prefetch(uint32 deadline);
+
 	/**
 	 * Returns a list of all resources of the specified type.
 	 * @param type		The resource type to look for
@@ -483,7 +553,19 @@ protected:
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+
+	struct LRUList {
+		Resource *first;	///< the most recently used resource
+		Resource *last;		///< the least recently used resource
+		uint count;
+		int memory;
+		int budget;
+	};
+
+	LRUList _lru[kLRUClassCount]; ///< Last Resource Used lists
+	uint32 _lruStamp;
+	LRUStats _lruStats;
+	Common::List<ResourceId> _prefetchQueue;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -618,6 +700,7 @@ protected:
 	void printLRU();
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
+	void evictFromLRU(Resource *res);
 
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
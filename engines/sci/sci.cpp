@@ -314,6 +314,13 @@ Common::Error SciEngine::run() {
 	_vocabulary = hasParser() ? new Vocabulary(_resMan, false) : NULL;
 
 	_gamestate = new EngineState(segMan);
+	if (ConfMan.hasKey("script_decode")) {
+		const Common::String decode = ConfMan.get("script_decode");
+		if (decode == "on")
+			_gamestate->_decoder.setMode(PMachineDecoder::kModeOn);
+		else if (decode == "verify")
+			_gamestate->_decoder.setMode(PMachineDecoder::kModeVerify);
+	}
 	_guestAdditions = new GuestAdditions(_gamestate, _features, _kernel);
 	_eventMan = new EventManager(_resMan->detectFontExtended());
 #ifdef ENABLE_SCI32
@@ -844,6 +851,9 @@ void SciEngine::sleep(uint32 msecs) {
 			g_sci->_gfxFrameout->updateScreen();
 		}
 #endif
+		// Use the time to read the resources the game will need next
+		_resMan->prefetch(wakeUpTime);
+
 		time = g_system->getMillis();
 		if (time + 10 < wakeUpTime) {
 			g_system->delayMillis(10);
@@ -3330,7 +3330,7 @@ void ScummEngine_v71he::postProcessAuxQueue() {
 						int y1 = (int16)READ_LE_UINT16(axur + 2) + dy;
 						int x2 = (int16)READ_LE_UINT16(axur + 4) + dx;
 						int y2 = (int16)READ_LE_UINT16(axur + 6) + dy;
-						markRectAsDirty(kMainVirtScreen, x1, x2, y1, y2 + 1);
+						markRectAsDirty(kMainVirtScreen, x1, x2, y1, y2 + 1, 0, kDamageActor);
 						axur += 8;
 					}
 				}
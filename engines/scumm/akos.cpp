@@ -24,6 +24,7 @@
 #include "scumm/actor.h"
 #include "scumm/akos.h"
 #include "scumm/bomp.h"
+#include "scumm/costume-codec1.h"
 #include "scumm/imuse/imuse.h"
 #include "scumm/imuse_digi/dimuse.h"
 #include "scumm/he/intern_he.h"
@@ -673,106 +674,6 @@ const byte smallCostumeScaleTableAKOS[256] = {
 	0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE,
 	0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE
 };
-const byte bigCostumeScaleTable[768] = {
-	0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0,
-	0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0,
-	0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8,
-	0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8,
-	0x04, 0x84, 0x44, 0xC4, 0x24, 0xA4, 0x64, 0xE4,
-	0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4,
-	0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC,
-	0x1C, 0x9C, 0x5C, 0xDC, 0x3C, 0xBC, 0x7C, 0xFC,
-	0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2,
-	0x12, 0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2,
-	0x0A, 0x8A, 0x4A, 0xCA, 0x2A, 0xAA, 0x6A, 0xEA,
-	0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA,
-	0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6,
-	0x16, 0x96, 0x56, 0xD6, 0x36, 0xB6, 0x76, 0xF6,
-	0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE,
-	0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE,
-	0x01, 0x81, 0x41, 0xC1, 0x21, 0xA1, 0x61, 0xE1,
-	0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1,
-	0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9,
-	0x19, 0x99, 0x59, 0xD9, 0x39, 0xB9, 0x79, 0xF9,
-	0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5,
-	0x15, 0x95, 0x55, 0xD5, 0x35, 0xB5, 0x75, 0xF5,
-	0x0D, 0x8D, 0x4D, 0xCD, 0x2D, 0xAD, 0x6D, 0xED,
-	0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD, 0x7D, 0xFD,
-	0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3,
-	0x13, 0x93, 0x53, 0xD3, 0x33, 0xB3, 0x73, 0xF3,
-	0x0B, 0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB,
-	0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB,
-	0x07, 0x87, 0x47, 0xC7, 0x27, 0xA7, 0x67, 0xE7,
-	0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7,
-	0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F, 0xEF,
-	0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFE,
-
-	0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0,
-	0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0,
-	0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8,
-	0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8,
-	0x04, 0x84, 0x44, 0xC4, 0x24, 0xA4, 0x64, 0xE4,
-	0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4,
-	0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC,
-	0x1C, 0x9C, 0x5C, 0xDC, 0x3C, 0xBC, 0x7C, 0xFC,
-	0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2,
-	0x12, 0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2,
-	0x0A, 0x8A, 0x4A, 0xCA, 0x2A, 0xAA, 0x6A, 0xEA,
-	0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA,
-	0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6,
-	0x16, 0x96, 0x56, 0xD6, 0x36, 0xB6, 0x76, 0xF6,
-	0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE,
-	0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE,
-	0x01, 0x81, 0x41, 0xC1, 0x21, 0xA1, 0x61, 0xE1,
-	0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1,
-	0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9,
-	0x19, 0x99, 0x59, 0xD9, 0x39, 0xB9, 0x79, 0xF9,
-	0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5,
-	0x15, 0x95, 0x55, 0xD5, 0x35, 0xB5, 0x75, 0xF5,
-	0x0D, 0x8D, 0x4D, 0xCD, 0x2D, 0xAD, 0x6D, 0xED,
-	0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD, 0x7D, 0xFD,
-	0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3,
-	0x13, 0x93, 0x53, 0xD3, 0x33, 0xB3, 0x73, 0xF3,
-	0x0B, 0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB,
-	0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB,
-	0x07, 0x87, 0x47, 0xC7, 0x27, 0xA7, 0x67, 0xE7,
-	0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7,
-	0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F, 0xEF,
-	0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFE,
-
-	0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0,
-	0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0,
-	0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8,
-	0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8,
-	0x04, 0x84, 0x44, 0xC4, 0x24, 0xA4, 0x64, 0xE4,
-	0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4,
-	0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC,
-	0x1C, 0x9C, 0x5C, 0xDC, 0x3C, 0xBC, 0x7C, 0xFC,
-	0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2,
-	0x12, 0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2,
-	0x0A, 0x8A, 0x4A, 0xCA, 0x2A, 0xAA, 0x6A, 0xEA,
-	0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA,
-	0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6,
-	0x16, 0x96, 0x56, 0xD6, 0x36, 0xB6, 0x76, 0xF6,
-	0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE,
-	0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE,
-	0x01, 0x81, 0x41, 0xC1, 0x21, 0xA1, 0x61, 0xE1,
-	0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1,
-	0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9,
-	0x19, 0x99, 0x59, 0xD9, 0x39, 0xB9, 0x79, 0xF9,
-	0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5,
-	0x15, 0x95, 0x55, 0xD5, 0x35, 0xB5, 0x75, 0xF5,
-	0x0D, 0x8D, 0x4D, 0xCD, 0x2D, 0xAD, 0x6D, 0xED,
-	0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD, 0x7D, 0xFD,
-	0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3,
-	0x13, 0x93, 0x53, 0xD3, 0x33, 0xB3, 0x73, 0xF3,
-	0x0B, 0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB,
-	0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB,
-	0x07, 0x87, 0x47, 0xC7, 0x27, 0xA7, 0x67, 0xE7,
-	0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7,
-	0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F, 0xEF,
-	0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFF,
-};
 
 byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 	int num_colors;
@@ -996,7 +897,27 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 
 	v1.destptr = (byte *)_out.getBasePtr(v1.x, v1.y);
 
-	codec1_genericDecode(v1);
+	// Shadow modes 2 and 3, 16 bit graphics and hit tests are rare enough
+	// to be left to the generic decoder.
+	if (_actorHitMode || _vm->_bytesPerPixel != 1 || _shadow_mode == 2 || _shadow_mode == 3) {
+		codec1_genericDecode(v1);
+	} else {
+		Codec1Context ctx;
+		ctx.src = _srcptr;
+		ctx.height = _height;
+		ctx.pitch = _out.pitch;
+		ctx.numStrips = _numStrips;
+		ctx.scaleX = _scaleX;
+		ctx.scaleY = _scaleY;
+		ctx.palette = _palette;
+		ctx.shadowTable = _shadow_table;
+
+		v1.mask_ptr = _vm->getMaskBuffer(0, v1.y, _zbuf);
+
+		const Codec1Shadow shadow = (_shadow_mode == 1) ? kCodec1ShadowColor13 : kCodec1ShadowNone;
+		Codec1Decoder decode = getCodec1Decoder(kCodec1Akos, use_scaling, v1.scaleXstep > 0, !isCodec1MaskClear(v1, ctx), shadow);
+		decode(v1, ctx);
+	}
 
 	return drawFlag;
 }
@@ -1004,7 +925,7 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 void AkosRenderer::markRectAsDirty(Common::Rect rect) {
 	rect.left -= _vm->_virtscr[kMainVirtScreen].xstart & 7;
 	rect.right -= _vm->_virtscr[kMainVirtScreen].xstart & 7;
-	_vm->markRectAsDirty(kMainVirtScreen, rect, _actorID);
+	_vm->markRectAsDirty(kMainVirtScreen, rect, _actorID, kDamageActor);
 }
 
 byte AkosRenderer::codec5(int xmoveCur, int ymoveCur) {
@@ -1157,10 +1078,17 @@ void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, in
 		tmp_buf += (t_width - 1);
 	}
 
-	akos16SetupBitReader(src);
+	// Cels drawn before are copied from the cache instead of decoded.
+	const byte *cel = getAkos16Cel(src);
+
+	if (cel) {
+		cel += numskip_before;
+	} else {
+		akos16SetupBitReader(src);
 
-	if (numskip_before != 0) {
-		akos16SkipData(numskip_before);
+		if (numskip_before != 0) {
+			akos16SkipData(numskip_before);
+		}
 	}
 
 	maskpitch = _numStrips;
@@ -1170,12 +1098,22 @@ void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, in
 	assert(t_height > 0);
 	assert(t_width > 0);
 	while (t_height--) {
-		akos16DecodeLine(tmp_buf, t_width, dir);
+		if (cel) {
+			if (dir > 0) {
+				memcpy(tmp_buf, cel, t_width);
+			} else {
+				for (int32 i = 0; i < t_width; i++)
+					tmp_buf[-i] = cel[i];
+			}
+			cel += t_width + numskip_after;
+		} else {
+			akos16DecodeLine(tmp_buf, t_width, dir);
+		}
 		bompApplyMask(_akos16.buffer, maskptr, maskbit, t_width, transparency);
 		bool HE7Check = (_vm->_game.heversion == 70);
 		bompApplyShadow(_shadow_mode, _shadow_table, _akos16.buffer, dest, t_width, transparency, HE7Check);
 
-		if (numskip_after != 0)	{
+		if (!cel && numskip_after != 0)	{
 			akos16SkipData(numskip_after);
 		}
 		dest += pitch;
@@ -1183,6 +1121,28 @@ void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, in
 	}
 }
 
+const byte *AkosRenderer::getAkos16Cel(const byte *src) {
+	StripCache &cache = _vm->_celCache;
+	const byte *data;
+
+	if (!cache.isEnabled() || _width <= 0 || _height <= 0)
+		return 0;
+
+	// The same data could in theory be used for cels of different sizes.
+	if (cache.lookup(StripCache::kAkos16Cel, src, 0, _height, data) && data && READ_UINT16(data) == _width)
+		return data + kCelHeaderSize;
+
+	const uint32 size = _width * _height;
+	byte *cel = cache.insert(StripCache::kAkos16Cel, src, 0, _height, kCelHeaderSize + size);
+	if (!cel)
+		return 0;
+
+	WRITE_UINT16(cel, _width);
+	akos16SetupBitReader(src);
+	akos16DecodeLine(cel + kCelHeaderSize, size, 1);
+	return cel + kCelHeaderSize;
+}
+
 byte AkosRenderer::codec16(int xmoveCur, int ymoveCur) {
 	assert(_vm->_bytesPerPixel == 1);
 
@@ -1359,7 +1319,17 @@ byte AkosRenderer::codec32(int xmoveCur, int ymoveCur) {
 	}
 
 	byte *dstPtr = (byte *)_out.getBasePtr(dst.left, dst.top);
-	if (_shadow_mode == 3) {
+	const byte *cel = (_shadow_mode == 3) ? 0 : getAkos32Cel();
+	if (cel) {
+		// Drawn before, copy the cel from the cache.
+		const int transColor = cel[-kCelHeaderSize + 2];
+		cel += src.top * _width + src.left;
+		if (palPtr != NULL) {
+			Wiz::decompressRawWizImage<kWizRMap>(dstPtr, _out.pitch, kDstScreen, cel, _width, src.width(), src.height(), transColor, palPtr, _vm->_bytesPerPixel);
+		} else {
+			Wiz::decompressRawWizImage<kWizCopy>(dstPtr, _out.pitch, kDstScreen, cel, _width, src.width(), src.height(), transColor, NULL, _vm->_bytesPerPixel);
+		}
+	} else if (_shadow_mode == 3) {
 		Wiz::decompressWizImage<kWizXMap>(dstPtr, _out.pitch, kDstScreen, _srcptr, src, 0, palPtr, xmap, _vm->_bytesPerPixel);
 	} else {
 		if (palPtr != NULL) {
@@ -1372,6 +1342,61 @@ byte AkosRenderer::codec32(int xmoveCur, int ymoveCur) {
 	return 0;
 }
 
+#ifdef ENABLE_HE
+const byte *AkosRenderer::getAkos32Cel() {
+	StripCache &cache = _vm->_celCache;
+	const byte *data;
+
+	if (!cache.isEnabled() || _width <= 0 || _height <= 0)
+		return 0;
+
+	if (cache.lookup(StripCache::kAkos32Cel, _srcptr, 0, _height, data) && (!data || READ_UINT16(data) == _width))
+		return data ? data + kCelHeaderSize : 0;
+
+	// Decode the cel twice, onto a background of 0 and one of 255, to find
+	// the transparent pixels. They are set to a color the cel does not use.
+	const uint32 size = _width * _height;
+	const Common::Rect rect(_width, _height);
+	byte *clear0 = new byte[size];
+	byte *clear255 = new byte[size];
+	memset(clear0, 0, size);
+	memset(clear255, 255, size);
+	Wiz::decompressWizImage<kWizCopy>(clear0, _width, kDstMemory, _srcptr, rect, 0, NULL, NULL, 1);
+	Wiz::decompressWizImage<kWizCopy>(clear255, _width, kDstMemory, _srcptr, rect, 0, NULL, NULL, 1);
+
+	bool used[256];
+	memset(used, 0, sizeof(used));
+	for (uint32 i = 0; i < size; i++) {
+		if (clear0[i] == clear255[i])
+			used[clear0[i]] = true;
+	}
+
+	int transColor = 0;
+	while (transColor < 256 && used[transColor])
+		transColor++;
+
+	byte *cel = 0;
+	if (transColor == 256) {
+		// Remember that the cel cannot be cached.
+		cache.insert(StripCache::kAkos32Cel, _srcptr, 0, _height, 0);
+	} else {
+		cel = cache.insert(StripCache::kAkos32Cel, _srcptr, 0, _height, kCelHeaderSize + size);
+		if (cel) {
+			WRITE_UINT16(cel, _width);
+			cel[2] = transColor;
+			cel[3] = 0;
+			cel += kCelHeaderSize;
+			for (uint32 i = 0; i < size; i++)
+				cel[i] = (clear0[i] == clear255[i]) ? clear0[i] : transColor;
+		}
+	}
+
+	delete[] clear0;
+	delete[] clear255;
+	return cel;
+}
+#endif
+
 byte AkosCostumeLoader::increaseAnims(Actor *a) {
 	return ((ScummEngine_v6 *)_vm)->akos_increaseAnims(_akos, a);
 }
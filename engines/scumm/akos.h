@@ -121,6 +121,21 @@ protected:
 	void akos16DecodeLine(byte *buf, int32 numbytes, int32 dir);
 	void akos16Decompress(byte *dest, int32 pitch, const byte *src, int32 t_width, int32 t_height, int32 dir, int32 numskip_before, int32 numskip_after, byte transparency, int maskLeft, int maskTop, int zBuf);
 
+	enum {
+		/** Cached cels start with their width and, for codec 32, the transparent color. */
+		kCelHeaderSize = 4
+	};
+
+	/**
+	 * Return the cel decoded into _width x _height color indices, taken
+	 * from the cel cache if it was drawn before. Returns 0 if the cel
+	 * cannot be cached.
+	 */
+	const byte *getAkos16Cel(const byte *src);
+#ifdef ENABLE_HE
+	const byte *getAkos32Cel();
+#endif
+
 	void markRectAsDirty(Common::Rect rect);
 };
 
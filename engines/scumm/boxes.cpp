@@ -87,6 +87,7 @@ struct Box {				/* Internal walkbox file format */
 
 
 static void getGates(const BoxCoords &box1, const BoxCoords &box2, Common::Point gateA[2], Common::Point gateB[2]);
+static bool areBoxCoordsNeighbors(BoxCoords box2, BoxCoords box);
 
 static bool compareSlope(const Common::Point &p1, const Common::Point &p2, const Common::Point &p3) {
 	return (p2.y - p1.y) * (p3.x - p1.x) <= (p3.y - p1.y) * (p2.x - p1.x);
@@ -793,18 +794,14 @@ int ScummEngine::getNextBox(byte from, byte to) {
 	return dest;
 }
 
-/*
- * Computes the next point actor a has to walk towards in a straight
- * line in order to get from box1 to box3 via box2.
+/**
+ * Find the sides along which two boxes touch. Only sides on a common vertical
+ * or horizontal line are considered.
  */
-bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point &foundPath) {
-	assert(_vm->_game.version >= 3);
-	BoxCoords box1 = _vm->getBoxCoordinates(box1nr);
-	BoxCoords box2 = _vm->getBoxCoordinates(box2nr);
+static void findBoxSide(BoxCoords box1, BoxCoords box2, BoxSide &side) {
 	Common::Point tmp;
 	int i, j;
 	int flag;
-	int q, pos;
 
 	for (i = 0; i < 4; i++) {
 		for (j = 0; j < 4; j++) {
@@ -828,38 +825,13 @@ bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point
 					if (flag & 2)
 						SWAP(box2.ul.y, box2.ur.y);
 				} else {
-					pos = _pos.y;
-					if (box2nr == box3nr) {
-						int diffX = _walkdata.dest.x - _pos.x;
-						int diffY = _walkdata.dest.y - _pos.y;
-						int boxDiffX = box1.ul.x - _pos.x;
-
-						if (diffX != 0) {
-							int t;
-
-							diffY *= boxDiffX;
-							t = diffY / diffX;
-							if (t == 0 && (diffY <= 0 || diffX <= 0)
-									&& (diffY >= 0 || diffX >= 0))
-								t = -1;
-							pos = _pos.y + t;
-						}
-					}
-
-					q = pos;
-					if (q < box2.ul.y)
-						q = box2.ul.y;
-					if (q > box2.ur.y)
-						q = box2.ur.y;
-					if (q < box1.ul.y)
-						q = box1.ul.y;
-					if (q > box1.ur.y)
-						q = box1.ur.y;
-					if (q == pos && box2nr == box3nr)
-						return true;
-					foundPath.y = q;
-					foundPath.x = box1.ul.x;
-					return false;
+					side.type = BoxSide::kVertical;
+					side.line = box1.ul.x;
+					side.min1 = box1.ul.y;
+					side.max1 = box1.ur.y;
+					side.min2 = box2.ul.y;
+					side.max2 = box2.ur.y;
+					return;
 				}
 			}
 
@@ -883,34 +855,13 @@ bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point
 					if (flag & 2)
 						SWAP(box2.ul.x, box2.ur.x);
 				} else {
-
-					if (box2nr == box3nr) {
-						int diffX = _walkdata.dest.x - _pos.x;
-						int diffY = _walkdata.dest.y - _pos.y;
-						int boxDiffY = box1.ul.y - _pos.y;
-
-						pos = _pos.x;
-						if (diffY != 0) {
-							pos += diffX * boxDiffY / diffY;
-						}
-					} else {
-						pos = _pos.x;
-					}
-
-					q = pos;
-					if (q < box2.ul.x)
-						q = box2.ul.x;
-					if (q > box2.ur.x)
-						q = box2.ur.x;
-					if (q < box1.ul.x)
-						q = box1.ul.x;
-					if (q > box1.ur.x)
-						q = box1.ur.x;
-					if (q == pos && box2nr == box3nr)
-						return true;
-					foundPath.x = q;
-					foundPath.y = box1.ul.y;
-					return false;
+					side.type = BoxSide::kHorizontal;
+					side.line = box1.ul.y;
+					side.min1 = box1.ul.x;
+					side.max1 = box1.ur.x;
+					side.min2 = box2.ul.x;
+					side.max2 = box2.ur.x;
+					return;
 				}
 			}
 			tmp = box1.ul;
@@ -925,6 +876,91 @@ bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point
 		box2.lr = box2.ll;
 		box2.ll = tmp;
 	}
+
+	side.type = BoxSide::kNone;
+}
+
+/*
+ * Computes the next point actor a has to walk towards in a straight
+ * line in order to get from box1 to box3 via box2.
+ */
+bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point &foundPath) {
+	assert(_vm->_game.version >= 3);
+	BoxSide side;
+	int q, pos;
+
+	// The sides only depend on the boxes, so they are only searched for
+	// once per room.
+	if (!_vm->_boxGates.lookupSide(box1nr, box2nr, side)) {
+		findBoxSide(_vm->getBoxCoordinates(box1nr), _vm->getBoxCoordinates(box2nr), side);
+		_vm->_boxGates.storeSide(box1nr, box2nr, side);
+	}
+
+	if (side.type == BoxSide::kVertical) {
+		pos = _pos.y;
+		if (box2nr == box3nr) {
+			int diffX = _walkdata.dest.x - _pos.x;
+			int diffY = _walkdata.dest.y - _pos.y;
+			int boxDiffX = side.line - _pos.x;
+
+			if (diffX != 0) {
+				int t;
+
+				diffY *= boxDiffX;
+				t = diffY / diffX;
+				if (t == 0 && (diffY <= 0 || diffX <= 0)
+						&& (diffY >= 0 || diffX >= 0))
+					t = -1;
+				pos = _pos.y + t;
+			}
+		}
+
+		q = pos;
+		if (q < side.min2)
+			q = side.min2;
+		if (q > side.max2)
+			q = side.max2;
+		if (q < side.min1)
+			q = side.min1;
+		if (q > side.max1)
+			q = side.max1;
+		if (q == pos && box2nr == box3nr)
+			return true;
+		foundPath.y = q;
+		foundPath.x = side.line;
+		return false;
+	}
+
+	if (side.type == BoxSide::kHorizontal) {
+		if (box2nr == box3nr) {
+			int diffX = _walkdata.dest.x - _pos.x;
+			int diffY = _walkdata.dest.y - _pos.y;
+			int boxDiffY = side.line - _pos.y;
+
+			pos = _pos.x;
+			if (diffY != 0) {
+				pos += diffX * boxDiffY / diffY;
+			}
+		} else {
+			pos = _pos.x;
+		}
+
+		q = pos;
+		if (q < side.min2)
+			q = side.min2;
+		if (q > side.max2)
+			q = side.max2;
+		if (q < side.min1)
+			q = side.min1;
+		if (q > side.max1)
+			q = side.max1;
+		if (q == pos && box2nr == box3nr)
+			return true;
+		foundPath.x = q;
+		foundPath.y = side.line;
+		return false;
+	}
+
 	return false;
 }
 
@@ -942,7 +978,7 @@ static void printMatrix(byte *boxm, int num) {
 	}
 }
 
-static void printMatrix2(byte *matrix, int num) {
+static void printMatrix2(const byte *matrix, int num) {
 	int i, j;
 	debug("    ");
 	for (i = 0; i < num; i++)
@@ -1019,6 +1055,38 @@ void ScummEngine::calcItineraryMatrix(byte *itineraryMatrix, int num) {
 	free(adjacentMatrix);
 }
 
+/**
+ * Brings the routes of the walkbox router up to date. The passages between
+ * the boxes are only looked for once per room, after that only the boxes
+ * which were hidden or shown since the last call are taken into account.
+ */
+void ScummEngine::updateBoxRoutes(int num) {
+	if (!_boxRouter.hasLinks() || _boxRouter.getNumBoxes() != num) {
+		BoxCoords boxes[WalkboxRouter::kMaxBoxes];
+		WalkboxRouter::BoxSet links[WalkboxRouter::kMaxBoxes];
+		int i, j;
+
+		for (i = 0; i < num; i++)
+			boxes[i] = getBoxCoordinates(i);
+
+		for (i = 0; i < num; i++) {
+			links[i] = 0;
+			for (j = 0; j < num; j++) {
+				if (i != j && areBoxCoordsNeighbors(boxes[i], boxes[j]))
+					links[i] |= (WalkboxRouter::BoxSet)1 << j;
+			}
+		}
+		_boxRouter.setLinks(num, links);
+	}
+
+	WalkboxRouter::BoxSet hidden = 0;
+	for (int i = 0; i < num; i++) {
+		if (getBoxFlags(i) & kBoxInvisible)
+			hidden |= (WalkboxRouter::BoxSet)1 << i;
+	}
+	_boxRouter.update(hidden);
+}
+
 void ScummEngine::createBoxMatrix() {
 	int num, i, j;
 
@@ -1028,8 +1096,16 @@ void ScummEngine::createBoxMatrix() {
 	const uint8 boxSize = (_game.version == 0) ? num : 64;
 
 	// calculate shortest paths
-	byte *itineraryMatrix = (byte *)malloc(boxSize * boxSize);
-	calcItineraryMatrix(itineraryMatrix, num);
+	byte *itineraryMatrix = 0;
+	const byte *itinerary;
+	if (_game.version >= 3 && num <= WalkboxRouter::kMaxBoxes) {
+		updateBoxRoutes(num);
+		itinerary = _boxRouter.getItinerary();
+	} else {
+		itineraryMatrix = (byte *)malloc(boxSize * boxSize);
+		calcItineraryMatrix(itineraryMatrix, num);
+		itinerary = itineraryMatrix;
+	}
 
 	// "Compress" the distance matrix into the box matrix format used
 	// by the engine. The format is like this:
@@ -1051,13 +1127,13 @@ void ScummEngine::createBoxMatrix() {
 	for (i = 0; i < num; i++) {
 		addToMatrix(0xFF);
 		for (j = 0; j < num; j++) {
-			byte itinerary = itineraryMatrix[boxSize * i + j];
-			if (itinerary != Actor::kInvalidBox) {
+			byte nextBox = itinerary[boxSize * i + j];
+			if (nextBox != Actor::kInvalidBox) {
 				addToMatrix(j);
-				while (j < num - 1 && itinerary == itineraryMatrix[boxSize * i + (j + 1)])
+				while (j < num - 1 && nextBox == itinerary[boxSize * i + (j + 1)])
 					j++;
 				addToMatrix(j);
-				addToMatrix(itinerary);
+				addToMatrix(nextBox);
 			}
 		}
 	}
@@ -1066,7 +1142,7 @@ void ScummEngine::createBoxMatrix() {
 
 #if BOX_DEBUG
 	debug("Itinerary matrix:\n");
-	printMatrix2(itineraryMatrix, num);
+	printMatrix2(itinerary, num);
 	debug("compressed matrix:\n");
 	printMatrix(getBoxMatrixBaseAddr(), num);
 #endif
@@ -1076,16 +1152,19 @@ void ScummEngine::createBoxMatrix() {
 
 /** Check if two boxes are neighbors. */
 bool ScummEngine::areBoxesNeighbors(int box1nr, int box2nr) {
-	Common::Point tmp;
-	BoxCoords box;
-	BoxCoords box2;
-
 	if ((getBoxFlags(box1nr) & kBoxInvisible) || (getBoxFlags(box2nr) & kBoxInvisible))
 		return false;
 
 	assert(_game.version >= 3);
-	box2 = getBoxCoordinates(box1nr);
-	box = getBoxCoordinates(box2nr);
+	return areBoxCoordsNeighbors(getBoxCoordinates(box1nr), getBoxCoordinates(box2nr));
+}
+
+/**
+ * Check if two boxes touch, given their coordinates. Unlike areBoxesNeighbors,
+ * this does not look at the box flags.
+ */
+static bool areBoxCoordsNeighbors(BoxCoords box2, BoxCoords box) {
+	Common::Point tmp;
 
 	// Roughly, the idea of this algorithm is to search for sies of the given
 	// boxes that touch each other.
@@ -1246,7 +1325,10 @@ void Actor_v3::findPathTowardsOld(byte box1, byte box2, byte finalBox, Common::P
 	Common::Point gateA[2];
 	Common::Point gateB[2];
 
-	getGates(_vm->getBoxCoordinates(box1), _vm->getBoxCoordinates(box2), gateA, gateB);
+	if (!_vm->_boxGates.lookupGates(box1, box2, gateA, gateB)) {
+		getGates(_vm->getBoxCoordinates(box1), _vm->getBoxCoordinates(box2), gateA, gateB);
+		_vm->_boxGates.storeGates(box1, box2, gateA, gateB);
+	}
 
 	p2.x = 32000;
 	p3.x = 32000;
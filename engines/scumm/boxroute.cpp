@@ -0,0 +1,242 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/boxroute.h"
+
+namespace Scumm {
+
+static inline WalkboxRouter::BoxSet boxBit(int box) {
+	return (WalkboxRouter::BoxSet)1 << box;
+}
+
+WalkboxRouter::WalkboxRouter() {
+	invalidate();
+	resetStats();
+}
+
+void WalkboxRouter::invalidate() {
+	_num = -1;
+	_routesValid = false;
+	_hidden = 0;
+}
+
+void WalkboxRouter::setLinks(int num, const BoxSet *links) {
+	assert(num >= 0 && num <= kMaxBoxes);
+
+	_num = num;
+	_routesValid = false;
+	for (int i = 0; i < num; i++) {
+		_links[i] = links[i] & ~boxBit(i);
+		_touching[i] = _links[i];
+	}
+	for (int i = 0; i < num; i++) {
+		for (int j = 0; j < num; j++) {
+			if (_links[i] & boxBit(j))
+				_touching[j] |= boxBit(i);
+		}
+	}
+}
+
+uint WalkboxRouter::update(BoxSet hidden) {
+	assert(hasLinks());
+
+	const BoxSet all = (_num == kMaxBoxes) ? ~(BoxSet)0 : boxBit(_num) - 1;
+	hidden &= all;
+
+	BoxSet rows;
+	if (!_routesValid) {
+		rows = all;
+		_stats.builds++;
+	} else {
+		const BoxSet changed = hidden ^ _hidden;
+		if (!changed) {
+			_stats.unchanged++;
+			_stats.rowsReused += _num;
+			return 0;
+		}
+
+		// Every passage which appears or disappears has a changed box at one
+		// end, so the routes of all boxes which are not connected to a
+		// changed box or its neighbors, before or after the change, stay
+		// the same.
+		BoxSet seeds = changed;
+		for (int i = 0; i < _num; i++) {
+			if (changed & boxBit(i))
+				seeds |= _touching[i];
+		}
+		rows = getReachable(seeds, _hidden) | getReachable(seeds, hidden);
+		_stats.updates++;
+	}
+
+	computeRows(rows, hidden);
+	_hidden = hidden;
+	_routesValid = true;
+
+	uint count = 0;
+	for (int i = 0; i < _num; i++) {
+		if (rows & boxBit(i))
+			count++;
+	}
+	_stats.rowsComputed += count;
+	_stats.rowsReused += _num - count;
+	return count;
+}
+
+WalkboxRouter::BoxSet WalkboxRouter::getReachable(BoxSet from, BoxSet hidden) const {
+	BoxSet reached = from;
+	BoxSet pending = from & ~hidden;
+
+	while (pending) {
+		int box = 0;
+		while (!(pending & boxBit(box)))
+			box++;
+		pending &= ~boxBit(box);
+
+		const BoxSet found = _touching[box] & ~hidden & ~reached;
+		reached |= found;
+		pending |= found;
+	}
+
+	return reached;
+}
+
+void WalkboxRouter::computeRows(BoxSet rows, BoxSet hidden) {
+	byte boxes[kMaxBoxes];
+	int count = 0;
+
+	for (int i = 0; i < _num; i++) {
+		if (!(rows & boxBit(i)))
+			continue;
+		boxes[count++] = i;
+
+		byte *dist = _dist + i * kMaxBoxes;
+		byte *next = _next + i * kMaxBoxes;
+		const BoxSet links = (hidden & boxBit(i)) ? 0 : (_links[i] & ~hidden);
+		for (int j = 0; j < _num; j++) {
+			if (i == j) {
+				dist[j] = 0;
+				next[j] = j;
+			} else if (links & boxBit(j)) {
+				dist[j] = 1;
+				next[j] = j;
+			} else {
+				dist[j] = 255;
+				next[j] = kNoRoute;
+			}
+		}
+	}
+
+	// The boxes outside of the rows are not connected to those inside, so
+	// they can neither be a stop on the way nor a destination.
+	for (int k = 0; k < count; k++) {
+		const byte *distK = _dist + boxes[k] * kMaxBoxes;
+		for (int i = 0; i < count; i++) {
+			byte *distI = _dist + boxes[i] * kMaxBoxes;
+			byte *nextI = _next + boxes[i] * kMaxBoxes;
+			const byte distIK = distI[boxes[k]];
+			if (distIK == 255)
+				continue;
+			for (int j = 0; j < count; j++) {
+				const int to = boxes[j];
+				if (i == j)
+					continue;
+				if (distI[to] > distIK + distK[to]) {
+					distI[to] = distIK + distK[to];
+					nextI[to] = nextI[boxes[k]];
+				}
+			}
+		}
+	}
+}
+
+void WalkboxRouter::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+BoxGateCache::BoxGateCache() {
+	invalidate();
+	resetStats();
+}
+
+void BoxGateCache::invalidate() {
+	memset(_valid, 0, sizeof(_valid));
+}
+
+bool BoxGateCache::lookupSide(int box1, int box2, BoxSide &side) {
+	if (!isCacheable(box1, box2))
+		return false;
+
+	const int idx = box1 * kMaxBoxes + box2;
+	if (!(_valid[idx] & kSideValid)) {
+		_stats.misses++;
+		return false;
+	}
+
+	side = _sides[idx];
+	_stats.hits++;
+	return true;
+}
+
+void BoxGateCache::storeSide(int box1, int box2, const BoxSide &side) {
+	if (!isCacheable(box1, box2))
+		return;
+
+	const int idx = box1 * kMaxBoxes + box2;
+	_sides[idx] = side;
+	_valid[idx] |= kSideValid;
+}
+
+bool BoxGateCache::lookupGates(int box1, int box2, Common::Point gateA[2], Common::Point gateB[2]) {
+	if (!isCacheable(box1, box2))
+		return false;
+
+	const int idx = box1 * kMaxBoxes + box2;
+	if (!(_valid[idx] & kGatesValid)) {
+		_stats.misses++;
+		return false;
+	}
+
+	gateA[0] = _gates[idx][0];
+	gateA[1] = _gates[idx][1];
+	gateB[0] = _gates[idx][2];
+	gateB[1] = _gates[idx][3];
+	_stats.hits++;
+	return true;
+}
+
+void BoxGateCache::storeGates(int box1, int box2, const Common::Point gateA[2], const Common::Point gateB[2]) {
+	if (!isCacheable(box1, box2))
+		return;
+
+	const int idx = box1 * kMaxBoxes + box2;
+	_gates[idx][0] = gateA[0];
+	_gates[idx][1] = gateA[1];
+	_gates[idx][2] = gateB[0];
+	_gates[idx][3] = gateB[1];
+	_valid[idx] |= kGatesValid;
+}
+
+void BoxGateCache::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+} // End of namespace Scumm
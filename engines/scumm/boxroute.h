@@ -0,0 +1,175 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_BOXROUTE_H
+#define SCUMM_BOXROUTE_H
+
+#include "common/rect.h"
+
+namespace Scumm {
+
+/**
+ * Shortest routes between the walkboxes of a room, as used for the
+ * itinerary matrix of SCUMM v3 and later.
+ *
+ * The router is told once per room which boxes touch each other. After
+ * that, only the set of invisible boxes changes, whenever a script calls
+ * createBoxMatrix after changing box flags. Showing or hiding a box can only
+ * affect routes starting in the part of the room which is connected to it,
+ * so only those rows of the matrix are computed again.
+ *
+ * Rows are computed with the same Floyd-Warshall loop the engine always
+ * used, restricted to the affected boxes. Since a row only depends on the
+ * boxes reachable from it, the result, including the choice between routes
+ * of the same length, is identical to computing the whole matrix.
+ */
+class WalkboxRouter {
+public:
+	enum {
+		kMaxBoxes = 64,
+		/** Marks a box which cannot be reached, the same as Actor::kInvalidBox. */
+		kNoRoute = 255
+	};
+
+	typedef uint64 BoxSet;
+
+	struct Stats {
+		uint32 builds;		///< number of matrices computed from scratch
+		uint32 updates;		///< number of incremental updates
+		uint32 unchanged;	///< updates where no box changed its visibility
+		uint32 rowsComputed;
+		uint32 rowsReused;
+	};
+
+	WalkboxRouter();
+
+	/** Forget the boxes of the current room. */
+	void invalidate();
+	bool hasLinks() const { return _num >= 0; }
+
+	/**
+	 * Set which boxes touch each other, regardless of their flags.
+	 *
+	 * @param num	the number of boxes, at most kMaxBoxes
+	 * @param links	for each box, the set of boxes it has a passage to
+	 */
+	void setLinks(int num, const BoxSet *links);
+	int getNumBoxes() const { return _num; }
+
+	/**
+	 * Bring the routes up to date for the given set of invisible boxes.
+	 *
+	 * @return	the number of rows which had to be computed
+	 */
+	uint update(BoxSet hidden);
+
+	/** The next box on the way from one box to another, or kNoRoute. */
+	byte getNextBox(int from, int to) const { return _next[from * kMaxBoxes + to]; }
+
+	/** The itinerary matrix, with rows of kMaxBoxes entries. */
+	const byte *getItinerary() const { return _next; }
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
+private:
+	BoxSet getReachable(BoxSet from, BoxSet hidden) const;
+	void computeRows(BoxSet rows, BoxSet hidden);
+
+	int _num;
+	bool _routesValid;
+	BoxSet _hidden;
+	BoxSet _links[kMaxBoxes];
+	/** Boxes touching each box, in either direction. */
+	BoxSet _touching[kMaxBoxes];
+	byte _dist[kMaxBoxes * kMaxBoxes];
+	byte _next[kMaxBoxes * kMaxBoxes];
+	Stats _stats;
+};
+
+/**
+ * Where two walkboxes touch, as found by Actor::findPathTowards. The side is
+ * a segment of a vertical or horizontal line, the ranges are those of the
+ * matching sides of both boxes.
+ */
+struct BoxSide {
+	enum {
+		kNone,
+		kVertical,
+		kHorizontal
+	};
+
+	byte type;
+	int16 line;		///< x of a vertical, y of a horizontal side
+	int16 min1, max1;
+	int16 min2, max2;
+};
+
+/**
+ * The geometry of the passages between pairs of walkboxes. It only depends
+ * on the box coordinates, so it is kept until the boxes of the room are
+ * replaced.
+ */
+class BoxGateCache {
+public:
+	enum {
+		kMaxBoxes = WalkboxRouter::kMaxBoxes
+	};
+
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+	};
+
+	BoxGateCache();
+
+	void invalidate();
+
+	bool lookupSide(int box1, int box2, BoxSide &side);
+	void storeSide(int box1, int box2, const BoxSide &side);
+
+	/** The gates computed for Actor_v3::findPathTowardsOld. */
+	bool lookupGates(int box1, int box2, Common::Point gateA[2], Common::Point gateB[2]);
+	void storeGates(int box1, int box2, const Common::Point gateA[2], const Common::Point gateB[2]);
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
+private:
+	enum {
+		kSideValid = 1 << 0,
+		kGatesValid = 1 << 1
+	};
+
+	static bool isCacheable(int box1, int box2) {
+		return box1 >= 0 && box1 < kMaxBoxes && box2 >= 0 && box2 < kMaxBoxes;
+	}
+
+	byte _valid[kMaxBoxes * kMaxBoxes];
+	BoxSide _sides[kMaxBoxes * kMaxBoxes];
+	Common::Point _gates[kMaxBoxes * kMaxBoxes][4];
+	Stats _stats;
+};
+
+} // End of namespace Scumm
+
+#endif
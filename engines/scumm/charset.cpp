@@ -649,7 +649,7 @@ void CharsetRendererV3::printChar(int chr, bool ignoreCharsetMask) {
 
 	int drawTop = _top - vs->topline;
 
-	_vm->markRectAsDirty(vs->number, _left, _left + width, drawTop, drawTop + height);
+	_vm->markRectAsDirty(vs->number, _left, _left + width, drawTop, drawTop + height, 0, kDamageCharset);
 
 	if (!ignoreCharsetMask) {
 		_hasMask = true;
@@ -772,7 +772,7 @@ void CharsetRendererClassic::printChar(int chr, bool ignoreCharsetMask) {
 
 	int drawTop = _top - vs->topline;
 
-	_vm->markRectAsDirty(vs->number, _left, _left + _width, drawTop, drawTop + _height);
+	_vm->markRectAsDirty(vs->number, _left, _left + _width, drawTop, drawTop + _height, 0, kDamageCharset);
 
 	// This check for kPlatformFMTowns and kMainVirtScreen is at least required for the chat with
 	// the navigator's head in front of the ghost ship in Monkey Island 1
@@ -1299,7 +1299,7 @@ void CharsetRendererNut::printChar(int chr, bool ignoreCharsetMask) {
 		_current->draw2byte(s, chr, _left, drawTop, _color);
 	else
 		_current->drawChar(s, (byte)chr, _left, drawTop, _color);
-	_vm->markRectAsDirty(kMainVirtScreen, shadow);
+	_vm->markRectAsDirty(kMainVirtScreen, shadow, 0, kDamageCharset);
 
 	if (_str.left > _left)
 		_str.left = _left;
@@ -1354,7 +1354,7 @@ void CharsetRendererNES::printChar(int chr, bool ignoreCharsetMask) {
 
 	int drawTop = _top - vs->topline;
 
-	_vm->markRectAsDirty(vs->number, _left, _left + width, drawTop, drawTop + height);
+	_vm->markRectAsDirty(vs->number, _left, _left + width, drawTop, drawTop + height, 0, kDamageCharset);
 
 	if (!ignoreCharsetMask) {
 		_hasMask = true;
@@ -0,0 +1,196 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/compose16.h"
+#include "scumm/gfx.h"
+
+#include "common/endian.h"
+
+#ifdef SCUMM_COMPOSE16_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef SCUMM_COMPOSE16_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Scumm {
+
+/**
+ * Compose count pixels one at a time.
+ */
+static inline bool composeRun(byte *dst, const byte *src, const byte *text, const uint16 *palette, int count) {
+	bool drawn = false;
+
+	for (int i = 0; i < count; ++i) {
+		if (text[i] == CHARSET_MASK_TRANSPARENCY) {
+			WRITE_UINT16(dst, READ_UINT16(src));
+		} else {
+			WRITE_UINT16(dst, palette[text[i]]);
+			drawn = true;
+		}
+		src += 2;
+		dst += 2;
+	}
+
+	return drawn;
+}
+
+bool composeText16Scalar(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                         const uint16 *palette, int width, int height) {
+	bool drawn = false;
+
+	for (int h = 0; h < height; ++h) {
+		drawn |= composeRun(dst, src, text, palette, width);
+		src += srcPitch;
+		text += textPitch;
+		dst += width * 2;
+	}
+
+	return drawn;
+}
+
+bool composeText16Generic(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                          const uint16 *palette, int width, int height) {
+	const uint64 transparent = ((uint64)CHARSET_MASK_TRANSPARENCY_32 << 32) | CHARSET_MASK_TRANSPARENCY_32;
+	bool drawn = false;
+
+	for (int h = 0; h < height; ++h) {
+		int w = 0;
+		for (; w + 8 <= width; w += 8) {
+			if (READ_UINT64(text + w) == transparent) {
+				WRITE_UINT64(dst + w * 2, READ_UINT64(src + w * 2));
+				WRITE_UINT64(dst + w * 2 + 8, READ_UINT64(src + w * 2 + 8));
+			} else {
+				drawn |= composeRun(dst + w * 2, src + w * 2, text + w, palette, 8);
+			}
+		}
+		drawn |= composeRun(dst + w * 2, src + w * 2, text + w, palette, width - w);
+
+		src += srcPitch;
+		text += textPitch;
+		dst += width * 2;
+	}
+
+	return drawn;
+}
+
+#ifdef SCUMM_COMPOSE16_SSE2
+bool composeText16SSE2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                       const uint16 *palette, int width, int height) {
+	const __m128i transparent = _mm_set1_epi8((char)CHARSET_MASK_TRANSPARENCY);
+	bool drawn = false;
+
+	for (int h = 0; h < height; ++h) {
+		int w = 0;
+		for (; w + 16 <= width; w += 16) {
+			const __m128i t = _mm_loadu_si128((const __m128i *)(text + w));
+			const __m128i isTransparent = _mm_cmpeq_epi8(t, transparent);
+			const __m128i src0 = _mm_loadu_si128((const __m128i *)(src + w * 2));
+			const __m128i src1 = _mm_loadu_si128((const __m128i *)(src + w * 2 + 16));
+
+			if (_mm_movemask_epi8(isTransparent) == 0xFFFF) {
+				_mm_storeu_si128((__m128i *)(dst + w * 2), src0);
+				_mm_storeu_si128((__m128i *)(dst + w * 2 + 16), src1);
+				continue;
+			}
+
+			// There is no gather, so the text colors are looked up one by
+			// one and merged with the graphics using the widened mask.
+			uint16 colors[16];
+			for (int i = 0; i < 16; ++i)
+				colors[i] = palette[text[w + i]];
+
+			const __m128i mask0 = _mm_unpacklo_epi8(isTransparent, isTransparent);
+			const __m128i mask1 = _mm_unpackhi_epi8(isTransparent, isTransparent);
+			const __m128i colors0 = _mm_loadu_si128((const __m128i *)colors);
+			const __m128i colors1 = _mm_loadu_si128((const __m128i *)(colors + 8));
+			_mm_storeu_si128((__m128i *)(dst + w * 2), _mm_or_si128(_mm_and_si128(mask0, src0), _mm_andnot_si128(mask0, colors0)));
+			_mm_storeu_si128((__m128i *)(dst + w * 2 + 16), _mm_or_si128(_mm_and_si128(mask1, src1), _mm_andnot_si128(mask1, colors1)));
+			drawn = true;
+		}
+		drawn |= composeRun(dst + w * 2, src + w * 2, text + w, palette, width - w);
+
+		src += srcPitch;
+		text += textPitch;
+		dst += width * 2;
+	}
+
+	return drawn;
+}
+#endif
+
+#ifdef SCUMM_COMPOSE16_NEON
+bool composeText16NEON(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                       const uint16 *palette, int width, int height) {
+	const uint8x16_t transparent = vdupq_n_u8(CHARSET_MASK_TRANSPARENCY);
+	bool drawn = false;
+
+	for (int h = 0; h < height; ++h) {
+		int w = 0;
+		for (; w + 16 <= width; w += 16) {
+			const uint8x16_t isTransparent = vceqq_u8(vld1q_u8(text + w), transparent);
+			const uint64x2_t all = vreinterpretq_u64_u8(isTransparent);
+			const uint16x8_t src0 = vreinterpretq_u16_u8(vld1q_u8(src + w * 2));
+			const uint16x8_t src1 = vreinterpretq_u16_u8(vld1q_u8(src + w * 2 + 16));
+
+			if ((vgetq_lane_u64(all, 0) & vgetq_lane_u64(all, 1)) == 0xFFFFFFFFFFFFFFFFULL) {
+				vst1q_u8(dst + w * 2, vreinterpretq_u8_u16(src0));
+				vst1q_u8(dst + w * 2 + 16, vreinterpretq_u8_u16(src1));
+				continue;
+			}
+
+			uint16 colors[16];
+			for (int i = 0; i < 16; ++i)
+				colors[i] = palette[text[w + i]];
+
+			// Sign extension widens each 0x00/0xFF byte of the mask to a
+			// 16 bit mask.
+			const int8x16_t mask8 = vreinterpretq_s8_u8(isTransparent);
+			const uint16x8_t mask0 = vreinterpretq_u16_s16(vmovl_s8(vget_low_s8(mask8)));
+			const uint16x8_t mask1 = vreinterpretq_u16_s16(vmovl_s8(vget_high_s8(mask8)));
+			vst1q_u8(dst + w * 2, vreinterpretq_u8_u16(vbslq_u16(mask0, src0, vld1q_u16(colors))));
+			vst1q_u8(dst + w * 2 + 16, vreinterpretq_u8_u16(vbslq_u16(mask1, src1, vld1q_u16(colors + 8))));
+			drawn = true;
+		}
+		drawn |= composeRun(dst + w * 2, src + w * 2, text + w, palette, width - w);
+
+		src += srcPitch;
+		text += textPitch;
+		dst += width * 2;
+	}
+
+	return drawn;
+}
+#endif
+
+TextCompositor16 getTextCompositor16() {
+#if defined(SCUMM_COMPOSE16_SSE2)
+	return composeText16SSE2;
+#elif defined(SCUMM_COMPOSE16_NEON)
+	return composeText16NEON;
+#else
+	return composeText16Generic;
+#endif
+}
+
+} // End of namespace Scumm
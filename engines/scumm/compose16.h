@@ -0,0 +1,84 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_COMPOSE16_H
+#define SCUMM_COMPOSE16_H
+
+#include "common/scummsys.h"
+
+#if defined(__SSE2__)
+#define SCUMM_COMPOSE16_SSE2
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SCUMM_COMPOSE16_NEON
+#endif
+
+namespace Scumm {
+
+/**
+ * Composes a rectangle of the 8 bit text surface over 16 bit graphics.
+ * Text pixels with the value CHARSET_MASK_TRANSPARENCY let the graphics
+ * show through, all others are converted through the palette.
+ *
+ * @param dst			receives the result, width pixels per line without gaps
+ * @param src			the 16 bit graphics
+ * @param srcPitch		distance in bytes between two lines of src
+ * @param text			the text pixels, one byte each
+ * @param textPitch		distance in bytes between two lines of text
+ * @param palette		the 16 bit colors of the text pixels
+ * @param width			the width in pixels
+ * @param height		the height in lines
+ * @return	true if any text pixel was drawn
+ */
+typedef bool (*TextCompositor16)(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                                 const uint16 *palette, int width, int height);
+
+/** Reference implementation, one pixel at a time. */
+bool composeText16Scalar(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                         const uint16 *palette, int width, int height);
+
+/**
+ * Checks eight text pixels at a time and copies the graphics below fully
+ * transparent groups in 64 bit words.
+ */
+bool composeText16Generic(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                          const uint16 *palette, int width, int height);
+
+#ifdef SCUMM_COMPOSE16_SSE2
+bool composeText16SSE2(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                       const uint16 *palette, int width, int height);
+#endif
+
+#ifdef SCUMM_COMPOSE16_NEON
+bool composeText16NEON(byte *dst, const byte *src, int srcPitch, const byte *text, int textPitch,
+                       const uint16 *palette, int width, int height);
+#endif
+
+/**
+ * Return the fastest compositor available in this build.
+ */
+TextCompositor16 getTextCompositor16();
+
+} // End of namespace Scumm
+
+#endif
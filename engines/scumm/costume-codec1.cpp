@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/costume-codec1.h"
+#include "scumm/util.h"
+
+namespace Scumm {
+
+typedef BaseCostumeRenderer::Codec1 Codec1;
+
+template<Codec1Shadow shadow>
+static inline byte shadePixel(uint color, byte background, const Codec1Context &ctx) {
+	if (shadow == kCodec1ShadowAll)
+		return ctx.shadowTable[background];
+
+	const uint pcolor = ctx.palette[color];
+	if (shadow == kCodec1ShadowColor13 && pcolor == 13)
+		return ctx.shadowTable[background];
+	return pcolor;
+}
+
+template<Codec1Flavor flavor, bool scaled, bool mirrored, bool masked, Codec1Shadow shadow>
+static void decodeCodec1(Codec1 &v1, const Codec1Context &ctx) {
+	const int step = mirrored ? 1 : -1;
+	const int top = v1.boundsRect.top;
+	const int bottom = v1.boundsRect.bottom;
+	const byte *src = ctx.src;
+	const byte *mask = 0;
+	byte *dst = v1.destptr;
+	byte len = v1.replen;
+	byte maskbit = revBitMask(v1.x & 7);
+	uint color = v1.repcolor;
+	uint height = ctx.height;
+	uint scaleIndexY = v1.scaleYindex;
+	int y = v1.y;
+	bool visible = (v1.x >= 0 && v1.x < v1.boundsRect.right);
+	bool skipColumn = false;
+
+	assert(v1.scaleXstep == step);
+
+	if (masked)
+		mask = v1.mask_ptr + v1.x / 8;
+
+	if (len)
+		goto StartPos;
+
+	do {
+		len = *src++;
+		color = len >> v1.shr;
+		len &= v1.mask;
+		if (!len)
+			len = *src++;
+
+		do {
+			// The classic costumes wrap around in their 256 byte scale table
+			if (!scaled || ctx.scaleY == 255 || v1.scaletable[flavor == kCodec1Classic ? (byte)scaleIndexY++ : scaleIndexY++] < ctx.scaleY) {
+				if (color && visible && y >= top && y < bottom && !(scaled && skipColumn) && !(masked && (*mask & maskbit)))
+					*dst = shadePixel<shadow>(color, *dst, ctx);
+				dst += ctx.pitch;
+				if (masked)
+					mask += ctx.numStrips;
+				y++;
+			}
+			if (!--height) {
+				if (!--v1.skip_width)
+					return;
+				height = ctx.height;
+				y = v1.y;
+				scaleIndexY = v1.scaleYindex;
+
+				if (!scaled || ctx.scaleX == 255 || v1.scaletable[flavor == kCodec1Classic ? (byte)v1.scaleXindex : v1.scaleXindex] < ctx.scaleX) {
+					v1.x += step;
+					if (v1.x < 0 || v1.x >= v1.boundsRect.right)
+						return;
+					maskbit = revBitMask(v1.x & 7);
+					v1.destptr += step;
+					visible = true;
+					skipColumn = false;
+				} else if (flavor == kCodec1Akos) {
+					skipColumn = true;
+				}
+				v1.scaleXindex += step;
+				dst = v1.destptr;
+				if (masked)
+					mask = v1.mask_ptr + v1.x / 8;
+			}
+		StartPos:;
+		} while (--len);
+	} while (1);
+}
+
+template<Codec1Flavor flavor, bool scaled, bool mirrored, bool masked>
+static Codec1Decoder selectShadow(Codec1Shadow shadow) {
+	switch (shadow) {
+	case kCodec1ShadowColor13:
+		return &decodeCodec1<flavor, scaled, mirrored, masked, kCodec1ShadowColor13>;
+	case kCodec1ShadowAll:
+		return &decodeCodec1<flavor, scaled, mirrored, masked, kCodec1ShadowAll>;
+	default:
+		return &decodeCodec1<flavor, scaled, mirrored, masked, kCodec1ShadowNone>;
+	}
+}
+
+template<Codec1Flavor flavor>
+static Codec1Decoder selectDecoder(bool scaled, bool mirrored, bool masked, Codec1Shadow shadow) {
+	if (scaled) {
+		if (mirrored)
+			return masked ? selectShadow<flavor, true, true, true>(shadow) : selectShadow<flavor, true, true, false>(shadow);
+		return masked ? selectShadow<flavor, true, false, true>(shadow) : selectShadow<flavor, true, false, false>(shadow);
+	}
+	if (mirrored)
+		return masked ? selectShadow<flavor, false, true, true>(shadow) : selectShadow<flavor, false, true, false>(shadow);
+	return masked ? selectShadow<flavor, false, false, true>(shadow) : selectShadow<flavor, false, false, false>(shadow);
+}
+
+Codec1Decoder getCodec1Decoder(Codec1Flavor flavor, bool scaled, bool mirrored, bool masked, Codec1Shadow shadow) {
+	if (flavor == kCodec1Akos)
+		return selectDecoder<kCodec1Akos>(scaled, mirrored, masked, shadow);
+	return selectDecoder<kCodec1Classic>(scaled, mirrored, masked, shadow);
+}
+
+bool isCodec1MaskClear(const Codec1 &v1, const Codec1Context &ctx) {
+	if (!v1.mask_ptr)
+		return true;
+
+	// Every column is at most ctx.height pixels high, and there are at
+	// most v1.skip_width of them.
+	int left = v1.x, right = v1.x;
+	if (v1.scaleXstep > 0)
+		right += v1.skip_width;
+	else
+		left -= v1.skip_width;
+	left = MAX(left, 0);
+	right = MIN<int>(right, v1.boundsRect.right - 1);
+
+	const int firstRow = MAX<int>(v1.y, v1.boundsRect.top);
+	const int lastRow = MIN<int>(v1.y + ctx.height, v1.boundsRect.bottom);
+	if (left > right || firstRow >= lastRow)
+		return true;
+
+	const byte *mask = v1.mask_ptr + (firstRow - v1.y) * ctx.numStrips;
+	for (int row = firstRow; row < lastRow; ++row, mask += ctx.numStrips) {
+		for (int strip = left / 8; strip <= right / 8; ++strip) {
+			if (mask[strip])
+				return false;
+		}
+	}
+	return true;
+}
+
+} // End of namespace Scumm
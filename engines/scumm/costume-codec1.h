@@ -0,0 +1,92 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_COSTUME_CODEC1_H
+#define SCUMM_COSTUME_CODEC1_H
+
+#include "scumm/base-costume.h"
+
+namespace Scumm {
+
+/**
+ * Decoders for the RLE cels of classic costumes and of AKOS codec 1, drawn
+ * to an 8 bit surface.
+ *
+ * The per pixel loop of these is the hottest part of actor drawing, so
+ * there is one decoder for each combination of scaling, mirroring, masking
+ * and shadow mode. The renderers select one per limb.
+ */
+enum Codec1Flavor {
+	/** ClassicCostumeRenderer::proc3, which redraws a column not advanced to by the scaling. */
+	kCodec1Classic,
+	/** AkosRenderer::codec1, which skips such columns instead. */
+	kCodec1Akos
+};
+
+enum Codec1Shadow {
+	kCodec1ShadowNone,
+	/** Pixels of palette color 13 darken the background with the shadow table. */
+	kCodec1ShadowColor13,
+	/** All pixels darken the background (shadow mode 0x20 of classic costumes). */
+	kCodec1ShadowAll
+};
+
+/** The renderer state the decoders need besides the Codec1 parameters. */
+struct Codec1Context {
+	const byte *src;
+	int height;
+	int pitch;
+	/** The pitch of the mask buffer. */
+	int32 numStrips;
+	byte scaleX, scaleY;
+	const uint16 *palette;
+	const byte *shadowTable;
+};
+
+/**
+ * Decode a cel starting at v1.destptr. The decoders clip to the top,
+ * bottom and right edge of v1.boundsRect and to the left edge of the
+ * surface.
+ *
+ * The decoders use v1.scaleXindex and v1.scaleYindex as scale table
+ * indices, v1.mask_ptr has to point to the mask of the first row at x = 0.
+ */
+typedef void (*Codec1Decoder)(BaseCostumeRenderer::Codec1 &v1, const Codec1Context &ctx);
+
+/**
+ * Return the decoder for a limb.
+ *
+ * @param scaled	whether scaleX or scaleY is not 255
+ * @param mirrored	whether v1.scaleXstep is 1 rather than -1
+ * @param masked	whether the mask has to be checked for every pixel
+ */
+Codec1Decoder getCodec1Decoder(Codec1Flavor flavor, bool scaled, bool mirrored, bool masked, Codec1Shadow shadow);
+
+/**
+ * Return whether the mask is clear at all pixels a decoder could draw to,
+ * in which case the decoder need not check it.
+ */
+bool isCodec1MaskClear(const BaseCostumeRenderer::Codec1 &v1, const Codec1Context &ctx);
+
+} // End of namespace Scumm
+
+#endif
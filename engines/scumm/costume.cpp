@@ -24,6 +24,7 @@
 #include "scumm/scumm.h"
 #include "scumm/actor.h"
 #include "scumm/costume.h"
+#include "scumm/costume-codec1.h"
 #include "scumm/sound.h"
 #include "scumm/util.h"
 
@@ -222,9 +223,9 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 
 	if (_vm->_game.version == 1)
 		// V1 games uses 8 x 8 pixels for actors
-		_vm->markRectAsDirty(kMainVirtScreen, rect.left, rect.right + 8, rect.top, rect.bottom, _actorID);
+		_vm->markRectAsDirty(kMainVirtScreen, rect.left, rect.right + 8, rect.top, rect.bottom, _actorID, kDamageActor);
 	else
-		_vm->markRectAsDirty(kMainVirtScreen, rect.left, rect.right + 1, rect.top, rect.bottom, _actorID);
+		_vm->markRectAsDirty(kMainVirtScreen, rect.left, rect.right + 1, rect.top, rect.bottom, _actorID, kDamageActor);
 
 	if (rect.top >= _out.h || rect.bottom <= 0)
 		return 0;
@@ -431,14 +432,6 @@ extern "C" int ClassicProc3RendererShadowARM(int _scaleY,
 #endif
 
 void ClassicCostumeRenderer::proc3(Codec1 &v1) {
-	const byte *mask, *src;
-	byte *dst;
-	byte len, maskbit;
-	int y;
-	uint color, height, pcolor;
-	byte scaleIndexY;
-	bool masked;
-
 #ifdef USE_ARM_COSTUME_ASM
 	if (((_shadow_mode & 0x20) == 0) &&
 	    (v1.mask_ptr != NULL) &&
@@ -459,67 +452,31 @@ void ClassicCostumeRenderer::proc3(Codec1 &v1) {
 	}
 #endif /* USE_ARM_COSTUME_ASM */
 
-	y = v1.y;
-	src = _srcptr;
-	dst = v1.destptr;
-	len = v1.replen;
-	color = v1.repcolor;
-	height = _height;
-
-	scaleIndexY = _scaleIndexY;
-	maskbit = revBitMask(v1.x & 7);
-	mask = v1.mask_ptr + v1.x / 8;
-
-	if (len)
-		goto StartPos;
-
-	do {
-		len = *src++;
-		color = len >> v1.shr;
-		len &= v1.mask;
-		if (!len)
-			len = *src++;
-
-		do {
-			if (_scaleY == 255 || v1.scaletable[scaleIndexY++] < _scaleY) {
-				masked = (y < 0 || y >= _out.h) || (v1.x < 0 || v1.x >= _out.w) || (v1.mask_ptr && (mask[0] & maskbit));
-
-				if (color && !masked) {
-					if (_shadow_mode & 0x20) {
-						pcolor = _shadow_table[*dst];
-					} else {
-						pcolor = _palette[color];
-						if (pcolor == 13 && _shadow_table)
-							pcolor = _shadow_table[*dst];
-					}
-					*dst = pcolor;
-				}
-				dst += _out.pitch;
-				mask += _numStrips;
-				y++;
-			}
-			if (!--height) {
-				if (!--v1.skip_width)
-					return;
-				height = _height;
-				y = v1.y;
-
-				scaleIndexY = _scaleIndexY;
-
-				if (_scaleX == 255 || v1.scaletable[_scaleIndexX] < _scaleX) {
-					v1.x += v1.scaleXstep;
-					if (v1.x < 0 || v1.x >= _out.w)
-						return;
-					maskbit = revBitMask(v1.x & 7);
-					v1.destptr += v1.scaleXstep;
-				}
-				_scaleIndexX += v1.scaleXstep;
-				dst = v1.destptr;
-				mask = v1.mask_ptr + v1.x / 8;
-			}
-		StartPos:;
-		} while (--len);
-	} while (1);
+	Codec1Context ctx;
+	ctx.src = _srcptr;
+	ctx.height = _height;
+	ctx.pitch = _out.pitch;
+	ctx.numStrips = _numStrips;
+	ctx.scaleX = _scaleX;
+	ctx.scaleY = _scaleY;
+	ctx.palette = _palette;
+	ctx.shadowTable = _shadow_table;
+
+	v1.boundsRect = Common::Rect(_out.w, _out.h);
+	v1.scaleXindex = _scaleIndexX;
+	v1.scaleYindex = _scaleIndexY;
+
+	Codec1Shadow shadow = kCodec1ShadowNone;
+	if (_shadow_mode & 0x20)
+		shadow = kCodec1ShadowAll;
+	else if (_shadow_table)
+		shadow = kCodec1ShadowColor13;
+
+	const bool scaled = (_scaleX != 255 || _scaleY != 255);
+	Codec1Decoder decode = getCodec1Decoder(kCodec1Classic, scaled, v1.scaleXstep > 0, !isCodec1MaskClear(v1, ctx), shadow);
+	decode(v1, ctx);
+
+	_scaleIndexX = v1.scaleXindex;
 }
 
 void ClassicCostumeRenderer::proc3_ami(Codec1 &v1) {
@@ -838,7 +795,7 @@ byte NESCostumeRenderer::drawLimb(const Actor *a, int limb) {
 	_draw_top = top;
 	_draw_bottom = bottom;
 
-	_vm->markRectAsDirty(kMainVirtScreen, left, right, top, bottom, _actorID);
+	_vm->markRectAsDirty(kMainVirtScreen, left, right, top, bottom, _actorID, kDamageActor);
 
 	return 0;
 }
@@ -1256,9 +1213,9 @@ byte V0CostumeRenderer::drawLimb(const Actor *a, int limb) {
 	_draw_top = MIN(_draw_top, ypos);
 	_draw_bottom = MAX(_draw_bottom, ypos + height);
 	if (a0->_limb_flipped[limb])
-		_vm->markRectAsDirty(kMainVirtScreen, xpos - (width * 8), xpos, ypos, ypos + height, _actorID);
+		_vm->markRectAsDirty(kMainVirtScreen, xpos - (width * 8), xpos, ypos, ypos + height, _actorID, kDamageActor);
 	else
-		_vm->markRectAsDirty(kMainVirtScreen, xpos, xpos + (width * 8), ypos, ypos + height, _actorID);
+		_vm->markRectAsDirty(kMainVirtScreen, xpos, xpos + (width * 8), ypos, ypos + height, _actorID, kDamageActor);
 	return 0;
 }
 
@@ -0,0 +1,212 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/damage.h"
+
+#include "common/str.h"
+#include "common/stream.h"
+#include "common/util.h"
+
+namespace Scumm {
+
+static const char *const s_damageSourceNames[kDamageSourceCount] = {
+	"background",
+	"object",
+	"actor",
+	"charset",
+	"verb",
+	"other"
+};
+
+const char *getDamageSourceName(DamageSource source) {
+	assert(source >= 0 && source < kDamageSourceCount);
+	return s_damageSourceNames[source];
+}
+
+void DamageTracker::Stats::reset() {
+	frames = 0;
+	for (int i = 0; i < kDamageSourceCount; ++i)
+		invalidations[i] = lastInvalidations[i] = 0;
+	invalidated = rects = pixels = stripPixels = 0;
+	lastInvalidated = lastRects = lastPixels = lastStripPixels = 0;
+	totalRects = totalPixels = totalStripPixels = 0;
+}
+
+void DamageTracker::Stats::endFrame() {
+	++frames;
+	for (int i = 0; i < kDamageSourceCount; ++i) {
+		lastInvalidations[i] = invalidations[i];
+		invalidations[i] = 0;
+	}
+	lastInvalidated = invalidated;
+	lastRects = rects;
+	lastPixels = pixels;
+	lastStripPixels = stripPixels;
+	totalRects += rects;
+	totalPixels += pixels;
+	totalStripPixels += stripPixels;
+	invalidated = rects = pixels = stripPixels = 0;
+}
+
+DamageTracker::DamageTracker() : _trace(0) {
+	clear();
+}
+
+void DamageTracker::clear() {
+	memset(_count, 0, sizeof(_count));
+}
+
+void DamageTracker::markAll(int top, int bottom) {
+	if (top >= bottom) {
+		clear();
+		return;
+	}
+
+	for (int i = 0; i < kMaxStrips; ++i) {
+		_spans[i][0].top = top;
+		_spans[i][0].bottom = bottom;
+		_count[i] = 1;
+	}
+}
+
+void DamageTracker::addRect(DamageSource source, int firstStrip, int lastStrip, int top, int bottom) {
+	if (_trace)
+		_trace->writeString(Common::String::format("%d %d %d %d %d\n", source, firstStrip, lastStrip, top, bottom));
+
+	firstStrip = MAX(firstStrip, 0);
+	lastStrip = MIN<int>(lastStrip, kMaxStrips - 1);
+	if (firstStrip > lastStrip || top >= bottom)
+		return;
+
+	_stats.invalidations[source]++;
+	_stats.invalidated += (lastStrip - firstStrip + 1) * kStripWidth * (bottom - top);
+
+	for (int strip = firstStrip; strip <= lastStrip; ++strip)
+		addSpan(strip, top, bottom);
+}
+
+void DamageTracker::addSpan(int strip, int top, int bottom) {
+	assert(strip >= 0 && strip < kMaxStrips);
+	if (top >= bottom)
+		return;
+
+	// The spans are kept sorted and apart from each other. Spans which
+	// overlap or touch the new one are folded into it.
+	Span merged[kMaxSpans + 1];
+	Span *spans = _spans[strip];
+	const int count = _count[strip];
+	int out = 0;
+	bool inserted = false;
+
+	for (int i = 0; i < count; ++i) {
+		if (spans[i].bottom < top) {
+			merged[out++] = spans[i];
+		} else if (spans[i].top > bottom) {
+			if (!inserted) {
+				merged[out].top = top;
+				merged[out].bottom = bottom;
+				++out;
+				inserted = true;
+			}
+			merged[out++] = spans[i];
+		} else {
+			top = MIN<int>(top, spans[i].top);
+			bottom = MAX<int>(bottom, spans[i].bottom);
+		}
+	}
+
+	if (!inserted) {
+		merged[out].top = top;
+		merged[out].bottom = bottom;
+		++out;
+	}
+
+	// Too many separate spans, give up on the smallest gap.
+	if (out > kMaxSpans) {
+		int closest = 0;
+		for (int i = 1; i < out - 1; ++i) {
+			if (merged[i + 1].top - merged[i].bottom < merged[closest + 1].top - merged[closest].bottom)
+				closest = i;
+		}
+		merged[closest].bottom = merged[closest + 1].bottom;
+		for (int i = closest + 1; i < out - 1; ++i)
+			merged[i] = merged[i + 1];
+		--out;
+	}
+
+	for (int i = 0; i < out; ++i)
+		spans[i] = merged[i];
+	_count[strip] = out;
+}
+
+void DamageTracker::collectRects(int numStrips, Common::Array<Common::Rect> &rects) {
+	// Indices of the rectangles which end at the right edge of the previous
+	// strip, sorted from top to bottom like the spans.
+	uint open[kMaxSpans];
+	uint numOpen = 0;
+
+	numStrips = MIN<int>(numStrips, kMaxStrips);
+	for (int strip = 0; strip < numStrips; ++strip) {
+		const Span *spans = _spans[strip];
+		const int count = _count[strip];
+		const int16 left = strip * kStripWidth;
+		uint next[kMaxSpans];
+		uint o = 0;
+
+		for (int i = 0; i < count; ++i) {
+			while (o < numOpen && rects[open[o]].top < spans[i].top)
+				++o;
+
+			if (o < numOpen && rects[open[o]].top == spans[i].top && rects[open[o]].bottom == spans[i].bottom) {
+				rects[open[o]].right += kStripWidth;
+				next[i] = open[o++];
+			} else {
+				next[i] = rects.size();
+				rects.push_back(Common::Rect(left, spans[i].top, left + kStripWidth, spans[i].bottom));
+				_stats.rects++;
+			}
+			_stats.pixels += kStripWidth * (spans[i].bottom - spans[i].top);
+		}
+
+		if (count)
+			_stats.stripPixels += kStripWidth * (spans[count - 1].bottom - spans[0].top);
+
+		for (int i = 0; i < count; ++i)
+			open[i] = next[i];
+		numOpen = count;
+		_count[strip] = 0;
+	}
+}
+
+void DamageTracker::noteFullCopy(int width, int height) {
+	_stats.rects++;
+	_stats.pixels += width * height;
+	_stats.stripPixels += width * height;
+}
+
+void DamageTracker::endFrame() {
+	_stats.endFrame();
+	if (_trace)
+		_trace->writeString("F\n");
+}
+
+} // End of namespace Scumm
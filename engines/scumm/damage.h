@@ -0,0 +1,141 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_DAMAGE_H
+#define SCUMM_DAMAGE_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Common {
+class WriteStream;
+}
+
+namespace Scumm {
+
+/** What caused an area of a virtual screen to be invalidated. */
+enum DamageSource {
+	kDamageBackground = 0,
+	kDamageObject,
+	kDamageActor,
+	kDamageCharset,
+	kDamageVerb,
+	kDamageOther,
+	kDamageSourceCount
+};
+
+const char *getDamageSourceName(DamageSource source);
+
+/**
+ * Collects the areas of a virtual screen which have to be copied to the
+ * real screen.
+ *
+ * Every strip keeps a few separate spans of dirty lines instead of a single
+ * range, so that a line of text at the top and an actor at the bottom of a
+ * strip do not cause everything in between to be copied as well. When the
+ * areas are collected, equal spans of neighbouring strips are joined, which
+ * yields the smallest set of rectangles covering exactly the damaged lines
+ * of each strip.
+ */
+class DamageTracker {
+public:
+	enum {
+		kMaxStrips = 80 + 1,
+		/** Spans kept per strip before the closest two are merged. */
+		kMaxSpans = 4,
+		kStripWidth = 8
+	};
+
+	struct Stats {
+		uint32 frames;
+		uint32 invalidations[kDamageSourceCount];		///< current frame
+		uint32 invalidated, rects, pixels, stripPixels;	///< current frame
+		uint32 lastInvalidations[kDamageSourceCount];	///< last complete frame
+		uint32 lastInvalidated, lastRects, lastPixels, lastStripPixels;
+		uint64 totalRects, totalPixels, totalStripPixels;
+
+		Stats() { reset(); }
+
+		void reset();
+		void endFrame();
+	};
+
+	DamageTracker();
+
+	/** Mark all strips as clean. */
+	void clear();
+
+	/** Mark the lines top up to (excluding) bottom of all strips as dirty. */
+	void markAll(int top, int bottom);
+
+	/**
+	 * Invalidate the lines top up to (excluding) bottom of the strips
+	 * firstStrip to lastStrip (inclusive).
+	 */
+	void addRect(DamageSource source, int firstStrip, int lastStrip, int top, int bottom);
+
+	/**
+	 * Invalidate lines of a single strip without counting an invalidation,
+	 * e.g. for areas which were only recorded as a single range per strip.
+	 */
+	void addSpan(int strip, int top, int bottom);
+
+	bool isDirty(int strip) const { return _count[strip] != 0; }
+
+	/**
+	 * Append the rectangles covering the damaged areas of the first
+	 * numStrips strips to rects, in virtual screen coordinates, and mark
+	 * these strips as clean.
+	 */
+	void collectRects(int numStrips, Common::Array<Common::Rect> &rects);
+
+	/** Account for a full copy of the screen done without the tracker. */
+	void noteFullCopy(int width, int height);
+
+	/** Finish the statistics of the current frame. */
+	void endFrame();
+
+	Stats &getStats() { return _stats; }
+	const Stats &getStats() const { return _stats; }
+
+	/**
+	 * Record all invalidations to the given stream, one line per call of
+	 * addRect ("<source> <first strip> <last strip> <top> <bottom>") and a
+	 * line "F" after each frame. The benchmarks replay such traces.
+	 */
+	void setTrace(Common::WriteStream *trace) { _trace = trace; }
+	Common::WriteStream *getTrace() const { return _trace; }
+
+private:
+	struct Span {
+		uint16 top, bottom;
+	};
+
+	Span _spans[kMaxStrips][kMaxSpans];
+	byte _count[kMaxStrips];
+	Stats _stats;
+	Common::WriteStream *_trace;
+};
+
+} // End of namespace Scumm
+
+#endif
@@ -34,9 +34,18 @@
 #include "scumm/resource.h"
 #include "scumm/scumm.h"
 #include "scumm/sound.h"
+#ifdef ENABLE_SCUMM_7_8
+#include "scumm/scumm_v7.h"
+#include "scumm/smush/smush_player.h"
+#endif
+#ifdef ENABLE_HE
+#include "scumm/he/intern_he.h"
+#endif
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 #if defined(__amigaos3__) && defined(NDEBUG)
 inline void debugC(int channel, const char *s, ...) {}
 #else
@@ -59,7 +68,7 @@ void debugC(int channel, const char *s, ...) {
 
 
 ScummDebugger::ScummDebugger(ScummEngine *s)
-	: GUI::Debugger() {
+	: GUI::Debugger(), _damageTrace(0), _resourceTrace(0) {
 	_vm = s;
 
 	// Register variables
@@ -102,10 +111,29 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	registerCmd("imuse",     WRAP_METHOD(ScummDebugger, Cmd_IMuse));
 
 	registerCmd("resetcursors",    WRAP_METHOD(ScummDebugger, Cmd_ResetCursors));
+
+	registerCmd("screenstats",     WRAP_METHOD(ScummDebugger, Cmd_ScreenStats));
+	registerCmd("damage",          WRAP_METHOD(ScummDebugger, Cmd_Damage));
+	registerCmd("stripcache",      WRAP_METHOD(ScummDebugger, Cmd_StripCache));
+	registerCmd("celcache",        WRAP_METHOD(ScummDebugger, Cmd_CelCache));
+	registerCmd("opcodes",         WRAP_METHOD(ScummDebugger, Cmd_Opcodes));
+	registerCmd("dispatch",        WRAP_METHOD(ScummDebugger, Cmd_Dispatch));
+	registerCmd("resources",       WRAP_METHOD(ScummDebugger, Cmd_Resources));
+	registerCmd("offsets",         WRAP_METHOD(ScummDebugger, Cmd_Offsets));
+	registerCmd("saves",           WRAP_METHOD(ScummDebugger, Cmd_Saves));
+	registerCmd("smush",           WRAP_METHOD(ScummDebugger, Cmd_Smush));
+	registerCmd("wiz",             WRAP_METHOD(ScummDebugger, Cmd_Wiz));
 }
 
 ScummDebugger::~ScummDebugger() {
-	 // we need this destructor, even if it is empty, for __SYMBIAN32__
+	if (_damageTrace) {
+		_vm->_virtscr[kMainVirtScreen].damage.setTrace(0);
+		delete _damageTrace;
+	}
+	if (_resourceTrace) {
+		_vm->_res->setTrace(0);
+		delete _resourceTrace;
+	}
 }
 
 void ScummDebugger::preEnter() {
@@ -847,4 +875,456 @@ bool ScummDebugger::Cmd_ResetCursors(int argc, const char **argv) {
 	return false;
 }
 
+bool ScummDebugger::Cmd_ScreenStats(int argc, const char **argv) {
+	ScummEngine::ScreenCopyStats &stats = _vm->_screenCopyStats;
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Screen statistics reset\n");
+		return true;
+	}
+
+	debugPrintf("Bytes passed to the backend by drawStripToScreen:\n");
+	debugPrintf("  last frame: %u copied, %u composed in place\n", stats.lastCopied, stats.lastDirect);
+	if (stats.frames) {
+		debugPrintf("  average over %u frames: %u copied, %u composed in place\n", stats.frames,
+			(uint32)(stats.totalCopied / stats.frames), (uint32)(stats.totalDirect / stats.frames));
+	}
+	debugPrintf("Composing in place is %s\n", _vm->_directScreenAccess ? "enabled" : "not supported by the backend");
+	debugPrintf("Use \"screenstats reset\" to start over\n");
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_Damage(int argc, const char **argv) {
+	static const char *const screenNames[] = { "main", "text", "verb" };
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		for (int i = kMainVirtScreen; i <= kVerbVirtScreen; i++)
+			_vm->_virtscr[i].damage.getStats().reset();
+		debugPrintf("Damage statistics reset\n");
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "trace")) {
+		DamageTracker &damage = _vm->_virtscr[kMainVirtScreen].damage;
+
+		damage.setTrace(0);
+		if (_damageTrace) {
+			_damageTrace->finalize();
+			delete _damageTrace;
+			_damageTrace = 0;
+			debugPrintf("Damage trace stopped\n");
+		}
+
+		if (argc > 2) {
+			_damageTrace = new Common::DumpFile();
+			if (!_damageTrace->open(argv[2])) {
+				debugPrintf("Could not open '%s' for writing\n", argv[2]);
+				delete _damageTrace;
+				_damageTrace = 0;
+				return true;
+			}
+			damage.setTrace(_damageTrace);
+			debugPrintf("Recording the invalidations of the main screen to '%s'\n", argv[2]);
+		}
+		return true;
+	}
+
+	for (int i = kMainVirtScreen; i <= kVerbVirtScreen; i++) {
+		const DamageTracker::Stats &stats = _vm->_virtscr[i].damage.getStats();
+
+		debugPrintf("%s screen, last frame: %u pixels in %u rects copied (%u with one range per strip), %u invalidated\n",
+			screenNames[i], stats.lastPixels, stats.lastRects, stats.lastStripPixels, stats.lastInvalidated);
+		for (int s = 0; s < kDamageSourceCount; s++) {
+			if (stats.lastInvalidations[s])
+				debugPrintf("  %-10s %u invalidations\n", getDamageSourceName((DamageSource)s), stats.lastInvalidations[s]);
+		}
+		if (stats.frames) {
+			debugPrintf("  average over %u frames: %u pixels in %u rects copied (%u with one range per strip)\n", stats.frames,
+				(uint32)(stats.totalPixels / stats.frames), (uint32)(stats.totalRects / stats.frames),
+				(uint32)(stats.totalStripPixels / stats.frames));
+		}
+	}
+	debugPrintf("Use \"damage reset\" to start over, \"damage trace <file>\" to record the\n");
+	debugPrintf("invalidations of the main screen and \"damage trace\" to stop recording\n");
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_StripCache(int argc, const char **argv) {
+	StripCache &cache = _vm->_gdi->_stripCache;
+	StripCache::Stats &stats = cache.getStats();
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Strip cache statistics reset\n");
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "clear")) {
+		cache.clear();
+		debugPrintf("Strip cache cleared\n");
+		return true;
+	}
+
+	if (argc > 2 && !strcmp(argv[1], "size")) {
+		_vm->_gdi->setStripCacheSize(MAX(atoi(argv[2]), 0) * 1024);
+		debugPrintf("Strip cache size set to %u KB\n", cache.getMaxSize() / 1024);
+		return true;
+	}
+
+	if (!cache.isEnabled())
+		debugPrintf("The strip cache is disabled or not supported by this game\n");
+
+	const uint32 lookups = stats.hits + stats.misses;
+	debugPrintf("%u entries, %u of %u KB used\n", cache.getEntryCount(), cache.getSize() / 1024, cache.getMaxSize() / 1024);
+	debugPrintf("%u hits, %u misses (%u%% hit rate), %u transparent strips decoded\n", stats.hits, stats.misses,
+		lookups ? (uint32)((uint64)stats.hits * 100 / lookups) : 0, stats.bypassed);
+	debugPrintf("%u evicted, %u dropped with their resource\n", stats.evictions, stats.invalidations);
+	debugPrintf("Use \"stripcache reset\" to start over, \"stripcache clear\" to empty the cache\n");
+	debugPrintf("and \"stripcache size <KB>\" to change its size (0 disables it)\n");
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_CelCache(int argc, const char **argv) {
+	StripCache &cache = _vm->_celCache;
+	StripCache::Stats &stats = cache.getStats();
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Cel cache statistics reset\n");
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "clear")) {
+		cache.clear();
+		debugPrintf("Cel cache cleared\n");
+		return true;
+	}
+
+	if (argc > 2 && !strcmp(argv[1], "size")) {
+		cache.setMaxSize(MAX(atoi(argv[2]), 0) * 1024);
+		debugPrintf("Cel cache size set to %u KB\n", cache.getMaxSize() / 1024);
+		return true;
+	}
+
+	if (_vm->_game.version < 7 && !_vm->_game.heversion)
+		debugPrintf("This game does not use AKOS costumes\n");
+	else if (!cache.isEnabled())
+		debugPrintf("The cel cache is disabled\n");
+
+	const uint32 lookups = stats.hits + stats.misses;
+	debugPrintf("%u cels, %u of %u KB used\n", cache.getEntryCount(), cache.getSize() / 1024, cache.getMaxSize() / 1024);
+	debugPrintf("%u hits, %u misses (%u%% hit rate), %u cels drawn without the cache\n", stats.hits, stats.misses,
+		lookups ? (uint32)((uint64)stats.hits * 100 / lookups) : 0, stats.bypassed);
+	debugPrintf("%u evicted, %u dropped with their costume\n", stats.evictions, stats.invalidations);
+	debugPrintf("Use \"celcache reset\" to start over, \"celcache clear\" to empty the cache\n");
+	debugPrintf("and \"celcache size <KB>\" to change its size (0 disables it)\n");
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_Opcodes(int argc, const char **argv) {
+	OpcodeProfile &profile = _vm->_opcodeProfile;
+	uint num = 20;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			profile.setEnabled(true);
+			debugPrintf("Counting opcodes\n");
+			return true;
+		} else if (!strcmp(argv[1], "off")) {
+			profile.setEnabled(false);
+			debugPrintf("Stopped counting opcodes\n");
+			return true;
+		} else if (!strcmp(argv[1], "reset")) {
+			profile.reset();
+			debugPrintf("Opcode counts reset\n");
+			return true;
+		}
+		num = MAX(atoi(argv[1]), 1);
+	}
+
+	if (!profile.isEnabled() && !profile.getTotal()) {
+		debugPrintf("Use \"opcodes on\" to start counting the executed opcodes, \"opcodes off\" to stop\n");
+		debugPrintf("and \"opcodes reset\" to start over. \"opcodes <n>\" shows the n most frequent ones\n");
+		return true;
+	}
+
+	const uint64 total = profile.getTotal();
+	Common::Array<OpcodeProfile::Entry> entries;
+	profile.getTop(num, entries);
+
+	debugPrintf("%.0f opcodes executed%s\n", (double)total, profile.isEnabled() ? "" : " (not counting)");
+	for (uint i = 0; i < entries.size(); ++i) {
+		debugPrintf("  0x%02X %-28s %10u  %5.1f%%\n", entries[i].opcode, _vm->getOpcodeDesc(entries[i].opcode),
+			entries[i].count, entries[i].count * 100.0 / total);
+	}
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_Dispatch(int argc, const char **argv) {
+	static const char *const names[] = { "classic", "direct", "verify" };
+
+	if (argc > 1) {
+		int i;
+		for (i = 0; i < ARRAYSIZE(names); ++i) {
+			if (!strcmp(argv[1], names[i]))
+				break;
+		}
+		if (i == ARRAYSIZE(names)) {
+			debugPrintf("Usage: dispatch [classic|direct|verify]\n");
+			return true;
+		}
+		_vm->setScriptDispatch((ScriptDispatch)i);
+	}
+
+	debugPrintf("Script dispatch: %s\n", names[_vm->_scriptDispatch]);
+	return true;
+}
+
+bool ScummDebugger::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+	ResourceManager::Stats &stats = res->getStats();
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Resource statistics reset\n");
+		return true;
+	}
+
+	if (argc > 2 && !strcmp(argv[1], "policy")) {
+		if (!strcmp(argv[2], "classic")) {
+			res->setPolicy(0);
+		} else {
+			ResourcePolicy *policy = ResourceManager::createPolicy(argv[2]);
+			if (!policy) {
+				debugPrintf("Unknown policy '%s', use \"classic\" or \"arc\"\n", argv[2]);
+				return true;
+			}
+			res->setPolicy(policy);
+		}
+		debugPrintf("Expiring resources with the %s policy\n", res->getPolicy() ? res->getPolicy()->getName() : "classic");
+		return true;
+	}
+
+	if (argc > 3 && !strcmp(argv[1], "weight")) {
+		ResourcePolicy *policy = res->getPolicy();
+		const int type = atoi(argv[2]);
+		if (!policy) {
+			debugPrintf("The classic policy does not use weights\n");
+		} else if (type < rtFirst || type > rtLast) {
+			debugPrintf("Resource types range from %d to %d\n", rtFirst, rtLast);
+		} else {
+			policy->setTypeWeight(type, MAX(atoi(argv[3]), 0));
+			debugPrintf("Weight of %s set to %u%%\n", nameOfResType((ResType)type), policy->getTypeWeight(type));
+		}
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "trace")) {
+		res->setTrace(0);
+		if (_resourceTrace) {
+			_resourceTrace->finalize();
+			delete _resourceTrace;
+			_resourceTrace = 0;
+			debugPrintf("Resource trace stopped\n");
+		}
+
+		if (argc > 2) {
+			_resourceTrace = new Common::DumpFile();
+			if (!_resourceTrace->open(argv[2])) {
+				debugPrintf("Could not open '%s' for writing\n", argv[2]);
+				delete _resourceTrace;
+				_resourceTrace = 0;
+				return true;
+			}
+			res->setTrace(_resourceTrace);
+			debugPrintf("Recording the resource usage to '%s'\n", argv[2]);
+		}
+		return true;
+	}
+
+	ResourcePolicy *policy = res->getPolicy();
+	debugPrintf("Policy: %s, %u KB allocated\n", policy ? policy->getName() : "classic", res->getAllocatedSize() / 1024);
+	if (policy) {
+		const Common::String desc = policy->getDescription();
+		if (!desc.empty())
+			debugPrintf("  %s\n", desc.c_str());
+		for (int type = rtFirst; type <= rtLast; type++) {
+			if (policy->getTypeWeight(type) != ResourcePolicy::kDefaultWeight)
+				debugPrintf("  %s (%d) weighted %u%%\n", nameOfResType((ResType)type), type, policy->getTypeWeight(type));
+		}
+	}
+	debugPrintf("%u loaded (%u KB), %u of them reloaded after expiry (%u KB)\n", stats.loads, (uint32)(stats.loadBytes / 1024),
+		stats.reloads, (uint32)(stats.reloadBytes / 1024));
+	debugPrintf("%u expired (%u KB)\n", stats.expired, (uint32)(stats.expiredBytes / 1024));
+	debugPrintf("Use \"resources reset\" to start over, \"resources policy classic|arc\" to switch policies,\n");
+	debugPrintf("\"resources weight <type> <percent>\" to change the reload cost of a type and\n");
+	debugPrintf("\"resources trace [<file>]\" to start or stop recording the resource usage\n");
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_Offsets(int argc, const char **argv) {
+	ResourceOffsetCache &cache = _vm->_offsetCache;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			cache.resetStats();
+			debugPrintf("Statistics reset\n");
+		} else if (!strcmp(argv[1], "clear")) {
+			// Take the room file out of the cache, it is registered again when reopened
+			_vm->closeRoom();
+			cache.clear();
+			debugPrintf("Resource offsets cleared\n");
+		} else if (!strcmp(argv[1], "on") || !strcmp(argv[1], "off")) {
+			_vm->closeRoom();
+			cache.setEnabled(!strcmp(argv[1], "on"));
+			debugPrintf("Resource offset cache %s\n", cache.isEnabled() ? "enabled" : "disabled");
+		} else {
+			debugPrintf("Unknown argument '%s'\n", argv[1]);
+		}
+		return true;
+	}
+
+	const ResourceOffsetCache::Stats &stats = cache.getStats();
+	debugPrintf("Resource offset cache %s, %u offsets in %u files\n", cache.isEnabled() ? "enabled" : "disabled",
+		cache.getEntryCount(), cache.getFileCount());
+	debugPrintf("%u hits, %u misses, %u files changed\n", stats.hits, stats.misses, stats.invalidated);
+	if (stats.roomLoads)
+		debugPrintf("%u rooms loaded in %u ms, %u ms on average, at most %u ms\n", stats.roomLoads, stats.roomLoadMillis,
+			stats.roomLoadMillis / stats.roomLoads, stats.roomLoadMaxMillis);
+	debugPrintf("Use \"offsets reset\" to start over, \"offsets clear\" to forget the offsets and\n");
+	debugPrintf("\"offsets on|off\" to compare the room load times with and without the cache\n");
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_Saves(int argc, const char **argv) {
+	IncrementalSaveWriter &writer = _vm->_saveWriter;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			writer.resetStats();
+			debugPrintf("Statistics reset\n");
+		} else if (!strcmp(argv[1], "chunk") && argc > 2) {
+			writer.setChunkSize(MAX(atoi(argv[2]), 0) * 1024);
+			debugPrintf("Autosaves are written in chunks of %u KB\n", writer.getChunkSize() / 1024);
+		} else {
+			debugPrintf("Unknown argument '%s'\n", argv[1]);
+		}
+		return true;
+	}
+
+	const IncrementalSaveWriter::Stats &stats = writer.getStats();
+	if (writer.getChunkSize())
+		debugPrintf("Autosaves are written in chunks of %u KB\n", writer.getChunkSize() / 1024);
+	else
+		debugPrintf("Autosaves are written at once\n");
+	if (writer.isBusy())
+		debugPrintf("Still writing '%s'\n", writer.getName().c_str());
+	debugPrintf("%u saves written in %u chunks, %u KB, %u unchanged saves skipped\n", stats.saves, stats.chunks,
+		stats.bytes / 1024, stats.skipped);
+	debugPrintf("%u KB of the state changed between snapshots\n", stats.changedBytes / 1024);
+	debugPrintf("Taking the snapshots took %u ms, at most %u ms, writing a chunk at most %u ms\n",
+		stats.snapshotMillis, stats.maxSnapshotMillis, stats.maxStepMillis);
+	debugPrintf("Use \"saves reset\" to start over and \"saves chunk <KB>\" to change the chunk size\n");
+	debugPrintf("(0 writes autosaves at once)\n");
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_Smush(int argc, const char **argv) {
+#ifdef ENABLE_SCUMM_7_8
+	if (_vm->_game.version < 7) {
+		debugPrintf("This game does not use SMUSH animations\n");
+		return true;
+	}
+
+	SmushPlayer *player = ((ScummEngine_v7 *)_vm)->_splayer;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			player->clearPlaybackHistory();
+			debugPrintf("Statistics reset\n");
+		} else if (!strcmp(argv[1], "ahead") && argc > 2) {
+			player->setReadAhead(MAX(atoi(argv[2]), 0));
+			debugPrintf("Reading %u chunks ahead\n", player->getReadAhead());
+		} else {
+			debugPrintf("Unknown argument '%s'\n", argv[1]);
+		}
+		return true;
+	}
+
+	debugPrintf("Reading %u chunks ahead\n", player->getReadAhead());
+	const Common::Array<SmushPlayer::PlaybackStats> &history = player->getPlaybackHistory();
+	for (uint i = 0; i < history.size(); ++i) {
+		const SmushPlayer::PlaybackStats &stats = history[i];
+		debugPrintf("%-12s %5u frames, %5u shown, %4u late, %4u dropped, %5u of %5u chunks read ahead\n",
+			stats.file.c_str(), stats.frames, stats.shown, stats.late, stats.dropped, stats.readAhead,
+			stats.readAhead + stats.underruns);
+	}
+	debugPrintf("Use \"smush reset\" to start over and \"smush ahead <chunks>\" to change how many\n");
+	debugPrintf("chunks are read ahead (0 reads them when needed)\n");
+#else
+	debugPrintf("SMUSH support is not compiled in\n");
+#endif
+
+	return true;
+}
+
+bool ScummDebugger::Cmd_Wiz(int argc, const char **argv) {
+#ifdef ENABLE_HE
+	if (_vm->_game.heversion < 71) {
+		debugPrintf("This game does not use Wiz images\n");
+		return true;
+	}
+
+	Wiz *wiz = ((ScummEngine_v71he *)_vm)->_wiz;
+	StripCache &cache = wiz->_spanCache;
+	StripCache::Stats &stats = cache.getStats();
+	Wiz::PolygonStats &polygons = wiz->_polygonStats;
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		stats.reset();
+		polygons.reset();
+		debugPrintf("Wiz statistics reset\n");
+		return true;
+	}
+
+	if (argc > 1 && !strcmp(argv[1], "clear")) {
+		cache.clear();
+		debugPrintf("Span cache cleared\n");
+		return true;
+	}
+
+	if (argc > 2 && !strcmp(argv[1], "size")) {
+		cache.setMaxSize(MAX(atoi(argv[2]), 0) * 1024);
+		debugPrintf("Span cache size set to %u KB\n", cache.getMaxSize() / 1024);
+		return true;
+	}
+
+	if (!cache.isEnabled())
+		debugPrintf("The span cache is disabled\n");
+
+	const uint32 lookups = stats.hits + stats.misses;
+	debugPrintf("%u images, %u of %u KB used\n", cache.getEntryCount(), cache.getSize() / 1024, cache.getMaxSize() / 1024);
+	debugPrintf("%u hits, %u misses (%u%% hit rate), %u images which cannot be drawn from spans\n", stats.hits, stats.misses,
+		lookups ? (uint32)((uint64)stats.hits * 100 / lookups) : 0, stats.bypassed);
+	debugPrintf("%u evicted, %u dropped with their image\n", stats.evictions, stats.invalidations);
+	debugPrintf("%u polygon hit tests, %u outside of all polygons, %u point in polygon tests\n",
+		polygons.queries, polygons.rejected, polygons.tests);
+	debugPrintf("Use \"wiz reset\" to start over, \"wiz clear\" to empty the span cache\n");
+	debugPrintf("and \"wiz size <KB>\" to change its size (0 disables it)\n");
+#else
+	debugPrintf("HE support is not compiled in\n");
+#endif
+
+	return true;
+}
+
 } // End of namespace Scumm
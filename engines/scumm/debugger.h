@@ -25,6 +25,10 @@
 
 #include "gui/debugger.h"
 
+namespace Common {
+class DumpFile;
+}
+
 namespace Scumm {
 
 class ScummEngine;
@@ -36,6 +40,8 @@ public:
 
 private:
 	ScummEngine *_vm;
+	Common::DumpFile *_damageTrace;
+	Common::DumpFile *_resourceTrace;
 
 	virtual void preEnter();
 	virtual void postEnter();
@@ -69,6 +75,18 @@ private:
 
 	bool Cmd_ResetCursors(int argc, const char **argv);
 
+	bool Cmd_ScreenStats(int argc, const char **argv);
+	bool Cmd_Damage(int argc, const char **argv);
+	bool Cmd_StripCache(int argc, const char **argv);
+	bool Cmd_CelCache(int argc, const char **argv);
+	bool Cmd_Opcodes(int argc, const char **argv);
+	bool Cmd_Dispatch(int argc, const char **argv);
+	bool Cmd_Resources(int argc, const char **argv);
+	bool Cmd_Offsets(int argc, const char **argv);
+	bool Cmd_Saves(int argc, const char **argv);
+	bool Cmd_Smush(int argc, const char **argv);
+	bool Cmd_Wiz(int argc, const char **argv);
+
 	void printBox(int box);
 	void drawBox(int box);
 };
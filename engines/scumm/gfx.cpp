@@ -277,6 +277,15 @@ void Gdi::init() {
 void Gdi::roomChanged(byte *roomptr) {
 }
 
+void Gdi::setStripCacheSize(uint32 size) {
+	// The Amiga versions remap the room palette whenever the palette
+	// changes, and HE games draw strips through their own palettes.
+	if (_vm->_game.heversion || (_vm->_game.platform == Common::kPlatformAmiga && _vm->_game.version >= 4))
+		size = 0;
+
+	_stripCache.setMaxSize(size);
+}
+
 void GdiNES::roomChanged(byte *roomptr) {
 	decodeNESGfx(roomptr);
 }
@@ -446,7 +455,8 @@ VirtScreen *ScummEngine::findVirtScreen(int y) {
 	return NULL;
 }
 
-void ScummEngine::markRectAsDirty(VirtScreenNumber virt, int left, int right, int top, int bottom, int dirtybit) {
+void ScummEngine::markRectAsDirty(VirtScreenNumber virt, int left, int right, int top, int bottom, int dirtybit,
+                                  DamageSource source) {
 	VirtScreen *vs = &_virtscr[virt];
 	int lp, rp;
 
@@ -489,13 +499,7 @@ void ScummEngine::markRectAsDirty(VirtScreenNumber virt, int left, int right, in
 	if (rp >= _gdi->_numStrips)
 		rp = _gdi->_numStrips - 1;
 
-	while (lp <= rp) {
-		if (top < vs->tdirty[lp])
-			vs->tdirty[lp] = top;
-		if (bottom > vs->bdirty[lp])
-			vs->bdirty[lp] = bottom;
-		lp++;
-	}
+	vs->markStripsDirty(source, lp, rp, top, bottom);
 }
 
 /**
@@ -516,6 +520,7 @@ void ScummEngine::drawDirtyScreenParts() {
 		VirtScreen *vs = &_virtscr[kMainVirtScreen];
 		drawStripToScreen(vs, 0, vs->w, 0, vs->h);
 		vs->setDirtyRange(vs->h, 0);
+		vs->damage.noteFullCopy(vs->w, vs->h);
 	} else {
 		updateDirtyScreen(kMainVirtScreen);
 	}
@@ -528,6 +533,10 @@ void ScummEngine::drawDirtyScreenParts() {
 		_shakeFrame = 0;
 		_system->setShakePos(0);
 	}
+
+	_screenCopyStats.endFrame();
+	for (int i = kMainVirtScreen; i <= kVerbVirtScreen; i++)
+		_virtscr[i].damage.endFrame();
 }
 
 void ScummEngine_v6::drawDirtyScreenParts() {
@@ -574,26 +583,20 @@ void ScummEngine::updateDirtyScreen(VirtScreenNumber slot) {
 	if (vs->h == 0)
 		return;
 
-	int i;
-	int w = 8;
-	int start = 0;
-
-	for (i = 0; i < _gdi->_numStrips; i++) {
-		if (vs->bdirty[i]) {
-			const int top = vs->tdirty[i];
-			const int bottom = vs->bdirty[i];
-			vs->tdirty[i] = vs->h;
-			vs->bdirty[i] = 0;
-			if (i != (_gdi->_numStrips - 1) && vs->bdirty[i + 1] == bottom && vs->tdirty[i + 1] == top) {
-				// Simple optimizations: if two or more neighboring strips
-				// form one bigger rectangle, coalesce them.
-				w += 8;
-				continue;
-			}
-			drawStripToScreen(vs, start * 8, w, top, bottom);
-			w = 8;
-		}
-		start = i + 1;
+	// Strips which were marked as dirty without going through the damage
+	// tracker are copied as a whole range.
+	for (int i = 0; i < _gdi->_numStrips; i++) {
+		if (vs->bdirty[i] && !vs->damage.isDirty(i))
+			vs->damage.addSpan(i, vs->tdirty[i], vs->bdirty[i]);
+		vs->tdirty[i] = vs->h;
+		vs->bdirty[i] = 0;
+	}
+
+	_damageRects.clear();
+	vs->damage.collectRects(_gdi->_numStrips, _damageRects);
+	for (uint i = 0; i < _damageRects.size(); i++) {
+		const Common::Rect &r = _damageRects[i];
+		drawStripToScreen(vs, r.left, r.width(), r.top, r.bottom);
 	}
 }
 
@@ -661,38 +664,43 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 		} else
 #endif
 		if (_outputPixelFormat.bytesPerPixel == 2) {
-			const byte *srcPtr = (const byte *)src;
-			const byte *textPtr = (byte *)_textSurface.getBasePtr(x * m, y * m);
-			byte *dstPtr = _compositeBuf;
-
-			for (int h = 0; h < height * m; ++h) {
-				for (int w = 0; w < width * m; ++w) {
-					uint16 tmp = *textPtr++;
-					if (tmp == CHARSET_MASK_TRANSPARENCY) {
-						tmp = READ_UINT16(srcPtr);
-						WRITE_UINT16(dstPtr, tmp); dstPtr += 2;
-					} else if (_game.heversion != 0) {
-						error ("16Bit Color HE Game using old charset");
-					} else {
-						WRITE_UINT16(dstPtr, _16BitPalette[tmp]); dstPtr += 2;
-					}
-					srcPtr += vs->format.bytesPerPixel;
+			assert(vs->format.bytesPerPixel == 2);
+
+			// The lines of the graphics keep the distance the text lines
+			// have, also when the text surface is scaled.
+			const int srcPitch = vs->pitch + width * (m - 1) * 2;
+			if (_composeText16(_compositeBuf, (const byte *)src, srcPitch, (const byte *)text, _textSurface.pitch,
+			                   _16BitPalette, width * m, height * m) && _game.heversion != 0)
+				error("16Bit Color HE Game using old charset");
+		} else {
+			// Unless the composed strip has to be processed any further,
+			// compose it straight into the backend's screen. This saves
+			// copying it from _compositeBuf.
+			Graphics::Surface *screen = 0;
+			if (_directScreenAccess && m == 1 && _game.platform != Common::kPlatformNES &&
+				_renderMode != Common::kRenderHercA && _renderMode != Common::kRenderHercG) {
+				screen = _system->lockScreen();
+				if (screen && (screen->format.bytesPerPixel != 1 || (screen->pitch & 3) || !IS_ALIGNED(screen->getPixels(), 4))) {
+					_system->unlockScreen();
+					screen = 0;
 				}
-				srcPtr += vsPitch;
-				textPtr += _textSurface.pitch - width * m;
 			}
-		} else {
+
+			byte *dst = screen ? (byte *)screen->getBasePtr(x, y) : _compositeBuf;
+			const int dstPitch = screen ? screen->pitch : width;
+
 #ifdef USE_ARM_GFX_ASM
-			asmDrawStripToScreen(height, width, text, src, _compositeBuf, vs->pitch, width, _textSurface.pitch);
+			asmDrawStripToScreen(height, width, text, src, dst, vs->pitch, dstPitch, _textSurface.pitch);
 #else
 			// We blit four pixels at a time, for improved performance.
 			const uint32 *src32 = (const uint32 *)src;
-			uint32 *dst32 = (uint32 *)_compositeBuf;
+			uint32 *dst32 = (uint32 *)dst;
 
 			vsPitch >>= 2;
 
 			const uint32 *text32 = (const uint32 *)text;
 			const int textPitch = (_textSurface.pitch - width * m) >> 2;
+			const int dst32Pitch = screen ? (dstPitch - width) >> 2 : 0;
 			for (int h = height * m; h > 0; --h) {
 				for (int w = width * m; w > 0; w -= 4) {
 					uint32 temp = *text32++;
@@ -714,8 +722,18 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 				}
 				src32 += vsPitch;
 				text32 += textPitch;
+				dst32 += dst32Pitch;
 			}
 #endif
+
+			if (screen) {
+				if (_renderMode == Common::kRenderCGA)
+					ditherCGA(dst, dstPitch, x, y, width, height);
+
+				_system->unlockScreenRect(x, y, width, height);
+				_screenCopyStats.direct += width * height;
+				return;
+			}
 		}
 		src = _compositeBuf;
 		pitch = width * vs->format.bytesPerPixel;
@@ -765,6 +783,7 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 
 	// Finally blit the whole thing to the screen
 	_system->copyRectToScreen(src, pitch, x, y, width, height);
+	_screenCopyStats.copied += width * height * _outputPixelFormat.bytesPerPixel;
 }
 
 // CGA
@@ -1050,7 +1069,7 @@ void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
 		rect.right = 319;
 #endif
 
-	markRectAsDirty(vs->number, rect, USAGE_BIT_RESTORED);
+	markRectAsDirty(vs->number, rect, USAGE_BIT_RESTORED, kDamageBackground);
 
 	screenBuf = vs->getPixels(rect.left, rect.top);
 
@@ -1104,7 +1123,7 @@ void ScummEngine::restoreCharsetBg() {
 		if (!vs->h)
 			return;
 
-		markRectAsDirty(vs->number, Common::Rect(vs->w, vs->h), USAGE_BIT_RESTORED);
+		markRectAsDirty(vs->number, Common::Rect(vs->w, vs->h), USAGE_BIT_RESTORED, kDamageBackground);
 
 		byte *screenBuf = vs->getPixels(0, 0);
 
@@ -1450,9 +1469,8 @@ void ScummEngine_v5::drawFlashlight() {
 	for (i = _flashlight.x / 8; i < (_flashlight.x + _flashlight.w) / 8; i++) {
 		assert(0 <= i && i < _gdi->_numStrips);
 		setGfxUsageBit(_screenStartStrip + i, USAGE_BIT_DIRTY);
-		vs->tdirty[i] = 0;
-		vs->bdirty[i] = vs->h;
 	}
+	vs->markStripsDirty(kDamageOther, _flashlight.x / 8, (_flashlight.x + _flashlight.w) / 8 - 1, 0, vs->h);
 
 	byte *bgbak;
 	_flashlight.buffer = vs->getPixels(_flashlight.x, _flashlight.y);
@@ -1818,13 +1836,9 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		limit = numstrip;
 	if (limit > _numStrips - sx)
 		limit = _numStrips - sx;
+	if (limit > 0)
+		vs->markStripsDirty((flag & dbObjectMode) ? kDamageObject : kDamageBackground, sx, sx + limit - 1, y, y + height);
 	for (int k = 0; k < limit; ++k, ++stripnr, ++sx, ++x) {
-		if (y < vs->tdirty[sx])
-			vs->tdirty[sx] = y;
-
-		if (y + height > vs->bdirty[sx])
-			vs->bdirty[sx] = y + height;
-
 		// In the case of a double buffered virtual screen, we draw to
 		// the backbuffer, otherwise to the primary surface memory.
 		if (vs->hasTwoBuffers)
@@ -1913,7 +1927,35 @@ bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width,
 			_roomPalette = _vm->_roomPalette;
 	}
 
-	return decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+	const byte *src = smap_ptr + offset;
+	if (!_stripCache.isEnabled())
+		return decompressBitmap(dstPtr, vs->pitch, src, height);
+
+	const int rowSize = 8 * vs->format.bytesPerPixel;
+	const byte *cached;
+	if (_stripCache.lookup(StripCache::kPixels, src, _roomPalette, height, cached) && cached) {
+		for (int h = 0; h < height; h++) {
+			memcpy(dstPtr, cached, rowSize);
+			dstPtr += vs->pitch;
+			cached += rowSize;
+		}
+		return false;
+	}
+
+	const bool transpStrip = decompressBitmap(dstPtr, vs->pitch, src, height);
+
+	// Transparent strips keep what was drawn below them, so only the
+	// fact that they are transparent is remembered.
+	byte *data = _stripCache.insert(StripCache::kPixels, src, _roomPalette, height, transpStrip ? 0 : rowSize * height);
+	if (data) {
+		for (int h = 0; h < height; h++) {
+			memcpy(data, dstPtr, rowSize);
+			dstPtr += vs->pitch;
+			data += rowSize;
+		}
+	}
+
+	return transpStrip;
 }
 
 bool GdiNES::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
@@ -1979,10 +2021,7 @@ void Gdi::decodeMask(int x, int y, const int width, const int height,
 			z_plane_ptr = zplane_list[1] + READ_LE_UINT16(zplane_list[1] + stripnr * 2 + 8);
 		for (i = 0; i < numzbuf; i++) {
 			mask_ptr = getMaskBuffer(x, y, i);
-			if (transpStrip && (flag & dbAllowMaskOr))
-				decompressMaskImgOr(mask_ptr, z_plane_ptr, height);
-			else
-				decompressMaskImg(mask_ptr, z_plane_ptr, height);
+			decompressMaskImgCached(mask_ptr, z_plane_ptr, height, transpStrip && (flag & dbAllowMaskOr));
 		}
 	} else {
 		for (i = 1; i < numzbuf; i++) {
@@ -2007,11 +2046,7 @@ void Gdi::decodeMask(int x, int y, const int width, const int height,
 			if (offs) {
 				z_plane_ptr = zplane_list[i] + offs;
 
-				if (transpStrip && (flag & dbAllowMaskOr)) {
-					decompressMaskImgOr(mask_ptr, z_plane_ptr, height);
-				} else {
-					decompressMaskImg(mask_ptr, z_plane_ptr, height);
-				}
+				decompressMaskImgCached(mask_ptr, z_plane_ptr, height, transpStrip && (flag & dbAllowMaskOr));
 
 			} else {
 				if (!(transpStrip && (flag & dbAllowMaskOr)))
@@ -2241,7 +2276,7 @@ void ScummEngine_v70he::restoreBackgroundHE(Common::Rect rect, int dirtybit) {
 	assert(rw <= _screenWidth && rw > 0);
 	assert(rh <= _screenHeight && rh > 0);
 	blit(dst, _virtscr[kMainVirtScreen].pitch, src, _virtscr[kMainVirtScreen].pitch, rw, rh, vs->format.bytesPerPixel);
-	markRectAsDirty(kMainVirtScreen, rect, dirtybit);
+	markRectAsDirty(kMainVirtScreen, rect, dirtybit, kDamageBackground);
 }
 #endif
 
@@ -2264,11 +2299,7 @@ void Gdi::resetBackground(int top, int bottom, int strip) {
 
 	assert(0 <= strip && strip < _numStrips);
 
-	if (top < vs->tdirty[strip])
-		vs->tdirty[strip] = top;
-
-	if (bottom > vs->bdirty[strip])
-		vs->bdirty[strip] = bottom;
+	vs->markStripsDirty(kDamageBackground, strip, strip, top, bottom);
 
 	bgbak_ptr = (byte *)vs->backBuf + top * vs->pitch + (strip + vs->xstart/8) * 8 * vs->format.bytesPerPixel;
 	backbuff_ptr = (byte *)vs->getBasePtr((strip + vs->xstart/8) * 8, top);
@@ -2427,7 +2458,7 @@ bool Gdi::decompressBitmap(byte *dst, int dstPitch, const byte *src, int numLine
 	return transpStrip;
 }
 
-void Gdi::decompressMaskImg(byte *dst, const byte *src, int height) const {
+static void decompressMaskColumn(byte *dst, int dstPitch, const byte *src, int height) {
 	byte b, c;
 
 	while (height) {
@@ -2439,19 +2470,50 @@ void Gdi::decompressMaskImg(byte *dst, const byte *src, int height) const {
 
 			do {
 				*dst = c;
-				dst += _numStrips;
+				dst += dstPitch;
 				--height;
 			} while (--b && height);
 		} else {
 			do {
 				*dst = *src++;
-				dst += _numStrips;
+				dst += dstPitch;
 				--height;
 			} while (--b && height);
 		}
 	}
 }
 
+void Gdi::decompressMaskImg(byte *dst, const byte *src, int height) const {
+	decompressMaskColumn(dst, _numStrips, src, height);
+}
+
+void Gdi::decompressMaskImgCached(byte *dst, const byte *src, int height, bool maskOr) {
+	const byte *column = 0;
+
+	if (_stripCache.isEnabled() && !_stripCache.lookup(StripCache::kMask, src, 0, height, column)) {
+		byte *data = _stripCache.insert(StripCache::kMask, src, 0, height, height);
+		if (data)
+			decompressMaskColumn(data, 1, src, height);
+		column = data;
+	}
+
+	if (!column) {
+		if (maskOr)
+			decompressMaskImgOr(dst, src, height);
+		else
+			decompressMaskImg(dst, src, height);
+		return;
+	}
+
+	if (maskOr) {
+		for (int h = 0; h < height; h++, dst += _numStrips)
+			*dst |= column[h];
+	} else {
+		for (int h = 0; h < height; h++, dst += _numStrips)
+			*dst = column[h];
+	}
+}
+
 void GdiHE::decompressTMSK(byte *dst, const byte *tmsk, const byte *src, int height) const {
 	byte srcbits = 0;
 	byte srcFlag = 0;
@@ -3890,10 +3952,8 @@ void ScummEngine::transitionEffect(int a) {
 
 			if (t == b) {
 				while (l <= r) {
-					if (l >= 0 && l < _gdi->_numStrips && t < bottom) {
-						_virtscr[kMainVirtScreen].tdirty[l] = _screenTop + t * 8;
-						_virtscr[kMainVirtScreen].bdirty[l] = _screenTop + (b + 1) * 8;
-					}
+					if (l >= 0 && l < _gdi->_numStrips && t < bottom)
+						_virtscr[kMainVirtScreen].markStripsDirty(kDamageOther, l, l, _screenTop + t * 8, _screenTop + (b + 1) * 8);
 					l++;
 				}
 			} else {
@@ -3903,8 +3963,7 @@ void ScummEngine::transitionEffect(int a) {
 					b = bottom;
 				if (t < 0)
 					t = 0;
-				_virtscr[kMainVirtScreen].tdirty[l] = _screenTop + t * 8;
-				_virtscr[kMainVirtScreen].bdirty[l] = _screenTop + (b + 1) * 8;
+				_virtscr[kMainVirtScreen].markStripsDirty(kDamageOther, l, l, _screenTop + t * 8, _screenTop + (b + 1) * 8);
 			}
 			updateDirtyScreen(kMainVirtScreen);
 		}
@@ -28,6 +28,9 @@
 
 #include "graphics/surface.h"
 
+#include "scumm/damage.h"
+#include "scumm/stripcache.h"
+
 namespace Scumm {
 
 class ScummEngine;
@@ -169,8 +172,31 @@ struct VirtScreen : Graphics::Surface {
 			tdirty[i] = top;
 			bdirty[i] = bottom;
 		}
+		damage.markAll(top, bottom);
 	}
 
+	/**
+	 * Mark the lines top up to (excluding) bottom of the given strips as
+	 * dirty. Besides widening tdirty and bdirty, which other code inspects
+	 * to find out whether a strip needs to be redrawn, this records the area
+	 * with the damage tracker, which decides what is copied to the screen.
+	 */
+	void markStripsDirty(DamageSource source, int firstStrip, int lastStrip, int top, int bottom) {
+		for (int i = firstStrip; i <= lastStrip; i++) {
+			if (top < tdirty[i])
+				tdirty[i] = top;
+			if (bottom > bdirty[i])
+				bdirty[i] = bottom;
+		}
+		damage.addRect(source, firstStrip, lastStrip, top, bottom);
+	}
+
+	/**
+	 * The areas of this screen which have to be copied to the real screen,
+	 * see DamageTracker.
+	 */
+	DamageTracker damage;
+
 	byte *getPixels(int x, int y) const {
 		return (byte *)pixels + y * pitch + (xstart + x) * format.bytesPerPixel;
 	}
@@ -217,6 +243,17 @@ public:
 	int _imgBufOffs[8];
 	int32 _numStrips;
 
+	/**
+	 * Decoded strips and z-plane columns drawn by drawBitmap. The cache is
+	 * disabled unless a size is set with setStripCacheSize().
+	 */
+	StripCache _stripCache;
+
+	enum {
+		/** Size of the strip cache unless configured otherwise. */
+		kDefaultStripCacheSize = 256 * 1024
+	};
+
 protected:
 	/* Bitmap decompressors */
 	bool decompressBitmap(byte *dst, int dstPitch, const byte *src, int numLinesToProcess);
@@ -240,6 +277,7 @@ protected:
 	/* Mask decompressors */
 	void decompressMaskImgOr(byte *dst, const byte *src, int height) const;
 	void decompressMaskImg(byte *dst, const byte *src, int height) const;
+	void decompressMaskImgCached(byte *dst, const byte *src, int height, bool maskOr);
 
 	/* Misc */
 	int getZPlanes(const byte *smap_ptr, const byte *zplane_list[9], bool bmapImage) const;
@@ -265,6 +303,12 @@ public:
 	virtual void loadTiles(byte *roomptr);
 	void setTransparentColor(byte transparentColor) { _transparentColor = transparentColor; }
 
+	/**
+	 * Set the size of the strip cache in bytes, 0 disables it. Games whose
+	 * strips cannot be cached keep it disabled.
+	 */
+	void setStripCacheSize(uint32 size);
+
 	void drawBitmap(const byte *ptr, VirtScreen *vs, int x, int y, const int width, const int height,
 	                int stripnr, int numstrip, byte flag);
 
@@ -64,6 +64,8 @@ void Moonbase::initFOW() {
 
 void Moonbase::releaseFOWResources() {
 	if (_fowImage) {
+		// Drop the spans of the tiles along with their pixels.
+		_vm->_wiz->_spanCache.clear();
 		free(_fowImage);
 		_fowImage = 0;
 	}
@@ -23,6 +23,7 @@
 #ifdef ENABLE_HE
 
 #include "common/archive.h"
+#include "common/config-manager.h"
 #include "common/system.h"
 #include "graphics/cursorman.h"
 #include "graphics/primitives.h"
@@ -31,6 +32,7 @@
 #include "scumm/scumm.h"
 #include "scumm/util.h"
 #include "scumm/he/wiz_he.h"
+#include "scumm/he/wizspans_he.h"
 #include "scumm/he/moonbase/moonbase.h"
 
 namespace Scumm {
@@ -41,6 +43,12 @@ Wiz::Wiz(ScummEngine_v71he *vm) : _vm(vm) {
 	memset(&_polygons, 0, sizeof(_polygons));
 	_cursorImage = false;
 	_rectOverrideEnabled = false;
+	polygonUpdateBound();
+
+	if (ConfMan.hasKey("wiz_cache_size"))
+		_spanCache.setMaxSize(MAX(ConfMan.getInt("wiz_cache_size"), 0) * 1024);
+	else
+		_spanCache.setMaxSize(kDefaultSpanCacheSize);
 }
 
 void Wiz::clearWizBuffer() {
@@ -52,6 +60,7 @@ void Wiz::polygonClear() {
 		if (_polygons[i].flag == 1)
 			_polygons[i].reset();
 	}
+	polygonUpdateBound();
 }
 
 void Wiz::polygonLoad(const uint8 *polData) {
@@ -106,6 +115,7 @@ void Wiz::polygonStore(int id, bool flag, int vert1x, int vert1y, int vert2x, in
 	wp->flag = flag;
 
 	polygonCalcBoundBox(wp->vert, wp->numVerts, wp->bound);
+	polygonUpdateBound();
 }
 
 void Wiz::polygonRotatePoints(Common::Point *pts, int num, int angle) {
@@ -175,11 +185,35 @@ void Wiz::polygonErase(int fromId, int toId) {
 		if (_polygons[i].id >= fromId && _polygons[i].id <= toId)
 			_polygons[i].reset();
 	}
+	polygonUpdateBound();
 }
 
-int Wiz::polygonHit(int id, int x, int y) {
+void Wiz::polygonUpdateBound() {
+	_polygonBound = Common::Rect();
+	_polygonSlots = 0;
 	for (int i = 0; i < ARRAYSIZE(_polygons); i++) {
+		if (_polygons[i].id == 0)
+			continue;
+		if (_polygonBound.isEmpty())
+			_polygonBound = _polygons[i].bound;
+		else
+			_polygonBound.extend(_polygons[i].bound);
+		_polygonSlots = i + 1;
+	}
+}
+
+int Wiz::polygonHit(int id, int x, int y) {
+	// Scripts test each object against the cursor, and most points are
+	// not near any polygon.
+	_polygonStats.queries++;
+	if (!_polygonBound.contains(x, y)) {
+		_polygonStats.rejected++;
+		return 0;
+	}
+
+	for (int i = 0; i < _polygonSlots; i++) {
 		if ((id == 0 || _polygons[i].id == id) && _polygons[i].bound.contains(x, y)) {
+			_polygonStats.tests++;
 			if (polygonContains(_polygons[i], x, y)) {
 				return _polygons[i].id;
 			}
@@ -977,6 +1011,10 @@ void Wiz::decompressRawWizImage(uint8 *dst, int dstPitch, int dstType, const uin
 	}
 }
 
+// NOTE: AkosRenderer draws cached costume cels with these.
+template void Wiz::decompressRawWizImage<kWizRMap>(uint8 *dst, int dstPitch, int dstType, const uint8 *src, int srcPitch, int w, int h, int transColor, const uint8 *palPtr, uint8 bitDepth);
+template void Wiz::decompressRawWizImage<kWizCopy>(uint8 *dst, int dstPitch, int dstType, const uint8 *src, int srcPitch, int w, int h, int transColor, const uint8 *palPtr, uint8 bitDepth);
+
 int Wiz::isPixelNonTransparent(const uint8 *data, int x, int y, int w, int h, uint8 bitDepth) {
 	if (x < 0 || x >= w || y < 0 || y >= h) {
 		return 0;
@@ -1600,6 +1638,43 @@ uint8 *Wiz::drawWizImage(int resNum, int state, int maskNum, int maskState, int
 	return dst;
 }
 
+bool Wiz::drawWizImageSpans(uint8 *dst, const uint8 *wizd, int pixelSize, int width, int height, int dstPitch, int dstType,
+		int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, const uint8 *palPtr, uint8 bitDepth) {
+	if (!_spanCache.isEnabled() || height <= 0 || height > 0xFFFF)
+		return false;
+
+	Common::Rect r1, r2;
+	if (!calcClipRects(dstw, dsth, srcx, srcy, srcw, srch, rect, r1, r2))
+		return true;
+	if (flags & kWIFFlipY) {
+		const int dy = (srcy < 0) ? srcy : (srch - r1.height());
+		r1.translate(0, dy);
+	}
+	if (flags & kWIFFlipX) {
+		const int dx = (srcx < 0) ? srcx : (srcw - r1.width());
+		r1.translate(dx, 0);
+	}
+	// Composite images pass their own size; leave parts outside of the
+	// image to the decoder.
+	if (r1.left < 0 || r1.top < 0 || r1.right > width || r1.bottom > height)
+		return false;
+
+	const byte *spans;
+	if (!_spanCache.lookup(StripCache::kWizSpans, wizd, 0, height, spans)) {
+		const uint32 size = WizSpans::measure(wizd, width, height, pixelSize);
+		byte *buffer = _spanCache.insert(StripCache::kWizSpans, wizd, 0, height, size);
+		if (!buffer)
+			return false;
+		WizSpans::build(buffer, wizd, width, height, pixelSize);
+		spans = buffer;
+	}
+	if (!spans)
+		return false;
+
+	dst += r2.top * dstPitch + r2.left * (pixelSize == 2 ? 2 : bitDepth);
+	return WizSpans::draw(dst, dstPitch, dstType, spans, wizd, pixelSize, r1, flags, palPtr ? kWizRMap : kWizCopy, palPtr, bitDepth);
+}
+
 void Wiz::drawWizImageEx(uint8 *dst, uint8 *dataPtr, uint8 *maskPtr, int dstPitch, int dstType,
 		int dstw, int dsth, int srcx, int srcy, int srcw, int srch, int state, const Common::Rect *rect,
 		int flags, const uint8 *palPtr, int transColor, uint8 bitDepth, const uint8 *xmapPtr, uint32 conditionBits) {
@@ -1626,7 +1701,7 @@ void Wiz::drawWizImageEx(uint8 *dst, uint8 *dataPtr, uint8 *maskPtr, int dstPitc
 			dst = _vm->getMaskBuffer(0, 0, 1);
 			dstPitch /= _vm->_bytesPerPixel;
 			copyWizImageWithMask(dst, wizd, dstPitch, dstw, dsth, srcx, srcy, srcw, srch, rect, 0, 1);
-		} else {
+		} else if (xmapPtr || !drawWizImageSpans(dst, wizd, 1, width, height, dstPitch, dstType, dstw, dsth, srcx, srcy, srcw, srch, rect, flags, palPtr, bitDepth)) {
 			copyWizImage(dst, wizd, dstPitch, dstType, dstw, dsth, srcx, srcy, srcw, srch, rect, flags, palPtr, xmapPtr, bitDepth);
 		}
 		break;
@@ -1642,7 +1717,8 @@ void Wiz::drawWizImageEx(uint8 *dst, uint8 *dataPtr, uint8 *maskPtr, int dstPitc
 		copyCompositeWizImage(dst, dataPtr, wizd, maskPtr, dstPitch, dstType, dstw, dsth, srcx, srcy, srcw, srch, state, rect, flags, palPtr, transColor, bitDepth, xmapPtr, conditionBits);
 		break;
 	case 5:
-		copy16BitWizImage(dst, wizd, dstPitch, dstType, dstw, dsth, srcx, srcy, srcw, srch, rect, flags, xmapPtr);
+		if (xmapPtr || !drawWizImageSpans(dst, wizd, 2, width, height, dstPitch, dstType, dstw, dsth, srcx, srcy, srcw, srch, rect, flags, 0, bitDepth))
+			copy16BitWizImage(dst, wizd, dstPitch, dstType, dstw, dsth, srcx, srcy, srcw, srch, rect, flags, xmapPtr);
 		break;
 	case 9:
 		copy555WizImage(dst, wizd, dstPitch, dstType, dstw, dsth, srcx, srcy, rect, conditionBits);
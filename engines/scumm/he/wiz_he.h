@@ -25,6 +25,8 @@
 
 #include "common/rect.h"
 
+#include "scumm/stripcache.h"
+
 namespace Scumm {
 
 struct WizPolygon {
@@ -240,10 +242,29 @@ public:
 		NUM_IMAGES   = 255
 	};
 
+	enum {
+		/** Size of the span cache unless configured otherwise. */
+		kDefaultSpanCacheSize = 2 * 1024 * 1024
+	};
+
+	struct PolygonStats {
+		uint32 queries, rejected, tests;
+
+		PolygonStats() { reset(); }
+
+		void reset() {
+			queries = rejected = tests = 0;
+		}
+	};
+
 	WizImage _images[NUM_IMAGES];
 	uint16 _imagesNum;
 	WizPolygon _polygons[NUM_POLYGONS];
 
+	/** The span lists of the run length encoded images, see WizSpans. */
+	StripCache _spanCache;
+	PolygonStats _polygonStats;
+
 	Wiz(ScummEngine_v71he *vm);
 
 	void clearWizBuffer();
@@ -259,6 +280,7 @@ public:
 	int polygonHit(int id, int x, int y);
 	bool polygonDefined(int id);
 	bool polygonContains(const WizPolygon &pol, int x, int y);
+	void polygonUpdateBound();
 	void polygonRotatePoints(Common::Point *pts, int num, int alpha);
 	void polygonTransform(int resNum, int state, int po_x, int po_y, int angle, int zoom, Common::Point *vert);
 
@@ -309,6 +331,9 @@ public:
 			int dstw, int dsth, int srcx, int srcy, const Common::Rect *clipBox, uint32 conditionBits);
 #endif
 
+	bool drawWizImageSpans(uint8 *dst, const uint8 *wizd, int pixelSize, int width, int height, int dstPitch, int dstType,
+		int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, const uint8 *palPtr, uint8 bitDepth);
+
 	static void copyAuxImage(uint8 *dst1, uint8 *dst2, const uint8 *src, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, uint8 bitdepth);
 	static void copyWizImageWithMask(uint8 *dst, const uint8 *src, int dstPitch, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int maskT, int maskP);
 	static void copyWizImage(uint8 *dst, const uint8 *src, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitdepth);
@@ -334,6 +359,10 @@ public:
 
 private:
 	ScummEngine_v71he *_vm;
+
+	/** Bounds of all polygons, and the number of slots which may be in use. */
+	Common::Rect _polygonBound;
+	int _polygonSlots;
 };
 
 } // End of namespace Scumm
@@ -0,0 +1,231 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifdef ENABLE_HE
+
+#include "common/endian.h"
+
+#include "scumm/he/wiz_he.h"
+#include "scumm/he/wizspans_he.h"
+
+namespace Scumm {
+
+/**
+ * Walk through the codes of each line of an image and call the visitor for
+ * every span of visible pixels, clipped to the width of the image.
+ *
+ * @return	false if a line which is not empty ends before the width is covered
+ */
+template<class Visitor>
+static bool parseWizLines(const uint8 *src, int width, int height, int pixelSize, Visitor &visitor) {
+	const uint8 *dataPtr = src;
+
+	for (int y = 0; y < height; ++y) {
+		const uint16 lineSize = READ_LE_UINT16(dataPtr);
+		const uint8 *lineEnd = dataPtr + 2 + lineSize;
+		dataPtr += 2;
+		visitor.line(y);
+
+		if (lineSize != 0) {
+			int x = 0;
+			while (x < width) {
+				if (dataPtr >= lineEnd)
+					return false;
+
+				const uint8 code = *dataPtr++;
+				if (code & 1) {
+					x += code >> 1;
+				} else if (code & 2) {
+					const int length = MIN<int>((code >> 2) + 1, width - x);
+					const uint32 color = pixelSize == 2 ? READ_LE_UINT16(dataPtr) : *dataPtr;
+					visitor.span(x, length, WizSpans::kRun | color);
+					x += length;
+					dataPtr += pixelSize;
+				} else {
+					const int count = (code >> 2) + 1;
+					visitor.span(x, MIN<int>(count, width - x), dataPtr - src);
+					x += count;
+					dataPtr += count * pixelSize;
+				}
+			}
+		}
+		dataPtr = lineEnd;
+	}
+	visitor.line(height);
+
+	return true;
+}
+
+struct WizSpanCounter {
+	uint32 count;
+
+	WizSpanCounter() : count(0) {}
+
+	void line(int y) {}
+	void span(int x, int length, uint32 data) { ++count; }
+};
+
+struct WizSpanWriter {
+	uint32 *lines;
+	WizSpans::Span *spans;
+	uint32 count;
+
+	WizSpanWriter(byte *buffer, int height) : count(0) {
+		lines = (uint32 *)buffer + 1;
+		spans = (WizSpans::Span *)(lines + height + 1);
+	}
+
+	void line(int y) {
+		lines[y] = count;
+	}
+
+	void span(int x, int length, uint32 data) {
+		WizSpans::Span &span = spans[count++];
+		span.x = x;
+		span.length = length;
+		span.data = data;
+	}
+};
+
+uint32 WizSpans::measure(const uint8 *src, int width, int height, int pixelSize) {
+	if (width <= 0 || height <= 0 || width > 0xFFFF)
+		return 0;
+
+	WizSpanCounter counter;
+	if (!parseWizLines(src, width, height, pixelSize, counter))
+		return 0;
+
+	return (height + 2) * sizeof(uint32) + counter.count * sizeof(Span);
+}
+
+void WizSpans::build(byte *spans, const uint8 *src, int width, int height, int pixelSize) {
+	WizSpanWriter writer(spans, height);
+	WRITE_UINT32(spans, height);
+	parseWizLines(src, width, height, pixelSize, writer);
+}
+
+static inline void writeWizPixel16(uint8 *dstPtr, int dstType, uint16 color) {
+	if (dstType == kDstMemory || dstType == kDstResource)
+		WRITE_LE_UINT16(dstPtr, color);
+	else
+		WRITE_UINT16(dstPtr, color);
+}
+
+static void fillWizPixels16(uint8 *dstPtr, int dstType, uint16 color, int count) {
+	while (count--) {
+		writeWizPixel16(dstPtr, dstType, color);
+		dstPtr += 2;
+	}
+}
+
+bool WizSpans::draw(uint8 *dst, int dstPitch, int dstType, const byte *spans, const uint8 *src, int pixelSize,
+                    const Common::Rect &srcRect, int flags, int type, const uint8 *palPtr, uint8 bitDepth) {
+	if (type != kWizCopy && type != kWizRMap)
+		return false;
+	if (type == kWizRMap && (!palPtr || pixelSize != 1))
+		return false;
+	if (pixelSize == 1 && bitDepth != 1 && bitDepth != 2)
+		return false;
+	if (dstType < kDstScreen || dstType > kDstCursor)
+		return false;
+
+	// 16 bit images ignore the depth of the surface.
+	const int dstBytes = pixelSize == 2 ? 2 : bitDepth;
+	const int w = srcRect.width();
+	const int h = srcRect.height();
+	if (w <= 0 || h <= 0)
+		return true;
+
+	const uint32 height = READ_UINT32(spans);
+	const uint32 *lines = (const uint32 *)spans + 1;
+	const Span *first = (const Span *)(lines + height + 1);
+	const bool flipX = (flags & kWIFFlipX) != 0;
+	const bool flipY = (flags & kWIFFlipY) != 0;
+
+#ifdef SCUMM_LITTLE_ENDIAN
+	const bool copy16 = true;
+#else
+	const bool copy16 = dstType == kDstMemory || dstType == kDstResource;
+#endif
+
+	for (int y = srcRect.top; y < srcRect.bottom && y < (int)height; ++y) {
+		uint8 *line = dst + (flipY ? h - 1 - (y - srcRect.top) : y - srcRect.top) * dstPitch;
+		const Span *end = first + lines[y + 1];
+
+		for (const Span *span = first + lines[y]; span < end; ++span) {
+			if (span->x >= srcRect.right)
+				break;
+			const int x0 = MAX<int>(span->x, srcRect.left);
+			const int x1 = MIN<int>(span->x + span->length, srcRect.right);
+			if (x0 >= x1)
+				continue;
+
+			const int count = x1 - x0;
+			uint8 *dstPtr = line + (flipX ? srcRect.right - x1 : x0 - srcRect.left) * dstBytes;
+
+			if (span->data & kRun) {
+				const uint16 color = span->data & 0xFFFF;
+				if (pixelSize == 2)
+					fillWizPixels16(dstPtr, dstType, color, count);
+				else if (bitDepth == 1)
+					memset(dstPtr, type == kWizRMap ? palPtr[color] : color, count);
+				else
+					fillWizPixels16(dstPtr, dstType, type == kWizRMap ? READ_LE_UINT16(palPtr + color * 2) : color, count);
+				continue;
+			}
+
+			const uint8 *dataPtr = src + span->data + (x0 - span->x) * pixelSize;
+			if (pixelSize == 2) {
+				if (!flipX && copy16) {
+					memcpy(dstPtr, dataPtr, count * 2);
+				} else {
+					for (int i = 0; i < count; ++i)
+						writeWizPixel16(dstPtr + (flipX ? count - 1 - i : i) * 2, dstType, READ_LE_UINT16(dataPtr + i * 2));
+				}
+			} else if (bitDepth == 1) {
+				if (!flipX && type == kWizCopy) {
+					memcpy(dstPtr, dataPtr, count);
+				} else if (type == kWizCopy) {
+					for (int i = 0; i < count; ++i)
+						dstPtr[count - 1 - i] = dataPtr[i];
+				} else if (!flipX) {
+					for (int i = 0; i < count; ++i)
+						dstPtr[i] = palPtr[dataPtr[i]];
+				} else {
+					for (int i = 0; i < count; ++i)
+						dstPtr[count - 1 - i] = palPtr[dataPtr[i]];
+				}
+			} else {
+				for (int i = 0; i < count; ++i) {
+					const uint16 color = type == kWizRMap ? READ_LE_UINT16(palPtr + dataPtr[i] * 2) : dataPtr[i];
+					writeWizPixel16(dstPtr + (flipX ? count - 1 - i : i) * 2, dstType, color);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+} // End of namespace Scumm
+
+#endif // ENABLE_HE
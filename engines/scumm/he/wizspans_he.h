@@ -0,0 +1,90 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#if !defined(SCUMM_HE_WIZSPANS_HE_H) && defined(ENABLE_HE)
+#define SCUMM_HE_WIZSPANS_HE_H
+
+#include "common/rect.h"
+
+namespace Scumm {
+
+/**
+ * The lines of a run length encoded Wiz image (compression type 1, or 5
+ * for 16 bit pixels) as lists of spans of visible pixels.
+ *
+ * Decoding an image means parsing every code of every line, and then
+ * writing the pixels one at a time. Sprites which are drawn every frame
+ * are parsed once into spans instead, which know where they start, and
+ * whether they are a run of one color or a copy of literal pixels from
+ * the image data. Drawing from spans can then skip clipped lines and
+ * spans directly and copy or fill whole spans at once.
+ *
+ * The spans are kept in one buffer: the number of lines, the index of the
+ * first span of each line, and then the spans themselves. Literal spans refer to the
+ * pixels in the image data, which therefore has to stay where it is.
+ */
+class WizSpans {
+public:
+	struct Span {
+		uint16 x;
+		uint16 length;
+		/** Offset of the literal pixels in the image data, or the color of a run with kRun set. */
+		uint32 data;
+	};
+
+	enum {
+		kRun = 0x80000000
+	};
+
+	/**
+	 * Measure the buffer needed for the spans of an image.
+	 *
+	 * @param pixelSize	1 for 8 bit images, 2 for 16 bit ones
+	 * @return	the size in bytes, or 0 if the image cannot be drawn from
+	 *			spans, as it has lines which do not describe all pixels
+	 */
+	static uint32 measure(const uint8 *src, int width, int height, int pixelSize);
+
+	/** Fill a buffer of the size measure() returned. */
+	static void build(byte *spans, const uint8 *src, int width, int height, int pixelSize);
+
+	/**
+	 * Draw part of an image, with the same results as
+	 * Wiz::decompressWizImage or Wiz::decompress16BitWizImage.
+	 *
+	 * Supported are 8 bit images drawn with or without a palette to 8 or
+	 * 16 bit surfaces, and 16 bit images drawn without a shadow map.
+	 *
+	 * @param dst		receives the top left pixel of srcRect
+	 * @param type		kWizCopy or kWizRMap
+	 * @param srcRect	the part of the image to draw
+	 * @param flags		kWIFFlipX and kWIFFlipY are honored
+	 * @param palPtr	for kWizRMap, the palette map or the 16 bit colors
+	 * @return	false if the combination is not supported
+	 */
+	static bool draw(uint8 *dst, int dstPitch, int dstType, const byte *spans, const uint8 *src, int pixelSize,
+	                 const Common::Rect &srcRect, int flags, int type, const uint8 *palPtr, uint8 bitDepth);
+};
+
+} // End of namespace Scumm
+
+#endif
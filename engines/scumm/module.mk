@@ -6,12 +6,16 @@ MODULE_OBJS := \
 	base-costume.o \
 	bomp.o \
 	boxes.o \
+	boxroute.o \
 	camera.o \
 	cdda.o \
 	charset.o \
 	charset-fontdata.o \
+	compose16.o \
 	costume.o \
+	costume-codec1.o \
 	cursor.o \
+	damage.o \
 	debugger.o \
 	detection.o \
 	dialogs.o \
@@ -37,6 +41,8 @@ MODULE_OBJS := \
 	input.o \
 	midiparser_ro.o \
 	object.o \
+	offsetcache.o \
+	opcodeprofile.o \
 	palette.o \
 	players/player_ad.o \
 	players/player_apple2.o \
@@ -60,8 +66,10 @@ MODULE_OBJS := \
 	resource_v3.o \
 	resource_v4.o \
 	resource.o \
+	respolicy.o \
 	room.o \
 	saveload.o \
+	savewriter.o \
 	script_v0.o \
 	script_v2.o \
 	script_v3.o \
@@ -72,6 +80,7 @@ MODULE_OBJS := \
 	scumm.o \
 	sound.o \
 	string.o \
+	stripcache.o \
 	usage_bits.o \
 	util.o \
 	vars.o \
@@ -105,6 +114,7 @@ MODULE_OBJS += \
 	smush/codec47.o \
 	smush/imuse_channel.o \
 	smush/smush_player.o \
+	smush/smush_queue.o \
 	smush/saud_channel.o \
 	smush/smush_mixer.o \
 	smush/smush_font.o
@@ -135,6 +145,7 @@ MODULE_OBJS += \
 	he/script_v100he.o \
 	he/sprite_he.o \
 	he/wiz_he.o \
+	he/wizspans_he.o \
 	he/logic/baseball2001.o \
 	he/logic/basketball.o \
 	he/logic/football.o \
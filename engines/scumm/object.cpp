@@ -1771,7 +1771,7 @@ void ScummEngine_v6::drawBlastObject(BlastObject *eo) {
 
 	drawBomp(bdd);
 
-	markRectAsDirty(vs->number, bdd.x, bdd.x + bdd.srcwidth, bdd.y, bdd.y + bdd.srcheight);
+	markRectAsDirty(vs->number, bdd.x, bdd.x + bdd.srcwidth, bdd.y, bdd.y + bdd.srcheight, 0, kDamageObject);
 }
 
 void ScummEngine_v6::removeBlastObjects() {
@@ -1809,7 +1809,7 @@ void ScummEngine_v6::removeBlastObject(BlastObject *eo) {
 	for (i = left_strip; i <= right_strip; i++)
 		_gdi->resetBackground(r.top, r.bottom, i);
 
-	markRectAsDirty(kMainVirtScreen, r, USAGE_BIT_RESTORED);
+	markRectAsDirty(kMainVirtScreen, r, USAGE_BIT_RESTORED, kDamageObject);
 }
 
 int ScummEngine::findLocalObjectSlot() {
@@ -0,0 +1,205 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/offsetcache.h"
+
+#include "common/endian.h"
+#include "common/md5.h"
+#include "common/stream.h"
+
+namespace Scumm {
+
+ResourceOffsetCache::ResourceOffsetCache() : _enabled(true), _dirty(false), _current(0) {
+	resetStats();
+}
+
+ResourceOffsetCache::~ResourceOffsetCache() {
+	clear();
+}
+
+void ResourceOffsetCache::setEnabled(bool enabled) {
+	_enabled = enabled;
+	if (!enabled)
+		_current = 0;
+}
+
+void ResourceOffsetCache::clear() {
+	for (FileMap::iterator i = _files.begin(); i != _files.end(); ++i)
+		delete i->_value;
+	_files.clear();
+	_current = 0;
+	_dirty = false;
+}
+
+void ResourceOffsetCache::openFile(const Common::String &name, Common::SeekableReadStream &stream) {
+	_current = 0;
+	if (!_enabled)
+		return;
+
+	FileMap::iterator i = _files.find(name);
+	FileRecord *record;
+	if (i == _files.end()) {
+		record = new FileRecord;
+		record->size = 0;
+		record->checked = false;
+		_files[name] = record;
+	} else {
+		record = i->_value;
+	}
+
+	if (!record->checked) {
+		const uint32 size = stream.size();
+		stream.seek(0, SEEK_SET);
+		const Common::String md5 = Common::computeStreamMD5AsString(stream, kChecksumBytes);
+		stream.seek(0, SEEK_SET);
+
+		if (record->size != size || record->md5 != md5) {
+			if (!record->entries.empty()) {
+				record->entries.clear();
+				_stats.invalidated++;
+				_dirty = true;
+			}
+			record->size = size;
+			record->md5 = md5;
+		}
+		record->checked = true;
+	}
+
+	_current = record;
+}
+
+bool ResourceOffsetCache::lookup(int type, int idx, uint32 &offset, uint32 &size) {
+	if (!_current)
+		return false;
+
+	EntryMap::const_iterator i = _current->entries.find(makeKey(type, idx));
+	if (i == _current->entries.end()) {
+		_stats.misses++;
+		return false;
+	}
+
+	offset = i->_value.offset;
+	size = i->_value.size;
+	_stats.hits++;
+	return true;
+}
+
+void ResourceOffsetCache::store(int type, int idx, uint32 offset, uint32 size) {
+	if (!_current)
+		return;
+
+	const uint32 key = makeKey(type, idx);
+	EntryMap::const_iterator i = _current->entries.find(key);
+	if (i != _current->entries.end() && i->_value.offset == offset && i->_value.size == size)
+		return;
+
+	Entry entry;
+	entry.offset = offset;
+	entry.size = size;
+	_current->entries[key] = entry;
+	_dirty = true;
+}
+
+uint ResourceOffsetCache::getEntryCount() const {
+	uint count = 0;
+	for (FileMap::const_iterator i = _files.begin(); i != _files.end(); ++i)
+		count += i->_value->entries.size();
+	return count;
+}
+
+bool ResourceOffsetCache::load(Common::SeekableReadStream &stream) {
+	clear();
+
+	if (stream.readUint32BE() != MKTAG('S','O','F','C') || stream.readUint32LE() != kVersion)
+		return false;
+
+	uint32 numFiles = stream.readUint32LE();
+	while (numFiles-- && !stream.eos() && !stream.err()) {
+		FileRecord *record = new FileRecord;
+		Common::String name;
+
+		uint len = stream.readUint16LE();
+		while (len--)
+			name += (char)stream.readByte();
+		record->size = stream.readUint32LE();
+		len = stream.readByte();
+		while (len--)
+			record->md5 += (char)stream.readByte();
+		record->checked = false;
+
+		uint32 numEntries = stream.readUint32LE();
+		while (numEntries-- && !stream.eos()) {
+			const uint32 key = stream.readUint32LE();
+			Entry &entry = record->entries[key];
+			entry.offset = stream.readUint32LE();
+			entry.size = stream.readUint32LE();
+		}
+
+		delete _files[name];
+		_files[name] = record;
+	}
+
+	if (stream.eos() || stream.err()) {
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+void ResourceOffsetCache::save(Common::WriteStream &stream) {
+	stream.writeUint32BE(MKTAG('S','O','F','C'));
+	stream.writeUint32LE(kVersion);
+
+	stream.writeUint32LE(_files.size());
+	for (FileMap::const_iterator i = _files.begin(); i != _files.end(); ++i) {
+		const FileRecord *record = i->_value;
+
+		stream.writeUint16LE(i->_key.size());
+		stream.write(i->_key.c_str(), i->_key.size());
+		stream.writeUint32LE(record->size);
+		stream.writeByte(record->md5.size());
+		stream.write(record->md5.c_str(), record->md5.size());
+
+		stream.writeUint32LE(record->entries.size());
+		for (EntryMap::const_iterator e = record->entries.begin(); e != record->entries.end(); ++e) {
+			stream.writeUint32LE(e->_key);
+			stream.writeUint32LE(e->_value.offset);
+			stream.writeUint32LE(e->_value.size);
+		}
+	}
+
+	_dirty = false;
+}
+
+void ResourceOffsetCache::addRoomLoad(uint32 millis) {
+	_stats.roomLoads++;
+	_stats.roomLoadMillis += millis;
+	if (millis > _stats.roomLoadMaxMillis)
+		_stats.roomLoadMaxMillis = millis;
+}
+
+void ResourceOffsetCache::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+} // End of namespace Scumm
@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_OFFSETCACHE_H
+#define SCUMM_OFFSETCACHE_H
+
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+
+namespace Common {
+class SeekableReadStream;
+class WriteStream;
+}
+
+namespace Scumm {
+
+/**
+ * Remembers where in the data files the resources were found, so that
+ * loading them again, also in later sessions, takes a single seek and read
+ * instead of walking the block headers.
+ *
+ * The locations are recorded per data file, together with its size and the
+ * MD5 of its beginning. Whenever a data file is opened for the first time,
+ * it is compared against these and all locations recorded for it are
+ * dropped if it changed.
+ */
+class ResourceOffsetCache {
+public:
+	enum {
+		kVersion = 1,
+		/** Number of bytes at the start of a data file covered by the MD5. */
+		kChecksumBytes = 5000
+	};
+
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		/** Files whose recorded locations had to be dropped. */
+		uint32 invalidated;
+		uint32 roomLoads;
+		uint32 roomLoadMillis;
+		uint32 roomLoadMaxMillis;
+	};
+
+	ResourceOffsetCache();
+	~ResourceOffsetCache();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return _enabled; }
+
+	/** Forget all recorded locations. */
+	void clear();
+
+	/**
+	 * Make the data file which was just opened the one lookup() and store()
+	 * refer to. The stream is left at its start.
+	 */
+	void openFile(const Common::String &name, Common::SeekableReadStream &stream);
+	void closeFile() { _current = 0; }
+
+	/** Return the location of a resource in the current data file. */
+	bool lookup(int type, int idx, uint32 &offset, uint32 &size);
+	void store(int type, int idx, uint32 offset, uint32 size);
+
+	/** Return whether anything was recorded since the last load() or save(). */
+	bool isDirty() const { return _dirty; }
+
+	/**
+	 * Read the locations written by save(). Nothing is read if the data is
+	 * not in the expected format.
+	 */
+	bool load(Common::SeekableReadStream &stream);
+	void save(Common::WriteStream &stream);
+
+	uint getFileCount() const { return _files.size(); }
+	uint getEntryCount() const;
+
+	void addRoomLoad(uint32 millis);
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
+private:
+	struct Entry {
+		uint32 offset;
+		uint32 size;
+	};
+
+	typedef Common::HashMap<uint32, Entry> EntryMap;
+
+	struct FileRecord {
+		uint32 size;
+		Common::String md5;
+		/** Whether the file was compared against size and md5 in this session. */
+		bool checked;
+		EntryMap entries;
+	};
+
+	typedef Common::HashMap<Common::String, FileRecord *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileMap;
+
+	static uint32 makeKey(int type, int idx) { return ((uint32)type << 16) | (uint16)idx; }
+
+	bool _enabled;
+	bool _dirty;
+	FileMap _files;
+	FileRecord *_current;
+	Stats _stats;
+};
+
+} // End of namespace Scumm
+
+#endif
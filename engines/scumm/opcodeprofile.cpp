@@ -0,0 +1,60 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/opcodeprofile.h"
+
+#include "common/algorithm.h"
+
+namespace Scumm {
+
+static bool moreFrequent(const OpcodeProfile::Entry &a, const OpcodeProfile::Entry &b) {
+	if (a.count != b.count)
+		return a.count > b.count;
+	return a.opcode < b.opcode;
+}
+
+OpcodeProfile::OpcodeProfile() : _enabled(false) {
+	reset();
+}
+
+void OpcodeProfile::reset() {
+	memset(_counts, 0, sizeof(_counts));
+	_total = 0;
+}
+
+void OpcodeProfile::getTop(uint num, Common::Array<Entry> &entries) const {
+	entries.clear();
+	for (int i = 0; i < 256; ++i) {
+		if (_counts[i]) {
+			Entry entry;
+			entry.opcode = i;
+			entry.count = _counts[i];
+			entries.push_back(entry);
+		}
+	}
+
+	Common::sort(entries.begin(), entries.end(), moreFrequent);
+	if (entries.size() > num)
+		entries.resize(num);
+}
+
+} // End of namespace Scumm
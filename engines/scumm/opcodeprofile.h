@@ -0,0 +1,70 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_OPCODEPROFILE_H
+#define SCUMM_OPCODEPROFILE_H
+
+#include "common/array.h"
+
+namespace Scumm {
+
+/**
+ * Counts how often each opcode gets executed. The debugger shows the
+ * result, which tells which opcodes are worth optimizing.
+ */
+class OpcodeProfile {
+public:
+	struct Entry {
+		byte opcode;
+		uint32 count;
+	};
+
+	OpcodeProfile();
+
+	void setEnabled(bool enabled) { _enabled = enabled; }
+	bool isEnabled() const { return _enabled; }
+
+	void count(byte opcode) {
+		_counts[opcode]++;
+		_total++;
+	}
+
+	void reset();
+
+	uint32 getCount(byte opcode) const { return _counts[opcode]; }
+	uint64 getTotal() const { return _total; }
+
+	/**
+	 * Fill entries with the num most frequently executed opcodes, most
+	 * frequent first. Opcodes which never ran are left out.
+	 */
+	void getTop(uint num, Common::Array<Entry> &entries) const;
+
+private:
+	bool _enabled;
+	uint32 _counts[256];
+	uint64 _total;
+};
+
+} // End of namespace Scumm
+
+#endif
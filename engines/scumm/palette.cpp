@@ -413,6 +413,7 @@ void ScummEngine::setAmigaPaletteFromPtr(const byte *ptr) {
 		}
 	}
 
+	_gdi->_stripCache.clear();
 	setDirtyColors(0, 255);
 }
 
@@ -576,6 +577,7 @@ void ScummEngine::initCycl(const byte *ptr) {
 			if (_colorUsedByCycle[_roomPalette[i]])
 				mapRoomPalette(i);
 		}
+		_gdi->_stripCache.clear();
 	}
 }
 
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/savefile.h"
 #include "common/str.h"
 #ifndef MACOSX
 #include "common/config-manager.h"
@@ -48,6 +49,7 @@ enum {
 	RF_USAGE_MAX = RF_USAGE,
 
 	RS_MODIFIED = 0x10,
+	RS_EXPIRED = 0x20,
 	RF_OFFHEAP = 0x40
 };
 
@@ -77,6 +79,7 @@ void ScummEngine::openRoom(const int room) {
 	/* Room -1 means close file */
 	if (room == -1) {
 		deleteRoomOffsets();
+		_offsetCache.closeFile();
 		_fileHandle->close();
 		return;
 	}
@@ -151,6 +154,7 @@ void ScummEngine::closeRoom() {
 	if (_lastLoadedRoom != -1) {
 		_lastLoadedRoom = -1;
 		deleteRoomOffsets();
+		_offsetCache.closeFile();
 		_fileHandle->close();
 	}
 }
@@ -205,6 +209,7 @@ bool ScummEngine::openResourceFile(const Common::String &filename, byte encByte)
 
 	if (openFile(*_fileHandle, filename, true)) {
 		_fileHandle->setEnc(encByte);
+		_offsetCache.openFile(filename, *_fileHandle);
 		return true;
 	}
 	return false;
@@ -644,6 +649,12 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 
 	openRoom(roomNr);
 
+	// Once the data was found, later loads need not look at the headers.
+	if (_offsetCache.lookup(type, idx, fileOffs, size)) {
+		_fileHandle->seek(fileOffs, SEEK_SET);
+		return readResourceData(type, idx, size);
+	}
+
 	_fileHandle->seek(fileOffs + _fileOffset, SEEK_SET);
 
 	if (_game.features & GF_OLD_BUNDLE) {
@@ -686,6 +697,12 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 		size = _fileHandle->readUint32BE();
 		_fileHandle->seek(-8, SEEK_CUR);
 	}
+
+	_offsetCache.store(type, idx, _fileHandle->pos(), size);
+	return readResourceData(type, idx, size);
+}
+
+int ScummEngine::readResourceData(ResType type, ResId idx, uint32 size) {
 	_fileHandle->read(_res->createResource(type, idx, size), size);
 
 	// dump the resource if requested
@@ -700,6 +717,31 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 	return 1;
 }
 
+void ScummEngine::loadOffsetCache() {
+	Common::InSaveFile *in = _saveFileMan->openForLoading(_targetName + ".ofs");
+	if (!in)
+		return;
+
+	if (!_offsetCache.load(*in))
+		debugC(DEBUG_RESOURCE, "Ignoring invalid resource offset cache '%s.ofs'", _targetName.c_str());
+	delete in;
+}
+
+void ScummEngine::saveOffsetCache() {
+	if (!_offsetCache.isEnabled() || !_offsetCache.isDirty())
+		return;
+
+	Common::OutSaveFile *out = _saveFileMan->openForSaving(_targetName + ".ofs", false);
+	if (!out)
+		return;
+
+	_offsetCache.save(*out);
+	out->finalize();
+	if (out->err())
+		warning("Can't write resource offset cache '%s.ofs'", _targetName.c_str());
+	delete out;
+}
+
 int ScummEngine::getResourceRoomNr(ResType type, ResId idx) {
 	if (type == rtRoom && _game.heversion < 70)
 		return idx;
@@ -770,6 +812,13 @@ byte *ScummEngine::getStringAddressVar(int i) {
 }
 
 void ResourceManager::increaseExpireCounter() {
+	if (_policy)
+		_policy->tick();
+	if (_trace) {
+		_trace->writeString("T\n");
+		_lastTracedAccess = 0xFFFFFFFF;
+	}
+
 	++_expireCounter;
 	if (_expireCounter == 0) {	// overflow?
 		increaseResourceCounters();
@@ -782,7 +831,7 @@ void ResourceManager::increaseResourceCounters() {
 		while (idx-- > 0) {
 			byte counter = _types[type][idx].getResourceCounter();
 			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(type, idx, counter + 1);
+				_types[type][idx].setResourceCounter(counter + 1);
 			}
 		}
 	}
@@ -790,6 +839,41 @@ void ResourceManager::increaseResourceCounters() {
 
 void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
 	_types[type][idx].setResourceCounter(counter);
+
+	if (!isTracked(type) || !_types[type][idx]._address)
+		return;
+
+	// Scripts set the counter to the maximum for resources they do not
+	// need anymore, every use resets it to 1.
+	if (counter == 1) {
+		if (_policy)
+			_policy->access(ResourcePolicy::makeKey(type, idx));
+		traceEvent('A', type, idx);
+	} else if (counter == RF_USAGE_MAX) {
+		if (_policy)
+			_policy->demote(ResourcePolicy::makeKey(type, idx));
+		traceEvent('D', type, idx);
+	}
+}
+
+void ResourceManager::traceEvent(char event, ResType type, ResId idx) {
+	if (!_trace)
+		return;
+
+	// Resources are used many times per iteration, one line is enough.
+	const uint32 key = ResourcePolicy::makeKey(type, idx);
+	if (event == 'A') {
+		if (key == _lastTracedAccess)
+			return;
+		_lastTracedAccess = key;
+	} else {
+		_lastTracedAccess = 0xFFFFFFFF;
+	}
+
+	if (event == 'L')
+		_trace->writeString(Common::String::format("L %d %d %u\n", type, idx, _types[type][idx]._size));
+	else
+		_trace->writeString(Common::String::format("%c %d %d\n", event, type, idx));
 }
 
 void ResourceManager::Resource::setResourceCounter(byte counter) {
@@ -831,9 +915,25 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 	memset(ptr, 0, size + SAFETY_AREA);
 	_allocatedSize += size;
 
-	_types[type][idx]._address = ptr;
-	_types[type][idx]._size = size;
-	setResourceCounter(type, idx, 1);
+	Resource &res = _types[type][idx];
+	res._address = ptr;
+	res._size = size;
+	res.setResourceCounter(1);
+
+	if (isTracked(type)) {
+		_stats.loads++;
+		_stats.loadBytes += size;
+		if (res.isExpired()) {
+			_stats.reloads++;
+			_stats.reloadBytes += size;
+			res.setExpired(false);
+		}
+
+		if (_policy)
+			_policy->load(ResourcePolicy::makeKey(type, idx), size);
+		traceEvent('L', type, idx);
+	}
+
 	return ptr;
 }
 
@@ -872,9 +972,14 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_policy = 0;
+	_trace = 0;
+	_lastTracedAccess = 0xFFFFFFFF;
 }
 
 ResourceManager::~ResourceManager() {
+	delete _policy;
+	_policy = 0;
 	freeResources();
 }
 
@@ -883,6 +988,43 @@ void ResourceManager::setHeapThreshold(int min, int max) {
 	assert(min <= max);
 	_maxHeapThreshold = max;
 	_minHeapThreshold = min;
+	if (_policy)
+		_policy->setCapacity(_maxHeapThreshold);
+}
+
+void ResourceManager::setPolicy(ResourcePolicy *policy) {
+	if (policy == _policy)
+		return;
+
+	delete _policy;
+	_policy = policy;
+	if (!_policy)
+		return;
+
+	// Tell the policy about everything loaded so far.
+	_policy->setCapacity(_maxHeapThreshold);
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		if (!isTracked(type))
+			continue;
+		for (ResId idx = 0; idx < _types[type].size(); idx++) {
+			if (_types[type][idx]._address)
+				_policy->load(ResourcePolicy::makeKey(type, idx), _types[type][idx]._size);
+		}
+	}
+}
+
+ResourcePolicy *ResourceManager::createPolicy(const Common::String &name) {
+	if (name.equalsIgnoreCase("arc")) {
+		ResourcePolicy *policy = new ArcResourcePolicy();
+		// Rooms take the longest to reload, and are needed again whenever
+		// the player walks back. Costumes come right after them.
+		policy->setTypeWeight(rtRoom, 200);
+		policy->setTypeWeight(rtRoomImage, 200);
+		policy->setTypeWeight(rtRoomScripts, 200);
+		policy->setTypeWeight(rtCostume, 150);
+		return policy;
+	}
+	return 0;
 }
 
 bool ResourceManager::validateResource(const char *str, ResType type, ResId idx) const {
@@ -897,6 +1039,28 @@ void ResourceManager::nukeResource(ResType type, ResId idx) {
 	byte *ptr = _types[type][idx]._address;
 	if (ptr != NULL) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
+		if (isTracked(type)) {
+			if (_policy)
+				_policy->drop(ResourcePolicy::makeKey(type, idx), _types[type][idx].isExpired());
+			traceEvent('F', type, idx);
+		}
+		// The memory may be reused for other data, so strips and cels
+		// decoded from it have to go.
+		_vm->_gdi->_stripCache.invalidate(ptr, _types[type][idx]._size);
+		if (type == rtCostume)
+			_vm->_celCache.invalidate(ptr, _types[type][idx]._size);
+#ifdef ENABLE_HE
+		if (type == rtImage && _vm->_game.heversion >= 71 && ((ScummEngine_v71he *)_vm)->_wiz)
+			((ScummEngine_v71he *)_vm)->_wiz->_spanCache.invalidate(ptr, _types[type][idx]._size);
+#endif
+		// The walkboxes of the room are replaced.
+		if (type == rtMatrix && idx == 2) {
+			_vm->_boxRouter.invalidate();
+			_vm->_boxGates.invalidate();
+		}
+		// Make the running script find its code again before the next fetch.
+		if (ptr == _vm->_scriptOrgPointer)
+			_vm->_scriptPinned = false;
 		_allocatedSize -= _types[type][idx]._size;
 		_types[type][idx].nuke();
 	}
@@ -1032,12 +1196,28 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
+void ResourceManager::Resource::setExpired(bool expired) {
+	if (expired)
+		_status |= RS_EXPIRED;
+	else
+		_status &= ~RS_EXPIRED;
+}
+
+bool ResourceManager::Resource::isExpired() const {
+	return (_status & RS_EXPIRED) != 0;
+}
+
 void ResourceManager::expireResources(uint32 size) {
 	byte best_counter;
 	ResType best_type;
 	int best_res = 0;
 	uint32 oldAllocatedSize;
 
+	if (_policy) {
+		expireResourcesByPolicy(size);
+		return;
+	}
+
 	if (_expireCounter != 0xFF) {
 		_expireCounter = 0xFF;
 		increaseResourceCounters();
@@ -1071,7 +1251,7 @@ void ResourceManager::expireResources(uint32 size) {
 
 		if (!best_type)
 			break;
-		nukeResource(best_type, best_res);
+		expireResource(best_type, best_res);
 	} while (size + _allocatedSize > _minHeapThreshold);
 
 	increaseResourceCounters();
@@ -1079,6 +1259,56 @@ void ResourceManager::expireResources(uint32 size) {
 	debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d", oldAllocatedSize, _allocatedSize);
 }
 
+/**
+ * Passes the checks expireResources does on each resource to the policy.
+ */
+class ResourceManager::ExpiryFilter : public ResourcePolicy::Filter {
+public:
+	ExpiryFilter(const ResourceManager *res) : _res(res) {}
+
+	bool canEvict(uint32 key) const {
+		const ResType type = (ResType)ResourcePolicy::getKeyType(key);
+		const ResId idx = ResourcePolicy::getKeyIndex(key);
+		return _res->canExpire(type, idx);
+	}
+
+private:
+	const ResourceManager *_res;
+};
+
+bool ResourceManager::canExpire(ResType type, ResId idx) const {
+	if (type < rtFirst || type > rtLast || idx >= _types[type].size() || !isTracked(type))
+		return false;
+	const Resource &tmp = _types[type][idx];
+	return !tmp.isLocked() && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap();
+}
+
+void ResourceManager::expireResource(ResType type, ResId idx) {
+	Resource &tmp = _types[type][idx];
+	_stats.expired++;
+	_stats.expiredBytes += tmp._size;
+	// Remembered until the resource is loaded again, for the statistics.
+	tmp.setExpired(true);
+	nukeResource(type, idx);
+}
+
+void ResourceManager::expireResourcesByPolicy(uint32 size) {
+	if (size + _allocatedSize < _maxHeapThreshold)
+		return;
+
+	const uint32 oldAllocatedSize = _allocatedSize;
+	const ExpiryFilter filter(this);
+
+	do {
+		uint32 key;
+		if (!_policy->selectVictim(filter, key))
+			break;
+		expireResource((ResType)ResourcePolicy::getKeyType(key), ResourcePolicy::getKeyIndex(key));
+	} while (size + _allocatedSize > _minHeapThreshold);
+
+	debugC(DEBUG_RESOURCE, "Expired resources (%s), mem %d -> %d", _policy->getName(), oldAllocatedSize, _allocatedSize);
+}
+
 void ResourceManager::freeResources() {
 	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
 		ResId idx = _types[type].size();
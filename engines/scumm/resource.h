@@ -24,8 +24,13 @@
 #define SCUMM_RESOURCE_H
 
 #include "common/array.h"
+#include "scumm/respolicy.h"
 #include "scumm/scumm.h"	// for ResType
 
+namespace Common {
+class WriteStream;
+}
+
 namespace Scumm {
 
 enum {
@@ -145,6 +150,10 @@ public:
 		void setOffHeap();
 		void setOnHeap();
 		bool isOffHeap() const;
+
+		/** Whether the resource was expired the last time it was freed. */
+		void setExpired(bool expired);
+		bool isExpired() const;
 	};
 
 	/**
@@ -171,16 +180,64 @@ public:
 	};
 	ResTypeData _types[rtLast + 1];
 
+	/**
+	 * How much data had to be loaded from the game data files, counting
+	 * only resources which can be reloaded.
+	 */
+	struct Stats {
+		uint32 loads, reloads, expired;
+		uint64 loadBytes, reloadBytes, expiredBytes;
+
+		Stats() { reset(); }
+
+		void reset() {
+			loads = reloads = expired = 0;
+			loadBytes = reloadBytes = expiredBytes = 0;
+		}
+	};
+
 protected:
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	ResourcePolicy *_policy;
+	Stats _stats;
+	Common::WriteStream *_trace;
+	uint32 _lastTracedAccess;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
+	uint32 getAllocatedSize() const { return _allocatedSize; }
+
+	/**
+	 * Let the given policy decide which resources to expire, instead of the
+	 * usage counters. The ResourceManager takes ownership of the policy; 0
+	 * switches back to the usage counters.
+	 */
+	void setPolicy(ResourcePolicy *policy);
+	ResourcePolicy *getPolicy() const { return _policy; }
+
+	/**
+	 * Create the policy with the given name ("arc"), with the type weights
+	 * suiting SCUMM games, or return 0 if there is no such policy.
+	 */
+	static ResourcePolicy *createPolicy(const Common::String &name);
+
+	Stats &getStats() { return _stats; }
+
+	/**
+	 * Record the life of all reloadable resources to the given stream, one
+	 * event per line: "L <type> <idx> <size>" when one is loaded,
+	 * "A <type> <idx>" when it is used, "D <type> <idx>" when a script marks
+	 * it as no longer needed, "F <type> <idx>" when it is freed and "T" once
+	 * per game loop iteration. The benchmarks replay such traces.
+	 */
+	void setTrace(Common::WriteStream *trace) { _trace = trace; }
+	Common::WriteStream *getTrace() const { return _trace; }
 
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
 	void freeResources();
@@ -228,7 +285,14 @@ public:
 //protected:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
+	class ExpiryFilter;
+
 	void expireResources(uint32 size);
+	void expireResourcesByPolicy(uint32 size);
+	bool canExpire(ResType type, ResId idx) const;
+	void expireResource(ResType type, ResId idx);
+	bool isTracked(ResType type) const { return _types[type]._mode != kDynamicResTypeMode; }
+	void traceEvent(char event, ResType type, ResId idx);
 };
 
 } // End of namespace Scumm
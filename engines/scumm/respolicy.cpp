@@ -0,0 +1,273 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/respolicy.h"
+
+#include "common/util.h"
+
+namespace Scumm {
+
+ResourcePolicy::ResourcePolicy() : _capacity(0) {
+	for (int i = 0; i < kMaxTypes; ++i)
+		_weights[i] = kDefaultWeight;
+}
+
+void ResourcePolicy::setTypeWeight(int type, uint weight) {
+	assert(type >= 0 && type < kMaxTypes);
+	_weights[type] = MIN<uint>(weight, 0xFFFF);
+}
+
+uint ResourcePolicy::getTypeWeight(int type) const {
+	assert(type >= 0 && type < kMaxTypes);
+	return _weights[type];
+}
+
+bool ResourcePolicy::isCheaperToEvict(uint32 keyA, uint32 sizeA, uint32 keyB, uint32 sizeB) const {
+	// Reloading costs a seek plus reading the data, weighted by type. Compare
+	// costA / sizeA < costB / sizeB without dividing.
+	const uint64 costA = (uint64)_weights[getKeyType(keyA) % kMaxTypes] * (kSeekCost + sizeA);
+	const uint64 costB = (uint64)_weights[getKeyType(keyB) % kMaxTypes] * (kSeekCost + sizeB);
+	return costA * MAX<uint32>(sizeB, 1) < costB * MAX<uint32>(sizeA, 1);
+}
+
+ArcResourcePolicy::ArcResourcePolicy() : _target(0), _tick(0) {
+	for (int i = 0; i < kListCount; ++i) {
+		_lists[i].head = _lists[i].tail = 0;
+		_lists[i].bytes = 0;
+		_lists[i].count = 0;
+	}
+}
+
+ArcResourcePolicy::~ArcResourcePolicy() {
+	for (NodeMap::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+		delete i->_value;
+}
+
+Common::String ArcResourcePolicy::getDescription() const {
+	return Common::String::format("T1 %u (%u KB), T2 %u (%u KB), B1 %u (%u KB), B2 %u (%u KB), T1 target %u KB",
+		_lists[kT1].count, _lists[kT1].bytes / 1024, _lists[kT2].count, _lists[kT2].bytes / 1024,
+		_lists[kB1].count, _lists[kB1].bytes / 1024, _lists[kB2].count, _lists[kB2].bytes / 1024,
+		_target / 1024);
+}
+
+void ArcResourcePolicy::setCapacity(uint32 bytes) {
+	ResourcePolicy::setCapacity(bytes);
+	_target = MIN(_target, bytes);
+	trimGhosts();
+}
+
+void ArcResourcePolicy::load(uint32 key, uint32 size) {
+	NodeMap::iterator i = _nodes.find(key);
+	Node *node;
+
+	if (i == _nodes.end()) {
+		node = new Node;
+		node->key = key;
+		node->size = size;
+		_nodes[key] = node;
+		linkFront(kT1, node);
+	} else {
+		node = i->_value;
+		const ListId list = (ListId)node->list;
+		unlinkNode(node);
+		node->size = size;
+
+		if (list == kB1) {
+			// Evicted from the recency list too early, T1 should grow.
+			const uint32 ratio = MAX<uint32>(_lists[kB2].bytes / MAX<uint32>(_lists[kB1].bytes, 1), 1);
+			_target = MIN<uint64>((uint64)_target + (uint64)ratio * size, _capacity);
+			linkFront(kT2, node);
+		} else if (list == kB2) {
+			const uint32 ratio = MAX<uint32>(_lists[kB1].bytes / MAX<uint32>(_lists[kB2].bytes, 1), 1);
+			const uint64 delta = (uint64)ratio * size;
+			_target = (delta < _target) ? _target - (uint32)delta : 0;
+			linkFront(kT2, node);
+		} else {
+			// Loaded again without being freed, count it as a use.
+			linkFront(list, node);
+		}
+	}
+
+	node->lastTick = _tick;
+	trimGhosts();
+}
+
+void ArcResourcePolicy::access(uint32 key) {
+	NodeMap::iterator i = _nodes.find(key);
+	if (i == _nodes.end())
+		return;
+
+	Node *node = i->_value;
+	if (node->list != kT1 && node->list != kT2)
+		return;
+
+	// Uses following each other closely belong together and do not make a
+	// resource frequently used, e.g. those of a room the player stays in.
+	const ListId list = (node->list == kT1 && _tick - node->lastTick <= kCorrelationTicks) ? kT1 : kT2;
+	if (node != _lists[list].head) {
+		unlinkNode(node);
+		linkFront(list, node);
+	}
+	node->lastTick = _tick;
+}
+
+void ArcResourcePolicy::demote(uint32 key) {
+	NodeMap::iterator i = _nodes.find(key);
+	if (i == _nodes.end())
+		return;
+
+	Node *node = i->_value;
+	if (node->list != kT1 && node->list != kT2)
+		return;
+
+	unlinkNode(node);
+	linkBack(kT1, node);
+}
+
+void ArcResourcePolicy::drop(uint32 key, bool evicted) {
+	NodeMap::iterator i = _nodes.find(key);
+	if (i == _nodes.end())
+		return;
+
+	Node *node = i->_value;
+	if (node->list != kT1 && node->list != kT2)
+		return;
+
+	if (evicted) {
+		const ListId ghosts = (node->list == kT1) ? kB1 : kB2;
+		unlinkNode(node);
+		linkFront(ghosts, node);
+		trimGhosts();
+	} else {
+		deleteNode(node);
+	}
+}
+
+bool ArcResourcePolicy::selectVictim(const Filter &filter, uint32 &key) {
+	ListId first = kT2, second = kT1;
+	if (_lists[kT1].bytes > _target || !_lists[kT2].count) {
+		first = kT1;
+		second = kT2;
+	}
+
+	Node *node = pickVictim(first, filter);
+	if (!node)
+		node = pickVictim(second, filter);
+	if (!node)
+		return false;
+
+	key = node->key;
+	return true;
+}
+
+int ArcResourcePolicy::getListOf(uint32 key) const {
+	NodeMap::const_iterator i = _nodes.find(key);
+	if (i == _nodes.end())
+		return -1;
+	return i->_value->list;
+}
+
+void ArcResourcePolicy::unlinkNode(Node *node) {
+	List &list = _lists[node->list];
+
+	if (node->prev)
+		node->prev->next = node->next;
+	else
+		list.head = node->next;
+
+	if (node->next)
+		node->next->prev = node->prev;
+	else
+		list.tail = node->prev;
+
+	list.bytes -= node->size;
+	list.count--;
+}
+
+void ArcResourcePolicy::linkFront(ListId id, Node *node) {
+	List &list = _lists[id];
+
+	node->list = id;
+	node->prev = 0;
+	node->next = list.head;
+	if (list.head)
+		list.head->prev = node;
+	else
+		list.tail = node;
+	list.head = node;
+
+	list.bytes += node->size;
+	list.count++;
+}
+
+void ArcResourcePolicy::linkBack(ListId id, Node *node) {
+	List &list = _lists[id];
+
+	node->list = id;
+	node->next = 0;
+	node->prev = list.tail;
+	if (list.tail)
+		list.tail->next = node;
+	else
+		list.head = node;
+	list.tail = node;
+
+	list.bytes += node->size;
+	list.count++;
+}
+
+void ArcResourcePolicy::deleteNode(Node *node) {
+	unlinkNode(node);
+	_nodes.erase(node->key);
+	delete node;
+}
+
+void ArcResourcePolicy::trimGhosts() {
+	while (_lists[kB1].tail && _lists[kB1].bytes > _capacity)
+		deleteNode(_lists[kB1].tail);
+
+	while (_lists[kB1].bytes + _lists[kB2].bytes > 2 * (uint64)_capacity) {
+		if (_lists[kB2].tail)
+			deleteNode(_lists[kB2].tail);
+		else
+			deleteNode(_lists[kB1].tail);
+	}
+}
+
+ArcResourcePolicy::Node *ArcResourcePolicy::pickVictim(ListId list, const Filter &filter) const {
+	Node *best = 0;
+	int candidates = 0;
+
+	for (Node *node = _lists[list].tail; node && candidates < kVictimWindow; node = node->prev) {
+		// Whatever was used in this iteration may still be referenced.
+		if (node->lastTick == _tick || !filter.canEvict(node->key))
+			continue;
+
+		if (!best || isCheaperToEvict(node->key, node->size, best->key, best->size))
+			best = node;
+		candidates++;
+	}
+
+	return best;
+}
+
+} // End of namespace Scumm
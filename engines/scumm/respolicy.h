@@ -0,0 +1,211 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_RESPOLICY_H
+#define SCUMM_RESPOLICY_H
+
+#include "common/hashmap.h"
+#include "common/str.h"
+
+namespace Scumm {
+
+/**
+ * Decides which resources the ResourceManager throws out when the heap
+ * grows too large. Without a policy, the ResourceManager falls back to its
+ * usage counters.
+ *
+ * Policies only see resources which can be reloaded from the game data
+ * files. Each is identified by a key made from its type and index. The
+ * ResourceManager reports when such a resource is loaded, used, marked as
+ * no longer needed by a script, or freed, and asks for a victim whenever
+ * memory has to be made available.
+ */
+class ResourcePolicy {
+public:
+	enum {
+		kMaxTypes = 32,
+		/** The weight of a type unless set otherwise, in percent. */
+		kDefaultWeight = 100,
+		/**
+		 * The cost of finding a resource in the data files, expressed as the
+		 * number of bytes which could have been read in the same time.
+		 */
+		kSeekCost = 16 * 1024
+	};
+
+	/** Tells the policy which resources are currently not evictable. */
+	class Filter {
+	public:
+		virtual ~Filter() {}
+		virtual bool canEvict(uint32 key) const = 0;
+	};
+
+	ResourcePolicy();
+	virtual ~ResourcePolicy() {}
+
+	static uint32 makeKey(int type, int idx) { return ((uint32)type << 16) | (uint16)idx; }
+	static int getKeyType(uint32 key) { return key >> 16; }
+	static int getKeyIndex(uint32 key) { return key & 0xFFFF; }
+
+	virtual const char *getName() const = 0;
+
+	/** A short summary of the internal state, for the debugger. */
+	virtual Common::String getDescription() const { return Common::String(); }
+
+	/** Set the number of bytes the resources may occupy. */
+	virtual void setCapacity(uint32 bytes) { _capacity = bytes; }
+	uint32 getCapacity() const { return _capacity; }
+
+	/**
+	 * Set how expensive it is to reload resources of a type, in percent of
+	 * the default. Resources with a high weight are kept longer.
+	 */
+	void setTypeWeight(int type, uint weight);
+	uint getTypeWeight(int type) const;
+
+	/** Called once per game loop iteration. */
+	virtual void tick() = 0;
+
+	virtual void load(uint32 key, uint32 size) = 0;
+	virtual void access(uint32 key) = 0;
+
+	/** A script declared that the resource is no longer needed. */
+	virtual void demote(uint32 key) = 0;
+
+	/**
+	 * The resource was freed.
+	 *
+	 * @param evicted	true if it was freed because the policy chose it
+	 */
+	virtual void drop(uint32 key, bool evicted) = 0;
+
+	/**
+	 * Choose the next resource to be freed.
+	 *
+	 * @return	false if none of the resources may be evicted
+	 */
+	virtual bool selectVictim(const Filter &filter, uint32 &key) = 0;
+
+protected:
+	/**
+	 * Return whether freeing resource a is cheaper than freeing resource b,
+	 * comparing the cost of reloading them per byte freed.
+	 */
+	bool isCheaperToEvict(uint32 keyA, uint32 sizeA, uint32 keyB, uint32 sizeB) const;
+
+	uint32 _capacity;
+	uint16 _weights[kMaxTypes];
+};
+
+/**
+ * Adaptive replacement cache, see N. Megiddo and D. S. Modha, "ARC: A
+ * Self-Tuning, Low Overhead Replacement Cache", FAST 2003.
+ *
+ * Resources used in one stretch only stay in the recency list T1, those
+ * used again after a while, e.g. when the player returns to a room, move to
+ * the frequency list T2. The lists
+ * B1 and B2 remember recently evicted resources. Reloading one of those
+ * shifts the target size of T1 towards the list which would have kept it.
+ * Unlike the original, all sizes are measured in bytes, and when choosing
+ * a victim the last few resources of a list are compared by their reload
+ * cost per byte.
+ *
+ * All bookkeeping is O(1), except that selectVictim has to skip the
+ * resources which are in use.
+ */
+class ArcResourcePolicy : public ResourcePolicy {
+public:
+	enum {
+		/** Number of evictable resources compared at the end of a list. */
+		kVictimWindow = 4,
+		/**
+		 * A resource which is used again within this many iterations of
+		 * its last use counts as used only once.
+		 */
+		kCorrelationTicks = 60
+	};
+
+	ArcResourcePolicy();
+	~ArcResourcePolicy();
+
+	const char *getName() const { return "arc"; }
+	Common::String getDescription() const;
+
+	void setCapacity(uint32 bytes);
+
+	void tick() { _tick++; }
+	void load(uint32 key, uint32 size);
+	void access(uint32 key);
+	void demote(uint32 key);
+	void drop(uint32 key, bool evicted);
+	bool selectVictim(const Filter &filter, uint32 &key);
+
+	/** The number of bytes T1 should occupy. */
+	uint32 getTarget() const { return _target; }
+
+	/** Return the list a resource is in, or -1 if it is unknown. */
+	int getListOf(uint32 key) const;
+
+	enum ListId {
+		kT1 = 0,
+		kT2 = 1,
+		kB1 = 2,
+		kB2 = 3,
+		kListCount
+	};
+
+	uint getListCount(ListId list) const { return _lists[list].count; }
+	uint32 getListBytes(ListId list) const { return _lists[list].bytes; }
+
+private:
+	struct Node {
+		uint32 key;
+		uint32 size;
+		uint32 lastTick;	///< the last iteration the resource was loaded or used in
+		byte list;
+		Node *prev, *next;
+	};
+
+	struct List {
+		Node *head, *tail;	///< most and least recently used
+		uint32 bytes;
+		uint count;
+	};
+
+	typedef Common::HashMap<uint32, Node *> NodeMap;
+
+	void unlinkNode(Node *node);
+	void linkFront(ListId list, Node *node);
+	void linkBack(ListId list, Node *node);
+	void deleteNode(Node *node);
+	void trimGhosts();
+	Node *pickVictim(ListId list, const Filter &filter) const;
+
+	NodeMap _nodes;
+	List _lists[kListCount];
+	uint32 _target;
+	uint32 _tick;
+};
+
+} // End of namespace Scumm
+
+#endif
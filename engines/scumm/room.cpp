@@ -103,6 +103,14 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 		// shadows tend to be rather black, don't they? ;-)
 		memset(_shadowPalette, 0, NUM_SHADOW_PALETTE * 256);
 	} else {
+		// Cached strips were remapped through the old room palette, so
+		// they only stay valid when it already was the identity map.
+		for (i = 0; i < 256; i++) {
+			if (_roomPalette[i] != i) {
+				_gdi->_stripCache.clear();
+				break;
+			}
+		}
 		for (i = 0; i < 256; i++) {
 			_roomPalette[i] = i;
 			if (_shadowPalette)
@@ -128,8 +136,11 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 	if (VAR_ROOM_RESOURCE != 0xFF)
 		VAR(VAR_ROOM_RESOURCE) = _roomResource;
 
-	if (room != 0)
+	if (room != 0) {
+		const uint32 loadStart = _system->getMillis();
 		ensureResourceLoaded(rtRoom, room);
+		_offsetCache.addRoomLoad(_system->getMillis() - loadStart);
+	}
 
 	clearRoomObjects();
 
@@ -731,8 +742,10 @@ void ScummEngine_v3old::resetRoomSubBlocks() {
 		error("Room %d: data not found (" __FILE__  ":%d)", _roomResource, __LINE__);
 
 	// Reset room color for V1 zak
-	if (_game.version <= 1)
+	if (_game.version <= 1) {
 		_roomPalette[0] = 0;
+		_gdi->_stripCache.clear();
+	}
 
 	//
 	// Load box data
@@ -142,6 +142,7 @@ bool ScummEngine::canSaveGameStateCurrently() {
 void ScummEngine::requestSave(int slot, const Common::String &name) {
 	_saveLoadSlot = slot;
 	_saveTemporaryState = false;
+	_saveInBackground = false;
 	_saveLoadFlag = 1;		// 1 for save
 	_saveLoadDescription = name;
 }
@@ -175,6 +176,12 @@ static bool saveSaveGameHeader(Common::WriteStream *out, SaveGameHeader &hdr) {
 }
 
 bool ScummEngine::saveState(Common::WriteStream *out, bool writeHeader) {
+	saveStateHeader(out, writeHeader);
+	saveStateData(out);
+	return true;
+}
+
+void ScummEngine::saveStateHeader(Common::WriteStream *out, bool writeHeader) {
 	SaveGameHeader hdr;
 
 	if (writeHeader) {
@@ -185,16 +192,22 @@ bool ScummEngine::saveState(Common::WriteStream *out, bool writeHeader) {
 	Graphics::saveThumbnail(*out);
 #endif
 	saveInfos(out);
+}
 
+void ScummEngine::saveStateData(Common::WriteStream *out) {
 	Common::Serializer ser(0, out);
 	ser.setVersion(CURRENT_VER);
 	saveLoadWithSerializer(ser);
-	return true;
 }
 
 bool ScummEngine::saveState(int slot, bool compat, Common::String &filename) {
 	bool saveFailed = false;
 
+	finishPendingSave();
+	// The file may be overwritten, so it cannot stand in for an unchanged
+	// autosave anymore.
+	_saveWriter.forgetDelta();
+
 	pauseEngine(true);
 
 	Common::WriteStream *out = openSaveFileForWriting(slot, compat, filename);
@@ -221,6 +234,70 @@ bool ScummEngine::saveState(int slot, bool compat, Common::String &filename) {
 }
 
 
+/**
+ * Take a snapshot of the game state in memory and leave compressing and
+ * writing it to the IncrementalSaveWriter, which does so over the following
+ * iterations of the game loop. If the game state did not change since the
+ * previous snapshot, the file already written is kept.
+ */
+bool ScummEngine::saveStateInBackground(int slot, Common::String &filename) {
+	finishPendingSave();
+
+	pauseEngine(true);
+
+	const uint32 start = _system->getMillis();
+	Common::MemoryWriteStreamDynamic snapshot(DisposeAfterUse::NO);
+	saveStateHeader(&snapshot, true);
+	const uint32 stateOffset = snapshot.size();
+	saveStateData(&snapshot);
+
+	byte *data = snapshot.getData();
+	const uint32 size = snapshot.size();
+	const uint32 changed = _saveWriter.updateDelta(data + stateOffset, size - stateOffset);
+	_saveWriter.addSnapshotTime(_system->getMillis() - start);
+
+	pauseEngine(false);
+
+	filename = makeSavegameName(slot, false);
+	if (!changed && !_saveFileMan->listSavefiles(filename).empty()) {
+		debug(1, "State in '%s' is unchanged", filename.c_str());
+		_saveWriter.addSkipped();
+		free(data);
+		return true;
+	}
+
+	Common::WriteStream *out = openSaveFileForWriting(slot, false, filename);
+	if (!out) {
+		debug(1, "State save as '%s' FAILED", filename.c_str());
+		_saveWriter.forgetDelta();
+		free(data);
+		return false;
+	}
+
+	_saveWriter.start(out, filename, data, size);
+	return true;
+}
+
+void ScummEngine::finishPendingSave() {
+	if (_saveWriter.isBusy() && !_saveWriter.finish())
+		pendingSaveFailed();
+}
+
+void ScummEngine::stepPendingSave() {
+	const uint32 start = _system->getMillis();
+	const bool more = _saveWriter.step();
+	_saveWriter.addStepTime(_system->getMillis() - start);
+	if (!more && _saveWriter.hasFailed())
+		pendingSaveFailed();
+}
+
+void ScummEngine::pendingSaveFailed() {
+	// The file is incomplete, so the next autosave has to be written in full
+	// even if the state did not change.
+	_saveWriter.forgetDelta();
+	warning("Failed to save game to file '%s'", _saveWriter.getName().c_str());
+}
+
 void ScummEngine_v4::prepareSavegame() {
 	Common::MemoryWriteStreamDynamic *memStream;
 	Common::WriteStream *writeStream;
@@ -323,6 +400,8 @@ bool ScummEngine::loadState(int slot, bool compat, Common::String &filename) {
 	SaveGameHeader hdr;
 	int sb, sh;
 
+	finishPendingSave();
+
 	Common::SeekableReadStream *in = openSaveFileForReading(slot, compat, filename);
 	if (!in)
 		return false;
@@ -560,6 +639,7 @@ bool ScummEngine::loadState(int slot, bool compat, Common::String &filename) {
 	clearTextSurface();
 
 	_lastCodePtr = NULL;
+	_scriptPinned = false;
 	_drawObjectQueNr = 0;
 	_verbMouseOver = 0;
 
@@ -631,6 +711,8 @@ bool ScummEngine::getSavegameName(int slot, Common::String &desc) {
 	Common::InSaveFile *in = 0;
 	bool result = false;
 
+	finishPendingSave();
+
 	desc.clear();
 	Common::String filename = makeSavegameName(slot, false);
 	in = _saveFileMan->openForLoading(filename);
@@ -1390,6 +1472,11 @@ void ScummEngine::saveLoadWithSerializer(Common::Serializer &s) {
 		}
 	}
 
+	// The loaded room palette may differ from the one cached strips were
+	// remapped with.
+	if (s.isLoading())
+		_gdi->_stripCache.clear();
+
 	//
 	// Save/load more global object state
 	//
@@ -1620,6 +1707,8 @@ void ScummEngine_v71he::saveLoadWithSerializer(Common::Serializer &s) {
 	ScummEngine_v70he::saveLoadWithSerializer(s);
 
 	s.syncArray(_wiz->_polygons, ARRAYSIZE(_wiz->_polygons), syncWithSerializer);
+	if (s.isLoading())
+		_wiz->polygonUpdateBound();
 }
 
 void syncWithSerializer(Common::Serializer &s, FloodFillParameters &ffp) {
@@ -0,0 +1,138 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/savewriter.h"
+
+#include "common/debug.h"
+#include "common/stream.h"
+#include "common/util.h"
+
+namespace Scumm {
+
+IncrementalSaveWriter::IncrementalSaveWriter()
+	: _out(0), _data(0), _size(0), _pos(0), _chunkSize(kDefaultChunkSize), _failed(false), _hasPrevious(false) {
+	resetStats();
+}
+
+IncrementalSaveWriter::~IncrementalSaveWriter() {
+	finish();
+}
+
+void IncrementalSaveWriter::start(Common::WriteStream *out, const Common::String &name, byte *data, uint32 size) {
+	finish();
+
+	_out = out;
+	_name = name;
+	_data = data;
+	_size = size;
+	_pos = 0;
+	_failed = false;
+
+	_stats.saves++;
+	_stats.bytes += size;
+}
+
+bool IncrementalSaveWriter::step() {
+	if (!_out)
+		return false;
+
+	const uint32 len = _chunkSize ? MIN(_chunkSize, _size - _pos) : _size - _pos;
+	if (_out->write(_data + _pos, len) != len)
+		_failed = true;
+	_pos += len;
+	_stats.chunks++;
+
+	if (_failed || _pos == _size) {
+		complete();
+		return false;
+	}
+	return true;
+}
+
+bool IncrementalSaveWriter::finish() {
+	while (step())
+		;
+	return !_failed;
+}
+
+bool IncrementalSaveWriter::complete() {
+	_out->finalize();
+	if (_out->err())
+		_failed = true;
+
+	if (_failed)
+		debug(1, "State save as '%s' FAILED", _name.c_str());
+	else
+		debug(1, "State saved as '%s'", _name.c_str());
+
+	delete _out;
+	_out = 0;
+	free(_data);
+	_data = 0;
+	return !_failed;
+}
+
+uint32 IncrementalSaveWriter::updateDelta(const byte *state, uint32 size) {
+	uint32 changed = 0;
+
+	if (!_hasPrevious) {
+		changed = size;
+	} else {
+		for (uint32 offset = 0; offset < size; offset += kDeltaBlockSize) {
+			const uint32 len = MIN<uint32>(kDeltaBlockSize, size - offset);
+			if (offset + len > _previous.size() || memcmp(state + offset, &_previous[offset], len))
+				changed += len;
+		}
+		if (size < _previous.size() && !changed)
+			changed = _previous.size() - size;
+	}
+
+	_previous.resize(size);
+	if (size)
+		memcpy(&_previous[0], state, size);
+	_hasPrevious = true;
+
+	_stats.changedBytes += changed;
+	return changed;
+}
+
+void IncrementalSaveWriter::forgetDelta() {
+	_previous.clear();
+	_hasPrevious = false;
+}
+
+void IncrementalSaveWriter::addSnapshotTime(uint32 millis) {
+	_stats.snapshotMillis += millis;
+	if (millis > _stats.maxSnapshotMillis)
+		_stats.maxSnapshotMillis = millis;
+}
+
+void IncrementalSaveWriter::addStepTime(uint32 millis) {
+	if (millis > _stats.maxStepMillis)
+		_stats.maxStepMillis = millis;
+}
+
+void IncrementalSaveWriter::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+} // End of namespace Scumm
@@ -0,0 +1,146 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_SAVEWRITER_H
+#define SCUMM_SAVEWRITER_H
+
+#include "common/array.h"
+#include "common/str.h"
+
+namespace Common {
+class WriteStream;
+}
+
+namespace Scumm {
+
+/**
+ * Writes a snapshot of the game state to a savegame file over several
+ * iterations of the game loop.
+ *
+ * Taking the snapshot in memory is fast. Compressing and writing it is what
+ * makes the game stop on slow storage, so the writer passes the snapshot to
+ * the (usually compressing) save file stream in chunks of a fixed size, one
+ * chunk per call to step().
+ *
+ * The writer also remembers the state part of the last snapshot, so that a
+ * new one can be compared against it block by block. Snapshots which did not
+ * change at all need not be written again.
+ */
+class IncrementalSaveWriter {
+public:
+	enum {
+		/** Number of bytes written per step unless set otherwise. */
+		kDefaultChunkSize = 32 * 1024,
+		/** Granularity of the comparison with the previous snapshot. */
+		kDeltaBlockSize = 4096
+	};
+
+	struct Stats {
+		uint32 saves;
+		uint32 skipped;			///< snapshots which did not have to be written
+		uint32 bytes;			///< size of all snapshots written
+		uint32 changedBytes;	///< bytes of the state which differed from the previous snapshot
+		uint32 chunks;
+		uint32 snapshotMillis;
+		uint32 maxSnapshotMillis;
+		uint32 maxStepMillis;
+	};
+
+	IncrementalSaveWriter();
+	~IncrementalSaveWriter();
+
+	/** Set the number of bytes written per step, 0 to write everything at once. */
+	void setChunkSize(uint32 bytes) { _chunkSize = bytes; }
+	uint32 getChunkSize() const { return _chunkSize; }
+
+	/**
+	 * Start writing a snapshot. Any save still in progress is finished
+	 * first.
+	 *
+	 * @param out	the stream to write to, deleted when done
+	 * @param name	the name of the file, for messages
+	 * @param data	the snapshot, allocated with malloc and freed when done
+	 * @param size	the size of the snapshot
+	 */
+	void start(Common::WriteStream *out, const Common::String &name, byte *data, uint32 size);
+
+	bool isBusy() const { return _out != 0; }
+	const Common::String &getName() const { return _name; }
+
+	/**
+	 * Write the next chunk.
+	 *
+	 * @return	true if there is more to write
+	 */
+	bool step();
+
+	/**
+	 * Write everything which is left.
+	 *
+	 * @return	false if the last save failed
+	 */
+	bool finish();
+
+	/**
+	 * Whether writing or finalizing the stream of the last save failed. The
+	 * file is then incomplete, so the next snapshot has to be written in
+	 * full even if it did not change.
+	 */
+	bool hasFailed() const { return _failed; }
+
+	/**
+	 * Compare the state part of a snapshot with the one passed last time,
+	 * then remember it for the next comparison.
+	 *
+	 * @return	the number of bytes in blocks which changed, everything if
+	 *			there was nothing to compare with
+	 */
+	uint32 updateDelta(const byte *state, uint32 size);
+	void forgetDelta();
+
+	void addSnapshotTime(uint32 millis);
+	void addStepTime(uint32 millis);
+	void addSkipped() { _stats.skipped++; }
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
+private:
+	bool complete();
+
+	Common::WriteStream *_out;
+	Common::String _name;
+	byte *_data;
+	uint32 _size;
+	uint32 _pos;
+	uint32 _chunkSize;
+	bool _failed;
+
+	Common::Array<byte> _previous;
+	bool _hasPrevious;
+
+	Stats _stats;
+};
+
+} // End of namespace Scumm
+
+#endif
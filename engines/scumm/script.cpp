@@ -21,6 +21,7 @@
  */
 
 #include "common/config-manager.h"
+#include "common/debug-channels.h"
 #include "common/util.h"
 #include "common/system.h"
 
@@ -433,6 +434,8 @@ void ScummEngine::getScriptBaseAddress() {
 		ss->status = ssDead;
 		_currentScript = 0xFF;
 	}
+
+	_scriptPinned = (_scriptDispatch != kDispatchClassic && _scriptOrgPointer != NULL);
 }
 
 void ScummEngine::resetScriptPointer() {
@@ -458,6 +461,13 @@ void ScummEngine::refreshScriptPointer() {
 
 /** Execute a script - Read opcode, and execute it from the table */
 void ScummEngine::executeScript() {
+	// The direct dispatch leaves out the debug output.
+	if (_scriptDispatch != kDispatchClassic && !_showStack && !_hexdumpScripts &&
+		!DebugMan.isDebugChannelEnabled(DEBUG_OPCODES)) {
+		executeScriptDirect();
+		return;
+	}
+
 	int c;
 	while (_currentScript != 0xFF) {
 
@@ -471,6 +481,8 @@ void ScummEngine::executeScript() {
 		_opcode = fetchScriptByte();
 		if (_game.version > 2) // V0-V2 games didn't use the didexec flag
 			vm.slot[_currentScript].didexec = true;
+		if (_opcodeProfile.isEnabled())
+			_opcodeProfile.count(_opcode);
 		debugC(DEBUG_OPCODES, "Script %d, offset 0x%x: [%X] %s()",
 				vm.slot[_currentScript].number,
 				(uint)(_scriptPointer - _scriptOrgPointer),
@@ -488,6 +500,51 @@ void ScummEngine::executeScript() {
 	}
 }
 
+/**
+ * Execute a script like executeScript, but call the opcode handlers
+ * directly and fetch from the pinned script pointer.
+ */
+void ScummEngine::executeScriptDirect() {
+	const bool verify = (_scriptDispatch == kDispatchVerify);
+
+	while (_currentScript != 0xFF) {
+		if (!_scriptPinned)
+			refreshScriptPointer();
+
+		if (verify) {
+			// The byte-stream path relocates against the current address of
+			// the code resource before it fetches.
+			const uint32 offs = _scriptPointer - _scriptOrgPointer;
+			const OpcodeFetch classic(_opcodes, *_lastCodePtr + offs);
+			if (classic.next != _scriptPointer + 1)
+				error("Script %d: code moved while pinned, at offset 0x%x",
+					vm.slot[_currentScript].number, offs);
+			const OpcodeFetch direct(_opcodes, _scriptPointer);
+			if (classic != direct || (direct.directProc != 0) != (direct.proc && direct.proc->isValid()))
+				error("Script %d: opcode 0x%x resolved differently, at offset 0x%x",
+					vm.slot[_currentScript].number, direct.opcode, offs);
+		}
+
+		_opcode = *_scriptPointer++;
+		if (_game.version > 2) // V0-V2 games didn't use the didexec flag
+			vm.slot[_currentScript].didexec = true;
+		if (_opcodeProfile.isEnabled())
+			_opcodeProfile.count(_opcode);
+
+		const OpcodeProc proc = _opcodes[_opcode].directProc;
+		if (proc)
+			(this->*proc)();
+		else
+			executeOpcode(_opcode);
+	}
+}
+
+void ScummEngine::setScriptDispatch(ScriptDispatch dispatch) {
+	_scriptDispatch = dispatch;
+	// Pinned again by the next refresh, if at all.
+	_scriptPinned = false;
+}
+
 void ScummEngine::executeOpcode(byte i) {
 	if (_opcodes[i].proc && _opcodes[i].proc->isValid())
 		(*_opcodes[i].proc)();
@@ -505,12 +562,14 @@ const char *ScummEngine::getOpcodeDesc(byte i) {
 }
 
 byte ScummEngine::fetchScriptByte() {
-	refreshScriptPointer();
+	if (!_scriptPinned)
+		refreshScriptPointer();
 	return *_scriptPointer++;
 }
 
 uint ScummEngine::fetchScriptWord() {
-	refreshScriptPointer();
+	if (!_scriptPinned)
+		refreshScriptPointer();
 	uint a = READ_LE_UINT16(_scriptPointer);
 	_scriptPointer += 2;
 	return a;
@@ -521,7 +580,8 @@ int ScummEngine::fetchScriptWordSigned() {
 }
 
 uint ScummEngine::fetchScriptDWord() {
-	refreshScriptPointer();
+	if (!_scriptPinned)
+		refreshScriptPointer();
 	uint a = READ_LE_UINT32(_scriptPointer);
 	_scriptPointer += 4;
 	return a;
@@ -27,43 +27,91 @@
 
 namespace Scumm {
 
+class ScummEngine;
+
 typedef Common::Functor0<void> Opcode;
 
+/** An opcode handler, resolved so that it can be called directly. */
+typedef void (ScummEngine::*OpcodeProc)();
+
 struct OpcodeEntry : Common::NonCopyable {
 	Opcode *proc;
+	OpcodeProc directProc;
 #ifndef REDUCE_MEMORY_USAGE
 	const char *desc;
 #endif
 
 #ifndef REDUCE_MEMORY_USAGE
-	OpcodeEntry() : proc(0), desc(0) {}
+	OpcodeEntry() : proc(0), directProc(0), desc(0) {}
 #else
-	OpcodeEntry() : proc(0) {}
+	OpcodeEntry() : proc(0), directProc(0) {}
 #endif
 	~OpcodeEntry() {
 		setProc(0, 0);
 	}
 
-	void setProc(Opcode *p, const char *d) {
+	void setProc(Opcode *p, const char *d, OpcodeProc dp = 0) {
 		if (proc != p) {
 			delete proc;
 			proc = p;
 		}
+		directProc = dp;
 #ifndef REDUCE_MEMORY_USAGE
 		desc = d;
 #endif
 	}
 };
 
+/**
+ * The outcome of fetching one opcode: where the script pointer is left and
+ * which handlers the opcode table selects. The direct dispatch checks its
+ * fetch from the pinned code against the one the byte-stream path would do
+ * from the current address of the code resource.
+ */
+struct OpcodeFetch {
+	const byte *next;
+	byte opcode;
+	const Opcode *proc;
+	OpcodeProc directProc;
+
+	OpcodeFetch(const OpcodeEntry *opcodes, const byte *pos) :
+		next(pos + 1), opcode(*pos), proc(opcodes[*pos].proc), directProc(opcodes[*pos].directProc) {}
+
+	bool operator==(const OpcodeFetch &other) const {
+		return next == other.next && opcode == other.opcode &&
+			proc == other.proc && directProc == other.directProc;
+	}
+	bool operator!=(const OpcodeFetch &other) const { return !(*this == other); }
+};
+
 
 // This is to help devices with small memory (PDA, smartphones, ...)
 // to save abit of memory used by opcode names in the Scumm engine.
 #ifndef REDUCE_MEMORY_USAGE
-#	define _OPCODE(ver, x)	setProc(new Common::Functor0Mem<void, ver>(this, &ver::x), #x)
+#	define _OPCODE(ver, x)	setProc(new Common::Functor0Mem<void, ver>(this, &ver::x), #x, static_cast<OpcodeProc>(&ver::x))
 #else
-#	define _OPCODE(ver, x)	setProc(new Common::Functor0Mem<void, ver>(this, &ver::x), "")
+#	define _OPCODE(ver, x)	setProc(new Common::Functor0Mem<void, ver>(this, &ver::x), "", static_cast<OpcodeProc>(&ver::x))
 #endif
 
+/**
+ * How executeScript dispatches the opcodes of the running script.
+ */
+enum ScriptDispatch {
+	/** Look up each opcode through its functor, checking every fetch. */
+	kDispatchClassic = 0,
+	/**
+	 * Call the resolved handlers directly. The script pointer stays pinned
+	 * to the code resource until that resource is freed, so fetches do not
+	 * check whether it moved.
+	 */
+	kDispatchDirect = 1,
+	/**
+	 * Like kDispatchDirect, but check before each opcode that the classic
+	 * dispatch would have done the same, and error out if not.
+	 */
+	kDispatchVerify = 2
+};
+
 /**
  * The number of script slots, which determines the maximal number
  * of concurrently running scripts, and the number of local variables
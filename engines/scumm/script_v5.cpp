@@ -1674,6 +1674,7 @@ void ScummEngine_v5::o5_roomOps() {
 			}
 			assertRange(0, a, 256, "o5_roomOps: 2: room color slot");
 			_roomPalette[b] = a;
+			_gdi->_stripCache.clear();
 			_fullRedraw = true;
 		} else {
 			error("room-color is no longer a valid command");
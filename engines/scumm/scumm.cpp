@@ -221,12 +221,15 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 	_saveLoadSlot = 0;
 	_lastSaveTime = 0;
 	_saveTemporaryState = false;
+	_saveInBackground = false;
 	memset(_localScriptOffsets, 0, sizeof(_localScriptOffsets));
 	_scriptPointer = NULL;
 	_scriptOrgPointer = NULL;
 	_opcode = 0;
 	vm.numNestedScripts = 0;
 	_lastCodePtr = NULL;
+	_scriptDispatch = kDispatchClassic;
+	_scriptPinned = false;
 	_scummStackPos = 0;
 	memset(_vmStack, 0, sizeof(_vmStack));
 	_fileOffset = 0;
@@ -498,6 +501,28 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_debugMode = true;
 
 	_copyProtection = ConfMan.getBool("copy_protection");
+
+	if (ConfMan.hasKey("strip_cache_size"))
+		_gdi->setStripCacheSize(MAX(ConfMan.getInt("strip_cache_size"), 0) * 1024);
+	else
+		_gdi->setStripCacheSize(Gdi::kDefaultStripCacheSize);
+	if (ConfMan.hasKey("cel_cache_size"))
+		_celCache.setMaxSize(MAX(ConfMan.getInt("cel_cache_size"), 0) * 1024);
+	else
+		_celCache.setMaxSize(kDefaultCelCacheSize);
+	if (ConfMan.hasKey("autosave_chunk_size"))
+		_saveWriter.setChunkSize(MAX(ConfMan.getInt("autosave_chunk_size"), 0) * 1024);
+	if (ConfMan.hasKey("resource_offset_cache"))
+		_offsetCache.setEnabled(ConfMan.getBool("resource_offset_cache"));
+	if (ConfMan.hasKey("resource_policy"))
+		_res->setPolicy(ResourceManager::createPolicy(ConfMan.get("resource_policy")));
+	if (ConfMan.hasKey("script_dispatch")) {
+		const Common::String dispatch = ConfMan.get("script_dispatch");
+		if (dispatch == "direct")
+			setScriptDispatch(kDispatchDirect);
+		else if (dispatch == "verify")
+			setScriptDispatch(kDispatchVerify);
+	}
 	if (ConfMan.getBool("demo_mode"))
 		_game.features |= GF_DEMO;
 	if (ConfMan.hasKey("nosubtitles")) {
@@ -587,6 +612,9 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_herculesBuf = (byte *)malloc(kHercWidth * kHercHeight);
 	}
 
+	_directScreenAccess = _system->hasFeature(OSystem::kFeaturePartialScreenUnlock);
+	_composeText16 = getTextCompositor16();
+
 	// Add debug levels
 	for (int i = 0; i < ARRAYSIZE(debugChannels); ++i)
 		DebugMan.addDebugChannel(debugChannels[i].flag,  debugChannels[i].channel, debugChannels[i].desc);
@@ -619,6 +647,8 @@ ScummEngine::~ScummEngine() {
 	delete _messageDialog;
 	delete _pauseDialog;
 	delete _versionDialog;
+	finishPendingSave();
+	saveOffsetCache();
 	delete _fileHandle;
 
 	delete _sound;
@@ -884,6 +914,8 @@ ScummEngine_v71he::ScummEngine_v71he(OSystem *syst, const DetectorResult &dr)
 
 ScummEngine_v71he::~ScummEngine_v71he() {
 	delete _wiz;
+	// The resources are freed afterwards, by the base class.
+	_wiz = NULL;
 }
 
 ScummEngine_v72he::ScummEngine_v72he(OSystem *syst, const DetectorResult &dr)
@@ -1321,6 +1353,8 @@ Common::Error ScummEngine::init() {
 
 	setupScumm();
 
+	if (_offsetCache.isEnabled())
+		loadOffsetCache();
 	readIndexFile();
 
 	// Create the debugger now that _numVariables has been set
@@ -2266,6 +2300,7 @@ void ScummEngine::scummLoop(int delta) {
 		_saveLoadDescription = Common::String::format("Autosave %d", _saveLoadSlot);
 		_saveLoadFlag = 1;
 		_saveTemporaryState = false;
+		_saveInBackground = (_saveWriter.getChunkSize() != 0);
 	}
 
 	if (VAR_GAME_LOADED != 0xFF)
@@ -2445,6 +2480,9 @@ void ScummEngine::scummLoop_updateScummVars() {
 }
 
 void ScummEngine::scummLoop_handleSaveLoad() {
+	if (_saveWriter.isBusy())
+		stepPendingSave();
+
 	if (_saveLoadFlag) {
 		bool success;
 		const char *errMsg = 0;
@@ -2454,7 +2492,11 @@ void ScummEngine::scummLoop_handleSaveLoad() {
 
 		Common::String filename;
 		if (_saveLoadFlag == 1) {
-			success = saveState(_saveLoadSlot, _saveTemporaryState, filename);
+			if (_saveInBackground && !_saveTemporaryState)
+				success = saveStateInBackground(_saveLoadSlot, filename);
+			else
+				success = saveState(_saveLoadSlot, _saveTemporaryState, filename);
+			_saveInBackground = false;
 			if (!success)
 				errMsg = _("Failed to save game to file:\n\n%s");
 
@@ -2773,6 +2815,10 @@ bool ScummEngine::startManiac() {
 
 void ScummEngine::pauseEngineIntern(bool pause) {
 	if (pause) {
+		// The dialogs shown while paused may list or load the savegame
+		// which is still being written.
+		finishPendingSave();
+
 		// Pause sound & video
 		_oldSoundsPaused = _sound->_soundsPaused;
 		_sound->pauseSounds(true);
@@ -39,8 +39,13 @@
 #include "graphics/surface.h"
 #include "graphics/sjis.h"
 
+#include "scumm/boxroute.h"
+#include "scumm/compose16.h"
 #include "scumm/gfx.h"
 #include "scumm/detection.h"
+#include "scumm/offsetcache.h"
+#include "scumm/opcodeprofile.h"
+#include "scumm/savewriter.h"
 #include "scumm/script.h"
 
 #ifdef __DS__
@@ -548,6 +553,17 @@ public:
 	BaseCostumeLoader *_costumeLoader;
 	BaseCostumeRenderer *_costumeRenderer;
 
+	/**
+	 * Cels of AKOS costumes using codec 16 or 32, decoded by the
+	 * AkosRenderer.
+	 */
+	StripCache _celCache;
+
+	enum {
+		/** Size of the cel cache unless configured otherwise. */
+		kDefaultCelCacheSize = 1024 * 1024
+	};
+
 	int _NESCostumeSet;
 	void NES_loadCostumeSet(int n);
 	byte *_NEScostdesc, *_NEScostlens, *_NEScostoffs, *_NEScostdata;
@@ -598,11 +614,22 @@ protected:
 	byte _saveLoadFlag, _saveLoadSlot;
 	uint32 _lastSaveTime;
 	bool _saveTemporaryState;
+	/** Write the requested save over several iterations of the game loop. */
+	bool _saveInBackground;
 	Common::String _saveLoadFileName;
 	Common::String _saveLoadDescription;
 
+	/** Autosaves which are still being written. */
+	IncrementalSaveWriter _saveWriter;
+
 	bool saveState(Common::WriteStream *out, bool writeHeader = true);
 	bool saveState(int slot, bool compat, Common::String &fileName);
+	bool saveStateInBackground(int slot, Common::String &fileName);
+	void finishPendingSave();
+	void stepPendingSave();
+	void pendingSaveFailed();
+	void saveStateHeader(Common::WriteStream *out, bool writeHeader);
+	void saveStateData(Common::WriteStream *out);
 	bool loadState(int slot, bool compat);
 	bool loadState(int slot, bool compat, Common::String &fileName);
 	virtual void saveLoadWithSerializer(Common::Serializer &s);
@@ -651,9 +678,18 @@ protected:
 
 	OpcodeEntry _opcodes[256];
 
+	ScriptDispatch _scriptDispatch;
+	/**
+	 * Set while _scriptOrgPointer is known to match the address of the code
+	 * resource, see kDispatchDirect. Freeing the resource clears it again.
+	 */
+	bool _scriptPinned;
+	OpcodeProfile _opcodeProfile;
+
 	virtual void setupOpcodes() = 0;
 	void executeOpcode(byte i);
 	const char *getOpcodeDesc(byte i);
+	void setScriptDispatch(ScriptDispatch dispatch);
 
 	void initializeLocals(int slot, int *vars);
 	int	getScriptSlot();
@@ -670,6 +706,7 @@ protected:
 	void runObjectScript(int script, int entry, bool freezeResistant, bool recursive, int *vars, int slot = -1, int cycle = 0);
 	void runScriptNested(int script);
 	void executeScript();
+	void executeScriptDirect();
 	void updateScriptPtr();
 	virtual void runInventoryScript(int i);
 	void inventoryScriptIndy3Mac();
@@ -723,6 +760,7 @@ protected:
 	/* Should be in Resource class */
 	BaseScummFile *_fileHandle;
 	uint32 _fileOffset;
+	ResourceOffsetCache _offsetCache;
 public:
 	/** The name of the (macintosh/rescumm style) container file, if any. */
 	Common::String _containerFile;
@@ -751,6 +789,9 @@ protected:
 //	void allocResTypeData(ResType type, uint32 tag, int num, int mode);
 //	byte *createResource(int type, int index, uint32 size);
 	int loadResource(ResType type, ResId idx);
+	int readResourceData(ResType type, ResId idx, uint32 size);
+	void loadOffsetCache();
+	void saveOffsetCache();
 //	void nukeResource(ResType type, ResId idx);
 	int getResourceRoomNr(ResType type, ResId idx);
 	virtual uint32 getResourceRoomOffset(ResType type, ResId idx);
@@ -1031,15 +1072,57 @@ protected:
 	void setCursorFromBuffer(const byte *ptr, int width, int height, int pitch);
 
 public:
-	void markRectAsDirty(VirtScreenNumber virt, int left, int right, int top, int bottom, int dirtybit = 0);
-	void markRectAsDirty(VirtScreenNumber virt, const Common::Rect& rect, int dirtybit = 0) {
-		markRectAsDirty(virt, rect.left, rect.right, rect.top, rect.bottom, dirtybit);
+	void markRectAsDirty(VirtScreenNumber virt, int left, int right, int top, int bottom, int dirtybit = 0,
+	                     DamageSource source = kDamageOther);
+	void markRectAsDirty(VirtScreenNumber virt, const Common::Rect& rect, int dirtybit = 0,
+	                     DamageSource source = kDamageOther) {
+		markRectAsDirty(virt, rect.left, rect.right, rect.top, rect.bottom, dirtybit, source);
 	}
 protected:
 	// Screen rendering
 	byte *_compositeBuf;
 	byte *_herculesBuf;
 
+	/** Whether drawStripToScreen may compose straight into the locked screen. */
+	bool _directScreenAccess;
+
+public:
+	/**
+	 * Bytes drawStripToScreen handed to the backend, either through
+	 * copyRectToScreen (which copies them once more) or by composing into
+	 * the locked screen. Shown by the "screenstats" debugger command.
+	 */
+	struct ScreenCopyStats {
+		uint32 frames;
+		uint32 copied, direct;			///< current frame
+		uint32 lastCopied, lastDirect;	///< last complete frame
+		uint64 totalCopied, totalDirect;
+
+		ScreenCopyStats() { reset(); }
+
+		void reset() {
+			frames = copied = direct = lastCopied = lastDirect = 0;
+			totalCopied = totalDirect = 0;
+		}
+
+		void endFrame() {
+			++frames;
+			lastCopied = copied;
+			lastDirect = direct;
+			totalCopied += copied;
+			totalDirect += direct;
+			copied = direct = 0;
+		}
+	} _screenCopyStats;
+
+	/** Composes the text surface over 16 bit graphics, see compose16.h. */
+	TextCompositor16 _composeText16;
+
+	/** Rectangles collected from the damage tracker by updateDirtyScreen. */
+	Common::Array<Common::Rect> _damageRects;
+
+protected:
+
 	virtual void drawDirtyScreenParts();
 	void updateDirtyScreen(VirtScreenNumber slot);
 	void drawStripToScreen(VirtScreen *vs, int x, int w, int t, int b);
@@ -1136,6 +1219,11 @@ protected:
 public:
 	uint16 _extraBoxFlags[65];
 
+	/** Routes between the walkboxes of the room, see createBoxMatrix. */
+	WalkboxRouter _boxRouter;
+	/** Passages between pairs of walkboxes, see Actor::findPathTowards. */
+	BoxGateCache _boxGates;
+
 	byte getNumBoxes();
 	byte *getBoxMatrixBaseAddr();
 	byte *getBoxConnectionBase(int box);
@@ -1170,6 +1258,7 @@ protected:
 	void convertScaleTableToScaleSlot(int slot);
 
 	void calcItineraryMatrix(byte *itineraryMatrix, int num);
+	void updateBoxRoutes(int num);
 	void createBoxMatrix();
 	virtual bool areBoxesNeighbors(int i, int j);
 
@@ -0,0 +1,174 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_SMUSH_BLOCKS_H
+#define SCUMM_SMUSH_BLOCKS_H
+
+#include "common/scummsys.h"
+#include "common/endian.h"
+
+#if defined(__SSE2__)
+#define SCUMM_SMUSH_BLOCKS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SCUMM_SMUSH_BLOCKS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Scumm {
+
+/**
+ * @name Block kernels of the SMUSH codecs
+ *
+ * Codecs 37 and 47 build frames out of square blocks which are copied from
+ * one of the previous frames, filled with one color, or drawn as a two color
+ * glyph. These kernels handle one block at a time and move whole lines of it
+ * at once: 8 pixel lines with SSE2 or NEON where available, otherwise in 32
+ * bit words, which READ_UINT32 and WRITE_UINT32 split into bytes on
+ * platforms that need aligned access.
+ *
+ * A glyph mask has one byte per pixel of the block, line by line, which is
+ * 0xFF where the first color is drawn and 0 where the second is.
+ * @{
+ */
+
+inline uint32 smushFillWord(byte color) {
+	return color * 0x01010101U;
+}
+
+inline void smushCopyBlock2(byte *dst, const byte *src, int pitch) {
+	WRITE_UINT16(dst, READ_UINT16(src));
+	WRITE_UINT16(dst + pitch, READ_UINT16(src + pitch));
+}
+
+inline void smushFillBlock2(byte *dst, int pitch, byte color) {
+	const uint16 value = color * 0x0101;
+	WRITE_UINT16(dst, value);
+	WRITE_UINT16(dst + pitch, value);
+}
+
+inline void smushCopyBlock4(byte *dst, const byte *src, int pitch) {
+	for (int i = 0; i < 4; ++i) {
+		WRITE_UINT32(dst, READ_UINT32(src));
+		dst += pitch;
+		src += pitch;
+	}
+}
+
+/** Copy 16 pixels, stored line by line, to a 4x4 block. */
+inline void smushLiteralBlock4(byte *dst, int pitch, const byte *src) {
+	for (int i = 0; i < 4; ++i) {
+		WRITE_UINT32(dst, READ_UINT32(src + i * 4));
+		dst += pitch;
+	}
+}
+
+inline void smushFillBlock4(byte *dst, int pitch, byte color) {
+	const uint32 value = smushFillWord(color);
+	for (int i = 0; i < 4; ++i) {
+		WRITE_UINT32(dst, value);
+		dst += pitch;
+	}
+}
+
+inline void smushGlyphBlock4(byte *dst, int pitch, const byte *mask, byte color1, byte color2) {
+	const uint32 value1 = smushFillWord(color1);
+	const uint32 value2 = smushFillWord(color2);
+	for (int i = 0; i < 4; ++i) {
+		const uint32 m = READ_UINT32(mask + i * 4);
+		WRITE_UINT32(dst, (value1 & m) | (value2 & ~m));
+		dst += pitch;
+	}
+}
+
+inline void smushCopyBlock8(byte *dst, const byte *src, int pitch) {
+	for (int i = 0; i < 8; ++i) {
+#if defined(SCUMM_SMUSH_BLOCKS_SSE2)
+		_mm_storel_epi64((__m128i *)dst, _mm_loadl_epi64((const __m128i *)src));
+#elif defined(SCUMM_SMUSH_BLOCKS_NEON)
+		vst1_u8(dst, vld1_u8(src));
+#else
+		WRITE_UINT32(dst, READ_UINT32(src));
+		WRITE_UINT32(dst + 4, READ_UINT32(src + 4));
+#endif
+		dst += pitch;
+		src += pitch;
+	}
+}
+
+inline void smushFillBlock8(byte *dst, int pitch, byte color) {
+#if defined(SCUMM_SMUSH_BLOCKS_SSE2)
+	const __m128i value = _mm_set1_epi8((char)color);
+#elif defined(SCUMM_SMUSH_BLOCKS_NEON)
+	const uint8x8_t value = vdup_n_u8(color);
+#else
+	const uint32 value = smushFillWord(color);
+#endif
+	for (int i = 0; i < 8; ++i) {
+#if defined(SCUMM_SMUSH_BLOCKS_SSE2)
+		_mm_storel_epi64((__m128i *)dst, value);
+#elif defined(SCUMM_SMUSH_BLOCKS_NEON)
+		vst1_u8(dst, value);
+#else
+		WRITE_UINT32(dst, value);
+		WRITE_UINT32(dst + 4, value);
+#endif
+		dst += pitch;
+	}
+}
+
+inline void smushGlyphBlock8(byte *dst, int pitch, const byte *mask, byte color1, byte color2) {
+#if defined(SCUMM_SMUSH_BLOCKS_SSE2)
+	const __m128i value1 = _mm_set1_epi8((char)color1);
+	const __m128i value2 = _mm_set1_epi8((char)color2);
+	for (int i = 0; i < 8; ++i) {
+		const __m128i m = _mm_loadl_epi64((const __m128i *)(mask + i * 8));
+		_mm_storel_epi64((__m128i *)dst, _mm_or_si128(_mm_and_si128(m, value1), _mm_andnot_si128(m, value2)));
+		dst += pitch;
+	}
+#elif defined(SCUMM_SMUSH_BLOCKS_NEON)
+	const uint8x8_t value1 = vdup_n_u8(color1);
+	const uint8x8_t value2 = vdup_n_u8(color2);
+	for (int i = 0; i < 8; ++i) {
+		vst1_u8(dst, vbsl_u8(vld1_u8(mask + i * 8), value1, value2));
+		dst += pitch;
+	}
+#else
+	const uint32 value1 = smushFillWord(color1);
+	const uint32 value2 = smushFillWord(color2);
+	for (int i = 0; i < 8; ++i) {
+		const uint32 m1 = READ_UINT32(mask + i * 8);
+		const uint32 m2 = READ_UINT32(mask + i * 8 + 4);
+		WRITE_UINT32(dst, (value1 & m1) | (value2 & ~m1));
+		WRITE_UINT32(dst + 4, (value1 & m2) | (value2 & ~m2));
+		dst += pitch;
+	}
+#endif
+}
+
+/** @} */
+
+} // End of namespace Scumm
+
+#endif
@@ -25,6 +25,7 @@
 #include "common/textconsole.h"
 #include "common/util.h"
 #include "scumm/bomp.h"
+#include "scumm/smush/blocks.h"
 #include "scumm/smush/codec37.h"
 
 namespace Scumm {
@@ -235,57 +236,11 @@ void Codec37Decoder::maketable(int pitch, int index) {
 	}
 }
 
-#if defined(SCUMM_NEED_ALIGNMENT)
-
-#define DECLARE_LITERAL_TEMP(v)			\
-	byte v
-
-#define READ_LITERAL_PIXEL(src, v)		\
-	v = *src++
-
-#define WRITE_4X1_LINE(dst, v)			\
-	do {					\
-		int j;				\
-		for (j=0; j<4; j++)		\
-			(dst)[j] = v;		\
-	} while (0)
-
-#define COPY_4X1_LINE(dst, src)			\
-	do {					\
-		int j;				\
-		for (j=0; j<4; j++)		\
-			(dst)[j] = (src)[j];	\
-	} while (0)
-
-#else /* SCUMM_NEED_ALIGNMENT */
-
-#define DECLARE_LITERAL_TEMP(v)			\
-	uint32 v
-
-#define READ_LITERAL_PIXEL(src, v)			\
-	do {						\
-		v = *src++;				\
-		v += (v << 8) + (v << 16) + (v << 24);	\
-	} while (0)
-
-#define WRITE_4X1_LINE(dst, v)			\
-	*(uint32 *)(dst) = v
-
-#define COPY_4X1_LINE(dst, src)			\
-	*(uint32 *)(dst) = *(const uint32 *)(src)
-
-#endif /* SCUMM_NEED_ALIGNMENT */
-
 /* Fill a 4x4 pixel block with a literal pixel value */
 
 #define LITERAL_4X4(src, dst, pitch)				\
 	do {							\
-		int x;						\
-		DECLARE_LITERAL_TEMP(t);			\
-		READ_LITERAL_PIXEL(src, t);			\
-		for (x=0; x<4; x++) {				\
-			WRITE_4X1_LINE(dst + pitch * x, t);	\
-		}						\
+		smushFillBlock4(dst, pitch, *src++);		\
 		dst += 4;					\
 	} while (0)
 
@@ -294,10 +249,8 @@ void Codec37Decoder::maketable(int pitch, int index) {
 #define LITERAL_4X1(src, dst, pitch)				\
 	do {							\
 		int x;						\
-		DECLARE_LITERAL_TEMP(t);			\
 		for (x=0; x<4; x++) {				\
-			READ_LITERAL_PIXEL(src, t);		\
-			WRITE_4X1_LINE(dst + pitch * x, t);	\
+			WRITE_UINT32(dst + pitch * x, smushFillWord(*src++));	\
 		}						\
 		dst += 4;					\
 	} while (0)
@@ -306,23 +259,17 @@ void Codec37Decoder::maketable(int pitch, int index) {
 
 #define LITERAL_1X1(src, dst, pitch)				\
 	do {							\
-		int x;						\
-		for (x=0; x<4; x++) {				\
-			COPY_4X1_LINE(dst + pitch * x, src);	\
-			src += 4;				\
-		}						\
+		smushLiteralBlock4(dst, pitch, src);		\
+		src += 16;					\
 		dst += 4;					\
 	} while (0)
 
 /* Copy a 4x4 pixel block from a different place in the framebuffer */
 
-#define COPY_4X4(dst2, dst, pitch)					  \
-	do {								  \
-		int x;							  \
-		for (x=0; x<4; x++) {					  \
-			COPY_4X1_LINE(dst + pitch * x, dst2 + pitch * x); \
-		}							  \
-		dst += 4;						  \
+#define COPY_4X4(dst2, dst, pitch)				\
+	do {							\
+		smushCopyBlock4(dst, dst2, pitch);		\
+		dst += 4;					\
 	} while (0)
 
 void Codec37Decoder::proc1(byte *dst, const byte *src, int32 next_offs, int bw, int bh, int pitch, int16 *offset_table) {
@@ -25,51 +25,11 @@
 #include "common/textconsole.h"
 #include "common/util.h"
 #include "scumm/bomp.h"
+#include "scumm/smush/blocks.h"
 #include "scumm/smush/codec47.h"
 
 namespace Scumm {
 
-#if defined(SCUMM_NEED_ALIGNMENT)
-
-#define COPY_4X1_LINE(dst, src)			\
-	do {					\
-		(dst)[0] = (src)[0];	\
-		(dst)[1] = (src)[1];	\
-		(dst)[2] = (src)[2];	\
-		(dst)[3] = (src)[3];	\
-	} while (0)
-
-#define COPY_2X1_LINE(dst, src)			\
-	do {					\
-		(dst)[0] = (src)[0];	\
-		(dst)[1] = (src)[1];	\
-	} while (0)
-
-
-#else /* SCUMM_NEED_ALIGNMENT */
-
-#define COPY_4X1_LINE(dst, src)			\
-	*(uint32 *)(dst) = *(const uint32 *)(src)
-
-#define COPY_2X1_LINE(dst, src)			\
-	*(uint16 *)(dst) = *(const uint16 *)(src)
-
-#endif
-
-#define FILL_4X1_LINE(dst, val)			\
-	do {					\
-		(dst)[0] = val;	\
-		(dst)[1] = val;	\
-		(dst)[2] = val;	\
-		(dst)[3] = val;	\
-	} while (0)
-
-#define FILL_2X1_LINE(dst, val)			\
-	do {					\
-		(dst)[0] = val;	\
-		(dst)[1] = val;	\
-	} while (0)
-
 static const  int8 codec47_table_small1[] = {
   0, 1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 1, 2, 2, 1,
 };
@@ -140,7 +100,7 @@ static const int8 codec47_table[] = {
 	 -6,  43,   1,  43,   0,   0,   0,   0,   0,   0
 };
 
-void Codec47Decoder::makeTablesInterpolation(int param) {
+static void makeTablesInterpolation(int param, byte *table) {
 	int32 variable1, variable2;
 	int32 b1, b2;
 	int32 value_table47_1_2, value_table47_1_1, value_table47_2_2, value_table47_2_1;
@@ -153,7 +113,7 @@ void Codec47Decoder::makeTablesInterpolation(int param) {
 	if (param == 8) {
 		table47_1 = codec47_table_big1;
 		table47_2 = codec47_table_big2;
-		ptr = _tableBig;
+		ptr = table;
 		for (i = 0; i < 256; i++) {
 			ptr[384] = 0;
 			ptr[385] = 0;
@@ -162,14 +122,14 @@ void Codec47Decoder::makeTablesInterpolation(int param) {
 	} else if (param == 4) {
 		table47_1 = codec47_table_small1;
 		table47_2 = codec47_table_small2;
-		ptr = _tableSmall;
+		ptr = table;
 		for (i = 0; i < 256; i++) {
 			ptr[96] = 0;
 			ptr[97] = 0;
 			ptr += 128;
 		}
 	} else {
-		error("Codec47Decoder::makeTablesInterpolation: unknown param %d", param);
+		error("Codec47: makeTablesInterpolation: unknown param %d", param);
 	}
 
 	s = 0;
@@ -265,11 +225,11 @@ void Codec47Decoder::makeTablesInterpolation(int param) {
 			if (param == 8) {
 				for (i = 64 - 1; i >= 0; i--) {
 					if (tableSmallBig[i] != 0) {
-						_tableBig[256 + s + _tableBig[384 + s]] = (byte)i;
-						_tableBig[384 + s]++;
+						table[256 + s + table[384 + s]] = (byte)i;
+						table[384 + s]++;
 					} else {
-						_tableBig[320 + s + _tableBig[385 + s]] = (byte)i;
-						_tableBig[385 + s]++;
+						table[320 + s + table[385 + s]] = (byte)i;
+						table[385 + s]++;
 					}
 				}
 				s += 388;
@@ -277,11 +237,11 @@ void Codec47Decoder::makeTablesInterpolation(int param) {
 			if (param == 4) {
 				for (i = 16 - 1; i >= 0; i--) {
 					if (tableSmallBig[i] != 0) {
-						_tableSmall[64 + s + _tableSmall[96 + s]] = (byte)i;
-						_tableSmall[96 + s]++;
+						table[64 + s + table[96 + s]] = (byte)i;
+						table[96 + s]++;
 					} else {
-						_tableSmall[80 + s + _tableSmall[97 + s]] = (byte)i;
-						_tableSmall[97 + s]++;
+						table[80 + s + table[97 + s]] = (byte)i;
+						table[97 + s]++;
 					}
 				}
 				s += 128;
@@ -290,21 +250,88 @@ void Codec47Decoder::makeTablesInterpolation(int param) {
 	}
 }
 
+#ifndef USE_ARM_SMUSH_ASM
+static byte *s_glyphMasks = NULL;
+#endif
+
+/**
+ * Make the tables the glyphs are drawn from. They do not depend on the frame
+ * size, but take about 130 KB, so they are only made when the first frame
+ * is decoded, instead of when the decoder is created or the engine starts.
+ *
+ * The assembler decoder draws glyphs from the interpolation tables, which
+ * makeTables47() then rewrites for its frame width, so each decoder has its
+ * own. The C++ one only keeps the masks made from them: one per 8x8 glyph
+ * (see smushGlyphBlock8()), followed by one per 4x4 glyph (see
+ * smushGlyphBlock4()). These are made once and shared by all decoders for as
+ * long as the engine runs, since a new decoder is created for each video.
+ */
+bool Codec47Decoder::makeGlyphs() {
+#ifdef USE_ARM_SMUSH_ASM
+	if (_tableBig && _tableSmall)
+		return true;
+
+	_tableBig = (byte *)malloc(256 * 388);
+	_tableSmall = (byte *)malloc(256 * 128);
+	if ((_tableBig == NULL) || (_tableSmall == NULL)) {
+		free(_tableBig);
+		free(_tableSmall);
+		_tableBig = NULL;
+		_tableSmall = NULL;
+		return false;
+	}
+	makeTablesInterpolation(4, _tableSmall);
+	makeTablesInterpolation(8, _tableBig);
+	return true;
+#else
+	if (s_glyphMasks)
+		return true;
+
+	byte *tableBig = (byte *)malloc(256 * 388);
+	byte *tableSmall = (byte *)malloc(256 * 128);
+	if ((tableBig != NULL) && (tableSmall != NULL)) {
+		s_glyphMasks = (byte *)calloc(256 * (64 + 16), 1);
+		if (s_glyphMasks) {
+			makeTablesInterpolation(4, tableSmall);
+			makeTablesInterpolation(8, tableBig);
+
+			// The pixels listed first are drawn in the first color, all
+			// others in the second one.
+			byte *masksSmall = s_glyphMasks + 256 * 64;
+			for (int i = 0; i < 256; i++) {
+				const byte *big = tableBig + i * 388;
+				for (int d = 0; d < big[384]; d++)
+					s_glyphMasks[i * 64 + big[256 + d]] = 0xFF;
+				const byte *small = tableSmall + i * 128;
+				for (int d = 0; d < small[96]; d++)
+					masksSmall[i * 16 + small[64 + d]] = 0xFF;
+			}
+		}
+	}
+	free(tableBig);
+	free(tableSmall);
+	return s_glyphMasks != NULL;
+#endif
+}
+
 void Codec47Decoder::makeTables47(int width) {
 	if (_lastTableWidth == width)
 		return;
 
 	_lastTableWidth = width;
 
-	int32 a, c, d;
-	int16 tmp;
-
 	for (int l = 0; l < ARRAYSIZE(codec47_table); l += 2) {
 		_table[l / 2] = (int16)(codec47_table[l + 1] * width + codec47_table[l]);
 	}
 	// Note: _table[255] is never inited; but since only the first 0xF8
 	// entries of it are used anyway, this doesn't matter.
 
+#ifdef USE_ARM_SMUSH_ASM
+	// The assembler decoder draws glyphs pixel by pixel, from lists of
+	// offsets into the frame.
+	int32 a, c, d;
+	int16 tmp;
+
 	a = 0;
 	c = 0;
 	do {
@@ -336,6 +363,7 @@ void Codec47Decoder::makeTables47(int width) {
 		a += 388;
 		c += 128;
 	} while (c < 32768);
+#endif
 }
 
 #ifdef USE_ARM_SMUSH_ASM
@@ -366,38 +394,30 @@ void Codec47Decoder::level3(byte *d_dst) {
 
 	if (code < 0xF8) {
 		tmp = _table[code] + _offset1;
-		COPY_2X1_LINE(d_dst, d_dst + tmp);
-		COPY_2X1_LINE(d_dst + _d_pitch, d_dst + _d_pitch + tmp);
+		smushCopyBlock2(d_dst, d_dst + tmp, _d_pitch);
 	} else if (code == 0xFF) {
-		COPY_2X1_LINE(d_dst, _d_src + 0);
-		COPY_2X1_LINE(d_dst + _d_pitch, _d_src + 2);
+		WRITE_UINT16(d_dst, READ_UINT16(_d_src + 0));
+		WRITE_UINT16(d_dst + _d_pitch, READ_UINT16(_d_src + 2));
 		_d_src += 4;
 	} else if (code == 0xFE) {
 		byte t = *_d_src++;
-		FILL_2X1_LINE(d_dst, t);
-		FILL_2X1_LINE(d_dst + _d_pitch, t);
+		smushFillBlock2(d_dst, _d_pitch, t);
 	} else if (code == 0xFC) {
 		tmp = _offset2;
-		COPY_2X1_LINE(d_dst, d_dst + tmp);
-		COPY_2X1_LINE(d_dst + _d_pitch, d_dst + _d_pitch + tmp);
+		smushCopyBlock2(d_dst, d_dst + tmp, _d_pitch);
 	} else {
 		byte t = _paramPtr[code];
-		FILL_2X1_LINE(d_dst, t);
-		FILL_2X1_LINE(d_dst + _d_pitch, t);
+		smushFillBlock2(d_dst, _d_pitch, t);
 	}
 }
 
 void Codec47Decoder::level2(byte *d_dst) {
 	int32 tmp;
 	byte code = *_d_src++;
-	int i;
 
 	if (code < 0xF8) {
 		tmp = _table[code] + _offset1;
-		for (i = 0; i < 4; i++) {
-			COPY_4X1_LINE(d_dst, d_dst + tmp);
-			d_dst += _d_pitch;
-		}
+		smushCopyBlock4(d_dst, d_dst + tmp, _d_pitch);
 	} else if (code == 0xFF) {
 		level3(d_dst);
 		d_dst += 2;
@@ -408,53 +428,27 @@ void Codec47Decoder::level2(byte *d_dst) {
 		level3(d_dst);
 	} else if (code == 0xFE) {
 		byte t = *_d_src++;
-		for (i = 0; i < 4; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			d_dst += _d_pitch;
-		}
+		smushFillBlock4(d_dst, _d_pitch, t);
 	} else if (code == 0xFD) {
-		byte *tmp_ptr = _tableSmall + *_d_src++ * 128;
-		int32 l = tmp_ptr[96];
-		byte val = *_d_src++;
-		int16 *tmp_ptr2 = (int16 *)tmp_ptr;
-		while (l--) {
-			*(d_dst + READ_LE_UINT16(tmp_ptr2)) = val;
-			tmp_ptr2++;
-		}
-		l = tmp_ptr[97];
-		val = *_d_src++;
-		tmp_ptr2 = (int16 *)(tmp_ptr + 32);
-		while (l--) {
-			*(d_dst + READ_LE_UINT16(tmp_ptr2)) = val;
-			tmp_ptr2++;
-		}
+		const byte *mask = s_glyphMasks + 256 * 64 + _d_src[0] * 16;
+		smushGlyphBlock4(d_dst, _d_pitch, mask, _d_src[1], _d_src[2]);
+		_d_src += 3;
 	} else if (code == 0xFC) {
 		tmp = _offset2;
-		for (i = 0; i < 4; i++) {
-			COPY_4X1_LINE(d_dst, d_dst + tmp);
-			d_dst += _d_pitch;
-		}
+		smushCopyBlock4(d_dst, d_dst + tmp, _d_pitch);
 	} else {
 		byte t = _paramPtr[code];
-		for (i = 0; i < 4; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			d_dst += _d_pitch;
-		}
+		smushFillBlock4(d_dst, _d_pitch, t);
 	}
 }
 
 void Codec47Decoder::level1(byte *d_dst) {
-	int32 tmp, tmp2;
+	int32 tmp;
 	byte code = *_d_src++;
-	int i;
 
 	if (code < 0xF8) {
-		tmp2 = _table[code] + _offset1;
-		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp2);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp2 + 4);
-			d_dst += _d_pitch;
-		}
+		tmp = _table[code] + _offset1;
+		smushCopyBlock8(d_dst, d_dst + tmp, _d_pitch);
 	} else if (code == 0xFF) {
 		level2(d_dst);
 		d_dst += 4;
@@ -465,42 +459,17 @@ void Codec47Decoder::level1(byte *d_dst) {
 		level2(d_dst);
 	} else if (code == 0xFE) {
 		byte t = *_d_src++;
-		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
-			d_dst += _d_pitch;
-		}
+		smushFillBlock8(d_dst, _d_pitch, t);
 	} else if (code == 0xFD) {
-		tmp = *_d_src++;
-		byte *tmp_ptr = _tableBig + tmp * 388;
-		byte l = tmp_ptr[384];
-		byte val = *_d_src++;
-		int16 *tmp_ptr2 = (int16 *)tmp_ptr;
-		while (l--) {
-			*(d_dst + READ_LE_UINT16(tmp_ptr2)) = val;
-			tmp_ptr2++;
-		}
-		l = tmp_ptr[385];
-		val = *_d_src++;
-		tmp_ptr2 = (int16 *)(tmp_ptr + 128);
-		while (l--) {
-			*(d_dst + READ_LE_UINT16(tmp_ptr2)) = val;
-			tmp_ptr2++;
-		}
+		const byte *mask = s_glyphMasks + _d_src[0] * 64;
+		smushGlyphBlock8(d_dst, _d_pitch, mask, _d_src[1], _d_src[2]);
+		_d_src += 3;
 	} else if (code == 0xFC) {
-		tmp2 = _offset2;
-		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp2);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp2 + 4);
-			d_dst += _d_pitch;
-		}
+		tmp = _offset2;
+		smushCopyBlock8(d_dst, d_dst + tmp, _d_pitch);
 	} else {
 		byte t = _paramPtr[code];
-		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
-			d_dst += _d_pitch;
-		}
+		smushFillBlock8(d_dst, _d_pitch, t);
 	}
 }
 
@@ -527,12 +496,10 @@ Codec47Decoder::Codec47Decoder(int width, int height) {
 	_lastTableWidth = -1;
 	_width = width;
 	_height = height;
-	_tableBig = (byte *)malloc(256 * 388);
-	_tableSmall = (byte *)malloc(256 * 128);
-	if ((_tableBig != NULL) && (_tableSmall != NULL)) {
-		makeTablesInterpolation(4);
-		makeTablesInterpolation(8);
-	}
+#ifdef USE_ARM_SMUSH_ASM
+	_tableBig = NULL;
+	_tableSmall = NULL;
+#endif
 
 	_frameSize = _width * _height;
 	_deltaSize = _frameSize * 3;
@@ -543,6 +510,7 @@ Codec47Decoder::Codec47Decoder(int width, int height) {
 }
 
 Codec47Decoder::~Codec47Decoder() {
+#ifdef USE_ARM_SMUSH_ASM
 	if (_tableBig) {
 		free(_tableBig);
 		_tableBig = NULL;
@@ -551,6 +519,7 @@ Codec47Decoder::~Codec47Decoder() {
 		free(_tableSmall);
 		_tableSmall = NULL;
 	}
+#endif
 	_lastTableWidth = -1;
 	if (_deltaBuf) {
 		free(_deltaBuf);
@@ -562,7 +531,9 @@ Codec47Decoder::~Codec47Decoder() {
 }
 
 bool Codec47Decoder::decode(byte *dst, const byte *src) {
-	if ((_tableBig == NULL) || (_tableSmall == NULL) || (_deltaBuf == NULL))
+	if (!makeGlyphs())
+		return false;
+	if (_deltaBuf == NULL)
 		return false;
 
 	_offset1 = _deltaBufs[1] - _curBuf;
@@ -39,13 +39,15 @@ private:
 	const byte *_d_src, *_paramPtr;
 	int _d_pitch;
 	int32 _offset1, _offset2;
+#ifdef USE_ARM_SMUSH_ASM
 	byte *_tableBig;
 	byte *_tableSmall;
+#endif
 	int16 _table[256];
 	int32 _frameSize;
 	int _width, _height;
 
-	void makeTablesInterpolation(int param);
+	bool makeGlyphs();
 	void makeTables47(int width);
 	void level1(byte *d_dst);
 	void level2(byte *d_dst);
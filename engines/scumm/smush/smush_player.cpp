@@ -251,6 +251,9 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm) {
 	_pauseTime = 0;
 
 
+	if (ConfMan.hasKey("smush_read_ahead"))
+		_frameQueue.setCapacity(MAX(ConfMan.getInt("smush_read_ahead"), 0));
+
 	_IACTchannel = new Audio::SoundHandle();
 	_compressedFileSoundHandle = new Audio::SoundHandle();
 }
@@ -910,11 +913,14 @@ void SmushPlayer::handleFrame(int32 frameSize, Common::SeekableReadStream &b) {
 	}
 
 	if (_width != 0 && _height != 0) {
+		if (_updateNeeded)
+			_playback.dropped++;
 		updateScreen();
 	}
 	_smixer->handleFrame();
 
 	_frame++;
+	_playback.frames++;
 }
 
 void SmushPlayer::handleAnimHeader(int32 subSize, Common::SeekableReadStream &b) {
@@ -1019,6 +1025,7 @@ void SmushPlayer::parseNextFrame() {
 		}
 
 		_base->seek(_seekPos + 8, SEEK_SET);
+		_frameQueue.reset(_base, _baseSize);
 		_frame = _seekFrame;
 		_startFrame = _frame;
 		_startTime = _vm->_system->getMillis();
@@ -1028,30 +1035,28 @@ void SmushPlayer::parseNextFrame() {
 
 	assert(_base);
 
-	const uint32 subType = _base->readUint32BE();
-	const int32 subSize = _base->readUint32BE();
-	const int32 subOffset = _base->pos();
-
-	if (_base->pos() >= (int32)_baseSize) {
+	uint32 subType;
+	Common::SeekableReadStream *chunk = _frameQueue.next(subType);
+	if (!chunk) {
 		_vm->_smushVideoShouldFinish = true;
 		_endOfFile = true;
 		return;
 	}
 
-	debug(3, "Chunk: %s at %x", tag2str(subType), subOffset);
+	debug(3, "Chunk: %s", tag2str(subType));
 
 	switch (subType) {
 	case MKTAG('A','H','D','R'): // FT INSANE may seek file to the beginning
-		handleAnimHeader(subSize, *_base);
+		handleAnimHeader(chunk->size(), *chunk);
 		break;
 	case MKTAG('F','R','M','E'):
-		handleFrame(subSize, *_base);
+		handleFrame(chunk->size(), *chunk);
 		break;
 	default:
-		error("Unknown Chunk found at %x: %s, %d", subOffset, tag2str(subType), subSize);
+		error("Unknown Chunk found: %s, %d", tag2str(subType), chunk->size());
 	}
 
-	_base->seek(subOffset + subSize, SEEK_SET);
+	delete chunk;
 
 	if (_insanity)
 		_vm->_sound->processSound();
@@ -1187,6 +1192,10 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 
 	_pauseTime = 0;
 
+	_frameQueue.resetStats();
+	_playback = PlaybackStats();
+	_playback.file = filename;
+
 	int skipped = 0;
 
 	for (;;) {
@@ -1217,7 +1226,10 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 				skipFrame = true;
 			else
 				skipFrame = false;
+			const uint32 frame = _frame;
 			timerCallback();
+			if (skipFrame && _frame != frame)
+				_playback.late++;
 		}
 
 		_vm->scummLoop_handleSound();
@@ -1252,6 +1264,7 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 				_vm->_system->copyRectToScreen(_dst, _width, 0, 0, w, h);
 				_vm->_system->updateScreen();
 				_updateNeeded = false;
+				_playback.shown++;
 			}
 		}
 		if (_endOfFile)
@@ -1263,9 +1276,24 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 			_IACTpos = 0;
 			break;
 		}
+		// Read the next chunks while waiting for the next frame.
+		const uint32 readStart = _vm->_system->getMillis();
+		while (_frameQueue.fill() && _vm->_system->getMillis() - readStart < kReadAheadMillis)
+			;
 		_vm->_system->delayMillis(10);
 	}
 
+	const SmushFrameQueue::Stats &queueStats = _frameQueue.getStats();
+	_playback.readAhead = queueStats.readAhead;
+	_playback.underruns = queueStats.underruns;
+	if (_playbackHistory.size() >= kStatsHistory)
+		_playbackHistory.remove_at(0);
+	_playbackHistory.push_back(_playback);
+	debug(1, "SmushPlayer: %s: %u frames, %u shown, %u late, %u dropped, %u of %u chunks read ahead", filename,
+		_playback.frames, _playback.shown, _playback.late, _playback.dropped, _playback.readAhead,
+		_playback.readAhead + _playback.underruns);
+
+	_frameQueue.reset(0, 0);
 	release();
 
 	// Reset mouse state
@@ -23,8 +23,12 @@
 #if !defined(SCUMM_SMUSH_PLAYER_H) && defined(ENABLE_SCUMM_7_8)
 #define SCUMM_SMUSH_PLAYER_H
 
+#include "common/array.h"
+#include "common/str.h"
 #include "common/util.h"
 
+#include "scumm/smush/smush_queue.h"
+
 namespace Audio {
 class SoundHandle;
 class QueuingAudioStream;
@@ -41,6 +45,25 @@ class Codec47Decoder;
 
 class SmushPlayer {
 	friend class Insane;
+public:
+	/** What happened while an animation was played. */
+	struct PlaybackStats {
+		Common::String file;
+		uint32 frames;
+		uint32 shown;
+		uint32 late;		///< frames handled after the following one was due
+		uint32 dropped;		///< frames replaced by the next one before they were shown
+		uint32 readAhead;	///< chunks read before they were needed
+		uint32 underruns;	///< chunks read when they were needed
+	};
+
+	enum {
+		/** Number of animations PlaybackStats are kept for. */
+		kStatsHistory = 16,
+		/** Time spent reading ahead per iteration of the playback loop. */
+		kReadAheadMillis = 5
+	};
+
 private:
 	ScummEngine_v7 *_vm;
 	int32 _nbframes;
@@ -86,6 +109,10 @@ private:
 	bool _middleAudio;
 	bool _skipPalette;
 
+	SmushFrameQueue _frameQueue;
+	PlaybackStats _playback;
+	Common::Array<PlaybackStats> _playbackHistory;
+
 public:
 	SmushPlayer(ScummEngine_v7 *scumm);
 	~SmushPlayer();
@@ -97,6 +124,13 @@ public:
 	void release();
 	void warpMouse(int x, int y, int buttons);
 
+	/** Set the number of chunks read ahead, 0 to read them when needed. */
+	void setReadAhead(uint chunks) { _frameQueue.setCapacity(chunks); }
+	uint getReadAhead() const { return _frameQueue.getCapacity(); }
+	/** The statistics of the last animations played, oldest first. */
+	const Common::Array<PlaybackStats> &getPlaybackHistory() const { return _playbackHistory; }
+	void clearPlaybackHistory() { _playbackHistory.clear(); }
+
 protected:
 	int _width, _height;
 
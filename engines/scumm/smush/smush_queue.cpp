@@ -0,0 +1,186 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/smush/smush_queue.h"
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+#include "common/zlib.h"
+
+namespace Scumm {
+
+SmushFrameQueue::SmushFrameQueue() : _stream(0), _end(0), _endOfFile(false), _capacity(kDefaultCapacity), _bytes(0) {
+	resetStats();
+}
+
+SmushFrameQueue::~SmushFrameQueue() {
+	clear();
+}
+
+void SmushFrameQueue::reset(Common::SeekableReadStream *stream, uint32 end) {
+	clear();
+	_stream = stream;
+	_end = end;
+	_endOfFile = false;
+}
+
+void SmushFrameQueue::clear() {
+	while (!_chunks.empty())
+		free(_chunks.pop().data);
+	_bytes = 0;
+}
+
+bool SmushFrameQueue::isFull() const {
+	return (uint)_chunks.size() >= _capacity || _bytes >= (uint32)kMaxBytes;
+}
+
+bool SmushFrameQueue::fill() {
+	if (!_stream || _endOfFile || isFull())
+		return false;
+
+	Chunk chunk;
+	if (!readChunk(chunk))
+		return false;
+	inflateFrameObjects(chunk);
+
+	_chunks.push(chunk);
+	_bytes += chunk.size;
+	if ((uint)_chunks.size() > _stats.maxQueued)
+		_stats.maxQueued = (uint)_chunks.size();
+	return true;
+}
+
+Common::SeekableReadStream *SmushFrameQueue::next(uint32 &type) {
+	Chunk chunk;
+
+	if (!_chunks.empty()) {
+		chunk = _chunks.pop();
+		_bytes -= chunk.size;
+		_stats.readAhead++;
+	} else {
+		if (!_stream || _endOfFile || !readChunk(chunk))
+			return 0;
+		_stats.underruns++;
+	}
+
+	_stats.chunks++;
+	type = chunk.type;
+	return new Common::MemoryReadStream(chunk.data, chunk.size, DisposeAfterUse::YES);
+}
+
+bool SmushFrameQueue::readChunk(Chunk &chunk) {
+	chunk.type = _stream->readUint32BE();
+	const int32 size = _stream->readUint32BE();
+	const int32 offset = _stream->pos();
+
+	if (_stream->pos() >= (int32)_end) {
+		_endOfFile = true;
+		return false;
+	}
+
+	if (size < 0)
+		error("SmushFrameQueue: Invalid chunk size %d at %x", size, offset);
+
+	chunk.size = size;
+	chunk.data = (byte *)malloc(MAX<uint32>(size, 1));
+	assert(chunk.data);
+	const uint32 len = _stream->read(chunk.data, size);
+	if (len < chunk.size)
+		memset(chunk.data + len, 0, chunk.size - len);
+	_stream->seek(offset + size, SEEK_SET);
+	return true;
+}
+
+void SmushFrameQueue::inflateFrameObjects(Chunk &chunk) {
+#ifdef USE_ZLIB
+	if (chunk.type != MKTAG('F','R','M','E'))
+		return;
+
+	// Walk the frame the same way SmushPlayer::handleFrame does and
+	// replace every ZFOB by the FOBJ it contains.
+	Common::Array<uint32> objects;
+	uint32 inflatedTotal = 0;
+	int32 remaining = chunk.size;
+	uint32 pos = 0;
+	while (remaining > 0 && pos + 8 <= chunk.size) {
+		const uint32 subType = READ_BE_UINT32(chunk.data + pos);
+		const uint32 subSize = READ_BE_UINT32(chunk.data + pos + 4);
+		const uint32 pad = subSize & 1;
+		if (subSize > chunk.size - pos - 8)
+			return;
+		if (subType == MKTAG('Z','F','O','B')) {
+			if (subSize < 4 || READ_BE_UINT32(chunk.data + pos + 8) > (uint32)kMaxBytes)
+				return;
+			objects.push_back(pos);
+			inflatedTotal += READ_BE_UINT32(chunk.data + pos + 8) + 1;
+		}
+		remaining -= subSize + 8 + pad;
+		pos += 8 + subSize + pad;
+	}
+
+	if (objects.empty())
+		return;
+
+	byte *data = (byte *)malloc(chunk.size + inflatedTotal);
+	assert(data);
+	byte *dst = data;
+	uint32 src = 0;
+	for (uint i = 0; i < objects.size(); ++i) {
+		const uint32 objPos = objects[i];
+		const uint32 subSize = READ_BE_UINT32(chunk.data + objPos + 4);
+		const uint32 expected = READ_BE_UINT32(chunk.data + objPos + 8);
+		unsigned long inflatedSize = expected;
+
+		memcpy(dst, chunk.data + src, objPos - src);
+		dst += objPos - src;
+
+		WRITE_BE_UINT32(dst, MKTAG('F','O','B','J'));
+		WRITE_BE_UINT32(dst + 4, expected);
+		if (!Common::uncompress(dst + 8, &inflatedSize, chunk.data + objPos + 12, subSize - 4) || inflatedSize != expected) {
+			// Leave it to SmushPlayer::handleZlibFrameObject to complain.
+			free(data);
+			return;
+		}
+		dst += 8 + expected;
+		if (expected & 1)
+			*dst++ = 0;
+
+		src = MIN<uint32>(objPos + 8 + subSize + (subSize & 1), chunk.size);
+	}
+	memcpy(dst, chunk.data + src, chunk.size - src);
+	dst += chunk.size - src;
+
+	free(chunk.data);
+	chunk.data = data;
+	chunk.size = dst - data;
+	_stats.inflated += objects.size();
+#endif
+}
+
+void SmushFrameQueue::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+} // End of namespace Scumm
@@ -0,0 +1,122 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_SMUSH_QUEUE_H
+#define SCUMM_SMUSH_QUEUE_H
+
+#include "common/queue.h"
+#include "common/stream.h"
+
+namespace Scumm {
+
+/**
+ * Reads the chunks of a SMUSH animation ahead of time.
+ *
+ * The SmushPlayer fills the queue while it waits for the next frame is due,
+ * so that reading the file, and inflating zlib compressed frame objects,
+ * does not delay the frame itself. The chunks are still handled in the order
+ * they appear in the file, so palette changes, sounds and text stay in step
+ * with the images.
+ *
+ * Frames are not decoded ahead: codecs 37 and 47 decode against the
+ * previous frame, and text and the INSANE overlays are drawn into the same
+ * buffer afterwards.
+ */
+class SmushFrameQueue {
+public:
+	enum {
+		/** Number of chunks read ahead unless set otherwise. */
+		kDefaultCapacity = 8,
+		/** Chunks are no longer read ahead once they take up this many bytes. */
+		kMaxBytes = 2 * 1024 * 1024
+	};
+
+	struct Stats {
+		uint32 chunks;		///< chunks handed out
+		uint32 readAhead;	///< chunks which had been read ahead when needed
+		uint32 underruns;	///< chunks which had to be read when needed
+		uint32 inflated;	///< frame objects inflated ahead
+		uint32 maxQueued;
+	};
+
+	SmushFrameQueue();
+	~SmushFrameQueue();
+
+	/** Set the number of chunks to read ahead, 0 to only read them when needed. */
+	void setCapacity(uint chunks) { _capacity = chunks; }
+	uint getCapacity() const { return _capacity; }
+
+	/**
+	 * Start reading at the current position of a stream. The stream is not
+	 * owned by the queue and must not be used by anyone else until reset()
+	 * is called again.
+	 *
+	 * @param end	the position where the animation ends
+	 */
+	void reset(Common::SeekableReadStream *stream, uint32 end);
+
+	/** Forget all queued chunks, e.g. before seeking in the stream. */
+	void clear();
+
+	bool isFull() const;
+	uint size() const { return _chunks.size(); }
+
+	/**
+	 * Read the next chunk ahead of time.
+	 *
+	 * @return	false if the queue is full or the animation ended
+	 */
+	bool fill();
+
+	/**
+	 * Take the next chunk. If it was not read ahead, it is read now.
+	 *
+	 * @param type	set to the type of the chunk
+	 * @return	the contents of the chunk, or 0 when the animation ended
+	 */
+	Common::SeekableReadStream *next(uint32 &type);
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
+private:
+	struct Chunk {
+		uint32 type;
+		uint32 size;
+		byte *data;
+	};
+
+	bool readChunk(Chunk &chunk);
+	void inflateFrameObjects(Chunk &chunk);
+
+	Common::SeekableReadStream *_stream;
+	uint32 _end;
+	bool _endOfFile;
+	uint _capacity;
+	uint32 _bytes;
+	Common::Queue<Chunk> _chunks;
+	Stats _stats;
+};
+
+} // End of namespace Scumm
+
+#endif
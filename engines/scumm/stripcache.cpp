@@ -0,0 +1,151 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "scumm/stripcache.h"
+
+namespace Scumm {
+
+StripCache::StripCache() : _head(0), _tail(0), _size(0), _maxSize(0) {
+}
+
+StripCache::~StripCache() {
+	clear();
+}
+
+void StripCache::setMaxSize(uint32 size) {
+	_maxSize = size;
+	if (!_maxSize)
+		clear();
+	else
+		evict(0);
+}
+
+bool StripCache::lookup(Kind kind, const byte *src, const byte *palette, uint16 height, const byte *&data) {
+	Key key;
+	key.src = src;
+	key.palette = palette;
+	key.height = height;
+	key.kind = kind;
+
+	EntryMap::iterator i = _entries.find(key);
+	if (i == _entries.end()) {
+		_stats.misses++;
+		return false;
+	}
+
+	Entry *entry = i->_value;
+	if (entry != _head) {
+		unlinkEntry(entry);
+		linkFront(entry);
+	}
+
+	data = entry->data;
+	if (data)
+		_stats.hits++;
+	else
+		_stats.bypassed++;
+	return true;
+}
+
+byte *StripCache::insert(Kind kind, const byte *src, const byte *palette, uint16 height, uint32 size) {
+	if (!_maxSize || sizeof(Entry) + size > _maxSize)
+		return 0;
+
+	Entry *entry = new Entry;
+	entry->key.src = src;
+	entry->key.palette = palette;
+	entry->key.height = height;
+	entry->key.kind = kind;
+	entry->data = size ? new byte[size] : 0;
+	entry->size = size;
+
+	// Replace an older entry for the same data.
+	EntryMap::iterator i = _entries.find(entry->key);
+	if (i != _entries.end())
+		removeEntry(i->_value);
+
+	evict(entrySize(entry));
+
+	_entries[entry->key] = entry;
+	linkFront(entry);
+	_size += entrySize(entry);
+
+	return entry->data;
+}
+
+void StripCache::invalidate(const byte *start, uint32 size) {
+	const byte *end = start + size;
+	Entry *entry = _head;
+
+	while (entry) {
+		Entry *next = entry->next;
+		if (entry->key.src >= start && entry->key.src < end) {
+			removeEntry(entry);
+			_stats.invalidations++;
+		}
+		entry = next;
+	}
+}
+
+void StripCache::clear() {
+	while (_head)
+		removeEntry(_head);
+}
+
+void StripCache::unlinkEntry(Entry *entry) {
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		_head = entry->next;
+
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		_tail = entry->prev;
+}
+
+void StripCache::linkFront(Entry *entry) {
+	entry->prev = 0;
+	entry->next = _head;
+	if (_head)
+		_head->prev = entry;
+	else
+		_tail = entry;
+	_head = entry;
+}
+
+void StripCache::removeEntry(Entry *entry) {
+	unlinkEntry(entry);
+	_entries.erase(entry->key);
+	_size -= entrySize(entry);
+	delete[] entry->data;
+	delete entry;
+}
+
+void StripCache::evict(uint32 needed) {
+	while (_tail && _size + needed > _maxSize) {
+		removeEntry(_tail);
+		_stats.evictions++;
+	}
+}
+
+} // End of namespace Scumm
@@ -0,0 +1,152 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_STRIPCACHE_H
+#define SCUMM_STRIPCACHE_H
+
+#include "common/hashmap.h"
+
+namespace Scumm {
+
+/**
+ * Keeps decoded 8 pixel wide strips of room and object images, and the
+ * decoded columns of their z-plane masks, so that redrawing a strip which
+ * did not change becomes a copy. Separate instances hold the decoded cels
+ * of AKOS costumes and the span lists of HE Wiz images.
+ *
+ * Entries are identified by the address of the compressed data inside its
+ * resource, the number of lines decoded and the palette map used. The
+ * ResourceManager drops the entries of a resource when it is freed, as the
+ * memory may be reused for other data afterwards. When the cache grows
+ * beyond its size limit, the least recently used entries are evicted.
+ *
+ * Strips which turn out to be transparent depend on what they are drawn
+ * onto and are remembered as such, without their pixels.
+ */
+class StripCache {
+public:
+	enum Kind {
+		kPixels = 0,
+		kMask = 1,
+		kAkos16Cel = 2,
+		kAkos32Cel = 3,
+		kWizSpans = 4
+	};
+
+	struct Stats {
+		uint32 hits, misses, bypassed, evictions, invalidations;
+
+		Stats() { reset(); }
+
+		void reset() {
+			hits = misses = bypassed = evictions = invalidations = 0;
+		}
+	};
+
+	StripCache();
+	~StripCache();
+
+	/**
+	 * Set the number of bytes the cache may use, including the bookkeeping
+	 * of each entry. A size of zero disables the cache.
+	 */
+	void setMaxSize(uint32 size);
+	uint32 getMaxSize() const { return _maxSize; }
+	bool isEnabled() const { return _maxSize != 0; }
+
+	/**
+	 * Look up the decoded data of a strip.
+	 *
+	 * @param data	set to the decoded data, or to 0 if the strip is known to
+	 *				be uncacheable
+	 * @return	true if the strip was found
+	 */
+	bool lookup(Kind kind, const byte *src, const byte *palette, uint16 height, const byte *&data);
+
+	/**
+	 * Add a strip to the cache.
+	 *
+	 * @param size	the size of the decoded data, or 0 to remember that the
+	 *				strip cannot be cached
+	 * @return	the buffer to store the decoded data in, or 0 if the strip
+	 *			does not fit into the cache or size was 0
+	 */
+	byte *insert(Kind kind, const byte *src, const byte *palette, uint16 height, uint32 size);
+
+	/**
+	 * Drop all strips decoded from data in the given memory range.
+	 */
+	void invalidate(const byte *start, uint32 size);
+
+	void clear();
+
+	uint32 getSize() const { return _size; }
+	uint getEntryCount() const { return _entries.size(); }
+
+	Stats &getStats() { return _stats; }
+	const Stats &getStats() const { return _stats; }
+
+private:
+	struct Key {
+		const byte *src;
+		const byte *palette;
+		uint16 height;
+		byte kind;
+
+		bool operator==(const Key &other) const {
+			return src == other.src && palette == other.palette && height == other.height && kind == other.kind;
+		}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const {
+			return (uint)(size_t)key.src * 31 + (uint)(size_t)key.palette + key.height * 7 + key.kind;
+		}
+	};
+
+	struct Entry {
+		Key key;
+		byte *data;
+		uint32 size;
+		Entry *prev, *next;		///< neighbours in the LRU list
+	};
+
+	typedef Common::HashMap<Key, Entry *, KeyHash> EntryMap;
+
+	static uint32 entrySize(const Entry *entry) {
+		return sizeof(Entry) + entry->size;
+	}
+
+	void unlinkEntry(Entry *entry);
+	void linkFront(Entry *entry);
+	void removeEntry(Entry *entry);
+	void evict(uint32 needed);
+
+	EntryMap _entries;
+	Entry *_head, *_tail;		///< most and least recently used entries
+	uint32 _size, _maxSize;
+	Stats _stats;
+};
+
+} // End of namespace Scumm
+
+#endif
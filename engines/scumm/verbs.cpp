@@ -352,7 +352,7 @@ void ScummEngine_v2::checkV2MouseOver(Common::Point pos) {
 				dst += vs->pitch;
 			}
 
-			markRectAsDirty(kVerbVirtScreen, rect);
+			markRectAsDirty(kVerbVirtScreen, rect, 0, kDamageVerb);
 		}
 
 		if (new_box != -1) {
@@ -369,7 +369,7 @@ void ScummEngine_v2::checkV2MouseOver(Common::Point pos) {
 				dst += vs->pitch;
 			}
 
-			markRectAsDirty(kVerbVirtScreen, rect);
+			markRectAsDirty(kVerbVirtScreen, rect, 0, kDamageVerb);
 		}
 
 		_mouseOverBoxV2 = new_box;
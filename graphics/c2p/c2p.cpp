@@ -0,0 +1,234 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/c2p/c2p.h"
+
+#include "common/endian.h"
+#include "common/util.h"
+
+namespace Graphics {
+
+// Exchanges the bits of a selected by (mask << shift) with the bits of b
+// selected by mask.
+#define C2P_MERGE(a, b, mask, shift) \
+	do { \
+		uint32 t = (((a) >> (shift)) ^ (b)) & (mask); \
+		(b) ^= t; \
+		(a) ^= t << (shift); \
+	} while (0)
+
+void c2pConvertGroup(const byte *src, uint32 *dst) {
+	uint32 w0 = READ_BE_UINT32(src);
+	uint32 w1 = READ_BE_UINT32(src + 4);
+	uint32 w2 = READ_BE_UINT32(src + 8);
+	uint32 w3 = READ_BE_UINT32(src + 12);
+	uint32 w4 = READ_BE_UINT32(src + 16);
+	uint32 w5 = READ_BE_UINT32(src + 20);
+	uint32 w6 = READ_BE_UINT32(src + 24);
+	uint32 w7 = READ_BE_UINT32(src + 28);
+
+	// This transposes the 32x8 bit matrix of pixels and their color bits.
+	// Each pass exchanges one bit of the word index with one bit of the bit
+	// position, pairing the words the right way round so that the pixel
+	// order ends up reversed, i.e. leftmost pixel in the highest bit.
+	C2P_MERGE(w4, w0, 0x0000FFFF, 16);
+	C2P_MERGE(w5, w1, 0x0000FFFF, 16);
+	C2P_MERGE(w6, w2, 0x0000FFFF, 16);
+	C2P_MERGE(w7, w3, 0x0000FFFF, 16);
+
+	C2P_MERGE(w2, w0, 0x00FF00FF, 8);
+	C2P_MERGE(w3, w1, 0x00FF00FF, 8);
+	C2P_MERGE(w6, w4, 0x00FF00FF, 8);
+	C2P_MERGE(w7, w5, 0x00FF00FF, 8);
+
+	C2P_MERGE(w1, w0, 0x0F0F0F0F, 4);
+	C2P_MERGE(w3, w2, 0x0F0F0F0F, 4);
+	C2P_MERGE(w5, w4, 0x0F0F0F0F, 4);
+	C2P_MERGE(w7, w6, 0x0F0F0F0F, 4);
+
+	C2P_MERGE(w4, w0, 0x33333333, 2);
+	C2P_MERGE(w5, w1, 0x33333333, 2);
+	C2P_MERGE(w6, w2, 0x33333333, 2);
+	C2P_MERGE(w7, w3, 0x33333333, 2);
+
+	C2P_MERGE(w2, w0, 0x55555555, 1);
+	C2P_MERGE(w3, w1, 0x55555555, 1);
+	C2P_MERGE(w6, w4, 0x55555555, 1);
+	C2P_MERGE(w7, w5, 0x55555555, 1);
+
+	dst[0] = w7;
+	dst[1] = w5;
+	dst[2] = w3;
+	dst[3] = w1;
+	dst[4] = w6;
+	dst[5] = w4;
+	dst[6] = w2;
+	dst[7] = w0;
+}
+
+#undef C2P_MERGE
+
+static bool groupUnchanged(const byte *src, const byte *previous, uint count) {
+	for (uint i = 0; i < count; ++i) {
+		if (src[i] != previous[i])
+			return false;
+	}
+	return true;
+}
+
+static bool groupUnchanged(const byte *src, const byte *previous) {
+	for (uint i = 0; i < kC2PGroupWidth; i += 4) {
+		if (READ_UINT32(src + i) != READ_UINT32(previous + i))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Convert the whole groups firstGroup up to (excluding) lastGroup of the
+ * given rows. Offsets into src and previous are identical.
+ */
+static uint convertGroups(const byte *src, uint srcPitch, int firstGroup, int lastGroup, int top, int bottom,
+                          const PlanarBitmap &dst, byte *previous) {
+	uint converted = 0;
+	uint32 planes[PlanarBitmap::kDepth];
+
+	for (int y = top; y < bottom; ++y) {
+		uint srcOffset = y * srcPitch + firstGroup * kC2PGroupWidth;
+		uint dstOffset = y * dst.bytesPerRow + firstGroup * (kC2PGroupWidth / 8);
+
+		for (int group = firstGroup; group < lastGroup; ++group) {
+			const byte *s = src + srcOffset;
+
+			if (!previous || !groupUnchanged(s, previous + srcOffset)) {
+				c2pConvertGroup(s, planes);
+				for (int p = 0; p < PlanarBitmap::kDepth; ++p)
+					WRITE_BE_UINT32(dst.planes[p] + dstOffset, planes[p]);
+
+				if (previous)
+					memcpy(previous + srcOffset, s, kC2PGroupWidth);
+				++converted;
+			}
+
+			srcOffset += kC2PGroupWidth;
+			dstOffset += kC2PGroupWidth / 8;
+		}
+	}
+
+	return converted;
+}
+
+/**
+ * Convert the pixels first up to (excluding) last of a single group,
+ * keeping the other pixels of the destination words.
+ */
+static uint convertPartialGroup(const byte *src, uint srcPitch, int group, int first, int last, int y,
+                                const PlanarBitmap &dst, byte *previous) {
+	const int groupX = group * kC2PGroupWidth;
+	const uint srcOffset = y * srcPitch + groupX + first;
+
+	if (previous && groupUnchanged(src + srcOffset, previous + srcOffset, last - first))
+		return 0;
+
+	byte pixels[kC2PGroupWidth];
+	memset(pixels, 0, sizeof(pixels));
+	memcpy(pixels + first, src + srcOffset, last - first);
+
+	uint32 planes[PlanarBitmap::kDepth];
+	c2pConvertGroup(pixels, planes);
+
+	uint32 mask = 0xFFFFFFFF >> first;
+	if (last < kC2PGroupWidth)
+		mask &= ~(0xFFFFFFFF >> last);
+
+	// Only touch the bytes of the planes that are covered, the last group
+	// of a row may reach past the end of the bitplane.
+	const uint dstOffset = y * dst.bytesPerRow + groupX / 8;
+	for (int b = first / 8; b <= (last - 1) / 8; ++b) {
+		const int shift = 24 - b * 8;
+		const byte byteMask = (mask >> shift) & 0xFF;
+
+		for (int p = 0; p < PlanarBitmap::kDepth; ++p) {
+			byte *d = dst.planes[p] + dstOffset + b;
+			*d = (*d & ~byteMask) | ((planes[p] >> shift) & byteMask);
+		}
+	}
+
+	if (previous)
+		memcpy(previous + srcOffset, src + srcOffset, last - first);
+
+	return 1;
+}
+
+uint c2pConvertFrame(const byte *src, uint srcPitch, uint w, uint h, const PlanarBitmap &dst, byte *previous) {
+	assert(w % kC2PGroupWidth == 0);
+
+	return convertGroups(src, srcPitch, 0, w / kC2PGroupWidth, 0, h, dst, previous);
+}
+
+uint c2pConvertStrips(const byte *src, uint srcPitch, const Common::Rect &area, const PlanarBitmap &dst, byte *previous) {
+	if (area.isEmpty())
+		return 0;
+
+	const int firstGroup = area.left / kC2PGroupWidth;
+	const int lastGroup = (area.right + kC2PGroupWidth - 1) / kC2PGroupWidth;
+
+	return convertGroups(src, srcPitch, firstGroup, lastGroup, area.top, area.bottom, dst, previous);
+}
+
+uint c2pConvertRect(const byte *src, uint srcPitch, const Common::Rect &area, const PlanarBitmap &dst, byte *previous) {
+	if (area.isEmpty())
+		return 0;
+
+	int firstGroup = area.left / kC2PGroupWidth;
+	int lastGroup = area.right / kC2PGroupWidth;
+	const int leftPixel = area.left % kC2PGroupWidth;
+	const int rightPixel = area.right % kC2PGroupWidth;
+
+	// The area lies within a single group.
+	if (firstGroup == lastGroup) {
+		uint converted = 0;
+		for (int y = area.top; y < area.bottom; ++y)
+			converted += convertPartialGroup(src, srcPitch, firstGroup, leftPixel, rightPixel, y, dst, previous);
+		return converted;
+	}
+
+	uint converted = 0;
+
+	if (leftPixel) {
+		for (int y = area.top; y < area.bottom; ++y)
+			converted += convertPartialGroup(src, srcPitch, firstGroup, leftPixel, kC2PGroupWidth, y, dst, previous);
+		++firstGroup;
+	}
+
+	if (rightPixel) {
+		for (int y = area.top; y < area.bottom; ++y)
+			converted += convertPartialGroup(src, srcPitch, lastGroup, 0, rightPixel, y, dst, previous);
+	}
+
+	if (firstGroup < lastGroup)
+		converted += convertGroups(src, srcPitch, firstGroup, lastGroup, area.top, area.bottom, dst, previous);
+
+	return converted;
+}
+
+} // End of namespace Graphics
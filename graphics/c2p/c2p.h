@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_C2P_H
+#define GRAPHICS_C2P_H
+
+#include "common/rect.h"
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * Destination of a chunky to planar conversion: eight separate bitplanes
+ * of the same layout, as found in an AmigaOS BitMap. The leftmost pixel of
+ * each byte is stored in its most significant bit.
+ */
+struct PlanarBitmap {
+	enum {
+		kDepth = 8
+	};
+
+	byte *planes[kDepth];
+	uint bytesPerRow;
+};
+
+/**
+ * Number of pixels converted in one go. The strip and frame converters
+ * only ever write whole groups, i.e. whole 32 bit words of each plane.
+ */
+enum {
+	kC2PGroupWidth = 32
+};
+
+/**
+ * Convert 32 chunky pixels into one 32 bit word for each bitplane.
+ *
+ * @param src	the 32 chunky pixels
+ * @param dst	receives the word of plane n in dst[n]
+ */
+void c2pConvertGroup(const byte *src, uint32 *dst);
+
+/**
+ * Convert a whole frame.
+ *
+ * @param src		the chunky pixels
+ * @param srcPitch	width in bytes of one line of src
+ * @param w			the width of the frame, a multiple of kC2PGroupWidth
+ * @param h			the height of the frame
+ * @param dst		the planar destination
+ * @param previous	if not NULL, the chunky frame the planar destination
+ *					currently shows, using the pitch of src. Unchanged
+ *					groups are skipped and converted groups are copied
+ *					into it.
+ * @return			the number of groups written to dst
+ */
+uint c2pConvertFrame(const byte *src, uint srcPitch, uint w, uint h, const PlanarBitmap &dst, byte *previous = 0);
+
+/**
+ * Convert an area extended to whole groups horizontally. This is the
+ * fastest way to update a part of the destination, at the cost of also
+ * converting the pixels to the left and the right of the area which share
+ * a group with it.
+ *
+ * The width of the frame src belongs to has to be a multiple of
+ * kC2PGroupWidth. See c2pConvertFrame for the other parameters.
+ */
+uint c2pConvertStrips(const byte *src, uint srcPitch, const Common::Rect &area, const PlanarBitmap &dst, byte *previous = 0);
+
+/**
+ * Convert exactly the pixels of an area. Groups only partially covered by
+ * the area are merged into the destination, and no chunky pixel outside of
+ * the area is read. See c2pConvertFrame for the other parameters.
+ */
+uint c2pConvertRect(const byte *src, uint srcPitch, const Common::Rect &area, const PlanarBitmap &dst, byte *previous = 0);
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,226 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/colormap16.h"
+
+#include "common/array.h"
+#include "common/stream.h"
+#include "common/util.h"
+
+namespace Graphics {
+
+// Colors are grouped into cubes of 32 values per component while the
+// table is built.
+enum {
+	kCellShift = 5,
+	kCellSize = 1 << kCellShift,
+	kCellsPerComponent = 256 / kCellSize,
+	kNumCells = kCellsPerComponent * kCellsPerComponent * kCellsPerComponent
+};
+
+static const int8 s_ditherMatrix[4][4] = {
+	{ -8,  0, -6,  2 },
+	{  4, -4,  6, -2 },
+	{ -5,  3, -7,  1 },
+	{  7, -1,  5, -3 }
+};
+
+ColorMap16::ColorMap16() : _table(0) {
+}
+
+ColorMap16::~ColorMap16() {
+	delete[] _table;
+}
+
+void ColorMap16::allocate() {
+	if (!_table)
+		_table = new byte[kSize];
+}
+
+static inline uint32 squaredDistance(int r1, int g1, int b1, int r2, int g2, int b2) {
+	return (r1 - r2) * (r1 - r2) + (g1 - g2) * (g1 - g2) + (b1 - b2) * (b1 - b2);
+}
+
+static inline int distanceToRange(int value, int low, int high) {
+	if (value < low)
+		return low - value;
+	if (value > high)
+		return value - high;
+	return 0;
+}
+
+/**
+ * Collect the palette entries which may be the closest one for any color
+ * in the given cell, in ascending order. These are the entries which are
+ * not further away from the cell than the farthest point of the cell is
+ * from the entry that is best in the worst case.
+ */
+static void findCandidates(uint cell, const byte *palette, uint numColors, Common::Array<byte> &candidates) {
+	const int lowR = (cell / (kCellsPerComponent * kCellsPerComponent)) * kCellSize;
+	const int lowG = ((cell / kCellsPerComponent) % kCellsPerComponent) * kCellSize;
+	const int lowB = (cell % kCellsPerComponent) * kCellSize;
+
+	uint32 bound = 0xFFFFFFFF;
+	for (uint i = 0; i < numColors; ++i) {
+		const byte *p = palette + i * 3;
+		const int dr = MAX<int>(ABS(p[0] - lowR), ABS(p[0] - (lowR + kCellSize - 1)));
+		const int dg = MAX<int>(ABS(p[1] - lowG), ABS(p[1] - (lowG + kCellSize - 1)));
+		const int db = MAX<int>(ABS(p[2] - lowB), ABS(p[2] - (lowB + kCellSize - 1)));
+		bound = MIN<uint32>(bound, dr * dr + dg * dg + db * db);
+	}
+
+	for (uint i = 0; i < numColors; ++i) {
+		const byte *p = palette + i * 3;
+		const int dr = distanceToRange(p[0], lowR, lowR + kCellSize - 1);
+		const int dg = distanceToRange(p[1], lowG, lowG + kCellSize - 1);
+		const int db = distanceToRange(p[2], lowB, lowB + kCellSize - 1);
+		if ((uint32)(dr * dr + dg * dg + db * db) <= bound)
+			candidates.push_back(i);
+	}
+}
+
+void ColorMap16::build(const PixelFormat &format, const byte *palette, uint numColors) {
+	assert(format.bytesPerPixel == 2);
+	assert(numColors > 0 && numColors <= 256);
+
+	_format = format;
+	allocate();
+
+	// Candidates are only collected for cells which actually contain colors
+	// of the format. A cell without candidates has not been visited yet.
+	Common::Array<byte> candidates;
+	Common::Array<uint32> cellStart;
+	Common::Array<uint16> cellSize;
+	cellStart.resize(kNumCells);
+	cellSize.resize(kNumCells);
+	for (uint i = 0; i < kNumCells; ++i)
+		cellSize[i] = 0;
+
+	for (uint color = 0; color < kSize; ++color) {
+		byte r, g, b;
+		format.colorToRGB(color, r, g, b);
+
+		const uint cell = ((r >> kCellShift) * kCellsPerComponent + (g >> kCellShift)) * kCellsPerComponent + (b >> kCellShift);
+		if (!cellSize[cell]) {
+			cellStart[cell] = candidates.size();
+			findCandidates(cell, palette, numColors, candidates);
+			cellSize[cell] = candidates.size() - cellStart[cell];
+		}
+
+		const byte *entry = &candidates[cellStart[cell]];
+		byte best = entry[0];
+		uint32 bestDistance = 0xFFFFFFFF;
+
+		for (uint i = 0; i < cellSize[cell]; ++i) {
+			const byte *p = palette + entry[i] * 3;
+			const uint32 distance = squaredDistance(r, g, b, p[0], p[1], p[2]);
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				best = entry[i];
+			}
+		}
+
+		_table[color] = best;
+	}
+}
+
+bool ColorMap16::load(const PixelFormat &format, Common::ReadStream &stream) {
+	assert(format.bytesPerPixel == 2);
+
+	if (stream.readUint32BE() != MKTAG('O', 'M', 'A', 'P'))
+		return false;
+	if (stream.readUint32BE() != kVersion)
+		return false;
+
+	allocate();
+	if (stream.read(_table, kSize) != kSize || stream.err()) {
+		delete[] _table;
+		_table = 0;
+		return false;
+	}
+
+	_format = format;
+	return true;
+}
+
+void ColorMap16::save(Common::WriteStream &stream) const {
+	assert(_table);
+
+	stream.writeUint32BE(MKTAG('O', 'M', 'A', 'P'));
+	stream.writeUint32BE(kVersion);
+	stream.write(_table, kSize);
+}
+
+void ColorMap16::convertRow(const uint16 *src, byte *dst, uint width) const {
+	const byte *table = _table;
+
+	while (width >= 4) {
+		dst[0] = table[src[0]];
+		dst[1] = table[src[1]];
+		dst[2] = table[src[2]];
+		dst[3] = table[src[3]];
+		src += 4;
+		dst += 4;
+		width -= 4;
+	}
+
+	while (width--)
+		*dst++ = table[*src++];
+}
+
+void ColorMap16::convertRowDithered(const uint16 *src, byte *dst, uint width, uint x, uint y) const {
+	const int8 *matrix = s_ditherMatrix[y & 3];
+
+	for (uint i = 0; i < width; ++i) {
+		byte r, g, b;
+		_format.colorToRGB(src[i], r, g, b);
+
+		const int offset = matrix[(x + i) & 3];
+		r = CLIP<int>(r + offset, 0, 255);
+		g = CLIP<int>(g + offset, 0, 255);
+		b = CLIP<int>(b + offset, 0, 255);
+
+		dst[i] = _table[_format.RGBToColor(r, g, b) & 0xFFFF];
+	}
+}
+
+void ColorMap16::convertRect(const void *src, uint srcPitch, byte *dst, uint dstPitch, uint w, uint h) const {
+	const byte *line = (const byte *)src;
+
+	while (h--) {
+		convertRow((const uint16 *)line, dst, w);
+		line += srcPitch;
+		dst += dstPitch;
+	}
+}
+
+void ColorMap16::convertRectDithered(const void *src, uint srcPitch, byte *dst, uint dstPitch, uint x, uint y, uint w, uint h) const {
+	const byte *line = (const byte *)src;
+
+	for (uint i = 0; i < h; ++i) {
+		convertRowDithered((const uint16 *)line, dst, w, x, y + i);
+		line += srcPitch;
+		dst += dstPitch;
+	}
+}
+
+} // End of namespace Graphics
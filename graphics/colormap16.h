@@ -0,0 +1,120 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_COLORMAP16_H
+#define GRAPHICS_COLORMAP16_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+
+namespace Common {
+class ReadStream;
+class WriteStream;
+}
+
+namespace Graphics {
+
+/**
+ * Maps every 16 bit color to the closest entry of an 8 bit palette, so
+ * that a high color surface can be shown on a palettized screen with one
+ * table lookup per pixel.
+ *
+ * The closest entry is the one with the smallest squared RGB distance; of
+ * several equally close entries the one with the lowest index is used.
+ * Tables created by devtools/create_overlaymap follow the same rules.
+ *
+ * The binary form consists of the tag 'OMAP', a big endian uint32 version
+ * and the 65536 palette indices.
+ */
+class ColorMap16 {
+public:
+	enum {
+		kSize = 65536,
+		kVersion = 1
+	};
+
+	ColorMap16();
+	~ColorMap16();
+
+	/**
+	 * Compute the table for the colors of the given 16 bit format.
+	 *
+	 * @param format	the format of the 16 bit colors
+	 * @param palette	the palette, 3 bytes per entry
+	 * @param numColors	the number of palette entries
+	 */
+	void build(const PixelFormat &format, const byte *palette, uint numColors);
+
+	/**
+	 * Load a table stored by save() or devtools/create_overlaymap.
+	 *
+	 * @return	true if the stream contained a valid table
+	 */
+	bool load(const PixelFormat &format, Common::ReadStream &stream);
+
+	void save(Common::WriteStream &stream) const;
+
+	bool isValid() const { return _table != 0; }
+
+	byte lookup(uint16 color) const { return _table[color]; }
+
+	/**
+	 * Convert one line of 16 bit colors to palette indices.
+	 */
+	void convertRow(const uint16 *src, byte *dst, uint width) const;
+
+	/**
+	 * Convert one line using a 4x4 ordered dither, which trades the color
+	 * banding of large gradients for a fine regular pattern.
+	 *
+	 * @param x, y	the screen position of the first pixel, which aligns
+	 *				the dither pattern of separately converted areas
+	 */
+	void convertRowDithered(const uint16 *src, byte *dst, uint width, uint x, uint y) const;
+
+	/**
+	 * Convert a rectangle of 16 bit colors.
+	 *
+	 * @param src		the 16 bit colors
+	 * @param srcPitch	width in bytes of one line of src
+	 * @param dst		receives the palette indices
+	 * @param dstPitch	width in bytes of one line of dst
+	 */
+	void convertRect(const void *src, uint srcPitch, byte *dst, uint dstPitch, uint w, uint h) const;
+
+	/**
+	 * Convert a rectangle using convertRowDithered.
+	 *
+	 * @param x, y	the screen position of the rectangle
+	 */
+	void convertRectDithered(const void *src, uint srcPitch, byte *dst, uint dstPitch, uint x, uint y, uint w, uint h) const;
+
+private:
+	PixelFormat _format;
+	byte *_table;
+
+	void allocate();
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,158 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/cursor_layer.h"
+
+#include "graphics/dirty_rects.h"
+
+namespace Graphics {
+
+CursorLayer::CursorLayer(uint numBuffers)
+	: _scratch(0), _keyColor(0), _hotspotX(0), _hotspotY(0), _x(0), _y(0), _visible(false) {
+	assert(numBuffers > 0);
+
+	_presentedRects.resize(numBuffers);
+	_imageChanged.resize(numBuffers);
+	reset();
+}
+
+CursorLayer::~CursorLayer() {
+	_image.free();
+	delete[] _scratch;
+}
+
+void CursorLayer::setCursor(const byte *pixels, uint w, uint h, int hotspotX, int hotspotY, uint32 keyColor) {
+	if (w != (uint)_image.w || h != (uint)_image.h) {
+		_image.create(w, h, PixelFormat::createFormatCLUT8());
+		delete[] _scratch;
+		_scratch = new byte[w * h];
+	}
+
+	for (uint y = 0; y < h; ++y)
+		memcpy(_image.getBasePtr(0, y), pixels + y * w, w);
+
+	_hotspotX = hotspotX;
+	_hotspotY = hotspotY;
+	_keyColor = keyColor;
+
+	for (uint i = 0; i < _imageChanged.size(); ++i)
+		_imageChanged[i] = true;
+}
+
+void CursorLayer::setPosition(int x, int y) {
+	_x = x;
+	_y = y;
+}
+
+bool CursorLayer::setVisible(bool visible) {
+	const bool last = _visible;
+	_visible = visible;
+	return last;
+}
+
+void CursorLayer::reset() {
+	for (uint i = 0; i < _presentedRects.size(); ++i) {
+		_presentedRects[i] = Common::Rect();
+		_imageChanged[i] = true;
+	}
+}
+
+Common::Rect CursorLayer::getRect(int16 screenWidth, int16 screenHeight) const {
+	if (!_visible || !_image.getPixels())
+		return Common::Rect();
+
+	Common::Rect r(_x - _hotspotX, _y - _hotspotY, _x - _hotspotX + _image.w, _y - _hotspotY + _image.h);
+	r.clip(screenWidth, screenHeight);
+	if (r.isEmpty())
+		return Common::Rect();
+	return r;
+}
+
+void CursorLayer::present(const Surface &screen, DirtyRectList &dirty, uint buffer, CursorPresenter &presenter) {
+	assert(buffer < _presentedRects.size());
+	assert(screen.format.bytesPerPixel == 1);
+
+	const Common::Rect cursorRect = getRect(screen.w, screen.h);
+	Common::Rect &presented = _presentedRects[buffer];
+
+	if (presented != cursorRect || _imageChanged[buffer]) {
+		dirty.addRect(presented);
+		dirty.addRect(cursorRect);
+		presented = cursorRect;
+		_imageChanged[buffer] = false;
+	}
+
+	for (DirtyRectList::const_iterator i = dirty.begin(); i != dirty.end(); ++i) {
+		Common::Rect r = *i;
+		r.clip(screen.w, screen.h);
+		if (!r.isEmpty())
+			presentArea(screen, r, cursorRect, presenter);
+	}
+}
+
+void CursorLayer::presentArea(const Surface &screen, const Common::Rect &r, const Common::Rect &cursorRect, CursorPresenter &presenter) {
+	if (!r.intersects(cursorRect)) {
+		presenter.presentRect(r, (const byte *)screen.getBasePtr(r.left, r.top), screen.pitch);
+		return;
+	}
+
+	// Split the area into the parts above, left of, right of and below the
+	// cursor, which come straight from the screen, and the part shared
+	// with the cursor.
+	Common::Rect shared(r);
+	shared.clip(cursorRect);
+
+	const Common::Rect parts[4] = {
+		Common::Rect(r.left, r.top, r.right, shared.top),
+		Common::Rect(r.left, shared.top, shared.left, shared.bottom),
+		Common::Rect(shared.right, shared.top, r.right, shared.bottom),
+		Common::Rect(r.left, shared.bottom, r.right, r.bottom)
+	};
+
+	for (uint i = 0; i < ARRAYSIZE(parts); ++i) {
+		if (!parts[i].isEmpty())
+			presenter.presentRect(parts[i], (const byte *)screen.getBasePtr(parts[i].left, parts[i].top), screen.pitch);
+	}
+
+	compose(screen, shared, presenter);
+}
+
+void CursorLayer::compose(const Surface &screen, const Common::Rect &r, CursorPresenter &presenter) {
+	const int w = r.width();
+	const int cursorX = r.left - (_x - _hotspotX);
+	const int cursorY = r.top - (_y - _hotspotY);
+
+	byte *dst = _scratch;
+	for (int y = 0; y < r.height(); ++y) {
+		const byte *src = (const byte *)screen.getBasePtr(r.left, r.top + y);
+		const byte *cursor = (const byte *)_image.getBasePtr(cursorX, cursorY + y);
+
+		for (int x = 0; x < w; ++x)
+			dst[x] = (cursor[x] != _keyColor) ? cursor[x] : src[x];
+
+		dst += w;
+	}
+
+	presenter.presentRect(r, _scratch, w);
+}
+
+} // End of namespace Graphics
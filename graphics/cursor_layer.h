@@ -0,0 +1,125 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_CURSOR_LAYER_H
+#define GRAPHICS_CURSOR_LAYER_H
+
+#include "common/array.h"
+#include "common/rect.h"
+#include "graphics/surface.h"
+
+namespace Graphics {
+
+class DirtyRectList;
+
+/**
+ * Receives the areas of the screen which have to be updated.
+ */
+class CursorPresenter {
+public:
+	virtual ~CursorPresenter() {}
+
+	/**
+	 * Show the given pixels at the position of r.
+	 *
+	 * @param r			the area of the screen
+	 * @param pixels	the top left pixel of the area
+	 * @param pitch		width in bytes of one line of pixels
+	 */
+	virtual void presentRect(const Common::Rect &r, const byte *pixels, uint pitch) = 0;
+};
+
+/**
+ * A software mouse cursor for 8 bit backends which present their screen
+ * in rectangles, e.g. through chunky to planar conversion.
+ *
+ * The cursor is never drawn into the game screen. Instead, when a dirty
+ * area is presented, the lines it shares with the cursor are composited
+ * into a small scratch buffer, while everything else is presented straight
+ * from the screen. The areas the cursor moved from and to are added to the
+ * dirty areas, so a frame in which only the cursor moved presents just
+ * those.
+ *
+ * The layer remembers where the cursor was presented to each of several
+ * screen buffers, for backends which flip between buffers.
+ */
+class CursorLayer {
+public:
+	CursorLayer(uint numBuffers = 1);
+	~CursorLayer();
+
+	/**
+	 * Set the cursor image. Pixels of the key color are transparent.
+	 */
+	void setCursor(const byte *pixels, uint w, uint h, int hotspotX, int hotspotY, uint32 keyColor);
+
+	void setPosition(int x, int y);
+	int getX() const { return _x; }
+	int getY() const { return _y; }
+
+	/**
+	 * @return	the previous visibility
+	 */
+	bool setVisible(bool visible);
+	bool isVisible() const { return _visible; }
+
+	/**
+	 * Forget what was presented to the screen buffers, e.g. after a
+	 * mode change.
+	 */
+	void reset();
+
+	/**
+	 * Return the area covered by the cursor, clipped to a screen of the
+	 * given size. Empty if the cursor is hidden.
+	 */
+	Common::Rect getRect(int16 screenWidth, int16 screenHeight) const;
+
+	/**
+	 * Present the dirty areas of screen, with the cursor on top.
+	 *
+	 * The areas the cursor was presented at in the given buffer and where
+	 * it is now are added to dirty first, unless the cursor did not
+	 * change. The list is not cleared.
+	 */
+	void present(const Surface &screen, DirtyRectList &dirty, uint buffer, CursorPresenter &presenter);
+
+private:
+	void presentArea(const Surface &screen, const Common::Rect &r, const Common::Rect &cursorRect, CursorPresenter &presenter);
+	void compose(const Surface &screen, const Common::Rect &r, CursorPresenter &presenter);
+
+	Surface _image;
+	byte *_scratch;
+	uint32 _keyColor;
+	int _hotspotX, _hotspotY;
+	int _x, _y;
+	bool _visible;
+
+	/** Where the cursor was last presented to each buffer. */
+	Common::Array<Common::Rect> _presentedRects;
+	/** Whether the image changed since it was last presented to each buffer. */
+	Common::Array<bool> _imageChanged;
+};
+
+} // End of namespace Graphics
+
+#endif
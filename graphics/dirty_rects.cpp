@@ -0,0 +1,95 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/dirty_rects.h"
+
+namespace Graphics {
+
+DirtyRectList::DirtyRectList(uint maxRects) : _maxRects(maxRects), _area(0), _full(false) {
+}
+
+void DirtyRectList::setBounds(int16 width, int16 height) {
+	_bounds = Common::Rect(width, height);
+	markAll();
+}
+
+void DirtyRectList::addRect(const Common::Rect &rect) {
+	if (_full || !rect.isValidRect())
+		return;
+
+	Common::Rect r(rect);
+	r.clip(_bounds);
+	if (r.isEmpty())
+		return;
+
+	// Swallow every entry the new rectangle can be merged with. A grown
+	// rectangle may reach entries it was too far away from before, so the
+	// scan restarts after each merge.
+	uint i = 0;
+	while (i < _rects.size()) {
+		const Common::Rect &entry = _rects[i];
+		if (entry.contains(r))
+			return;
+
+		Common::Rect merged(entry);
+		merged.extend(r);
+		if (area(merged) <= area(entry) + area(r) + kMergeSlack) {
+			_area -= area(entry);
+			_rects.remove_at(i);
+			r = merged;
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	// Presenting a few large rectangles costs more than a single full
+	// update once most of the surface is covered.
+	if (r == _bounds || _rects.size() >= _maxRects || (_area + area(r)) >= area(_bounds) / 4 * 3) {
+		markAll();
+		return;
+	}
+
+	_rects.push_back(r);
+	_area += area(r);
+}
+
+void DirtyRectList::markAll() {
+	_rects.clear();
+	_area = 0;
+	_full = false;
+
+	if (_bounds.isEmpty())
+		return;
+
+	_rects.push_back(_bounds);
+	_area = area(_bounds);
+	_full = true;
+}
+
+void DirtyRectList::clear() {
+	_rects.clear();
+	_area = 0;
+	_full = false;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTY_RECTS_H
+#define GRAPHICS_DIRTY_RECTS_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * A list of modified areas of a fixed size surface.
+ *
+ * Rectangles added to the list are clipped against the surface bounds and
+ * merged with their neighbours whenever the merged rectangle does not cover
+ * noticeably more pixels than the two separate ones. If too many rectangles
+ * accumulate, or most of the surface is dirty anyway, the list collapses
+ * into a single rectangle covering the whole surface.
+ *
+ * Backends which present through more than one buffer keep one list per
+ * buffer, so that each buffer is brought up to date with everything that
+ * changed since it was last shown.
+ */
+class DirtyRectList {
+public:
+	typedef Common::Array<Common::Rect>::const_iterator const_iterator;
+
+	enum {
+		/** Default number of rectangles kept before collapsing. */
+		kDefaultMaxRects = 32,
+		/** Number of extra pixels a merge may cover. */
+		kMergeSlack = 256
+	};
+
+	DirtyRectList(uint maxRects = kDefaultMaxRects);
+
+	/**
+	 * Set the size of the surface tracked. This marks the whole
+	 * surface as dirty.
+	 */
+	void setBounds(int16 width, int16 height);
+
+	const Common::Rect &getBounds() const { return _bounds; }
+
+	/**
+	 * Add a modified area. The rectangle is clipped to the surface bounds.
+	 */
+	void addRect(const Common::Rect &r);
+
+	void addRect(int x, int y, int w, int h) {
+		addRect(Common::Rect(x, y, x + w, y + h));
+	}
+
+	/**
+	 * Mark the whole surface as dirty.
+	 */
+	void markAll();
+
+	/**
+	 * Forget all modified areas, usually after they have been presented.
+	 */
+	void clear();
+
+	bool empty() const { return _rects.empty(); }
+
+	/**
+	 * Return whether the list was collapsed into a single rectangle
+	 * covering the whole surface.
+	 */
+	bool isFull() const { return _full; }
+
+	uint size() const { return _rects.size(); }
+
+	/**
+	 * Return the number of pixels covered by the list. Rectangles which
+	 * overlap without having been merged are counted twice.
+	 */
+	uint32 getArea() const { return _area; }
+
+	const_iterator begin() const { return _rects.begin(); }
+	const_iterator end() const { return _rects.end(); }
+
+private:
+	static uint32 area(const Common::Rect &r) {
+		return (uint32)r.width() * r.height();
+	}
+
+	Common::Rect _bounds;
+	Common::Array<Common::Rect> _rects;
+	uint _maxRects;
+	uint32 _area;
+	bool _full;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -1,8 +1,12 @@
 MODULE := graphics
 
 MODULE_OBJS := \
+	c2p/c2p.o \
+	colormap16.o \
 	conversion.o \
+	cursor_layer.o \
 	cursorman.o \
+	dirty_rects.o \
 	font.o \
 	fontman.o \
 	fonts/bdf.o \
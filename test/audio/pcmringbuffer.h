@@ -0,0 +1,133 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/pcmringbuffer.h"
+
+#ifdef POSIX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+class PCMRingBufferTestSuite : public CxxTest::TestSuite {
+#ifdef POSIX
+	enum {
+		kStressFrames = 4000000
+	};
+
+	struct StressState {
+		Audio::PCMRingBuffer *ring;
+		uint32 produced;
+		uint32 consumed;
+		bool inOrder;
+	};
+
+	// Writes an increasing sequence in chunks of varying size.
+	static void *producer(void *arg) {
+		StressState &state = *(StressState *)arg;
+		uint32 chunk[97];
+		uint32 next = 0, size = 1;
+
+		while (next < kStressFrames) {
+			size = size % 97 + 1;
+			const uint32 count = MIN<uint32>(size, kStressFrames - next);
+			for (uint32 i = 0; i < count; ++i)
+				chunk[i] = next + i;
+
+			const uint32 written = state.ring->write(chunk, count);
+			next += written;
+			if (written < count)
+				sched_yield();
+		}
+
+		state.produced = next;
+		return 0;
+	}
+
+	// Checks that the sequence arrives complete and in order.
+	static void *consumer(void *arg) {
+		StressState &state = *(StressState *)arg;
+		uint32 chunk[61];
+		uint32 expected = 0, size = 1;
+
+		while (expected < kStressFrames) {
+			size = size % 61 + 1;
+			const uint32 count = state.ring->read(chunk, size);
+			for (uint32 i = 0; i < count; ++i) {
+				if (chunk[i] != expected++)
+					state.inOrder = false;
+			}
+			if (count < size)
+				sched_yield();
+		}
+
+		state.consumed = expected;
+		return 0;
+	}
+#endif
+
+public:
+	void test_capacity() {
+		Audio::PCMRingBuffer ring(1000, 4);
+		TS_ASSERT_EQUALS(ring.getCapacity(), 1024U);
+		TS_ASSERT_EQUALS(ring.getFrameSize(), 4U);
+		TS_ASSERT_EQUALS(ring.getAvailable(), 0U);
+		TS_ASSERT_EQUALS(ring.getFree(), 1024U);
+	}
+
+	void test_wrap_around() {
+		Audio::PCMRingBuffer ring(8, 2);
+		int16 in[6], out[6];
+
+		int16 value = 0;
+		for (uint round = 0; round < 10; ++round) {
+			for (uint i = 0; i < 6; ++i)
+				in[i] = value++;
+
+			TS_ASSERT_EQUALS(ring.write(in, 6), 6U);
+			TS_ASSERT_EQUALS(ring.getAvailable(), 6U);
+			TS_ASSERT_EQUALS(ring.read(out, 6), 6U);
+			TS_ASSERT_EQUALS(memcmp(in, out, sizeof(in)), 0);
+		}
+
+		TS_ASSERT_EQUALS(ring.getUnderruns(), 0U);
+		TS_ASSERT_EQUALS(ring.getOverruns(), 0U);
+	}
+
+	void test_underrun_overrun() {
+		Audio::PCMRingBuffer ring(4, 4);
+		uint32 in[6] = { 1, 2, 3, 4, 5, 6 }, out[6];
+
+		TS_ASSERT_EQUALS(ring.read(out, 1), 0U);
+		TS_ASSERT_EQUALS(ring.getUnderruns(), 1U);
+
+		TS_ASSERT_EQUALS(ring.write(in, 6), 4U);
+		TS_ASSERT_EQUALS(ring.getOverruns(), 1U);
+		TS_ASSERT_EQUALS(ring.getFree(), 0U);
+
+		TS_ASSERT_EQUALS(ring.read(out, 6), 4U);
+		TS_ASSERT_EQUALS(ring.getUnderruns(), 2U);
+		TS_ASSERT_EQUALS(memcmp(in, out, 4 * sizeof(uint32)), 0);
+
+		ring.reset();
+		TS_ASSERT_EQUALS(ring.getUnderruns(), 0U);
+		TS_ASSERT_EQUALS(ring.getOverruns(), 0U);
+		TS_ASSERT_EQUALS(ring.getAvailable(), 0U);
+	}
+
+	void test_threaded_stress() {
+#ifdef POSIX
+		Audio::PCMRingBuffer ring(256, 4);
+		StressState state = { &ring, 0, 0, true };
+
+		pthread_t producerThread, consumerThread;
+		TS_ASSERT_EQUALS(pthread_create(&consumerThread, 0, consumer, &state), 0);
+		TS_ASSERT_EQUALS(pthread_create(&producerThread, 0, producer, &state), 0);
+		pthread_join(producerThread, 0);
+		pthread_join(consumerThread, 0);
+
+		TS_ASSERT_EQUALS(state.produced, (uint32)kStressFrames);
+		TS_ASSERT_EQUALS(state.consumed, (uint32)kStressFrames);
+		TS_ASSERT(state.inOrder);
+		TS_ASSERT_EQUALS(ring.getAvailable(), 0U);
+#endif
+	}
+};
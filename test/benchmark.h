@@ -0,0 +1,54 @@
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+// Helpers shared by the benchmark suites in test/benchmarks. These are
+// built into test/bench_runner with FORBIDDEN_SYMBOL_ALLOW_ALL, so the
+// host's clock() is available.
+
+#include <time.h>
+
+#include "common/str.h"
+
+namespace Benchmark {
+
+/**
+ * Measures processor time spent since construction.
+ */
+class Timer {
+public:
+	Timer() : _start(clock()) {}
+
+	double elapsedMillis() const {
+		return (double)(clock() - _start) * 1000.0 / CLOCKS_PER_SEC;
+	}
+
+private:
+	clock_t _start;
+};
+
+/**
+ * A small deterministic pseudo random generator, so that every run of a
+ * benchmark works on the same data regardless of the host.
+ */
+class Random {
+public:
+	Random(uint32 seed = 0x5eed) : _state(seed) {}
+
+	uint32 next() {
+		_state = _state * 1103515245 + 12345;
+		return (_state >> 8) & 0xFFFFFF;
+	}
+
+	uint32 next(uint32 max) {
+		return max ? next() % max : 0;
+	}
+
+private:
+	uint32 _state;
+};
+
+} // End of namespace Benchmark
+
+#define BENCH_REPORT(str) TS_TRACE((str).c_str())
+
+#endif
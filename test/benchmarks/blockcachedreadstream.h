@@ -0,0 +1,204 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/array.h"
+#include "common/bufferedstream.h"
+#include "common/memstream.h"
+
+// Replays file access traces against a plain stream and against the same
+// stream behind wrapBlockCachedReadStream, and reports how many calls reach
+// the underlying file. On AmigaOS every one of these is a DOS packet round
+// trip, so the call count matters far more than the host time.
+//
+// Two traces shaped after the engines are built in. A trace recorded from a
+// real session can be replayed by pointing BENCH_IO_TRACE to a text file
+// with one operation per line: "S <offset>" (seek), "R <bytes>" (read) or
+// "P" (pos).
+
+class BlockCachedBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kBlockSize = 4096,
+		kBlockCount = 8
+	};
+
+	struct Op {
+		char type;
+		uint32 value;
+	};
+
+	class CountingStream : public Common::MemoryReadStream {
+	public:
+		uint32 calls;
+
+		CountingStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size), calls(0) {}
+
+		virtual uint32 read(void *dataPtr, uint32 dataSize) { ++calls; return Common::MemoryReadStream::read(dataPtr, dataSize); }
+		virtual bool seek(int32 offs, int whence = SEEK_SET) { ++calls; return Common::MemoryReadStream::seek(offs, whence); }
+		virtual int32 pos() const { ++const_cast<CountingStream *>(this)->calls; return Common::MemoryReadStream::pos(); }
+	};
+
+	/**
+	 * SCUMM style resource parsing: walk a file of nested chunks, reading
+	 * each 8 byte header, asking for the position and either skipping the
+	 * chunk or reading its contents in small pieces.
+	 */
+	static void scummTrace(Common::Array<Op> &trace, uint32 fileSize) {
+		Benchmark::Random rnd(1);
+		uint32 offset = 0;
+
+		while (offset + 8 < fileSize) {
+			Op seek = { 'S', offset };
+			trace.push_back(seek);
+			Op header = { 'R', 8 };
+			trace.push_back(header);
+			Op pos = { 'P', 0 };
+			trace.push_back(pos);
+
+			const uint32 size = MIN<uint32>(8 + rnd.next(3000), fileSize - offset);
+			if (rnd.next(10) < 3) {
+				// Parse the contents, e.g. an object or script header.
+				for (uint32 i = 8; i + 4 <= size; i += 4) {
+					Op field = { 'R', (uint32)(2 + 2 * rnd.next(2)) };
+					trace.push_back(field);
+					if (i % 64 == 0)
+						trace.push_back(pos);
+				}
+			}
+			offset += size;
+		}
+	}
+
+	/**
+	 * SCI style resource loading: read the resource map entry by entry,
+	 * then load resources scattered over the volume, each with a small
+	 * header read followed by one read of the whole data.
+	 */
+	static void sciTrace(Common::Array<Op> &trace, uint32 fileSize) {
+		Benchmark::Random rnd(2);
+
+		Op rewind = { 'S', 0 };
+		trace.push_back(rewind);
+		for (uint i = 0; i < 2000; ++i) {
+			Op entry = { 'R', 6 };
+			trace.push_back(entry);
+		}
+
+		for (uint i = 0; i < 400; ++i) {
+			const uint32 size = 16 + rnd.next(20000);
+			Op seek = { 'S', rnd.next(fileSize - size) };
+			trace.push_back(seek);
+			Op header = { 'R', 9 };
+			trace.push_back(header);
+			Op pos = { 'P', 0 };
+			trace.push_back(pos);
+			Op data = { 'R', size };
+			trace.push_back(data);
+		}
+	}
+
+	static bool loadTrace(const char *fileName, Common::Array<Op> &trace, uint32 &fileSize) {
+		FILE *file = fopen(fileName, "r");
+		if (!file)
+			return false;
+
+		char line[64];
+		uint32 offset = 0;
+		fileSize = 0;
+		while (fgets(line, sizeof(line), file)) {
+			Op op = { line[0], (uint32)strtoul(line + 1, 0, 10) };
+			if (op.type != 'S' && op.type != 'R' && op.type != 'P')
+				continue;
+			trace.push_back(op);
+
+			offset = (op.type == 'S') ? op.value : (op.type == 'R') ? offset + op.value : offset;
+			fileSize = MAX(fileSize, offset);
+		}
+		fclose(file);
+		return true;
+	}
+
+	static uint32 replay(Common::SeekableReadStream &stream, const Common::Array<Op> &trace, byte *buffer) {
+		uint32 checksum = 0;
+		for (uint i = 0; i < trace.size(); ++i) {
+			switch (trace[i].type) {
+			case 'S':
+				stream.seek(trace[i].value);
+				break;
+			case 'R':
+				checksum += stream.read(buffer, trace[i].value) ? buffer[0] : 0;
+				break;
+			default:
+				checksum += stream.pos();
+				break;
+			}
+		}
+		return checksum;
+	}
+
+	void run(const char *name, const Common::Array<Op> &trace, uint32 fileSize) {
+		byte *data = new byte[fileSize];
+		Benchmark::Random rnd;
+		for (uint32 i = 0; i < fileSize; ++i)
+			data[i] = rnd.next() & 0xFF;
+
+		uint32 largestRead = 0;
+		for (uint i = 0; i < trace.size(); ++i) {
+			if (trace[i].type == 'R')
+				largestRead = MAX(largestRead, trace[i].value);
+		}
+		byte *buffer = new byte[largestRead + 1];
+
+		CountingStream plain(data, fileSize);
+		Benchmark::Timer plainTimer;
+		const uint32 plainChecksum = replay(plain, trace, buffer);
+		const double plainMillis = plainTimer.elapsedMillis();
+
+		CountingStream parent(data, fileSize);
+		Common::SeekableReadStream *cached = Common::wrapBlockCachedReadStream(&parent, kBlockSize, kBlockCount, DisposeAfterUse::NO);
+		Benchmark::Timer cachedTimer;
+		const uint32 cachedChecksum = replay(*cached, trace, buffer);
+		const double cachedMillis = cachedTimer.elapsedMillis();
+		delete cached;
+
+		TS_ASSERT_EQUALS(plainChecksum, cachedChecksum);
+
+		BENCH_REPORT(Common::String::format("%-6s %7u ops: %7u -> %6u file calls (%5.1f%%), %7.3f -> %7.3f ms",
+		                                    name, trace.size(), plain.calls, parent.calls,
+		                                    plain.calls ? parent.calls * 100.0 / plain.calls : 0.0,
+		                                    plainMillis, cachedMillis));
+
+		delete[] buffer;
+		delete[] data;
+	}
+
+public:
+	void test_scumm() {
+		Common::Array<Op> trace;
+		scummTrace(trace, 2 * 1024 * 1024);
+		run("scumm", trace, 2 * 1024 * 1024);
+	}
+
+	void test_sci() {
+		Common::Array<Op> trace;
+		sciTrace(trace, 4 * 1024 * 1024);
+		run("sci", trace, 4 * 1024 * 1024);
+	}
+
+	void test_recorded() {
+		const char *fileName = getenv("BENCH_IO_TRACE");
+		if (!fileName)
+			return;
+
+		Common::Array<Op> trace;
+		uint32 fileSize;
+		if (!loadTrace(fileName, trace, fileSize)) {
+			TS_FAIL("Could not read BENCH_IO_TRACE");
+			return;
+		}
+		run("trace", trace, fileSize + 1);
+	}
+};
@@ -0,0 +1,117 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "graphics/c2p/c2p.h"
+
+// Throughput of the chunky to planar converters on a 320x200 frame, the
+// typical AGA game screen.
+
+class C2PBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 320,
+		kHeight = 200,
+		kBytesPerRow = kWidth / 8,
+		kIterations = 200
+	};
+
+	byte *_chunky;
+	byte *_previous;
+	byte *_planeData;
+	Graphics::PlanarBitmap _planar;
+
+	static void naiveConvert(const byte *chunky, const Graphics::PlanarBitmap &planar) {
+		for (int y = 0; y < kHeight; ++y) {
+			for (int x = 0; x < kWidth; x += 8) {
+				for (int p = 0; p < Graphics::PlanarBitmap::kDepth; ++p) {
+					byte b = 0;
+					for (int i = 0; i < 8; ++i)
+						b |= ((chunky[y * kWidth + x + i] >> p) & 1) << (7 - i);
+					planar.planes[p][y * planar.bytesPerRow + x / 8] = b;
+				}
+			}
+		}
+	}
+
+	void report(const char *name, double millis, uint pixels) {
+		BENCH_REPORT(Common::String::format("%-28s %8.3f ms/frame %8.1f Mpixel/s", name, millis / kIterations,
+		                                    millis > 0 ? pixels / (millis * 1000.0) : 0.0));
+	}
+
+public:
+	void setUp() {
+		_chunky = new byte[kWidth * kHeight];
+		_previous = new byte[kWidth * kHeight];
+		_planeData = new byte[Graphics::PlanarBitmap::kDepth * kBytesPerRow * kHeight];
+
+		Benchmark::Random rnd;
+		for (uint i = 0; i < kWidth * kHeight; ++i)
+			_chunky[i] = rnd.next() & 0xFF;
+
+		for (int p = 0; p < Graphics::PlanarBitmap::kDepth; ++p)
+			_planar.planes[p] = _planeData + p * kBytesPerRow * kHeight;
+		_planar.bytesPerRow = kBytesPerRow;
+	}
+
+	void tearDown() {
+		delete[] _chunky;
+		delete[] _previous;
+		delete[] _planeData;
+	}
+
+	void test_full_frame() {
+		Benchmark::Timer naiveTimer;
+		for (int i = 0; i < kIterations; ++i)
+			naiveConvert(_chunky, _planar);
+		report("naive per pixel", naiveTimer.elapsedMillis(), kIterations * kWidth * kHeight);
+
+		Benchmark::Timer timer;
+		for (int i = 0; i < kIterations; ++i)
+			Graphics::c2pConvertFrame(_chunky, kWidth, kWidth, kHeight, _planar);
+		report("c2pConvertFrame", timer.elapsedMillis(), kIterations * kWidth * kHeight);
+	}
+
+	void test_partial() {
+		// A walking actor and a line of text.
+		const Common::Rect areas[] = {
+			Common::Rect(100, 64, 148, 144),
+			Common::Rect(0, 8, 320, 24)
+		};
+		uint pixels = 0;
+		for (uint i = 0; i < ARRAYSIZE(areas); ++i)
+			pixels += areas[i].width() * areas[i].height();
+
+		Benchmark::Timer rectTimer;
+		for (int i = 0; i < kIterations; ++i) {
+			for (uint a = 0; a < ARRAYSIZE(areas); ++a)
+				Graphics::c2pConvertRect(_chunky, kWidth, areas[a], _planar);
+		}
+		report("c2pConvertRect", rectTimer.elapsedMillis(), kIterations * pixels);
+
+		Benchmark::Timer stripTimer;
+		for (int i = 0; i < kIterations; ++i) {
+			for (uint a = 0; a < ARRAYSIZE(areas); ++a)
+				Graphics::c2pConvertStrips(_chunky, kWidth, areas[a], _planar);
+		}
+		report("c2pConvertStrips", stripTimer.elapsedMillis(), kIterations * pixels);
+	}
+
+	void test_delta() {
+		memcpy(_previous, _chunky, kWidth * kHeight);
+
+		Benchmark::Random rnd(1);
+		uint converted = 0;
+
+		Benchmark::Timer timer;
+		for (int i = 0; i < kIterations; ++i) {
+			// Change a few hundred scattered pixels per frame.
+			for (int c = 0; c < 256; ++c)
+				_chunky[rnd.next(kWidth * kHeight)] ^= 0x11;
+			converted += Graphics::c2pConvertFrame(_chunky, kWidth, kWidth, kHeight, _planar, _previous);
+		}
+		report("c2pConvertFrame (delta)", timer.elapsedMillis(), kIterations * kWidth * kHeight);
+
+		BENCH_REPORT(Common::String::format("delta converted %u of %u groups", converted,
+		                                    (uint)(kIterations * kWidth * kHeight / Graphics::kC2PGroupWidth)));
+	}
+};
@@ -0,0 +1,91 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "common/memstream.h"
+#include "graphics/colormap16.h"
+
+// Cost of getting the overlay color map ready at startup, and of converting
+// a full 320x256 GUI redraw with it.
+
+class ColorMap16BenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 320,
+		kHeight = 256,
+		kIterations = 50
+	};
+
+	byte _palette[256 * 3];
+	Graphics::PixelFormat _format;
+
+	void report(const char *name, double millis, uint iterations) {
+		BENCH_REPORT(Common::String::format("%-28s %9.3f ms", name, millis / iterations));
+	}
+
+public:
+	void setUp() {
+		_format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		Benchmark::Random rnd;
+		for (uint i = 0; i < sizeof(_palette); ++i)
+			_palette[i] = rnd.next() & 0xFF;
+	}
+
+	void test_startup() {
+		Graphics::ColorMap16 map;
+
+		Benchmark::Timer buildTimer;
+		map.build(_format, _palette, 256);
+		report("build", buildTimer.elapsedMillis(), 1);
+
+		// What the backend used to do: one decimal number per line.
+		Common::String text;
+		for (uint color = 0; color < Graphics::ColorMap16::kSize; ++color)
+			text += Common::String::format("%d\n", map.lookup(color));
+
+		Benchmark::Timer textTimer;
+		for (int i = 0; i < kIterations; ++i) {
+			Common::MemoryReadStream stream((const byte *)text.c_str(), text.size());
+			byte table[Graphics::ColorMap16::kSize];
+			for (uint color = 0; color < Graphics::ColorMap16::kSize; ++color)
+				table[color] = atoi(stream.readLine().c_str());
+		}
+		report("load text", textTimer.elapsedMillis(), kIterations);
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		map.save(out);
+
+		Benchmark::Timer loadTimer;
+		for (int i = 0; i < kIterations; ++i) {
+			Common::MemoryReadStream stream(out.getData(), out.size());
+			Graphics::ColorMap16 loaded;
+			loaded.load(_format, stream);
+		}
+		report("load binary", loadTimer.elapsedMillis(), kIterations);
+	}
+
+	void test_convert() {
+		Graphics::ColorMap16 map;
+		map.build(_format, _palette, 256);
+
+		uint16 *src = new uint16[kWidth * kHeight];
+		byte *dst = new byte[kWidth * kHeight];
+
+		Benchmark::Random rnd;
+		for (uint i = 0; i < kWidth * kHeight; ++i)
+			src[i] = rnd.next() & 0xFFFF;
+
+		Benchmark::Timer timer;
+		for (int i = 0; i < kIterations; ++i)
+			map.convertRect(src, kWidth * 2, dst, kWidth, kWidth, kHeight);
+		report("convertRect 320x256", timer.elapsedMillis(), kIterations);
+
+		Benchmark::Timer ditherTimer;
+		for (int i = 0; i < kIterations; ++i)
+			map.convertRectDithered(src, kWidth * 2, dst, kWidth, 0, 0, kWidth, kHeight);
+		report("convertRectDithered 320x256", ditherTimer.elapsedMillis(), kIterations);
+
+		delete[] src;
+		delete[] dst;
+	}
+};
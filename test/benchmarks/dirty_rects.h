@@ -0,0 +1,123 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "common/util.h"
+#include "graphics/dirty_rects.h"
+
+// Replays a synthetic frame trace through the same double buffered
+// dirty rectangle bookkeeping the AmigaOS3 AGA backend uses, and reports
+// how many pixels have to go through chunky to planar conversion compared
+// to presenting the full frame every time.
+
+class DirtyRectsBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 320,
+		kHeight = 200,
+		kFrames = 3000,
+		kBuffers = 2
+	};
+
+	struct TraceStats {
+		uint32 pixels;
+		uint32 rects;
+		uint32 fullFrames;
+	};
+
+	/**
+	 * A SCUMM-like session: an actor walking through the room (redrawn in
+	 * 8 pixel strips), the cursor moving every frame, the occasional line
+	 * of text and verb highlight, and a room change every 500 frames.
+	 */
+	static void generateFrame(Benchmark::Random &rnd, int frame, Common::Array<Common::Rect> &rects, Common::Point &cursor) {
+		rects.clear();
+
+		if (frame % 500 == 0) {
+			rects.push_back(Common::Rect(kWidth, kHeight));
+			return;
+		}
+
+		// Actor, 40x64, walking back and forth along the floor.
+		int actorX = 16 + (frame * 2) % 240;
+		int stripLeft = (actorX - 2) & ~7;
+		int stripRight = (actorX + 40 + 7) & ~7;
+		for (int x = stripLeft; x < stripRight; x += 8)
+			rects.push_back(Common::Rect(x, 64, x + 8, 144));
+
+		// Dialogue line every now and then.
+		if ((frame / 50) % 4 == 0)
+			rects.push_back(Common::Rect(0, 8, kWidth, 24));
+
+		// Verb highlight.
+		if (rnd.next(10) == 0) {
+			int verb = rnd.next(9);
+			rects.push_back(Common::Rect((verb % 3) * 64, 150 + (verb / 3) * 10, (verb % 3) * 64 + 64, 160 + (verb / 3) * 10));
+		}
+
+		cursor.x = CLIP<int>(cursor.x + (int)rnd.next(9) - 4, 0, kWidth - 1);
+		cursor.y = CLIP<int>(cursor.y + (int)rnd.next(9) - 4, 0, kHeight - 1);
+	}
+
+	static TraceStats replay(bool useDirtyRects) {
+		TraceStats stats = { 0, 0, 0 };
+
+		Graphics::DirtyRectList dirtyRects[kBuffers];
+		Common::Rect mouseRects[kBuffers];
+		for (int s = 0; s < kBuffers; ++s)
+			dirtyRects[s].setBounds(kWidth, kHeight);
+
+		Benchmark::Random rnd;
+		Common::Array<Common::Rect> rects;
+		Common::Point cursor(160, 100);
+		int current = 0;
+
+		for (int frame = 0; frame < kFrames; ++frame) {
+			generateFrame(rnd, frame, rects, cursor);
+
+			if (!useDirtyRects) {
+				stats.pixels += kWidth * kHeight;
+				stats.rects++;
+				stats.fullFrames++;
+				continue;
+			}
+
+			for (uint i = 0; i < rects.size(); ++i) {
+				for (int s = 0; s < kBuffers; ++s)
+					dirtyRects[s].addRect(rects[i]);
+			}
+
+			Graphics::DirtyRectList &dirty = dirtyRects[current];
+			dirty.addRect(mouseRects[current]);
+			mouseRects[current] = Common::Rect(cursor.x, cursor.y, cursor.x + 16, cursor.y + 16);
+			dirty.addRect(mouseRects[current]);
+
+			if (dirty.isFull())
+				stats.fullFrames++;
+			stats.rects += dirty.size();
+			stats.pixels += dirty.getArea();
+			dirty.clear();
+
+			current = (current + 1) % kBuffers;
+		}
+
+		return stats;
+	}
+
+public:
+	void test_frame_trace() {
+		TraceStats full = replay(false);
+
+		Benchmark::Timer timer;
+		TraceStats dirty = replay(true);
+		double millis = timer.elapsedMillis();
+
+		BENCH_REPORT(Common::String::format("full frames:  %u pixels converted, %u updates", full.pixels, full.rects));
+		BENCH_REPORT(Common::String::format("dirty rects:  %u pixels converted, %u updates, %u full frames",
+		                                    dirty.pixels, dirty.rects, dirty.fullFrames));
+		BENCH_REPORT(Common::String::format("converted per frame: %u -> %u pixels (%.1f%%)",
+		                                    full.pixels / kFrames, dirty.pixels / kFrames, 100.0 * dirty.pixels / full.pixels));
+		BENCH_REPORT(Common::String::format("bookkeeping: %.3f ms for %d frames", millis, (int)kFrames));
+
+		TS_ASSERT_LESS_THAN(dirty.pixels, full.pixels);
+	}
+};
@@ -0,0 +1,130 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "engines/scumm/boxroute.h"
+
+// Shows and hides walkboxes of a room with 64 boxes and brings the routes
+// up to date after every change, as scripts do when they lock doors or move
+// obstacles around. The baseline computes the whole itinerary matrix again,
+// as createBoxMatrix did before. The time ScummEngine::areBoxesNeighbors
+// took on every rebuild, which the router now only spends once per room, is
+// not part of the baseline.
+
+class ScummBoxRouteBenchmarkSuite : public CxxTest::TestSuite {
+	typedef Scumm::WalkboxRouter Router;
+
+	enum {
+		kNumBoxes = Router::kMaxBoxes,
+		kChanges = 5000
+	};
+
+	Router::BoxSet _links[kNumBoxes];
+
+	static Router::BoxSet bit(int box) {
+		return (Router::BoxSet)1 << box;
+	}
+
+	/** Grids of boxes, side by side, which are not connected to each other. */
+	void generateRoom(int areas) {
+		const int perArea = kNumBoxes / areas;
+		const int width = (perArea >= 16) ? 4 : 2;
+
+		for (int i = 0; i < kNumBoxes; i++) {
+			const int pos = i % perArea;
+			_links[i] = 0;
+			if (pos % width)
+				_links[i] |= bit(i - 1);
+			if ((pos + 1) % width && pos + 1 < perArea)
+				_links[i] |= bit(i + 1);
+			if (pos >= width)
+				_links[i] |= bit(i - width);
+			if (pos + width < perArea)
+				_links[i] |= bit(i + width);
+		}
+	}
+
+	/** ScummEngine::calcItineraryMatrix with the neighbors known in advance. */
+	void calcFull(Router::BoxSet hidden, byte *next) {
+		byte dist[kNumBoxes * kNumBoxes];
+
+		for (int i = 0; i < kNumBoxes; i++) {
+			for (int j = 0; j < kNumBoxes; j++) {
+				if (i == j) {
+					dist[i * kNumBoxes + j] = 0;
+					next[i * kNumBoxes + j] = j;
+				} else if (!(hidden & (bit(i) | bit(j))) && (_links[i] & bit(j))) {
+					dist[i * kNumBoxes + j] = 1;
+					next[i * kNumBoxes + j] = j;
+				} else {
+					dist[i * kNumBoxes + j] = 255;
+					next[i * kNumBoxes + j] = Router::kNoRoute;
+				}
+			}
+		}
+
+		for (int k = 0; k < kNumBoxes; k++) {
+			for (int i = 0; i < kNumBoxes; i++) {
+				for (int j = 0; j < kNumBoxes; j++) {
+					if (i == j)
+						continue;
+					byte distIK = dist[kNumBoxes * i + k];
+					byte distKJ = dist[kNumBoxes * k + j];
+					if (dist[kNumBoxes * i + j] > distIK + distKJ) {
+						dist[kNumBoxes * i + j] = distIK + distKJ;
+						next[kNumBoxes * i + j] = next[kNumBoxes * i + k];
+					}
+				}
+			}
+		}
+	}
+
+	/** Every third time nothing changed, otherwise one box is shown or hidden. */
+	Router::BoxSet nextHidden(Benchmark::Random &rnd, Router::BoxSet hidden, int change) {
+		if (change % 3 == 0)
+			return hidden;
+		hidden ^= bit(rnd.next(kNumBoxes));
+		return hidden;
+	}
+
+	void run(const char *name, int areas) {
+		byte next[kNumBoxes * kNumBoxes];
+		uint32 check = 0;
+		generateRoom(areas);
+
+		Benchmark::Random rndFull;
+		Benchmark::Timer fullTimer;
+		Router::BoxSet hidden = 0;
+		for (int i = 0; i < kChanges; i++) {
+			hidden = nextHidden(rndFull, hidden, i);
+			calcFull(hidden, next);
+			check += next[(i % kNumBoxes) * kNumBoxes + (i * 7) % kNumBoxes];
+		}
+		const double fullMs = fullTimer.elapsedMillis();
+
+		Router router;
+		Benchmark::Random rndRouter;
+		Benchmark::Timer routerTimer;
+		router.setLinks(kNumBoxes, _links);
+		hidden = 0;
+		for (int i = 0; i < kChanges; i++) {
+			hidden = nextHidden(rndRouter, hidden, i);
+			router.update(hidden);
+			check -= router.getNextBox(i % kNumBoxes, (i * 7) % kNumBoxes);
+		}
+		const double routerMs = routerTimer.elapsedMillis();
+
+		TS_ASSERT_EQUALS(check, 0U);
+		const Router::Stats &stats = router.getStats();
+		BENCH_REPORT(Common::String::format("walkbox routes, %-18s full %7.1f ms, incremental %7.1f ms (%5.1f%%), %u of %u rows computed",
+			name, fullMs, routerMs, fullMs > 0 ? routerMs * 100.0 / fullMs : 100.0,
+			stats.rowsComputed, stats.rowsComputed + stats.rowsReused));
+	}
+
+public:
+	void test_routes() {
+		run("one area", 1);
+		run("4 areas", 4);
+		run("16 areas", 16);
+	}
+};
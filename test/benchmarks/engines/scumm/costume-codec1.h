@@ -0,0 +1,142 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "engines/scumm/costume-codec1.h"
+
+// Draws a costume cel with every codec 1 decoder the costume renderers can
+// select and reports the time taken per variant. The variant which is
+// scaled (without actually changing the size) and masked (with an empty
+// mask) checks everything for every pixel, as the decoders did before they
+// were specialised, and serves as the baseline.
+
+class ScummCostumeCodec1BenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kPitch = 320,
+		kScreenHeight = 200,
+		kNumStrips = kPitch / 8,
+		kWidth = 48,
+		kHeight = 80,
+		kDraws = 20000
+	};
+
+	byte _rle[kWidth * kHeight * 2];
+	byte _screen[kPitch * kScreenHeight];
+	byte _mask[kNumStrips * kScreenHeight];
+	byte _scaleTable[256];
+	byte _shadowTable[256];
+	uint16 _palette[16];
+
+	/** An actor: a transparent outline with runs of a few colors inside. */
+	void generateCel() {
+		Benchmark::Random rnd;
+		byte image[kWidth * kHeight];
+
+		for (int x = 0; x < kWidth; ++x) {
+			const int margin = (x < kWidth / 2) ? kWidth / 2 - x : x - kWidth / 2;
+			for (int y = 0; y < kHeight; ++y) {
+				byte color = 0;
+				if (margin < kWidth / 3 && y > margin / 2)
+					color = (y > 1 && rnd.next(4)) ? image[(y - 1) * kWidth + x] : 1 + rnd.next(15);
+				image[y * kWidth + x] = color;
+			}
+		}
+
+		byte *dst = _rle;
+		int i = 0;
+		while (i < kWidth * kHeight) {
+			const byte color = image[(i % kHeight) * kWidth + i / kHeight];
+			int len = 1;
+			while (i + len < kWidth * kHeight && len < 255 && image[((i + len) % kHeight) * kWidth + (i + len) / kHeight] == color)
+				len++;
+			if (len < 16) {
+				*dst++ = (color << 4) | len;
+			} else {
+				*dst++ = color << 4;
+				*dst++ = len;
+			}
+			i += len;
+		}
+	}
+
+	double run(Scumm::Codec1Flavor flavor, bool scaled, bool masked, Scumm::Codec1Shadow shadow, byte scale) {
+		Scumm::Codec1Decoder decode = Scumm::getCodec1Decoder(flavor, scaled, false, masked, shadow);
+		Benchmark::Timer timer;
+
+		for (int i = 0; i < kDraws; ++i) {
+			Scumm::BaseCostumeRenderer::Codec1 v1;
+			Scumm::Codec1Context ctx;
+			const int x = kWidth + (i * 7) % (kPitch - kWidth);
+			const int y = (i * 3) % (kScreenHeight - kHeight);
+
+			v1.x = x;
+			v1.y = y;
+			v1.scaletable = _scaleTable;
+			v1.skip_width = kWidth;
+			v1.destptr = _screen + y * kPitch + x;
+			v1.mask_ptr = _mask + y * kNumStrips;
+			v1.scaleXstep = -1;
+			v1.mask = 15;
+			v1.shr = 4;
+			v1.repcolor = 0;
+			v1.replen = 0;
+			v1.boundsRect = Common::Rect(kPitch, kScreenHeight);
+			v1.scaleXindex = 128;
+			v1.scaleYindex = 0;
+
+			ctx.src = _rle;
+			ctx.height = kHeight;
+			ctx.pitch = kPitch;
+			ctx.numStrips = kNumStrips;
+			ctx.scaleX = scale;
+			ctx.scaleY = scale;
+			ctx.palette = _palette;
+			ctx.shadowTable = _shadowTable;
+
+			decode(v1, ctx);
+		}
+
+		return timer.elapsedMillis();
+	}
+
+public:
+	void test_decoders() {
+		generateCel();
+		memset(_screen, 0, sizeof(_screen));
+		memset(_mask, 0, sizeof(_mask));
+		for (int i = 0; i < 256; ++i) {
+			_scaleTable[i] = i;
+			_shadowTable[i] = i / 2;
+		}
+		for (int i = 0; i < 16; ++i)
+			_palette[i] = 0x30 + i;
+		_palette[5] = 13;
+
+		static const struct {
+			const char *name;
+			Scumm::Codec1Flavor flavor;
+			bool scaled, masked;
+			Scumm::Codec1Shadow shadow;
+			byte scale;
+		} variants[] = {
+			{ "classic, all checks",         Scumm::kCodec1Classic, true,  true,  Scumm::kCodec1ShadowColor13, 255 },
+			{ "classic, unscaled",           Scumm::kCodec1Classic, false, true,  Scumm::kCodec1ShadowColor13, 255 },
+			{ "classic, unscaled, unmasked", Scumm::kCodec1Classic, false, false, Scumm::kCodec1ShadowColor13, 255 },
+			{ "classic, plain",              Scumm::kCodec1Classic, false, false, Scumm::kCodec1ShadowNone,    255 },
+			{ "classic, scaled to 50%",      Scumm::kCodec1Classic, true,  true,  Scumm::kCodec1ShadowColor13, 128 },
+			{ "akos, all checks",            Scumm::kCodec1Akos,    true,  true,  Scumm::kCodec1ShadowNone,    255 },
+			{ "akos, unscaled, unmasked",    Scumm::kCodec1Akos,    false, false, Scumm::kCodec1ShadowNone,    255 },
+			{ "akos, scaled to 50%",         Scumm::kCodec1Akos,    true,  true,  Scumm::kCodec1ShadowNone,    128 }
+		};
+
+		double baseline[2] = { 0, 0 };
+		for (uint i = 0; i < ARRAYSIZE(variants); ++i) {
+			const double ms = run(variants[i].flavor, variants[i].scaled, variants[i].masked, variants[i].shadow, variants[i].scale);
+			double &base = baseline[variants[i].flavor];
+			if (!base)
+				base = ms;
+			BENCH_REPORT(Common::String::format("codec1 %-28s %8.1f ms for %d cels, %5.1f%% of all checks",
+				variants[i].name, ms, (int)kDraws, base > 0 ? ms * 100.0 / base : 100.0));
+		}
+	}
+};
@@ -0,0 +1,138 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "engines/scumm/damage.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Replays the invalidations of a room through the SCUMM damage tracker and
+// reports how many pixels of the main screen are copied per frame, compared
+// to the single dirty range per strip the engine used to keep.
+//
+// Without further setup a synthetic room is replayed. A trace recorded with
+// the "damage trace <file>" debugger command can be replayed instead by
+// pointing BENCH_DAMAGE_TRACE at it.
+
+class ScummDamageBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kNumStrips = 40,
+		kHeight = 144,
+		kFrames = 3000
+	};
+
+	struct Invalidation {
+		int source;
+		int firstStrip, lastStrip;
+		int top, bottom;
+	};
+
+	typedef Common::Array<Invalidation> Frame;
+
+	static void add(Frame &frame, int source, int left, int right, int top, int bottom) {
+		Invalidation inv = { source, left / 8, (right - 1) / 8, top, bottom };
+		frame.push_back(inv);
+	}
+
+	/**
+	 * A room in the style of the SCUMM v5 games: two actors walking at
+	 * different heights, the background restored behind them, a line of
+	 * dialogue at the top while someone talks, an animated object and the
+	 * occasional object state change.
+	 */
+	static void generateRoom(Common::Array<Frame> &frames) {
+		Benchmark::Random rnd;
+		int lastX[2] = { -1, -1 };
+		static const int actorY[2] = { 40, 72 };
+
+		frames.resize(kFrames);
+		for (int f = 0; f < kFrames; ++f) {
+			Frame &frame = frames[f];
+
+			for (int a = 0; a < 2; ++a) {
+				const int x = 8 + (f * (a + 1) + a * 97) % 264;
+				if (lastX[a] >= 0)
+					add(frame, Scumm::kDamageBackground, lastX[a], lastX[a] + 40, actorY[a], actorY[a] + 64);
+				add(frame, Scumm::kDamageActor, x, x + 40, actorY[a], actorY[a] + 64);
+				lastX[a] = x;
+			}
+
+			if ((f / 60) % 3 == 0)
+				add(frame, Scumm::kDamageCharset, 16, 304, 8, 24);
+
+			if (f % 3 == 0)
+				add(frame, Scumm::kDamageObject, 232, 256, 96, 128);
+
+			if (rnd.next(40) == 0) {
+				const int x = rnd.next(36) * 8;
+				add(frame, Scumm::kDamageObject, x, x + 32, 100, 140);
+			}
+		}
+	}
+
+	static bool loadTrace(const char *name, Common::Array<Frame> &frames) {
+		FILE *f = fopen(name, "r");
+		if (!f)
+			return false;
+
+		char line[128];
+		Frame current;
+		while (fgets(line, sizeof(line), f)) {
+			Invalidation inv;
+			if (line[0] == 'F') {
+				frames.push_back(current);
+				current.clear();
+			} else if (sscanf(line, "%d %d %d %d %d", &inv.source, &inv.firstStrip, &inv.lastStrip, &inv.top, &inv.bottom) == 5) {
+				current.push_back(inv);
+			}
+		}
+
+		fclose(f);
+		return !frames.empty();
+	}
+
+public:
+	void test_room() {
+		Common::Array<Frame> frames;
+		const char *traceName = getenv("BENCH_DAMAGE_TRACE");
+		if (traceName && loadTrace(traceName, frames)) {
+			BENCH_REPORT(Common::String::format("replaying %s, %u frames", traceName, frames.size()));
+		} else {
+			generateRoom(frames);
+			BENCH_REPORT(Common::String::format("replaying a synthetic room, %u frames", frames.size()));
+		}
+
+		Scumm::DamageTracker damage;
+		Common::Array<Common::Rect> rects;
+		uint32 maxPixels = 0;
+
+		Benchmark::Timer timer;
+		for (uint f = 0; f < frames.size(); ++f) {
+			const Frame &frame = frames[f];
+			for (uint i = 0; i < frame.size(); ++i) {
+				const Invalidation &inv = frame[i];
+				damage.addRect((Scumm::DamageSource)CLIP<int>(inv.source, 0, Scumm::kDamageSourceCount - 1),
+				               inv.firstStrip, inv.lastStrip, inv.top, inv.bottom);
+			}
+
+			rects.clear();
+			damage.collectRects(kNumStrips, rects);
+			damage.endFrame();
+			maxPixels = MAX(maxPixels, damage.getStats().lastPixels);
+		}
+		const double millis = timer.elapsedMillis();
+
+		const Scumm::DamageTracker::Stats &stats = damage.getStats();
+		const uint32 numFrames = MAX<uint32>(stats.frames, 1);
+		BENCH_REPORT(Common::String::format("one range per strip: %u pixels per frame",
+		                                    (uint32)(stats.totalStripPixels / numFrames)));
+		BENCH_REPORT(Common::String::format("damage tracker:      %u pixels per frame in %.1f rects (%.1f%%), at most %u",
+		                                    (uint32)(stats.totalPixels / numFrames), (double)stats.totalRects / numFrames,
+		                                    stats.totalStripPixels ? 100.0 * stats.totalPixels / stats.totalStripPixels : 0.0,
+		                                    maxPixels));
+		BENCH_REPORT(Common::String::format("bookkeeping: %.3f ms for %u frames", millis, stats.frames));
+
+		TS_ASSERT_LESS_THAN_EQUALS(stats.totalPixels, stats.totalStripPixels);
+	}
+};
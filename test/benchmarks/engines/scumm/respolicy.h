@@ -0,0 +1,367 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "common/hashmap.h"
+
+#include "engines/scumm/respolicy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Replays the resource usage of a game through a model of the usage
+// counters the SCUMM ResourceManager expires resources by, and through the
+// ARC policy, and reports how much data each had to reload.
+//
+// Without further setup a synthetic game is replayed. A trace recorded with
+// the "resources trace <file>" debugger command can be replayed instead by
+// pointing BENCH_RESOURCE_TRACE at it.
+
+class ScummResourcePolicyBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kMaxHeap = 550000,
+		kMinHeap = 400000,
+		kTicks = 60000,
+
+		kRoom = 1,
+		kScript = 2,
+		kCostume = 3,
+		kSound = 4,
+
+		kNumRooms = 40,
+		kNumCutsceneRooms = 20,
+		kNumScripts = 60,
+		kNumCostumes = 50,
+		kNumSounds = 80
+	};
+
+	struct Event {
+		char type;
+		uint32 key;
+		uint32 size;
+	};
+
+	typedef Common::HashMap<uint32, uint32> SizeMap;
+
+	/** The interface of the models replayed. */
+	class Model {
+	public:
+		virtual ~Model() {}
+		virtual void tick() = 0;
+		virtual void beginExpire() {}
+		virtual void endExpire() {}
+		virtual void load(uint32 key, uint32 size) = 0;
+		virtual void access(uint32 key) = 0;
+		virtual void demote(uint32 key) = 0;
+		virtual void drop(uint32 key, bool evicted) = 0;
+		virtual bool selectVictim(const Scumm::ResourcePolicy::Filter &filter, uint32 &key) = 0;
+	};
+
+	/**
+	 * The usage counters of ResourceManager: every use resets the counter to
+	 * 1, all counters are increased every 256 iterations and whenever a
+	 * resource is created, and the resource with the highest counter goes
+	 * first.
+	 */
+	class ClassicModel : public Model {
+	public:
+		ClassicModel() : _expireCounter(0) {}
+
+		void tick() {
+			if (++_expireCounter == 0)
+				age();
+		}
+
+		void beginExpire() {
+			if (_expireCounter != 0xFF) {
+				_expireCounter = 0xFF;
+				age();
+			}
+		}
+
+		void endExpire() { age(); }
+
+		void load(uint32 key, uint32 size) { _counters[key] = 1; }
+		void access(uint32 key) { _counters[key] = 1; }
+		void demote(uint32 key) { _counters[key] = 0x7F; }
+		void drop(uint32 key, bool evicted) { _counters.erase(key); }
+
+		bool selectVictim(const Scumm::ResourcePolicy::Filter &filter, uint32 &key) {
+			byte best = 2;
+			bool found = false;
+			for (CounterMap::iterator i = _counters.begin(); i != _counters.end(); ++i) {
+				if (i->_value >= best && filter.canEvict(i->_key)) {
+					best = i->_value;
+					key = i->_key;
+					found = true;
+				}
+			}
+			return found;
+		}
+
+	private:
+		typedef Common::HashMap<uint32, byte> CounterMap;
+
+		void age() {
+			for (CounterMap::iterator i = _counters.begin(); i != _counters.end(); ++i) {
+				if (i->_value && i->_value < 0x7F)
+					i->_value++;
+			}
+		}
+
+		CounterMap _counters;
+		byte _expireCounter;
+	};
+
+	class ArcModel : public Model {
+	public:
+		ArcModel() {
+			_arc.setCapacity(kMaxHeap);
+			_arc.setTypeWeight(kRoom, 200);
+			_arc.setTypeWeight(kCostume, 150);
+		}
+
+		void tick() { _arc.tick(); }
+		void load(uint32 key, uint32 size) { _arc.load(key, size); }
+		void access(uint32 key) { _arc.access(key); }
+		void demote(uint32 key) { _arc.demote(key); }
+		void drop(uint32 key, bool evicted) { _arc.drop(key, evicted); }
+		bool selectVictim(const Scumm::ResourcePolicy::Filter &filter, uint32 &key) { return _arc.selectVictim(filter, key); }
+
+	private:
+		Scumm::ArcResourcePolicy _arc;
+	};
+
+	/** Resources used in the current iteration are in use and stay. */
+	class InUseFilter : public Scumm::ResourcePolicy::Filter {
+	public:
+		InUseFilter(const Common::HashMap<uint32, uint32> &lastUse, const uint32 &tick) : _lastUse(lastUse), _tick(tick) {}
+
+		bool canEvict(uint32 key) const {
+			Common::HashMap<uint32, uint32>::const_iterator i = _lastUse.find(key);
+			return i == _lastUse.end() || i->_value != _tick;
+		}
+
+	private:
+		const Common::HashMap<uint32, uint32> &_lastUse;
+		const uint32 &_tick;
+	};
+
+	struct Result {
+		uint32 loads, reloads, expired;
+		uint64 loadBytes, reloadBytes;
+		double millis;
+	};
+
+	static void replay(const Common::Array<Event> &events, Model &model, Result &result) {
+		SizeMap resident, sizes;
+		Common::HashMap<uint32, bool> evicted;
+		Common::HashMap<uint32, uint32> lastUse;
+		uint32 tick = 0, allocated = 0;
+		const InUseFilter filter(lastUse, tick);
+
+		result.loads = result.reloads = result.expired = 0;
+		result.loadBytes = result.reloadBytes = 0;
+
+		Benchmark::Timer timer;
+		for (uint e = 0; e < events.size(); ++e) {
+			const Event &ev = events[e];
+			switch (ev.type) {
+			case 'T':
+				model.tick();
+				tick++;
+				break;
+			case 'L':
+				sizes[ev.key] = ev.size;
+				// fall through
+			case 'A':
+				lastUse[ev.key] = tick;
+				if (resident.contains(ev.key)) {
+					model.access(ev.key);
+				} else if (sizes.contains(ev.key)) {
+					const uint32 size = sizes[ev.key];
+
+					// The same steps as ResourceManager::expireResources.
+					model.beginExpire();
+					if (size + allocated >= kMaxHeap) {
+						do {
+							uint32 victim;
+							if (!model.selectVictim(filter, victim))
+								break;
+							allocated -= resident[victim];
+							resident.erase(victim);
+							evicted[victim] = true;
+							model.drop(victim, true);
+							result.expired++;
+						} while (size + allocated > kMinHeap);
+						model.endExpire();
+					}
+
+					resident[ev.key] = size;
+					allocated += size;
+					model.load(ev.key, size);
+					result.loads++;
+					result.loadBytes += size;
+					if (evicted.contains(ev.key)) {
+						evicted.erase(ev.key);
+						result.reloads++;
+						result.reloadBytes += size;
+					}
+				}
+				break;
+			case 'D':
+				if (resident.contains(ev.key))
+					model.demote(ev.key);
+				break;
+			case 'F':
+				if (resident.contains(ev.key)) {
+					allocated -= resident[ev.key];
+					resident.erase(ev.key);
+					model.drop(ev.key, false);
+				}
+				break;
+			default:
+				break;
+			}
+		}
+		result.millis = timer.elapsedMillis();
+	}
+
+	static void add(Common::Array<Event> &events, char type, int resType = 0, int idx = 0, uint32 size = 0) {
+		Event ev = { type, Scumm::ResourcePolicy::makeKey(resType, idx), size };
+		events.push_back(ev);
+	}
+
+	/**
+	 * A game in the style of the SCUMM v5 games: the player walks between
+	 * neighbouring rooms, and often returns to a few central ones. Each room
+	 * uses a few scripts and costumes, some of which are shared with other
+	 * rooms, and now and then plays a sound. Every now and then a cutscene
+	 * shows a few rooms the player does not visit otherwise, for a short
+	 * while each, and returns to where the player was.
+	 */
+	static void generateGame(Common::Array<Event> &events) {
+		enum {
+			kAllRooms = kNumRooms + kNumCutsceneRooms
+		};
+		Benchmark::Random rnd;
+		uint32 roomSize[kAllRooms], scriptSize[kNumScripts], costumeSize[kNumCostumes], soundSize[kNumSounds];
+		int roomScripts[kAllRooms][2], roomCostumes[kAllRooms][3], roomSounds[kAllRooms][4];
+
+		for (int i = 0; i < kAllRooms; ++i) {
+			roomSize[i] = 40000 + rnd.next(30000);
+			for (int j = 0; j < 2; ++j)
+				roomScripts[i][j] = rnd.next(kNumScripts);
+			for (int j = 0; j < 3; ++j)
+				roomCostumes[i][j] = (j == 0) ? 0 : rnd.next(kNumCostumes);
+			for (int j = 0; j < 4; ++j)
+				roomSounds[i][j] = rnd.next(kNumSounds);
+		}
+		for (int i = 0; i < kNumScripts; ++i)
+			scriptSize[i] = 2000 + rnd.next(4000);
+		for (int i = 0; i < kNumCostumes; ++i)
+			costumeSize[i] = 15000 + rnd.next(30000);
+		for (int i = 0; i < kNumSounds; ++i)
+			soundSize[i] = 3000 + rnd.next(17000);
+
+		int room = 0, playerRoom = 0;
+		int ticksLeft = 0, cutsceneLeft = 0;
+		for (int t = 0; t < kTicks; ++t) {
+			if (--ticksLeft <= 0) {
+				const uint32 r = rnd.next(100);
+				if (cutsceneLeft > 0) {
+					room = (--cutsceneLeft) ? kNumRooms + rnd.next(kNumCutsceneRooms) : playerRoom;
+					ticksLeft = cutsceneLeft ? 40 + rnd.next(40) : 200 + rnd.next(400);
+				} else if (r < 15) {
+					cutsceneLeft = 5;
+					room = kNumRooms + rnd.next(kNumCutsceneRooms);
+					ticksLeft = 40 + rnd.next(40);
+				} else {
+					if (r < 40)
+						playerRoom = rnd.next(3);
+					else if (r < 90)
+						playerRoom = (playerRoom + kNumRooms + (r & 1 ? 1 : -1)) % kNumRooms;
+					else
+						playerRoom = rnd.next(kNumRooms);
+					room = playerRoom;
+					ticksLeft = 200 + rnd.next(400);
+				}
+
+				add(events, 'L', kRoom, room, roomSize[room]);
+				for (int j = 0; j < 2; ++j)
+					add(events, 'L', kScript, roomScripts[room][j], scriptSize[roomScripts[room][j]]);
+				for (int j = 0; j < 3; ++j)
+					add(events, 'L', kCostume, roomCostumes[room][j], costumeSize[roomCostumes[room][j]]);
+			}
+
+			add(events, 'A', kRoom, room);
+			for (int j = 0; j < 3; ++j)
+				add(events, 'A', kCostume, roomCostumes[room][j]);
+			if (t % 5 == 0) {
+				for (int j = 0; j < 2; ++j)
+					add(events, 'A', kScript, roomScripts[room][j]);
+			}
+			if (rnd.next(50) == 0) {
+				const int sound = roomSounds[room][rnd.next(4)];
+				add(events, 'L', kSound, sound, soundSize[sound]);
+			}
+			add(events, 'T');
+		}
+	}
+
+	static bool loadTrace(const char *name, Common::Array<Event> &events) {
+		FILE *f = fopen(name, "r");
+		if (!f)
+			return false;
+
+		char line[128];
+		while (fgets(line, sizeof(line), f)) {
+			int type, idx;
+			unsigned int size;
+			if (line[0] == 'T') {
+				add(events, 'T');
+			} else if (line[0] == 'L' && sscanf(line + 1, "%d %d %u", &type, &idx, &size) == 3) {
+				add(events, 'L', type, idx, size);
+			} else if (sscanf(line + 1, "%d %d", &type, &idx) == 2) {
+				add(events, line[0], type, idx);
+			}
+		}
+
+		fclose(f);
+		return !events.empty();
+	}
+
+	static void report(const char *name, const Result &result) {
+		BENCH_REPORT(Common::String::format("%-8s %6u loads (%7u KB), %5u reloads (%7u KB), %5u expired, %.1f ms",
+		                                    name, result.loads, (uint32)(result.loadBytes / 1024), result.reloads,
+		                                    (uint32)(result.reloadBytes / 1024), result.expired, result.millis));
+	}
+
+public:
+	void test_replay() {
+		Common::Array<Event> events;
+		const char *traceName = getenv("BENCH_RESOURCE_TRACE");
+		if (traceName && loadTrace(traceName, events)) {
+			BENCH_REPORT(Common::String::format("replaying %s, %u events", traceName, events.size()));
+		} else {
+			generateGame(events);
+			BENCH_REPORT(Common::String::format("replaying a synthetic game, %u events", events.size()));
+		}
+
+		ClassicModel classic;
+		ArcModel arc;
+		Result classicResult, arcResult;
+		replay(events, classic, classicResult);
+		replay(events, arc, arcResult);
+
+		report("classic", classicResult);
+		report("arc", arcResult);
+		if (classicResult.reloadBytes) {
+			BENCH_REPORT(Common::String::format("arc reloads %.1f%% of the bytes the usage counters do",
+			                                    100.0 * arcResult.reloadBytes / classicResult.reloadBytes));
+		}
+
+		// Both see the same resources for the first time.
+		TS_ASSERT_EQUALS(classicResult.loads - classicResult.reloads, arcResult.loads - arcResult.reloads);
+	}
+};
@@ -0,0 +1,201 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "common/array.h"
+#include "common/endian.h"
+
+#include "engines/scumm/smush/codec37.h"
+#include "engines/scumm/smush/codec47.h"
+
+// Decodes synthetic 640x480 codec 37 and codec 47 frame objects, as found
+// in The Dig, Full Throttle and The Curse of Monkey Island. The block codes
+// are mixed roughly the way the games mix them: mostly motion compensated
+// copies from the previous frames, with fills, glyphs and literal pixels
+// where the picture changes. Codec 47 frames are also created with only
+// glyph blocks, which is what busy scenes with smoke and fire decode to,
+// and with only motion blocks. The decoders are created once per run, as
+// the SmushPlayer does, and once per frame, to see the cost of their
+// tables.
+
+class ScummSmushCodecsBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kFrames = 60,
+		// Motion vectors reach up to 43 pixels away; blocks closer to the
+		// edges than this do not use them.
+		kMargin = 48
+	};
+
+	enum Mix {
+		kMixed,
+		kGlyphs,
+		kMotion
+	};
+
+	Benchmark::Random _rnd;
+	Common::Array<byte> _data;
+	Common::Array<uint32> _frames;
+
+	void push(byte b) {
+		_data.push_back(b);
+	}
+
+	bool isInterior(int x, int y, int size) const {
+		return x >= kMargin && y >= kMargin && x + size <= kWidth - kMargin && y + size <= kHeight - kMargin;
+	}
+
+	void makeBlock47(int level, bool interior, Mix mix) {
+		const uint32 r = _rnd.next(100);
+
+		if (mix == kGlyphs && level < 3) {
+			push(0xFD);
+			push(_rnd.next(256));
+			push(_rnd.next(256));
+			push(_rnd.next(256));
+			return;
+		}
+		if (mix == kMotion) {
+			push(interior ? _rnd.next(0xF8) : 0xFC);
+			return;
+		}
+
+		if (r < 40 && interior) {
+			push(_rnd.next(0xF8));
+		} else if (r < 60) {
+			push(0xFF);
+			if (level < 3) {
+				for (int i = 0; i < 4; ++i)
+					makeBlock47(level + 1, interior, mix);
+			} else {
+				for (int i = 0; i < 4; ++i)
+					push(_rnd.next(256));
+			}
+		} else if (r < 70) {
+			push(0xFE);
+			push(_rnd.next(256));
+		} else if (r < 85 && level < 3) {
+			push(0xFD);
+			push(_rnd.next(256));
+			push(_rnd.next(256));
+			push(_rnd.next(256));
+		} else if (r < 95) {
+			push(0xFC);
+		} else {
+			push(0xF8 + _rnd.next(4));
+		}
+	}
+
+	void makeCodec47(Mix mix) {
+		_data.clear();
+		_frames.clear();
+		for (int frame = 0; frame < kFrames; ++frame) {
+			_frames.push_back(_data.size());
+			push(frame & 0xFF);
+			push(frame >> 8);
+			push(2);
+			push(frame ? _rnd.next(3) : 0);
+			for (int i = 4; i < 26; ++i)
+				push(_rnd.next(256));
+			_data[_frames.back() + 4] = 0;
+
+			for (int y = 0; y < kHeight; y += 8)
+				for (int x = 0; x < kWidth; x += 8)
+					makeBlock47(1, isInterior(x, y, 8), mix);
+		}
+	}
+
+	void makeCodec37() {
+		const int blocks = (kWidth / 4) * (kHeight / 4);
+
+		_data.clear();
+		_frames.clear();
+		for (int frame = 0; frame < kFrames; ++frame) {
+			_frames.push_back(_data.size());
+			const byte compression = frame & 1 ? 4 : 3;
+			push(compression);
+			push(frame & 1);
+			push(frame & 0xFF);
+			push(frame >> 8);
+			for (int i = 4; i < 16; ++i)
+				push(0);
+			// Use the 0xFD and 0xFE codes.
+			_data[_frames.back() + 12] = 4;
+
+			int left = blocks;
+			while (left > 0) {
+				const uint32 r = _rnd.next(100);
+				if (r < 60) {
+					push(1 + _rnd.next(0xFC));
+					--left;
+				} else if (r < 70) {
+					push(0xFD);
+					push(_rnd.next(256));
+					--left;
+				} else if (r < 78) {
+					push(0xFE);
+					for (int i = 0; i < 4; ++i)
+						push(_rnd.next(256));
+					--left;
+				} else if (r < 85) {
+					push(0xFF);
+					for (int i = 0; i < 16; ++i)
+						push(_rnd.next(256));
+					--left;
+				} else if (compression == 4) {
+					const int length = MIN<int>(1 + _rnd.next(16), left);
+					push(0x00);
+					push(length - 1);
+					left -= length;
+				} else {
+					push(0x01);
+					--left;
+				}
+			}
+		}
+		// Room for the decoders reading ahead.
+		for (int i = 0; i < 64; ++i)
+			push(0);
+	}
+
+	template<class Decoder>
+	double decodeAll(bool decoderPerFrame) {
+		byte *dst = new byte[kWidth * kHeight];
+		Decoder *decoder = 0;
+		Benchmark::Timer timer;
+		for (uint i = 0; i < _frames.size(); ++i) {
+			if (!decoder || decoderPerFrame) {
+				delete decoder;
+				decoder = new Decoder(kWidth, kHeight);
+			}
+			decoder->decode(dst, &_data[_frames[i]]);
+		}
+		const double ms = timer.elapsedMillis();
+		delete decoder;
+		delete[] dst;
+		return ms;
+	}
+
+	void report(const char *name, double ms) {
+		const double pixels = (double)kWidth * kHeight * kFrames;
+		BENCH_REPORT(Common::String::format("%-24s %7.3f ms per frame, %8.1f Mpixels/s",
+			name, ms / kFrames, ms > 0 ? pixels / ms / 1000.0 : 0.0));
+	}
+
+public:
+	void test_codec37() {
+		makeCodec37();
+		report("codec 37 mixed:", decodeAll<Scumm::Codec37Decoder>(false));
+	}
+
+	void test_codec47() {
+		makeCodec47(kMixed);
+		report("codec 47 mixed:", decodeAll<Scumm::Codec47Decoder>(false));
+		report("codec 47 decoder/frame:", decodeAll<Scumm::Codec47Decoder>(true));
+		makeCodec47(kGlyphs);
+		report("codec 47 glyphs:", decodeAll<Scumm::Codec47Decoder>(false));
+		makeCodec47(kMotion);
+		report("codec 47 motion:", decodeAll<Scumm::Codec47Decoder>(false));
+	}
+};
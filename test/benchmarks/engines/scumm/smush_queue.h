@@ -0,0 +1,142 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+
+#include "engines/scumm/smush/smush_queue.h"
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+// Plays an animation of zlib compressed 640x480 frames, as found in The
+// Curse of Monkey Island, through the SMUSH frame queue. Reading a frame
+// and inflating it when it is due is compared with taking it from the
+// queue, which was filled in the idle time after the previous frame. The
+// time spent when a frame is due is what makes frames late.
+
+class ScummSmushQueueBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kFrames = 120
+	};
+
+	Common::Array<byte> _file;
+
+	void writeUint32BE(uint32 value) {
+		for (int i = 3; i >= 0; --i)
+			_file.push_back((value >> (i * 8)) & 0xFF);
+	}
+
+	void makeAnimation() {
+#ifdef USE_ZLIB
+		Benchmark::Random rnd;
+		const uint32 fobjSize = 14 + kWidth * kHeight;
+		byte *fobj = new byte[fobjSize];
+		uLongf zlibSize = compressBound(fobjSize);
+		byte *zlib = new byte[zlibSize];
+
+		_file.clear();
+		writeUint32BE(MKTAG('A','N','I','M'));
+		writeUint32BE(0);
+
+		// Codec 1 like content: runs of colors which move a little each frame.
+		memset(fobj, 0, 14);
+		for (int frame = 0; frame < kFrames; ++frame) {
+			byte *pixels = fobj + 14;
+			for (int y = 0; y < kHeight; ++y) {
+				int x = 0;
+				while (x < kWidth) {
+					const int len = MIN<int>(1 + rnd.next(24), kWidth - x);
+					memset(pixels + y * kWidth + x, (x + y + frame) & 0xF0 ? rnd.next(256) : 0, len);
+					x += len;
+				}
+			}
+
+			uLongf size = compressBound(fobjSize);
+			compress2(zlib, &size, fobj, fobjSize, 6);
+			zlibSize = size;
+
+			const uint32 zfobSize = 4 + zlibSize;
+			writeUint32BE(MKTAG('F','R','M','E'));
+			writeUint32BE(8 + zfobSize + (zfobSize & 1));
+			writeUint32BE(MKTAG('Z','F','O','B'));
+			writeUint32BE(zfobSize);
+			writeUint32BE(fobjSize);
+			for (uint32 i = 0; i < zlibSize; ++i)
+				_file.push_back(zlib[i]);
+			if (zfobSize & 1)
+				_file.push_back(0);
+		}
+
+		WRITE_BE_UINT32(&_file[4], _file.size() - 8);
+		delete[] fobj;
+		delete[] zlib;
+#endif
+	}
+
+	struct Result {
+		double dueMs, maxDueMs, idleMs;
+	};
+
+	Result play(uint readAhead) {
+		Common::MemoryReadStream stream(&_file[0], _file.size());
+		Scumm::SmushFrameQueue queue;
+		Result result = { 0, 0, 0 };
+
+		stream.seek(8);
+		queue.setCapacity(readAhead);
+		queue.reset(&stream, _file.size());
+
+		for (;;) {
+			Benchmark::Timer idleTimer;
+			while (queue.fill())
+				;
+			result.idleMs += idleTimer.elapsedMillis();
+
+			Benchmark::Timer dueTimer;
+			uint32 type;
+			Common::SeekableReadStream *chunk = queue.next(type);
+			if (!chunk)
+				break;
+			// The frame object is inflated when it is handled, unless the
+			// queue did so already.
+			byte header[8];
+			chunk->read(header, 8);
+			if (READ_BE_UINT32(header) == MKTAG('Z','F','O','B')) {
+				const uint32 size = READ_BE_UINT32(header + 4);
+				byte *data = new byte[size];
+				chunk->read(data, size);
+				uLongf inflatedSize = READ_BE_UINT32(data);
+				byte *inflated = new byte[inflatedSize];
+				uncompress(inflated, &inflatedSize, data + 4, size - 4);
+				delete[] inflated;
+				delete[] data;
+			}
+			delete chunk;
+			const double ms = dueTimer.elapsedMillis();
+			result.dueMs += ms;
+			result.maxDueMs = MAX(result.maxDueMs, ms);
+		}
+
+		return result;
+	}
+
+public:
+	void test_playback() {
+#ifdef USE_ZLIB
+		makeAnimation();
+
+		const uint depths[] = { 0, 1, 4 };
+		for (uint i = 0; i < ARRAYSIZE(depths); ++i) {
+			const Result result = play(depths[i]);
+			BENCH_REPORT(Common::String::format("SMUSH %u frames ahead: %6.3f ms per frame when due, at most %6.3f ms, %6.3f ms in idle time",
+				depths[i], result.dueMs / kFrames, result.maxDueMs, result.idleMs / kFrames));
+		}
+#endif
+	}
+};
@@ -0,0 +1,168 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/benchmark.h"
+
+#include "common/array.h"
+#include "common/endian.h"
+
+#include "engines/scumm/he/wiz_he.h"
+#include "engines/scumm/he/wizspans_he.h"
+
+// Draws run length encoded Wiz sprites onto a 640x480 screen, the way
+// Moonbase Commander and the Backyard sports games fill their frames with a
+// few hundred units, tiles and players. The sprites are 64x64, with
+// transparent borders, some runs of one color and mostly literal pixels.
+// The per pixel decoder below is the loop of Wiz::decompressWizImage for
+// plain copies, which cannot be linked here without the engine; it is
+// compared with drawing from spans built once per sprite.
+
+class ScummWizSpansBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kScreenWidth = 640,
+		kScreenHeight = 480,
+		kSize = 64,
+		kSprites = 16,
+		kDraws = 300,
+		kFrames = 30
+	};
+
+	Benchmark::Random _rnd;
+	Common::Array<byte> _data[kSprites];
+	Common::Array<byte> _spans[kSprites];
+
+	void makeSprite(Common::Array<byte> &data) {
+		data.clear();
+		for (int y = 0; y < kSize; ++y) {
+			const uint start = data.size();
+			data.push_back(0);
+			data.push_back(0);
+
+			// A transparent border around a roughly round shape.
+			const int border = ABS(y - kSize / 2) / 2 + _rnd.next(4);
+			data.push_back((border << 1) | 1);
+			int x = border;
+			while (x < kSize - border) {
+				// The encoder makes literals of up to 64 pixels, and runs of
+				// the colors which repeat.
+				const bool run = _rnd.next(4) == 0;
+				const int count = MIN<int>(1 + _rnd.next(run ? 16 : 64), kSize - border - x);
+				if (run) {
+					data.push_back(((count - 1) << 2) | 2);
+					data.push_back(_rnd.next(256));
+				} else {
+					data.push_back((count - 1) << 2);
+					for (int i = 0; i < count; ++i)
+						data.push_back(_rnd.next(256));
+				}
+				x += count;
+			}
+			data.push_back((border << 1) | 1);
+			WRITE_LE_UINT16(&data[start], data.size() - start - 2);
+		}
+	}
+
+	static void decodeSprite(byte *dst, int dstPitch, const byte *src, const Common::Rect &srcRect) {
+		const byte *dataPtr = src;
+		for (int h = srcRect.top; h > 0; --h)
+			dataPtr += READ_LE_UINT16(dataPtr) + 2;
+
+		for (int h = srcRect.height(); h > 0; --h) {
+			int xoff = srcRect.left;
+			int w = srcRect.width();
+			const uint16 lineSize = READ_LE_UINT16(dataPtr);
+			dataPtr += 2;
+			const byte *dataPtrNext = dataPtr + lineSize;
+			byte *dstPtr = dst;
+			if (lineSize != 0) {
+				while (w > 0) {
+					byte code = *dataPtr++;
+					if (code & 1) {
+						code >>= 1;
+						if (xoff > 0) {
+							xoff -= code;
+							if (xoff >= 0)
+								continue;
+							code = -xoff;
+						}
+						dstPtr += code;
+						w -= code;
+					} else if (code & 2) {
+						code = (code >> 2) + 1;
+						if (xoff > 0) {
+							xoff -= code;
+							++dataPtr;
+							if (xoff >= 0)
+								continue;
+							code = -xoff;
+							--dataPtr;
+						}
+						w -= code;
+						if (w < 0)
+							code += w;
+						while (code--)
+							*dstPtr++ = *dataPtr;
+						dataPtr++;
+					} else {
+						code = (code >> 2) + 1;
+						if (xoff > 0) {
+							xoff -= code;
+							dataPtr += code;
+							if (xoff >= 0)
+								continue;
+							code = -xoff;
+							dataPtr += xoff;
+						}
+						w -= code;
+						if (w < 0)
+							code += w;
+						while (code--)
+							*dstPtr++ = *dataPtr++;
+					}
+				}
+			}
+			dataPtr = dataPtrNext;
+			dst += dstPitch;
+		}
+	}
+
+	double drawAll(bool spans) {
+		byte *screen = new byte[kScreenWidth * kScreenHeight];
+		Benchmark::Random rnd;
+		Benchmark::Timer timer;
+		for (int frame = 0; frame < kFrames; ++frame) {
+			for (int i = 0; i < kDraws; ++i) {
+				const int sprite = rnd.next(kSprites);
+				// Some sprites are cut off by the edges of the screen.
+				const int x = (int)rnd.next(kScreenWidth + kSize) - kSize;
+				const int y = (int)rnd.next(kScreenHeight + kSize) - kSize;
+				Common::Rect r(x, y, x + kSize, y + kSize);
+				r.clip(Common::Rect(kScreenWidth, kScreenHeight));
+				if (r.isEmpty())
+					continue;
+				byte *dst = screen + r.top * kScreenWidth + r.left;
+				r.translate(-x, -y);
+				if (spans)
+					Scumm::WizSpans::draw(dst, kScreenWidth, Scumm::kDstScreen, &_spans[sprite][0], &_data[sprite][0], 1, r, 0, Scumm::kWizCopy, 0, 1);
+				else
+					decodeSprite(dst, kScreenWidth, &_data[sprite][0], r);
+			}
+		}
+		const double ms = timer.elapsedMillis();
+		delete[] screen;
+		return ms;
+	}
+
+public:
+	void test_sprites() {
+		for (int i = 0; i < kSprites; ++i) {
+			makeSprite(_data[i]);
+			_spans[i].resize(Scumm::WizSpans::measure(&_data[i][0], kSize, kSize, 1));
+			Scumm::WizSpans::build(&_spans[i][0], &_data[i][0], kSize, kSize, 1);
+		}
+
+		const double decoded = drawAll(false);
+		const double spans = drawAll(true);
+		BENCH_REPORT(Common::String::format("Wiz %d sprites per frame: %7.3f ms decoded per pixel, %7.3f ms from spans",
+			kDraws, decoded / kFrames, spans / kFrames));
+	}
+};
@@ -0,0 +1,132 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/bufferedstream.h"
+
+// Counts what reaches the wrapped stream.
+class CountingReadStream : public Common::MemoryReadStream {
+public:
+	uint reads, seeks, positions;
+
+	CountingReadStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size), reads(0), seeks(0), positions(0) {}
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize) { ++reads; return Common::MemoryReadStream::read(dataPtr, dataSize); }
+	virtual bool seek(int32 offs, int whence = SEEK_SET) { ++seeks; return Common::MemoryReadStream::seek(offs, whence); }
+	virtual int32 pos() const { ++const_cast<CountingReadStream *>(this)->positions; return Common::MemoryReadStream::pos(); }
+};
+
+class BlockCachedReadStreamTestSuite : public CxxTest::TestSuite {
+	byte _contents[1000];
+
+public:
+	void setUp() {
+		for (uint i = 0; i < sizeof(_contents); ++i)
+			_contents[i] = (i * 7) & 0xFF;
+	}
+
+	void test_traverse() {
+		CountingReadStream ms(_contents, sizeof(_contents));
+		Common::SeekableReadStream &s = *Common::wrapBlockCachedReadStream(&ms, 16, 8, DisposeAfterUse::NO);
+
+		TS_ASSERT_EQUALS(s.size(), 1000);
+		for (uint i = 0; i < sizeof(_contents); ++i) {
+			TS_ASSERT(!s.eos());
+			TS_ASSERT_EQUALS(s.pos(), (int32)i);
+			TS_ASSERT_EQUALS(s.readByte(), _contents[i]);
+		}
+
+		TS_ASSERT(!s.eos());
+		byte b;
+		TS_ASSERT_EQUALS(s.read(&b, 1), 0U);
+		TS_ASSERT(s.eos());
+		TS_ASSERT_EQUALS(s.pos(), 1000);
+
+		// 63 blocks, loaded 1, 2, 4, 4, ... at a time, without seeking.
+		TS_ASSERT_EQUALS(ms.reads, 17U);
+		TS_ASSERT_EQUALS(ms.seeks, 0U);
+		TS_ASSERT_EQUALS(ms.positions, 1U);
+
+		delete &s;
+	}
+
+	void test_seek() {
+		CountingReadStream ms(_contents, sizeof(_contents));
+		Common::SeekableReadStream &s = *Common::wrapBlockCachedReadStream(&ms, 16, 4, DisposeAfterUse::NO);
+
+		TS_ASSERT(s.seek(500));
+		TS_ASSERT_EQUALS(s.readByte(), _contents[500]);
+		TS_ASSERT(s.seek(10, SEEK_CUR));
+		TS_ASSERT_EQUALS(s.pos(), 511);
+		TS_ASSERT_EQUALS(s.readByte(), _contents[511]);
+		TS_ASSERT(s.seek(-12, SEEK_CUR));
+		TS_ASSERT_EQUALS(s.readByte(), _contents[500]);
+
+		// All of these were within the block at 496.
+		TS_ASSERT_EQUALS(ms.reads, 1U);
+		TS_ASSERT_EQUALS(ms.seeks, 1U);
+
+		TS_ASSERT(s.seek(-1, SEEK_END));
+		TS_ASSERT_EQUALS(s.readByte(), _contents[999]);
+		TS_ASSERT(!s.eos());
+		s.readByte();
+		TS_ASSERT(s.eos());
+		TS_ASSERT(s.seek(0, SEEK_END));
+		TS_ASSERT(!s.eos());
+
+		TS_ASSERT(!s.seek(-1));
+		TS_ASSERT(!s.seek(1, SEEK_END));
+		TS_ASSERT_EQUALS(s.pos(), 1000);
+
+		// Back to the first block, which is still cached.
+		TS_ASSERT(s.seek(505));
+		TS_ASSERT_EQUALS(s.readByte(), _contents[505]);
+		TS_ASSERT_EQUALS(ms.reads, 2U);
+
+		delete &s;
+	}
+
+	void test_large_reads() {
+		CountingReadStream ms(_contents, sizeof(_contents));
+		Common::SeekableReadStream &s = *Common::wrapBlockCachedReadStream(&ms, 16, 4, DisposeAfterUse::NO);
+
+		byte buf[300];
+		TS_ASSERT(s.seek(3));
+		TS_ASSERT_EQUALS(s.readByte(), _contents[3]);
+
+		// Served from the cached block first, then straight from the parent.
+		TS_ASSERT_EQUALS(s.read(buf, sizeof(buf)), sizeof(buf));
+		TS_ASSERT_EQUALS(memcmp(buf, _contents + 4, sizeof(buf)), 0);
+		TS_ASSERT_EQUALS(s.pos(), 304);
+		TS_ASSERT_EQUALS(ms.reads, 2U);
+
+		TS_ASSERT(s.seek(900));
+		TS_ASSERT_EQUALS(s.read(buf, sizeof(buf)), 100U);
+		TS_ASSERT_EQUALS(memcmp(buf, _contents + 900, 100), 0);
+		TS_ASSERT(s.eos());
+		TS_ASSERT_EQUALS(s.pos(), 1000);
+
+		delete &s;
+	}
+
+	void test_mixed() {
+		Common::MemoryReadStream ms(_contents, sizeof(_contents));
+		Common::SeekableReadStream &s = *Common::wrapBlockCachedReadStream(&ms, 32, 3, DisposeAfterUse::NO);
+
+		// Pseudo random seeks and reads of all sizes.
+		uint32 seed = 4;
+		byte buf[80];
+		for (uint i = 0; i < 2000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const int32 offset = (seed >> 8) % 1000;
+			const uint32 size = (seed >> 20) % sizeof(buf);
+
+			TS_ASSERT(s.seek(offset));
+			const uint32 expected = MIN<uint32>(size, 1000 - offset);
+			TS_ASSERT_EQUALS(s.read(buf, size), expected);
+			TS_ASSERT_EQUALS(memcmp(buf, _contents + offset, expected), 0);
+			TS_ASSERT_EQUALS(s.pos(), (int32)(offset + expected));
+		}
+
+		delete &s;
+	}
+};
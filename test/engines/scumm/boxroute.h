@@ -0,0 +1,155 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/boxroute.h"
+
+class ScummBoxRouteTestSuite : public CxxTest::TestSuite {
+	typedef Scumm::WalkboxRouter Router;
+
+	/** The itinerary matrix as computed by ScummEngine::calcItineraryMatrix. */
+	static void calcReference(int num, const Router::BoxSet *links, Router::BoxSet hidden, byte *next) {
+		byte dist[Router::kMaxBoxes * Router::kMaxBoxes];
+		const int size = Router::kMaxBoxes;
+
+		for (int i = 0; i < num; i++) {
+			for (int j = 0; j < num; j++) {
+				const bool visible = !(hidden & ((Router::BoxSet)1 << i)) && !(hidden & ((Router::BoxSet)1 << j));
+				if (i == j) {
+					dist[i * size + j] = 0;
+					next[i * size + j] = j;
+				} else if (visible && (links[i] & ((Router::BoxSet)1 << j))) {
+					dist[i * size + j] = 1;
+					next[i * size + j] = j;
+				} else {
+					dist[i * size + j] = 255;
+					next[i * size + j] = Router::kNoRoute;
+				}
+			}
+		}
+
+		for (int k = 0; k < num; k++) {
+			for (int i = 0; i < num; i++) {
+				for (int j = 0; j < num; j++) {
+					if (i == j)
+						continue;
+					byte distIK = dist[size * i + k];
+					byte distKJ = dist[size * k + j];
+					if (dist[size * i + j] > distIK + distKJ) {
+						dist[size * i + j] = distIK + distKJ;
+						next[size * i + j] = next[size * i + k];
+					}
+				}
+			}
+		}
+	}
+
+	static bool matchesReference(const Router &router, int num, const Router::BoxSet *links, Router::BoxSet hidden) {
+		byte next[Router::kMaxBoxes * Router::kMaxBoxes];
+		calcReference(num, links, hidden, next);
+		for (int i = 0; i < num; i++) {
+			for (int j = 0; j < num; j++) {
+				if (router.getNextBox(i, j) != next[i * Router::kMaxBoxes + j])
+					return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	void test_chain() {
+		// 0 - 1 - 2 - 3, and 4 - 5 on their own.
+		Router::BoxSet links[6] = { 0x2, 0x5, 0xA, 0x4, 0x20, 0x10 };
+		Router router;
+
+		router.setLinks(6, links);
+		TS_ASSERT_EQUALS(router.update(0), 6U);
+		TS_ASSERT_EQUALS(router.getNextBox(0, 3), 1);
+		TS_ASSERT_EQUALS(router.getNextBox(3, 0), 2);
+		TS_ASSERT_EQUALS(router.getNextBox(0, 4), (int)Router::kNoRoute);
+
+		// Hiding box 2 cuts the chain, but leaves the other part alone.
+		TS_ASSERT_EQUALS(router.update(0x4), 4U);
+		TS_ASSERT_EQUALS(router.getNextBox(0, 3), (int)Router::kNoRoute);
+		TS_ASSERT_EQUALS(router.getNextBox(0, 1), 1);
+		TS_ASSERT_EQUALS(router.getNextBox(2, 2), 2);
+		TS_ASSERT_EQUALS(router.getNextBox(4, 5), 5);
+
+		TS_ASSERT_EQUALS(router.update(0x4), 0U);
+		TS_ASSERT_EQUALS(router.update(0), 4U);
+		TS_ASSERT_EQUALS(router.getNextBox(0, 3), 1);
+
+		const Router::Stats &stats = router.getStats();
+		TS_ASSERT_EQUALS(stats.builds, 1U);
+		TS_ASSERT_EQUALS(stats.updates, 2U);
+		TS_ASSERT_EQUALS(stats.unchanged, 1U);
+	}
+
+	void test_matches_full_computation() {
+		uint32 seed = 12345;
+		for (int round = 0; round < 20; round++) {
+			const int num = 8 + round * 3 > Router::kMaxBoxes ? Router::kMaxBoxes : 8 + round * 3;
+			Router::BoxSet links[Router::kMaxBoxes];
+
+			// Mostly grids of boxes, with a few one way passages.
+			for (int i = 0; i < num; i++) {
+				links[i] = 0;
+				for (int j = 0; j < num; j++) {
+					seed = seed * 1103515245 + 12345;
+					if (i != j && (j == i + 1 || j == i - 1 || j == i + 8 || j == i - 8 || (seed >> 16) % 61 == 0))
+						links[i] |= (Router::BoxSet)1 << j;
+				}
+			}
+
+			Router router;
+			router.setLinks(num, links);
+			Router::BoxSet hidden = 0;
+			router.update(hidden);
+			TS_ASSERT(matchesReference(router, num, links, hidden));
+
+			for (int step = 0; step < 30; step++) {
+				seed = seed * 1103515245 + 12345;
+				hidden ^= (Router::BoxSet)1 << ((seed >> 16) % num);
+				if (step % 7 == 3) {
+					seed = seed * 1103515245 + 12345;
+					hidden ^= (Router::BoxSet)1 << ((seed >> 16) % num);
+				}
+				router.update(hidden);
+				TS_ASSERT(matchesReference(router, num, links, hidden));
+			}
+		}
+	}
+
+	void test_gate_cache() {
+		Scumm::BoxGateCache cache;
+		Scumm::BoxSide side;
+
+		TS_ASSERT(!cache.lookupSide(1, 2, side));
+		side.type = Scumm::BoxSide::kVertical;
+		side.line = 100;
+		side.min1 = side.min2 = 10;
+		side.max1 = side.max2 = 50;
+		cache.storeSide(1, 2, side);
+
+		Scumm::BoxSide found;
+		TS_ASSERT(cache.lookupSide(1, 2, found));
+		TS_ASSERT_EQUALS(found.line, 100);
+		TS_ASSERT(!cache.lookupSide(2, 1, found));
+
+		Common::Point gateA[2], gateB[2];
+		TS_ASSERT(!cache.lookupGates(1, 2, gateA, gateB));
+		gateA[0] = Common::Point(1, 2);
+		gateA[1] = Common::Point(3, 4);
+		gateB[0] = Common::Point(5, 6);
+		gateB[1] = Common::Point(7, 8);
+		cache.storeGates(1, 2, gateA, gateB);
+
+		Common::Point foundA[2], foundB[2];
+		TS_ASSERT(cache.lookupGates(1, 2, foundA, foundB));
+		TS_ASSERT_EQUALS(foundB[1], Common::Point(7, 8));
+
+		cache.invalidate();
+		TS_ASSERT(!cache.lookupSide(1, 2, found));
+		TS_ASSERT(!cache.lookupGates(1, 2, foundA, foundB));
+		TS_ASSERT_EQUALS(cache.getStats().hits, 2U);
+		TS_ASSERT_EQUALS(cache.getStats().misses, 5U);
+	}
+};
@@ -0,0 +1,105 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/endian.h"
+
+#include "engines/scumm/compose16.h"
+
+class ScummCompose16TestSuite : public CxxTest::TestSuite {
+	enum {
+		kMaxWidth = 320,
+		kHeight = 6,
+		kPad = 24
+	};
+
+	uint32 _seed;
+	uint16 _palette[256];
+	byte _src[(kMaxWidth + kPad) * 2 * kHeight];
+	byte _text[(kMaxWidth + kPad) * kHeight];
+	byte _expected[kMaxWidth * 2 * kHeight];
+	byte _result[kMaxWidth * 2 * kHeight + 2];
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	/** Fill the text mostly transparent, with a few clusters of glyph pixels. */
+	void fillText(int textPitch, int width, int percent) {
+		memset(_text, 0xFD, sizeof(_text));
+		for (int h = 0; h < kHeight; ++h) {
+			for (int w = 0; w < width; ++w) {
+				if ((int)(nextRandom() % 100) < percent) {
+					const int run = 1 + nextRandom() % 5;
+					for (int i = 0; i < run && w < width; ++i, ++w)
+						_text[h * textPitch + w] = nextRandom() & 0xFF;
+				}
+			}
+		}
+	}
+
+	void check(Scumm::TextCompositor16 compose, int width, int percent) {
+		const int srcPitch = (width + kPad) * 2;
+		const int textPitch = width + kPad;
+
+		fillText(textPitch, width, percent);
+
+		const bool expectedDrawn = Scumm::composeText16Scalar(_expected, _src, srcPitch, _text, textPitch, _palette, width, kHeight);
+		memset(_result, 0xCC, sizeof(_result));
+		const bool drawn = compose(_result, _src, srcPitch, _text, textPitch, _palette, width, kHeight);
+
+		TS_ASSERT_EQUALS(drawn, expectedDrawn);
+		TS_ASSERT_SAME_DATA(_result, _expected, width * 2 * kHeight);
+		// Nothing is written beyond the composed area.
+		TS_ASSERT_EQUALS(_result[width * 2 * kHeight], 0xCC);
+	}
+
+	void checkAll(Scumm::TextCompositor16 compose) {
+		static const int widths[] = { 1, 4, 7, 8, 12, 16, 20, 33, 36, 320 };
+		static const int percents[] = { 0, 3, 30, 100 };
+
+		for (int i = 0; i < ARRAYSIZE(widths); ++i)
+			for (int j = 0; j < ARRAYSIZE(percents); ++j)
+				check(compose, widths[i], percents[j]);
+	}
+
+public:
+	void setUp() {
+		_seed = 4711;
+		for (int i = 0; i < 256; ++i)
+			_palette[i] = nextRandom() & 0xFFFF;
+		for (uint i = 0; i < sizeof(_src); ++i)
+			_src[i] = nextRandom() & 0xFF;
+	}
+
+	void test_scalar_drawn() {
+		const int textPitch = 8 + kPad;
+
+		fillText(textPitch, 8, 0);
+		TS_ASSERT(!Scumm::composeText16Scalar(_result, _src, 16, _text, textPitch, _palette, 8, kHeight));
+		TS_ASSERT_SAME_DATA(_result, _src, 16);
+
+		_text[textPitch + 3] = 0x12;
+		TS_ASSERT(Scumm::composeText16Scalar(_result, _src, 16, _text, textPitch, _palette, 8, kHeight));
+		TS_ASSERT_EQUALS(READ_UINT16(_result + 16 + 6), _palette[0x12]);
+	}
+
+	void test_generic() {
+		checkAll(Scumm::composeText16Generic);
+	}
+
+	void test_sse2() {
+#ifdef SCUMM_COMPOSE16_SSE2
+		checkAll(Scumm::composeText16SSE2);
+#endif
+	}
+
+	void test_neon() {
+#ifdef SCUMM_COMPOSE16_NEON
+		checkAll(Scumm::composeText16NEON);
+#endif
+	}
+
+	void test_selected() {
+		checkAll(Scumm::getTextCompositor16());
+	}
+};
@@ -0,0 +1,248 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/costume-codec1.h"
+
+class ScummCostumeCodec1TestSuite : public CxxTest::TestSuite {
+	enum {
+		kPitch = 64,
+		kScreenHeight = 48,
+		kNumStrips = kPitch / 8,
+		kWidth = 10,
+		kHeight = 12,
+		kBackground = 0xAA
+	};
+
+	byte _image[kWidth * kHeight];
+	byte _rle[kWidth * kHeight * 2];
+	byte _screen[kPitch * kScreenHeight];
+	byte _expected[kPitch * kScreenHeight];
+	byte _mask[kNumStrips * kScreenHeight];
+	byte _scaleTable[256];
+	byte _shadowTable[256];
+	uint16 _palette[16];
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	/** Encode the image column by column, with 4 bits for the color. */
+	void encode() {
+		byte *dst = _rle;
+		int i = 0;
+		while (i < kWidth * kHeight) {
+			const byte color = _image[(i % kHeight) * kWidth + i / kHeight];
+			int len = 1;
+			while (i + len < kWidth * kHeight && len < 255 && _image[((i + len) % kHeight) * kWidth + (i + len) / kHeight] == color)
+				len++;
+			if (len < 16) {
+				*dst++ = (color << 4) | len;
+			} else {
+				*dst++ = color << 4;
+				*dst++ = len;
+			}
+			i += len;
+		}
+	}
+
+	void setUp() {
+		_seed = 0xC0DEC1;
+		for (int i = 0; i < kWidth * kHeight; ++i)
+			_image[i] = (nextRandom() % 3) ? nextRandom() % 16 : 0;
+		encode();
+
+		memset(_screen, kBackground, sizeof(_screen));
+		memset(_mask, 0, sizeof(_mask));
+		memset(_scaleTable, 0, sizeof(_scaleTable));
+		for (int i = 0; i < 256; ++i)
+			_shadowTable[i] = 255 - i;
+		for (int i = 0; i < 16; ++i)
+			_palette[i] = 0x40 + i;
+	}
+
+	void setup(Scumm::BaseCostumeRenderer::Codec1 &v1, Scumm::Codec1Context &ctx, int x, int y, bool mirrored) {
+		v1.x = x;
+		v1.y = y;
+		v1.scaletable = _scaleTable;
+		v1.skip_width = kWidth;
+		v1.destptr = _screen + y * kPitch + x;
+		v1.mask_ptr = _mask + y * kNumStrips;
+		v1.scaleXstep = mirrored ? 1 : -1;
+		v1.mask = 15;
+		v1.shr = 4;
+		v1.repcolor = 0;
+		v1.replen = 0;
+		v1.boundsRect = Common::Rect(kPitch, kScreenHeight);
+		v1.scaleXindex = 0;
+		v1.scaleYindex = 0;
+
+		ctx.src = _rle;
+		ctx.height = kHeight;
+		ctx.pitch = kPitch;
+		ctx.numStrips = kNumStrips;
+		ctx.scaleX = 255;
+		ctx.scaleY = 255;
+		ctx.palette = _palette;
+		ctx.shadowTable = _shadowTable;
+	}
+
+	/** What an unscaled and unmasked decoder should draw. */
+	void drawExpected(int x, int y, bool mirrored) {
+		memset(_expected, kBackground, sizeof(_expected));
+		for (int col = 0; col < kWidth; ++col) {
+			const int dx = x + (mirrored ? col : -col);
+			for (int row = 0; row < kHeight; ++row) {
+				const byte color = _image[row * kWidth + col];
+				if (color && dx >= 0 && dx < kPitch && y + row < kScreenHeight)
+					_expected[(y + row) * kPitch + dx] = _palette[color];
+			}
+		}
+	}
+
+	void draw(Scumm::Codec1Flavor flavor, bool scaled, bool mirrored, bool masked, int x, int y) {
+		Scumm::BaseCostumeRenderer::Codec1 v1;
+		Scumm::Codec1Context ctx;
+		setup(v1, ctx, x, y, mirrored);
+		Scumm::getCodec1Decoder(flavor, scaled, mirrored, masked, Scumm::kCodec1ShadowNone)(v1, ctx);
+	}
+
+public:
+	void test_unscaled() {
+		for (int flavor = 0; flavor < 2; ++flavor) {
+			for (int mirrored = 0; mirrored < 2; ++mirrored) {
+				for (int masked = 0; masked < 2; ++masked) {
+					// The scaled decoders must not change anything without scaling.
+					for (int scaled = 0; scaled < 2; ++scaled) {
+						memset(_screen, kBackground, sizeof(_screen));
+						draw((Scumm::Codec1Flavor)flavor, scaled, mirrored, masked, 20, 5);
+						drawExpected(20, 5, mirrored);
+						TS_ASSERT_SAME_DATA(_screen, _expected, sizeof(_screen));
+					}
+				}
+			}
+		}
+	}
+
+	void test_clipping() {
+		// Mirrored cels run to the right, past the bottom right corner.
+		draw(Scumm::kCodec1Classic, false, true, false, kPitch - 4, kScreenHeight - 5);
+		drawExpected(kPitch - 4, kScreenHeight - 5, true);
+		TS_ASSERT_SAME_DATA(_screen, _expected, sizeof(_screen));
+	}
+
+	void test_mask() {
+		Scumm::BaseCostumeRenderer::Codec1 v1;
+		Scumm::Codec1Context ctx;
+		setup(v1, ctx, 20, 5, false);
+		TS_ASSERT(Scumm::isCodec1MaskClear(v1, ctx));
+
+		// Masked pixels away from the cel do not matter.
+		_mask[4 * kNumStrips + 2] = 0xFF;
+		_mask[5 * kNumStrips + 4] = 0xFF;
+		TS_ASSERT(Scumm::isCodec1MaskClear(v1, ctx));
+
+		_mask[16 * kNumStrips + 1] = 0x01;
+		TS_ASSERT(!Scumm::isCodec1MaskClear(v1, ctx));
+
+		memset(_mask, 0xFF, sizeof(_mask));
+		draw(Scumm::kCodec1Classic, false, false, true, 20, 5);
+		memset(_expected, kBackground, sizeof(_expected));
+		TS_ASSERT_SAME_DATA(_screen, _expected, sizeof(_screen));
+	}
+
+	void test_shadow() {
+		Scumm::BaseCostumeRenderer::Codec1 v1;
+		Scumm::Codec1Context ctx;
+
+		_palette[1] = 13;
+		setup(v1, ctx, 20, 5, true);
+		Scumm::getCodec1Decoder(Scumm::kCodec1Classic, false, true, false, Scumm::kCodec1ShadowColor13)(v1, ctx);
+		drawExpected(20, 5, true);
+		for (int i = 0; i < kPitch * kScreenHeight; ++i) {
+			if (_expected[i] == 13)
+				_expected[i] = _shadowTable[kBackground];
+		}
+		TS_ASSERT_SAME_DATA(_screen, _expected, sizeof(_screen));
+
+		memset(_screen, kBackground, sizeof(_screen));
+		setup(v1, ctx, 20, 5, true);
+		Scumm::getCodec1Decoder(Scumm::kCodec1Classic, false, true, false, Scumm::kCodec1ShadowAll)(v1, ctx);
+		drawExpected(20, 5, true);
+		for (int i = 0; i < kPitch * kScreenHeight; ++i) {
+			if (_expected[i] != kBackground)
+				_expected[i] = _shadowTable[kBackground];
+		}
+		TS_ASSERT_SAME_DATA(_screen, _expected, sizeof(_screen));
+	}
+
+	void test_skipped_columns() {
+		// Draw every row, but never advance to the next column.
+		for (int row = 0; row < kHeight; ++row) {
+			for (int col = 0; col < kWidth; ++col)
+				_image[row * kWidth + col] = col ? 2 : 1;
+		}
+		encode();
+		memset(_scaleTable, 0xFF, sizeof(_scaleTable));
+
+		Scumm::BaseCostumeRenderer::Codec1 v1;
+		Scumm::Codec1Context ctx;
+		setup(v1, ctx, 20, 5, false);
+		ctx.scaleX = 128;
+		ctx.scaleY = 255;
+		v1.scaleXindex = 128;
+		Scumm::getCodec1Decoder(Scumm::kCodec1Classic, true, false, false, Scumm::kCodec1ShadowNone)(v1, ctx);
+		// The classic costumes draw all columns on top of each other...
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 20], _palette[2]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 19], kBackground);
+
+		// ...while AKOS only draws the first one.
+		setup(v1, ctx, 20, 5, false);
+		ctx.scaleX = 128;
+		ctx.scaleY = 255;
+		v1.scaleXindex = 128;
+		Scumm::getCodec1Decoder(Scumm::kCodec1Akos, true, false, false, Scumm::kCodec1ShadowNone)(v1, ctx);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 20], _palette[1]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 19], kBackground);
+	}
+
+	void test_scale_index_wrap() {
+		// One color per column, to tell where each column was drawn.
+		for (int row = 0; row < kHeight; ++row) {
+			for (int col = 0; col < kWidth; ++col)
+				_image[row * kWidth + col] = col + 1;
+		}
+		encode();
+		// Only the columns at the indexes 255, 0 and 1 are advanced to.
+		memset(_scaleTable, 0xFF, sizeof(_scaleTable));
+		_scaleTable[255] = 0;
+		_scaleTable[0] = 0;
+		_scaleTable[1] = 0;
+
+		Scumm::BaseCostumeRenderer::Codec1 v1;
+		Scumm::Codec1Context ctx;
+
+		// The classic costumes wrap around to the start of the scale table...
+		setup(v1, ctx, 20, 5, true);
+		ctx.scaleX = 128;
+		v1.scaleXindex = 254;
+		Scumm::getCodec1Decoder(Scumm::kCodec1Classic, true, true, false, Scumm::kCodec1ShadowNone)(v1, ctx);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 20], _palette[2]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 21], _palette[3]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 22], _palette[4]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 23], _palette[kWidth]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 24], kBackground);
+
+		// ...and to its end.
+		memset(_screen, kBackground, sizeof(_screen));
+		setup(v1, ctx, 20, 5, false);
+		ctx.scaleX = 128;
+		v1.scaleXindex = 1;
+		Scumm::getCodec1Decoder(Scumm::kCodec1Classic, true, false, false, Scumm::kCodec1ShadowNone)(v1, ctx);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 20], _palette[1]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 19], _palette[2]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 18], _palette[3]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 17], _palette[kWidth]);
+		TS_ASSERT_EQUALS(_screen[5 * kPitch + 16], kBackground);
+	}
+};
@@ -0,0 +1,116 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/damage.h"
+
+class ScummDamageTrackerTestSuite : public CxxTest::TestSuite {
+	Scumm::DamageTracker _damage;
+	Common::Array<Common::Rect> _rects;
+
+	void collect(int numStrips = 40) {
+		_rects.clear();
+		_damage.collectRects(numStrips, _rects);
+	}
+
+public:
+	void setUp() {
+		_damage.clear();
+		_damage.getStats().reset();
+	}
+
+	void test_neighbours_joined() {
+		_damage.addRect(Scumm::kDamageActor, 2, 6, 64, 144);
+		collect();
+		TS_ASSERT_EQUALS(_rects.size(), 1U);
+		TS_ASSERT_EQUALS(_rects[0], Common::Rect(16, 64, 56, 144));
+
+		// Collecting marks the strips as clean.
+		collect();
+		TS_ASSERT(_rects.empty());
+	}
+
+	void test_separate_spans() {
+		// A line of text above an actor: the lines in between stay clean.
+		_damage.addRect(Scumm::kDamageCharset, 0, 39, 8, 24);
+		_damage.addRect(Scumm::kDamageActor, 10, 14, 64, 144);
+		collect();
+		TS_ASSERT_EQUALS(_rects.size(), 2U);
+		TS_ASSERT_EQUALS(_rects[0], Common::Rect(0, 8, 320, 24));
+		TS_ASSERT_EQUALS(_rects[1], Common::Rect(80, 64, 120, 144));
+
+		const Scumm::DamageTracker::Stats &stats = _damage.getStats();
+		TS_ASSERT_EQUALS(stats.pixels, 320U * 16 + 40U * 80);
+		TS_ASSERT_EQUALS(stats.stripPixels, 280U * 16 + 40U * 136);
+	}
+
+	void test_unequal_neighbours() {
+		_damage.addSpan(0, 0, 10);
+		_damage.addSpan(0, 20, 30);
+		_damage.addSpan(1, 20, 30);
+		_damage.addSpan(2, 0, 10);
+		collect();
+		TS_ASSERT_EQUALS(_rects.size(), 3U);
+		TS_ASSERT_EQUALS(_rects[0], Common::Rect(0, 0, 8, 10));
+		TS_ASSERT_EQUALS(_rects[1], Common::Rect(0, 20, 16, 30));
+		TS_ASSERT_EQUALS(_rects[2], Common::Rect(16, 0, 24, 10));
+	}
+
+	void test_fold() {
+		_damage.addSpan(0, 10, 20);
+		_damage.addSpan(0, 40, 50);
+		_damage.addSpan(0, 20, 25);
+		_damage.addSpan(0, 5, 12);
+		collect(1);
+		TS_ASSERT_EQUALS(_rects.size(), 2U);
+		TS_ASSERT_EQUALS(_rects[0], Common::Rect(0, 5, 8, 25));
+		TS_ASSERT_EQUALS(_rects[1], Common::Rect(0, 40, 8, 50));
+
+		_damage.addSpan(0, 10, 20);
+		_damage.addSpan(0, 40, 50);
+		_damage.addSpan(0, 0, 100);
+		collect(1);
+		TS_ASSERT_EQUALS(_rects.size(), 1U);
+		TS_ASSERT_EQUALS(_rects[0], Common::Rect(0, 0, 8, 100));
+	}
+
+	void test_too_many_spans() {
+		for (int i = 0; i < Scumm::DamageTracker::kMaxSpans; ++i)
+			_damage.addSpan(0, i * 20, i * 20 + 10);
+		_damage.addSpan(0, 75, 80);
+		collect(1);
+
+		// The closest two were merged.
+		TS_ASSERT_EQUALS(_rects.size(), (uint)Scumm::DamageTracker::kMaxSpans);
+		TS_ASSERT_EQUALS(_rects.back(), Common::Rect(0, 60, 8, 80));
+	}
+
+	void test_mark_all() {
+		_damage.markAll(0, 144);
+		collect();
+		TS_ASSERT_EQUALS(_rects.size(), 1U);
+		TS_ASSERT_EQUALS(_rects[0], Common::Rect(0, 0, 320, 144));
+
+		_damage.addRect(Scumm::kDamageVerb, 0, 3, 0, 8);
+		_damage.markAll(0, 0);
+		collect();
+		TS_ASSERT(_rects.empty());
+	}
+
+	void test_stats() {
+		Scumm::DamageTracker::Stats &stats = _damage.getStats();
+
+		_damage.addRect(Scumm::kDamageActor, 0, 1, 0, 10);
+		_damage.addRect(Scumm::kDamageActor, 0, 1, 0, 10);
+		_damage.addRect(Scumm::kDamageVerb, 5, 5, 0, 10);
+		collect();
+		_damage.endFrame();
+
+		TS_ASSERT_EQUALS(stats.frames, 1U);
+		TS_ASSERT_EQUALS(stats.lastInvalidations[Scumm::kDamageActor], 2U);
+		TS_ASSERT_EQUALS(stats.lastInvalidations[Scumm::kDamageVerb], 1U);
+		TS_ASSERT_EQUALS(stats.lastInvalidated, 2U * 160 + 80);
+		TS_ASSERT_EQUALS(stats.lastRects, 2U);
+		TS_ASSERT_EQUALS(stats.lastPixels, 240U);
+		TS_ASSERT_EQUALS(stats.invalidations[Scumm::kDamageActor], 0U);
+		TS_ASSERT_EQUALS(stats.pixels, 0U);
+	}
+};
@@ -0,0 +1,62 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/script.h"
+
+class ScummDispatchTestSuite : public CxxTest::TestSuite {
+	struct Handlers {
+		void o_first() {}
+		void o_second() {}
+	};
+
+	Handlers _handlers;
+
+	Scumm::Opcode *makeProc(void (Handlers::*func)()) {
+		return new Common::Functor0Mem<void, Handlers>(&_handlers, func);
+	}
+
+public:
+	void test_same_code() {
+		Scumm::OpcodeEntry opcodes[256];
+		opcodes[0x10].setProc(makeProc(&Handlers::o_first), "o_first");
+		opcodes[0x20].setProc(makeProc(&Handlers::o_second), "o_second");
+
+		const byte code[] = { 0x10, 0x20 };
+		Scumm::OpcodeFetch first(opcodes, code);
+		TS_ASSERT_EQUALS(first.next, code + 1);
+		TS_ASSERT_EQUALS(first.opcode, 0x10);
+		TS_ASSERT_EQUALS(first.proc, opcodes[0x10].proc);
+		TS_ASSERT(first == Scumm::OpcodeFetch(opcodes, code));
+
+		Scumm::OpcodeFetch second(opcodes, first.next);
+		TS_ASSERT_EQUALS(second.proc, opcodes[0x20].proc);
+		TS_ASSERT(second != first);
+	}
+
+	void test_moved_code() {
+		Scumm::OpcodeEntry opcodes[256];
+		opcodes[0x10].setProc(makeProc(&Handlers::o_first), "o_first");
+
+		// The same script at a new address is fetched to a different place.
+		const byte pinned[] = { 0x10 };
+		const byte moved[] = { 0x10 };
+		Scumm::OpcodeFetch direct(opcodes, pinned);
+		Scumm::OpcodeFetch classic(opcodes, moved);
+		TS_ASSERT_EQUALS(direct.opcode, classic.opcode);
+		TS_ASSERT_EQUALS(direct.proc, classic.proc);
+		TS_ASSERT(direct != classic);
+	}
+
+	void test_handler_identity() {
+		Scumm::OpcodeEntry opcodes[256];
+		opcodes[0x10].setProc(makeProc(&Handlers::o_first), "o_first");
+
+		const byte code[] = { 0x10 };
+		Scumm::OpcodeFetch before(opcodes, code);
+
+		// The same opcode at the same address, but resolved to another handler.
+		opcodes[0x10].setProc(makeProc(&Handlers::o_second), "o_second");
+		Scumm::OpcodeFetch after(opcodes, code);
+		TS_ASSERT_EQUALS(before.next, after.next);
+		TS_ASSERT(before != after);
+	}
+};
@@ -0,0 +1,129 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+
+#include "engines/scumm/offsetcache.h"
+
+class ScummOffsetCacheTestSuite : public CxxTest::TestSuite {
+	typedef Scumm::ResourceOffsetCache Cache;
+
+	static void fill(byte *data, uint size, byte seed) {
+		for (uint i = 0; i < size; ++i)
+			data[i] = (byte)(i * 7 + seed);
+	}
+
+public:
+	void test_lookup() {
+		byte data[256];
+		fill(data, sizeof(data), 1);
+		Common::MemoryReadStream file(data, sizeof(data));
+		Cache cache;
+		uint32 offset, size;
+
+		// Nothing is known about files which are not open.
+		cache.store(3, 1, 10, 20);
+		TS_ASSERT(!cache.lookup(3, 1, offset, size));
+		TS_ASSERT(!cache.isDirty());
+
+		cache.openFile("monkey.001", file);
+		TS_ASSERT(!cache.lookup(3, 1, offset, size));
+		cache.store(3, 1, 10, 20);
+		TS_ASSERT(cache.isDirty());
+		TS_ASSERT(cache.lookup(3, 1, offset, size));
+		TS_ASSERT_EQUALS(offset, 10U);
+		TS_ASSERT_EQUALS(size, 20U);
+		TS_ASSERT(!cache.lookup(4, 1, offset, size));
+
+		cache.closeFile();
+		TS_ASSERT(!cache.lookup(3, 1, offset, size));
+		TS_ASSERT_EQUALS(cache.getStats().hits, 1U);
+		TS_ASSERT_EQUALS(cache.getStats().misses, 2U);
+	}
+
+	void test_save_load() {
+		byte data1[256], data2[128];
+		fill(data1, sizeof(data1), 1);
+		fill(data2, sizeof(data2), 2);
+		Common::MemoryReadStream file1(data1, sizeof(data1));
+		Common::MemoryReadStream file2(data2, sizeof(data2));
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		uint32 offset, size;
+
+		Cache cache;
+		cache.openFile("monkey.001", file1);
+		cache.store(1, 5, 100, 50);
+		cache.store(3, 7, 150, 20);
+		cache.openFile("monkey.002", file2);
+		cache.store(1, 6, 8, 100);
+		cache.save(out);
+		TS_ASSERT(!cache.isDirty());
+
+		Common::MemoryReadStream in(out.getData(), out.size());
+		Cache loaded;
+		TS_ASSERT(loaded.load(in));
+		TS_ASSERT_EQUALS(loaded.getFileCount(), 2U);
+		TS_ASSERT_EQUALS(loaded.getEntryCount(), 3U);
+
+		// File names are not case sensitive.
+		loaded.openFile("MONKEY.001", file1);
+		TS_ASSERT(loaded.lookup(3, 7, offset, size));
+		TS_ASSERT_EQUALS(offset, 150U);
+		TS_ASSERT_EQUALS(size, 20U);
+		TS_ASSERT(!loaded.lookup(1, 6, offset, size));
+		loaded.openFile("monkey.002", file2);
+		TS_ASSERT(loaded.lookup(1, 6, offset, size));
+		TS_ASSERT_EQUALS(offset, 8U);
+		TS_ASSERT(!loaded.isDirty());
+	}
+
+	void test_changed_file() {
+		byte data[256];
+		fill(data, sizeof(data), 1);
+		Common::MemoryReadStream file(data, sizeof(data));
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		uint32 offset, size;
+
+		Cache cache;
+		cache.openFile("monkey.001", file);
+		cache.store(1, 5, 100, 50);
+		cache.save(out);
+
+		// Same size, different contents.
+		data[17] ^= 0xFF;
+		Common::MemoryReadStream in(out.getData(), out.size());
+		Cache loaded;
+		TS_ASSERT(loaded.load(in));
+		loaded.openFile("monkey.001", file);
+		TS_ASSERT(!loaded.lookup(1, 5, offset, size));
+		TS_ASSERT_EQUALS(loaded.getStats().invalidated, 1U);
+		TS_ASSERT(loaded.isDirty());
+
+		// Different size.
+		Common::MemoryReadStream shorter(data, sizeof(data) - 1);
+		Common::MemoryReadStream in2(out.getData(), out.size());
+		TS_ASSERT(loaded.load(in2));
+		loaded.openFile("monkey.001", shorter);
+		TS_ASSERT(!loaded.lookup(1, 5, offset, size));
+	}
+
+	void test_invalid_data() {
+		const byte garbage[] = { 'S', 'O', 'F', 'X', 1, 0, 0, 0 };
+		Common::MemoryReadStream in(garbage, sizeof(garbage));
+		Cache cache;
+		TS_ASSERT(!cache.load(in));
+
+		// Truncated data is dropped as a whole.
+		byte data[64];
+		fill(data, sizeof(data), 1);
+		Common::MemoryReadStream file(data, sizeof(data));
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		cache.openFile("monkey.001", file);
+		cache.store(1, 5, 10, 5);
+		cache.save(out);
+
+		Common::MemoryReadStream truncated(out.getData(), out.size() - 4);
+		Cache loaded;
+		TS_ASSERT(!loaded.load(truncated));
+		TS_ASSERT_EQUALS(loaded.getFileCount(), 0U);
+	}
+};
@@ -0,0 +1,49 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/opcodeprofile.h"
+
+class ScummOpcodeProfileTestSuite : public CxxTest::TestSuite {
+public:
+	void test_count() {
+		Scumm::OpcodeProfile profile;
+		TS_ASSERT(!profile.isEnabled());
+		TS_ASSERT_EQUALS(profile.getTotal(), 0U);
+
+		profile.count(0x1A);
+		profile.count(0x1A);
+		profile.count(0xFF);
+		TS_ASSERT_EQUALS(profile.getCount(0x1A), 2U);
+		TS_ASSERT_EQUALS(profile.getCount(0xFF), 1U);
+		TS_ASSERT_EQUALS(profile.getCount(0x00), 0U);
+		TS_ASSERT_EQUALS(profile.getTotal(), 3U);
+
+		profile.reset();
+		TS_ASSERT_EQUALS(profile.getCount(0x1A), 0U);
+		TS_ASSERT_EQUALS(profile.getTotal(), 0U);
+	}
+
+	void test_top() {
+		Scumm::OpcodeProfile profile;
+		for (int i = 0; i < 5; ++i)
+			profile.count(0x40);
+		for (int i = 0; i < 3; ++i) {
+			profile.count(0x80);
+			profile.count(0x10);
+		}
+		profile.count(0x01);
+
+		Common::Array<Scumm::OpcodeProfile::Entry> entries;
+		profile.getTop(3, entries);
+		TS_ASSERT_EQUALS(entries.size(), 3U);
+		TS_ASSERT_EQUALS(entries[0].opcode, 0x40);
+		TS_ASSERT_EQUALS(entries[0].count, 5U);
+		// Equal counts are ordered by opcode.
+		TS_ASSERT_EQUALS(entries[1].opcode, 0x10);
+		TS_ASSERT_EQUALS(entries[2].opcode, 0x80);
+
+		// Opcodes which never ran are left out.
+		profile.getTop(256, entries);
+		TS_ASSERT_EQUALS(entries.size(), 4U);
+		TS_ASSERT_EQUALS(entries[3].opcode, 0x01);
+	}
+};
@@ -0,0 +1,162 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/respolicy.h"
+
+class ScummResourcePolicyTestSuite : public CxxTest::TestSuite {
+	class LockFilter : public Scumm::ResourcePolicy::Filter {
+	public:
+		uint32 locked;
+
+		LockFilter() : locked(0xFFFFFFFF) {}
+		bool canEvict(uint32 key) const { return key != locked; }
+	};
+
+	typedef Scumm::ArcResourcePolicy Arc;
+
+	static uint32 key(int idx) {
+		return Scumm::ResourcePolicy::makeKey(3, idx);
+	}
+
+public:
+	void test_key() {
+		const uint32 k = Scumm::ResourcePolicy::makeKey(21, 1234);
+		TS_ASSERT_EQUALS(Scumm::ResourcePolicy::getKeyType(k), 21);
+		TS_ASSERT_EQUALS(Scumm::ResourcePolicy::getKeyIndex(k), 1234);
+	}
+
+	void test_recency_and_frequency() {
+		Arc arc;
+		arc.setCapacity(1000);
+
+		arc.load(key(1), 100);
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), (int)Arc::kT1);
+
+		// Uses following the load closely do not count.
+		arc.access(key(1));
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), (int)Arc::kT1);
+		arc.tick();
+		arc.access(key(1));
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), (int)Arc::kT1);
+
+		for (int i = 0; i <= Arc::kCorrelationTicks; ++i)
+			arc.tick();
+		arc.access(key(1));
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), (int)Arc::kT2);
+		TS_ASSERT_EQUALS(arc.getListBytes(Arc::kT2), 100U);
+		TS_ASSERT_EQUALS(arc.getListBytes(Arc::kT1), 0U);
+
+		// Freed on purpose, the resource is forgotten.
+		arc.drop(key(1), false);
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), -1);
+		TS_ASSERT_EQUALS(arc.getListCount(Arc::kT2), 0U);
+	}
+
+	void test_victim() {
+		Arc arc;
+		LockFilter filter;
+		uint32 victim;
+		arc.setCapacity(1000);
+
+		arc.load(key(1), 100);
+		arc.load(key(2), 100);
+		// Nothing may go that was used in this iteration.
+		TS_ASSERT(!arc.selectVictim(filter, victim));
+
+		arc.tick();
+		TS_ASSERT(arc.selectVictim(filter, victim));
+		TS_ASSERT_EQUALS(victim, key(1));
+
+		filter.locked = key(1);
+		TS_ASSERT(arc.selectVictim(filter, victim));
+		TS_ASSERT_EQUALS(victim, key(2));
+
+		// Resources used again later are kept longer than those used once.
+		filter.locked = 0xFFFFFFFF;
+		for (int i = 0; i <= Arc::kCorrelationTicks; ++i)
+			arc.tick();
+		arc.access(key(1));
+		arc.tick();
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), (int)Arc::kT2);
+		TS_ASSERT(arc.selectVictim(filter, victim));
+		TS_ASSERT_EQUALS(victim, key(2));
+	}
+
+	void test_demote() {
+		Arc arc;
+		LockFilter filter;
+		uint32 victim;
+		arc.setCapacity(1000);
+
+		arc.load(key(1), 100);
+		arc.tick();
+		arc.access(key(1));
+		arc.load(key(2), 100);
+		arc.tick();
+		arc.access(key(2));
+		arc.tick();
+
+		arc.demote(key(2));
+		TS_ASSERT(arc.selectVictim(filter, victim));
+		TS_ASSERT_EQUALS(victim, key(2));
+	}
+
+	void test_ghosts() {
+		Arc arc;
+		arc.setCapacity(1000);
+
+		arc.load(key(1), 100);
+		arc.tick();
+		arc.drop(key(1), true);
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), (int)Arc::kB1);
+		TS_ASSERT_EQUALS(arc.getTarget(), 0U);
+
+		// Reloading it shows that T1 was too small.
+		arc.load(key(1), 100);
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), (int)Arc::kT2);
+		TS_ASSERT_EQUALS(arc.getTarget(), 100U);
+
+		arc.tick();
+		arc.drop(key(1), true);
+		TS_ASSERT_EQUALS(arc.getListOf(key(1)), (int)Arc::kB2);
+		arc.load(key(1), 100);
+		TS_ASSERT_EQUALS(arc.getTarget(), 0U);
+
+		// The ghosts never describe more than the capacity.
+		for (int i = 10; i < 40; ++i) {
+			arc.load(key(i), 100);
+			arc.tick();
+			arc.drop(key(i), true);
+		}
+		TS_ASSERT_LESS_THAN_EQUALS(arc.getListBytes(Arc::kB1), 1000U);
+	}
+
+	void test_weights() {
+		Arc arc;
+		LockFilter filter;
+		uint32 victim;
+		arc.setCapacity(100000);
+
+		const uint32 room = Scumm::ResourcePolicy::makeKey(1, 1);
+		const uint32 sound = Scumm::ResourcePolicy::makeKey(4, 1);
+		arc.load(room, 20000);
+		arc.load(sound, 20000);
+		arc.tick();
+
+		// Same size, the older one goes.
+		TS_ASSERT(arc.selectVictim(filter, victim));
+		TS_ASSERT_EQUALS(victim, room);
+
+		arc.setTypeWeight(1, 200);
+		TS_ASSERT(arc.selectVictim(filter, victim));
+		TS_ASSERT_EQUALS(victim, sound);
+
+		// Large resources free more memory per seek.
+		arc.setTypeWeight(1, 100);
+		arc.drop(sound, false);
+		const uint32 big = Scumm::ResourcePolicy::makeKey(1, 2);
+		arc.load(big, 80000);
+		arc.tick();
+		TS_ASSERT(arc.selectVictim(filter, victim));
+		TS_ASSERT_EQUALS(victim, big);
+	}
+};
@@ -0,0 +1,136 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/stream.h"
+
+#include "engines/scumm/savewriter.h"
+
+class ScummSaveWriterTestSuite : public CxxTest::TestSuite {
+	/** Appends to an array owned by the test, which outlives the stream. */
+	class ArrayWriteStream : public Common::WriteStream {
+	public:
+		Common::Array<byte> &data;
+		uint writes;
+		bool finalized;
+		bool full;	///< fail all writes, like a full disk
+
+		ArrayWriteStream(Common::Array<byte> &d) : data(d), writes(0), finalized(false), full(false) {}
+
+		uint32 write(const void *dataPtr, uint32 dataSize) {
+			if (full)
+				return 0;
+			const byte *src = (const byte *)dataPtr;
+			for (uint32 i = 0; i < dataSize; ++i)
+				data.push_back(src[i]);
+			writes++;
+			return dataSize;
+		}
+		void finalize() { finalized = true; }
+		int32 pos() const { return data.size(); }
+	};
+
+	static byte *makeSnapshot(uint32 size, byte seed) {
+		byte *data = (byte *)malloc(size);
+		for (uint32 i = 0; i < size; ++i)
+			data[i] = (byte)(i * 7 + seed);
+		return data;
+	}
+
+public:
+	void test_chunks() {
+		Scumm::IncrementalSaveWriter writer;
+		Common::Array<byte> file;
+		writer.setChunkSize(1000);
+
+		byte *data = makeSnapshot(2500, 1);
+		writer.start(new ArrayWriteStream(file), "test.s00", data, 2500);
+		TS_ASSERT(writer.isBusy());
+
+		TS_ASSERT(writer.step());
+		TS_ASSERT_EQUALS(file.size(), 1000U);
+		TS_ASSERT(writer.step());
+		TS_ASSERT(!writer.step());
+		TS_ASSERT(!writer.isBusy());
+		TS_ASSERT_EQUALS(file.size(), 2500U);
+
+		bool same = true;
+		for (uint i = 0; i < file.size(); ++i)
+			same &= (file[i] == (byte)(i * 7 + 1));
+		TS_ASSERT(same);
+
+		TS_ASSERT_EQUALS(writer.getStats().saves, 1U);
+		TS_ASSERT_EQUALS(writer.getStats().chunks, 3U);
+		TS_ASSERT_EQUALS(writer.getStats().bytes, 2500U);
+	}
+
+	void test_finish() {
+		Scumm::IncrementalSaveWriter writer;
+		Common::Array<byte> first, second;
+		writer.setChunkSize(100);
+
+		writer.start(new ArrayWriteStream(first), "test.s00", makeSnapshot(1000, 1), 1000);
+		writer.step();
+
+		// Starting another save completes the first one.
+		writer.start(new ArrayWriteStream(second), "test.s00", makeSnapshot(1000, 2), 1000);
+		TS_ASSERT_EQUALS(first.size(), 1000U);
+		TS_ASSERT_EQUALS(second.size(), 0U);
+
+		TS_ASSERT(writer.finish());
+		TS_ASSERT_EQUALS(second.size(), 1000U);
+		TS_ASSERT(!writer.isBusy());
+
+		// Without a chunk size, everything is written in one step.
+		Common::Array<byte> third;
+		writer.setChunkSize(0);
+		writer.start(new ArrayWriteStream(third), "test.s00", makeSnapshot(1000, 3), 1000);
+		TS_ASSERT(!writer.step());
+		TS_ASSERT_EQUALS(third.size(), 1000U);
+	}
+
+	void test_failure() {
+		Scumm::IncrementalSaveWriter writer;
+		Common::Array<byte> file;
+		writer.setChunkSize(100);
+
+		ArrayWriteStream *out = new ArrayWriteStream(file);
+		writer.start(out, "test.s00", makeSnapshot(1000, 1), 1000);
+		TS_ASSERT(writer.step());
+		TS_ASSERT(!writer.hasFailed());
+
+		// A failed write ends the save at once.
+		out->full = true;
+		TS_ASSERT(!writer.step());
+		TS_ASSERT(!writer.isBusy());
+		TS_ASSERT(writer.hasFailed());
+		TS_ASSERT_EQUALS(file.size(), 100U);
+
+		// The next save starts out clean.
+		Common::Array<byte> second;
+		writer.start(new ArrayWriteStream(second), "test.s00", makeSnapshot(1000, 2), 1000);
+		TS_ASSERT(!writer.hasFailed());
+		TS_ASSERT(writer.finish());
+		TS_ASSERT(!writer.hasFailed());
+	}
+
+	void test_delta() {
+		Scumm::IncrementalSaveWriter writer;
+		const uint32 block = Scumm::IncrementalSaveWriter::kDeltaBlockSize;
+		byte *state = makeSnapshot(block * 4, 0);
+
+		TS_ASSERT_EQUALS(writer.updateDelta(state, block * 4), block * 4);
+		TS_ASSERT_EQUALS(writer.updateDelta(state, block * 4), 0U);
+
+		state[block + 5] ^= 0xFF;
+		state[block * 3] ^= 0xFF;
+		TS_ASSERT_EQUALS(writer.updateDelta(state, block * 4), block * 2);
+
+		// Growing or shrinking counts as a change.
+		TS_ASSERT_EQUALS(writer.updateDelta(state, block * 3 + 10), block - 10);
+		TS_ASSERT_EQUALS(writer.updateDelta(state, block * 3 + 10), 0U);
+		TS_ASSERT_EQUALS(writer.updateDelta(state, block * 4), block);
+
+		writer.forgetDelta();
+		TS_ASSERT_EQUALS(writer.updateDelta(state, block * 4), block * 4);
+		free(state);
+	}
+};
@@ -0,0 +1,179 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+
+#include "engines/scumm/smush/blocks.h"
+#include "engines/scumm/smush/codec37.h"
+#include "engines/scumm/smush/codec47.h"
+
+class ScummSmushCodecsTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 320,
+		kHeight = 200,
+		kFrames = 8,
+		kMargin = 48
+	};
+
+	uint32 _seed;
+	Common::Array<byte> _data;
+	Common::Array<uint32> _frames;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 8) & 0xFFFFFF) % max;
+	}
+
+	void push(byte b) {
+		_data.push_back(b);
+	}
+
+	void makeBlock47(int level, bool interior) {
+		const uint32 r = nextRandom(100);
+
+		if (r < 40 && interior) {
+			push(nextRandom(0xF8));
+		} else if (r < 60) {
+			push(0xFF);
+			if (level < 3) {
+				for (int i = 0; i < 4; ++i)
+					makeBlock47(level + 1, interior);
+			} else {
+				for (int i = 0; i < 4; ++i)
+					push(nextRandom(256));
+			}
+		} else if (r < 70) {
+			push(0xFE);
+			push(nextRandom(256));
+		} else if (r < 85 && level < 3) {
+			push(0xFD);
+			push(nextRandom(256));
+			push(nextRandom(256));
+			push(nextRandom(256));
+		} else if (r < 95) {
+			push(0xFC);
+		} else {
+			push(0xF8 + nextRandom(4));
+		}
+	}
+
+	/** Frames with every kind of block, each against the frames before. */
+	void makeCodec47() {
+		_seed = 47;
+		_data.clear();
+		_frames.clear();
+		for (int frame = 0; frame < kFrames; ++frame) {
+			_frames.push_back(_data.size());
+			push(frame);
+			push(0);
+			push(2);
+			push(frame ? nextRandom(3) : 0);
+			for (int i = 4; i < 26; ++i)
+				push(i == 4 ? 0 : nextRandom(256));
+
+			for (int y = 0; y < kHeight; y += 8) {
+				for (int x = 0; x < kWidth; x += 8) {
+					const bool interior = x >= kMargin && y >= kMargin && x + 8 <= kWidth - kMargin && y + 8 <= kHeight - kMargin;
+					makeBlock47(1, interior);
+				}
+			}
+		}
+	}
+
+	void makeCodec37() {
+		_seed = 37;
+		_data.clear();
+		_frames.clear();
+		for (int frame = 0; frame < kFrames; ++frame) {
+			_frames.push_back(_data.size());
+			const byte compression = frame & 1 ? 4 : 3;
+			push(compression);
+			push(frame & 1);
+			push(frame);
+			push(0);
+			for (int i = 4; i < 16; ++i)
+				push(i == 12 ? 4 : 0);
+
+			int left = (kWidth / 4) * (kHeight / 4);
+			while (left > 0) {
+				const uint32 r = nextRandom(100);
+				int count = 1;
+				if (r < 60) {
+					push(1 + nextRandom(0xFC));
+				} else if (r < 70) {
+					push(0xFD);
+					push(nextRandom(256));
+				} else if (r < 78) {
+					push(0xFE);
+					for (int i = 0; i < 4; ++i)
+						push(nextRandom(256));
+				} else if (r < 85) {
+					push(0xFF);
+					for (int i = 0; i < 16; ++i)
+						push(nextRandom(256));
+				} else if (compression == 4) {
+					count = MIN<int>(1 + nextRandom(16), left);
+					push(0x00);
+					push(count - 1);
+				} else {
+					push(0x01);
+				}
+				left -= count;
+			}
+		}
+		for (int i = 0; i < 64; ++i)
+			push(0);
+	}
+
+	/** FNV-1a over all decoded frames. */
+	template<class Decoder>
+	uint32 decodeAll() {
+		Decoder decoder(kWidth, kHeight);
+		byte dst[kWidth * kHeight];
+		uint32 hash = 2166136261U;
+		for (uint i = 0; i < _frames.size(); ++i) {
+			decoder.decode(dst, &_data[_frames[i]]);
+			for (uint j = 0; j < sizeof(dst); ++j)
+				hash = (hash ^ dst[j]) * 16777619U;
+		}
+		return hash;
+	}
+
+public:
+	void test_glyph_blocks() {
+		byte mask[64];
+		for (int i = 0; i < 64; ++i)
+			mask[i] = (i * 7) % 3 ? 0xFF : 0;
+
+		// Unaligned, with a pitch wider than the block.
+		byte frame[1 + 12 * 8];
+		memset(frame, 0x55, sizeof(frame));
+		Scumm::smushGlyphBlock8(frame + 1, 12, mask, 1, 2);
+		for (int y = 0; y < 8; ++y)
+			for (int x = 0; x < 12; ++x)
+				TS_ASSERT_EQUALS(frame[1 + y * 12 + x], x >= 8 ? 0x55 : mask[y * 8 + x] ? 1 : 2);
+
+		memset(frame, 0x55, sizeof(frame));
+		Scumm::smushGlyphBlock4(frame + 1, 5, mask, 3, 4);
+		for (int y = 0; y < 4; ++y)
+			for (int x = 0; x < 4; ++x)
+				TS_ASSERT_EQUALS(frame[1 + y * 5 + x], mask[y * 4 + x] ? 3 : 4);
+		TS_ASSERT_EQUALS(frame[1 + 4], 0x55);
+	}
+
+	void test_codec37_output() {
+#ifdef ENABLE_SCUMM_7_8
+		// The output of the byte by byte decoder this replaced.
+		makeCodec37();
+		TS_ASSERT_EQUALS(decodeAll<Scumm::Codec37Decoder>(), 3248192775U);
+#endif
+	}
+
+	void test_codec47_output() {
+#ifdef ENABLE_SCUMM_7_8
+		makeCodec47();
+		TS_ASSERT_EQUALS(decodeAll<Scumm::Codec47Decoder>(), 3683749333U);
+		// A second decoder uses the tables the first one made.
+		TS_ASSERT_EQUALS(decodeAll<Scumm::Codec47Decoder>(), 3683749333U);
+#endif
+	}
+};
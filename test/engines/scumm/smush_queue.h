@@ -0,0 +1,162 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+
+#include "engines/scumm/smush/smush_queue.h"
+
+class ScummSmushQueueTestSuite : public CxxTest::TestSuite {
+	Common::Array<byte> _file;
+
+	void writeTag(uint32 tag, uint32 size) {
+		for (int i = 3; i >= 0; --i)
+			_file.push_back((tag >> (i * 8)) & 0xFF);
+		for (int i = 3; i >= 0; --i)
+			_file.push_back((size >> (i * 8)) & 0xFF);
+	}
+
+	void writeBytes(const byte *data, uint32 size) {
+		for (uint32 i = 0; i < size; ++i)
+			_file.push_back(data[i]);
+	}
+
+	/** A zlib stream with one stored block, as good as compressed for the decoder. */
+	static Common::Array<byte> makeZlib(const byte *data, uint16 size) {
+		Common::Array<byte> out;
+		out.push_back(0x78);
+		out.push_back(0x01);
+		out.push_back(0x01);
+		out.push_back(size & 0xFF);
+		out.push_back(size >> 8);
+		out.push_back(~size & 0xFF);
+		out.push_back((~size >> 8) & 0xFF);
+		uint32 a = 1, b = 0;
+		for (uint16 i = 0; i < size; ++i) {
+			out.push_back(data[i]);
+			a = (a + data[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		const uint32 adler = (b << 16) | a;
+		for (int i = 3; i >= 0; --i)
+			out.push_back((adler >> (i * 8)) & 0xFF);
+		return out;
+	}
+
+	/** An AHDR, a frame with a ZFOB and a palette, and a plain frame. */
+	void makeAnimation(byte *fobj, uint32 fobjSize) {
+		_file.clear();
+		writeTag(MKTAG('A','N','I','M'), 0);
+
+		byte header[0x306];
+		memset(header, 7, sizeof(header));
+		writeTag(MKTAG('A','H','D','R'), sizeof(header));
+		writeBytes(header, sizeof(header));
+
+		for (uint32 i = 0; i < fobjSize; ++i)
+			fobj[i] = i * 3;
+		Common::Array<byte> zlib = makeZlib(fobj, fobjSize);
+		const uint32 zfobSize = 4 + zlib.size();
+		byte pal[0x300];
+		memset(pal, 9, sizeof(pal));
+
+		writeTag(MKTAG('F','R','M','E'), 8 + zfobSize + (zfobSize & 1) + 8 + sizeof(pal));
+		writeTag(MKTAG('Z','F','O','B'), zfobSize);
+		for (int i = 3; i >= 0; --i)
+			_file.push_back((fobjSize >> (i * 8)) & 0xFF);
+		writeBytes(&zlib[0], zlib.size());
+		if (zfobSize & 1)
+			_file.push_back(0);
+		writeTag(MKTAG('N','P','A','L'), sizeof(pal));
+		writeBytes(pal, sizeof(pal));
+
+		writeTag(MKTAG('F','R','M','E'), 8 + 4);
+		writeTag(MKTAG('S','K','I','P'), 4);
+		writeBytes(pal, 4);
+
+		WRITE_BE_UINT32(&_file[4], _file.size() - 8);
+	}
+
+public:
+	void test_order_and_end() {
+#ifdef ENABLE_SCUMM_7_8
+		byte fobj[100];
+		makeAnimation(fobj, sizeof(fobj));
+		Common::MemoryReadStream stream(&_file[0], _file.size());
+		stream.seek(8);
+
+		Scumm::SmushFrameQueue queue;
+		queue.setCapacity(2);
+		queue.reset(&stream, _file.size());
+		TS_ASSERT(queue.fill());
+		TS_ASSERT(queue.fill());
+		TS_ASSERT(queue.isFull());
+		TS_ASSERT(!queue.fill());
+
+		uint32 type;
+		Common::SeekableReadStream *chunk = queue.next(type);
+		TS_ASSERT(chunk);
+		TS_ASSERT_EQUALS(type, MKTAG('A','H','D','R'));
+		TS_ASSERT_EQUALS(chunk->size(), 0x306);
+		delete chunk;
+
+		chunk = queue.next(type);
+		TS_ASSERT_EQUALS(type, MKTAG('F','R','M','E'));
+		delete chunk;
+
+		// Not read ahead, read when needed.
+		chunk = queue.next(type);
+		TS_ASSERT(chunk);
+		TS_ASSERT_EQUALS(type, MKTAG('F','R','M','E'));
+		TS_ASSERT_EQUALS(chunk->readUint32BE(), MKTAG('S','K','I','P'));
+		delete chunk;
+
+		TS_ASSERT(!queue.next(type));
+		TS_ASSERT(!queue.fill());
+
+		const Scumm::SmushFrameQueue::Stats &stats = queue.getStats();
+		TS_ASSERT_EQUALS(stats.chunks, 3U);
+		TS_ASSERT_EQUALS(stats.readAhead, 2U);
+		TS_ASSERT_EQUALS(stats.underruns, 1U);
+#endif
+	}
+
+	void test_inflate_ahead() {
+#if defined(ENABLE_SCUMM_7_8) && defined(USE_ZLIB)
+		// An odd size, so that the FOBJ needs padding.
+		byte fobj[101];
+		makeAnimation(fobj, sizeof(fobj));
+		Common::MemoryReadStream stream(&_file[0], _file.size());
+		stream.seek(8);
+
+		Scumm::SmushFrameQueue queue;
+		queue.reset(&stream, _file.size());
+		while (queue.fill())
+			;
+		TS_ASSERT_EQUALS(queue.size(), 3U);
+		TS_ASSERT_EQUALS(queue.getStats().inflated, 1U);
+
+		uint32 type;
+		delete queue.next(type);
+		Common::SeekableReadStream *chunk = queue.next(type);
+		TS_ASSERT_EQUALS(chunk->size(), (int32)(8 + sizeof(fobj) + 1 + 8 + 0x300));
+		TS_ASSERT_EQUALS(chunk->readUint32BE(), MKTAG('F','O','B','J'));
+		TS_ASSERT_EQUALS(chunk->readUint32BE(), sizeof(fobj));
+		byte data[sizeof(fobj)];
+		chunk->read(data, sizeof(data));
+		TS_ASSERT_EQUALS(memcmp(data, fobj, sizeof(fobj)), 0);
+		chunk->skip(1);
+		TS_ASSERT_EQUALS(chunk->readUint32BE(), MKTAG('N','P','A','L'));
+		TS_ASSERT_EQUALS(chunk->readUint32BE(), 0x300U);
+		delete chunk;
+
+		// Seeking throws away what was read ahead.
+		stream.seek(8);
+		queue.reset(&stream, _file.size());
+		TS_ASSERT_EQUALS(queue.size(), 0U);
+		chunk = queue.next(type);
+		TS_ASSERT_EQUALS(type, MKTAG('A','H','D','R'));
+		delete chunk;
+#endif
+	}
+};
@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/stripcache.h"
+
+class ScummStripCacheTestSuite : public CxxTest::TestSuite {
+	byte _resource[64];
+	Scumm::StripCache _cache;
+
+	byte *insert(int offset, uint32 size = 16) {
+		return _cache.insert(Scumm::StripCache::kPixels, _resource + offset, 0, 2, size);
+	}
+
+	bool contains(int offset) {
+		const byte *data;
+		return _cache.lookup(Scumm::StripCache::kPixels, _resource + offset, 0, 2, data);
+	}
+
+public:
+	void setUp() {
+		_cache.clear();
+		_cache.setMaxSize(1024);
+		_cache.getStats().reset();
+	}
+
+	void test_lookup() {
+		const byte *data = 0;
+		TS_ASSERT(!_cache.lookup(Scumm::StripCache::kPixels, _resource, 0, 2, data));
+
+		byte *stored = insert(0);
+		TS_ASSERT(stored);
+		memset(stored, 0x5A, 16);
+
+		TS_ASSERT(_cache.lookup(Scumm::StripCache::kPixels, _resource, 0, 2, data));
+		TS_ASSERT_EQUALS(data, stored);
+
+		// All parts of the key have to match.
+		TS_ASSERT(!_cache.lookup(Scumm::StripCache::kMask, _resource, 0, 2, data));
+		TS_ASSERT(!_cache.lookup(Scumm::StripCache::kAkos16Cel, _resource, 0, 2, data));
+		TS_ASSERT(!_cache.lookup(Scumm::StripCache::kPixels, _resource, _resource, 2, data));
+		TS_ASSERT(!_cache.lookup(Scumm::StripCache::kPixels, _resource, 0, 3, data));
+
+		TS_ASSERT_EQUALS(_cache.getStats().hits, 1U);
+		TS_ASSERT_EQUALS(_cache.getStats().misses, 5U);
+	}
+
+	void test_uncacheable() {
+		TS_ASSERT(!insert(0, 0));
+
+		const byte *data = _resource;
+		TS_ASSERT(contains(0));
+		TS_ASSERT(_cache.lookup(Scumm::StripCache::kPixels, _resource, 0, 2, data));
+		TS_ASSERT(!data);
+		TS_ASSERT_EQUALS(_cache.getStats().bypassed, 2U);
+	}
+
+	void test_lru_eviction() {
+		// Find out how many entries fit.
+		int count = 0;
+		while (!_cache.getStats().evictions)
+			insert(count++, 64);
+		const int capacity = count - 1;
+		TS_ASSERT_LESS_THAN(1, capacity);
+		TS_ASSERT_LESS_THAN_EQUALS(_cache.getSize(), _cache.getMaxSize());
+
+		// Touch the oldest entry, so that the second one is evicted first.
+		_cache.clear();
+		for (int i = 0; i < capacity; ++i)
+			insert(i, 64);
+		TS_ASSERT(contains(0));
+
+		insert(capacity, 64);
+		TS_ASSERT(contains(0));
+		TS_ASSERT(!contains(1));
+		TS_ASSERT(contains(2));
+		TS_ASSERT(contains(capacity));
+	}
+
+	void test_too_large() {
+		TS_ASSERT(!insert(0, 4096));
+		TS_ASSERT(!contains(0));
+		TS_ASSERT_EQUALS(_cache.getEntryCount(), 0U);
+	}
+
+	void test_invalidate() {
+		insert(0);
+		insert(10);
+		insert(20);
+		_cache.invalidate(_resource + 5, 10);
+		TS_ASSERT(contains(0));
+		TS_ASSERT(!contains(10));
+		TS_ASSERT(contains(20));
+		TS_ASSERT_EQUALS(_cache.getStats().invalidations, 1U);
+	}
+
+	void test_disable() {
+		insert(0);
+		_cache.setMaxSize(0);
+		TS_ASSERT_EQUALS(_cache.getEntryCount(), 0U);
+		TS_ASSERT_EQUALS(_cache.getSize(), 0U);
+		TS_ASSERT(!insert(0));
+	}
+};
@@ -0,0 +1,172 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+
+#include "engines/scumm/he/wiz_he.h"
+#include "engines/scumm/he/wizspans_he.h"
+
+class ScummWizSpansTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 37,
+		kHeight = 23,
+		kTransparent = -1
+	};
+
+	uint32 _seed;
+	Common::Array<byte> _data;
+	/** The pixels the data decodes to, or kTransparent. */
+	Common::Array<int> _pixels;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 8) & 0xFFFFFF) % max;
+	}
+
+	void pushPixel(uint16 color, int pixelSize) {
+		_data.push_back(color & 0xFF);
+		if (pixelSize == 2)
+			_data.push_back(color >> 8);
+	}
+
+	/** Encode random lines, some of them empty and some with codes reaching past the width. */
+	void makeImage(int pixelSize) {
+		_data.clear();
+		_pixels.clear();
+		_pixels.resize(kWidth * kHeight);
+		for (uint i = 0; i < _pixels.size(); ++i)
+			_pixels[i] = kTransparent;
+
+		for (int y = 0; y < kHeight; ++y) {
+			const uint start = _data.size();
+			_data.push_back(0);
+			_data.push_back(0);
+			if (nextRandom(8) == 0)
+				continue;
+
+			int x = 0;
+			while (x < kWidth) {
+				const uint32 r = nextRandom(3);
+				if (r == 0) {
+					const int count = 1 + nextRandom(12);
+					_data.push_back((count << 1) | 1);
+					x += count;
+				} else if (r == 1) {
+					const int count = 1 + nextRandom(10);
+					const uint16 color = nextRandom(pixelSize == 2 ? 0x10000 : 0x100);
+					_data.push_back(((count - 1) << 2) | 2);
+					pushPixel(color, pixelSize);
+					for (int i = 0; i < count && x < kWidth; ++i)
+						_pixels[y * kWidth + x++] = color;
+				} else {
+					const int count = 1 + nextRandom(10);
+					_data.push_back((count - 1) << 2);
+					for (int i = 0; i < count; ++i) {
+						const uint16 color = nextRandom(pixelSize == 2 ? 0x10000 : 0x100);
+						pushPixel(color, pixelSize);
+						if (x < kWidth)
+							_pixels[y * kWidth + x] = color;
+						++x;
+					}
+				}
+			}
+			WRITE_LE_UINT16(&_data[start], _data.size() - start - 2);
+		}
+	}
+
+	/** Draw the part of the decoded pixels the way the Wiz decoders do. */
+	void drawReference(byte *dst, int pitch, int dstBytes, const Common::Rect &r, int flags, const byte *palette, const byte *palette16) {
+		for (int y = r.top; y < r.bottom; ++y) {
+			for (int x = r.left; x < r.right; ++x) {
+				const int color = _pixels[y * kWidth + x];
+				if (color == kTransparent)
+					continue;
+				const int dx = (flags & Scumm::kWIFFlipX) ? r.right - 1 - x : x - r.left;
+				const int dy = (flags & Scumm::kWIFFlipY) ? r.bottom - 1 - y : y - r.top;
+				byte *p = dst + dy * pitch + dx * dstBytes;
+				if (dstBytes == 1)
+					*p = palette ? palette[color] : color;
+				else
+					WRITE_LE_UINT16(p, palette16 ? READ_LE_UINT16(palette16 + color * 2) : color);
+			}
+		}
+	}
+
+	void compare(int pixelSize, int bitDepth, bool remap, int iterations) {
+		byte palette[256];
+		byte palette16[512];
+		for (int i = 0; i < 256; ++i) {
+			palette[i] = 255 - i;
+			WRITE_LE_UINT16(palette16 + i * 2, i * 0x0101 ^ 0x1234);
+		}
+
+		const uint32 size = Scumm::WizSpans::measure(&_data[0], kWidth, kHeight, pixelSize);
+		TS_ASSERT(size != 0);
+		Common::Array<byte> spans;
+		spans.resize(size);
+		Scumm::WizSpans::build(&spans[0], &_data[0], kWidth, kHeight, pixelSize);
+
+		const int dstBytes = pixelSize == 2 ? 2 : bitDepth;
+		const int pitch = kWidth * dstBytes + 3;
+		byte expected[(kWidth * 2 + 3) * kHeight];
+		byte actual[(kWidth * 2 + 3) * kHeight];
+
+		for (int i = 0; i < iterations; ++i) {
+			const int left = nextRandom(kWidth);
+			const int top = nextRandom(kHeight);
+			Common::Rect r(left, top, left + 1 + nextRandom(kWidth - left), top + 1 + nextRandom(kHeight - top));
+			if (i == 0)
+				r = Common::Rect(kWidth, kHeight);
+			const int flags = nextRandom(4) * Scumm::kWIFFlipX;
+			const byte *palPtr = remap ? (bitDepth == 2 ? palette16 : palette) : 0;
+
+			memset(expected, 0xA5, sizeof(expected));
+			memset(actual, 0xA5, sizeof(actual));
+			drawReference(expected, pitch, dstBytes, r, flags, remap && bitDepth == 1 ? palette : 0, remap && bitDepth == 2 ? palette16 : 0);
+			TS_ASSERT(Scumm::WizSpans::draw(actual, pitch, Scumm::kDstMemory, &spans[0], &_data[0], pixelSize, r, flags,
+				remap ? Scumm::kWizRMap : Scumm::kWizCopy, palPtr, bitDepth));
+			TS_ASSERT_SAME_DATA(actual, expected, sizeof(actual));
+		}
+	}
+
+public:
+	void test_draw_8bit() {
+		_seed = 1;
+		makeImage(1);
+		compare(1, 1, false, 200);
+		compare(1, 1, true, 200);
+	}
+
+	void test_draw_8bit_to_16bit() {
+		_seed = 2;
+		makeImage(1);
+		compare(1, 2, false, 200);
+		compare(1, 2, true, 200);
+	}
+
+	void test_draw_16bit() {
+		_seed = 3;
+		makeImage(2);
+		compare(2, 2, false, 200);
+	}
+
+	void test_short_lines() {
+		// A line which ends before the width is covered continues into the
+		// next one in the decoder, which spans cannot reproduce.
+		const byte data[] = { 2, 0, (2 << 1) | 1, 1 << 2 };
+		TS_ASSERT_EQUALS(Scumm::WizSpans::measure(data, 8, 1, 1), 0U);
+	}
+
+	void test_unsupported() {
+		_seed = 4;
+		makeImage(1);
+		Common::Array<byte> spans;
+		spans.resize(Scumm::WizSpans::measure(&_data[0], kWidth, kHeight, 1));
+		Scumm::WizSpans::build(&spans[0], &_data[0], kWidth, kHeight, 1);
+
+		byte dst[kWidth * kHeight];
+		const byte xmap[1] = { 0 };
+		TS_ASSERT(!Scumm::WizSpans::draw(dst, kWidth, Scumm::kDstMemory, &spans[0], &_data[0], 1,
+			Common::Rect(kWidth, kHeight), 0, Scumm::kWizXMap, xmap, 1));
+	}
+};
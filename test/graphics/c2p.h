@@ -0,0 +1,143 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/c2p/c2p.h"
+
+class C2PTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 96,
+		kHeight = 8,
+		kBytesPerRow = kWidth / 8 + 2
+	};
+
+	byte _chunky[kWidth * kHeight];
+	byte _previous[kWidth * kHeight];
+	byte _planeData[Graphics::PlanarBitmap::kDepth][kBytesPerRow * kHeight];
+	byte _expected[Graphics::PlanarBitmap::kDepth][kBytesPerRow * kHeight];
+	Graphics::PlanarBitmap _planar;
+	uint32 _seed;
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0xFF;
+	}
+
+	void fillRandom(byte *data, uint size) {
+		for (uint i = 0; i < size; ++i)
+			data[i] = nextRandom();
+	}
+
+	// Straightforward bit by bit conversion the optimized code is
+	// checked against.
+	static void referenceConvert(const byte *chunky, const Common::Rect &area, byte planes[][kBytesPerRow * kHeight]) {
+		for (int y = area.top; y < area.bottom; ++y) {
+			for (int x = area.left; x < area.right; ++x) {
+				const byte color = chunky[y * kWidth + x];
+				const byte bit = 0x80 >> (x & 7);
+
+				for (int p = 0; p < Graphics::PlanarBitmap::kDepth; ++p) {
+					byte &d = planes[p][y * kBytesPerRow + x / 8];
+					if (color & (1 << p))
+						d |= bit;
+					else
+						d &= ~bit;
+				}
+			}
+		}
+	}
+
+	bool planesMatch() const {
+		return memcmp(_planeData, _expected, sizeof(_planeData)) == 0;
+	}
+
+public:
+	void setUp() {
+		_seed = 0xC2;
+		fillRandom(_chunky, sizeof(_chunky));
+		fillRandom(&_planeData[0][0], sizeof(_planeData));
+		memcpy(_expected, _planeData, sizeof(_planeData));
+
+		for (int p = 0; p < Graphics::PlanarBitmap::kDepth; ++p)
+			_planar.planes[p] = _planeData[p];
+		_planar.bytesPerRow = kBytesPerRow;
+	}
+
+	void test_group_single_bits() {
+		for (int p = 0; p < Graphics::PlanarBitmap::kDepth; ++p) {
+			for (int x = 0; x < Graphics::kC2PGroupWidth; ++x) {
+				byte pixels[Graphics::kC2PGroupWidth];
+				memset(pixels, 0, sizeof(pixels));
+				pixels[x] = 1 << p;
+
+				uint32 words[Graphics::PlanarBitmap::kDepth];
+				Graphics::c2pConvertGroup(pixels, words);
+
+				for (int q = 0; q < Graphics::PlanarBitmap::kDepth; ++q)
+					TS_ASSERT_EQUALS(words[q], (q == p) ? (0x80000000U >> x) : 0U);
+			}
+		}
+	}
+
+	void test_frame() {
+		Graphics::c2pConvertFrame(_chunky, kWidth, kWidth, kHeight, _planar);
+		referenceConvert(_chunky, Common::Rect(kWidth, kHeight), _expected);
+		TS_ASSERT(planesMatch());
+	}
+
+	void test_strips() {
+		const Common::Rect area(40, 2, 70, 5);
+		TS_ASSERT_EQUALS(Graphics::c2pConvertStrips(_chunky, kWidth, area, _planar), (uint)(2 * 3));
+
+		// Extended to whole groups horizontally.
+		referenceConvert(_chunky, Common::Rect(32, 2, 96, 5), _expected);
+		TS_ASSERT(planesMatch());
+	}
+
+	void test_rect() {
+		const Common::Rect areas[] = {
+			Common::Rect(0, 0, 96, 8),
+			Common::Rect(3, 1, 29, 4),
+			Common::Rect(5, 0, 77, 8),
+			Common::Rect(32, 3, 64, 6),
+			Common::Rect(33, 0, 95, 1),
+			Common::Rect(64, 7, 65, 8)
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(areas); ++i) {
+			Graphics::c2pConvertRect(_chunky, kWidth, areas[i], _planar);
+			referenceConvert(_chunky, areas[i], _expected);
+			TS_ASSERT(planesMatch());
+		}
+	}
+
+	void test_delta() {
+		memcpy(_previous, _chunky, sizeof(_chunky));
+		TS_ASSERT_EQUALS(Graphics::c2pConvertFrame(_chunky, kWidth, kWidth, kHeight, _planar, _previous), 0U);
+
+		// Unchanged groups are left alone, so the planes keep their old contents.
+		TS_ASSERT(planesMatch());
+
+		_chunky[3 * kWidth + 50] ^= 0xFF;
+		_chunky[7 * kWidth + 95] ^= 0x01;
+		TS_ASSERT_EQUALS(Graphics::c2pConvertFrame(_chunky, kWidth, kWidth, kHeight, _planar, _previous), 2U);
+		referenceConvert(_chunky, Common::Rect(32, 3, 64, 4), _expected);
+		referenceConvert(_chunky, Common::Rect(64, 7, 96, 8), _expected);
+		TS_ASSERT(planesMatch());
+		TS_ASSERT_EQUALS(memcmp(_chunky, _previous, sizeof(_chunky)), 0);
+
+		TS_ASSERT_EQUALS(Graphics::c2pConvertFrame(_chunky, kWidth, kWidth, kHeight, _planar, _previous), 0U);
+	}
+
+	void test_delta_rect() {
+		memcpy(_previous, _chunky, sizeof(_chunky));
+
+		const Common::Rect area(10, 2, 60, 6);
+		TS_ASSERT_EQUALS(Graphics::c2pConvertRect(_chunky, kWidth, area, _planar, _previous), 0U);
+
+		_chunky[4 * kWidth + 12] ^= 0x80;
+		_chunky[5 * kWidth + 40] ^= 0x80;
+		TS_ASSERT_EQUALS(Graphics::c2pConvertRect(_chunky, kWidth, area, _planar, _previous), 2U);
+		referenceConvert(_chunky, Common::Rect(10, 4, 32, 5), _expected);
+		referenceConvert(_chunky, Common::Rect(32, 5, 60, 6), _expected);
+		TS_ASSERT(planesMatch());
+	}
+};
@@ -0,0 +1,141 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "graphics/colormap16.h"
+
+class ColorMap16TestSuite : public CxxTest::TestSuite {
+	byte _palette[256 * 3];
+	Graphics::PixelFormat _format;
+
+	static byte bruteForce(const Graphics::PixelFormat &format, const byte *palette, uint numColors, uint16 color) {
+		byte r, g, b;
+		format.colorToRGB(color, r, g, b);
+
+		byte best = 0;
+		int bestDistance = 0x7FFFFFFF;
+		for (uint i = 0; i < numColors; ++i) {
+			const int dr = palette[i * 3] - r, dg = palette[i * 3 + 1] - g, db = palette[i * 3 + 2] - b;
+			const int distance = dr * dr + dg * dg + db * db;
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				best = i;
+			}
+		}
+		return best;
+	}
+
+public:
+	void setUp() {
+		_format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		uint32 seed = 0x16;
+		for (uint i = 0; i < sizeof(_palette); ++i) {
+			seed = seed * 1103515245 + 12345;
+			_palette[i] = (seed >> 16) & 0xFF;
+		}
+	}
+
+	void test_build_matches_brute_force() {
+		Graphics::ColorMap16 map;
+		map.build(_format, _palette, 256);
+		TS_ASSERT(map.isValid());
+
+		uint mismatches = 0;
+		for (uint color = 0; color < Graphics::ColorMap16::kSize; ++color) {
+			if (map.lookup(color) != bruteForce(_format, _palette, 256, color))
+				++mismatches;
+		}
+		TS_ASSERT_EQUALS(mismatches, 0U);
+	}
+
+	void test_build_ties_and_small_palettes() {
+		// Duplicate entries: the first one has to win.
+		static const byte palette[] = { 0, 0, 0, 255, 255, 255, 0, 0, 0, 255, 255, 255 };
+
+		Graphics::ColorMap16 map;
+		map.build(_format, palette, 4);
+		TS_ASSERT_EQUALS(map.lookup(0x0000), 0);
+		TS_ASSERT_EQUALS(map.lookup(0xFFFF), 1);
+		TS_ASSERT_EQUALS(map.lookup(_format.RGBToColor(40, 40, 40)), 0);
+	}
+
+	void test_save_load() {
+		Graphics::ColorMap16 map;
+		map.build(_format, _palette, 256);
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		map.save(out);
+		TS_ASSERT_EQUALS(out.size(), (uint32)(8 + Graphics::ColorMap16::kSize));
+
+		Common::MemoryReadStream in(out.getData(), out.size());
+		Graphics::ColorMap16 loaded;
+		TS_ASSERT(loaded.load(_format, in));
+
+		for (uint color = 0; color < Graphics::ColorMap16::kSize; color += 7)
+			TS_ASSERT_EQUALS(loaded.lookup(color), map.lookup(color));
+	}
+
+	void test_load_rejects_invalid() {
+		static const byte text[] = "0\n3\n3\n3\n";
+		Common::MemoryReadStream textStream(text, sizeof(text));
+		Graphics::ColorMap16 map;
+		TS_ASSERT(!map.load(_format, textStream));
+		TS_ASSERT(!map.isValid());
+
+		// Valid header, but truncated.
+		static const byte truncated[] = { 'O', 'M', 'A', 'P', 0, 0, 0, 1, 0, 0 };
+		Common::MemoryReadStream truncatedStream(truncated, sizeof(truncated));
+		TS_ASSERT(!map.load(_format, truncatedStream));
+		TS_ASSERT(!map.isValid());
+	}
+
+	void test_convert_rect_pitch() {
+		Graphics::ColorMap16 map;
+		map.build(_format, _palette, 256);
+
+		uint16 src[4 * 3];
+		for (uint i = 0; i < ARRAYSIZE(src); ++i)
+			src[i] = i * 4099;
+
+		// Convert the 3x2 area at the top left of a 4x3 source into a 5 byte wide destination.
+		byte dst[5 * 2];
+		memset(dst, 0xEE, sizeof(dst));
+		map.convertRect(src, 4 * sizeof(uint16), dst, 5, 3, 2);
+
+		for (uint y = 0; y < 2; ++y) {
+			for (uint x = 0; x < 3; ++x)
+				TS_ASSERT_EQUALS(dst[y * 5 + x], map.lookup(src[y * 4 + x]));
+			TS_ASSERT_EQUALS(dst[y * 5 + 3], 0xEE);
+			TS_ASSERT_EQUALS(dst[y * 5 + 4], 0xEE);
+		}
+	}
+
+	void test_dither() {
+		static const byte palette[] = { 0, 0, 0, 64, 64, 64 };
+
+		Graphics::ColorMap16 map;
+		map.build(_format, palette, 2);
+
+		// Halfway between both entries, so the dither pattern picks both.
+		uint16 gray[8];
+		for (uint i = 0; i < ARRAYSIZE(gray); ++i)
+			gray[i] = _format.RGBToColor(32, 32, 32);
+
+		byte plain[8], dithered[8];
+		map.convertRow(gray, plain, 8);
+		map.convertRowDithered(gray, dithered, 8, 0, 0);
+
+		uint plainOnes = 0, ditheredOnes = 0;
+		for (uint i = 0; i < 8; ++i) {
+			plainOnes += plain[i];
+			ditheredOnes += dithered[i];
+		}
+		TS_ASSERT(plainOnes == 0 || plainOnes == 8);
+		TS_ASSERT(ditheredOnes > 0 && ditheredOnes < 8);
+
+		// The pattern only depends on the screen position.
+		byte shifted[4];
+		map.convertRowDithered(gray + 4, shifted, 4, 4, 0);
+		TS_ASSERT_EQUALS(memcmp(shifted, dithered + 4, 4), 0);
+	}
+};
@@ -0,0 +1,218 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/cursor_layer.h"
+#include "graphics/dirty_rects.h"
+
+// Copies whatever is presented into its own screen, like a backend would
+// copy it into video memory.
+class MockPresenter : public Graphics::CursorPresenter {
+public:
+	enum {
+		kWidth = 64,
+		kHeight = 48
+	};
+
+	byte screen[kWidth * kHeight];
+	uint32 pixels;
+	uint calls;
+
+	MockPresenter() : pixels(0), calls(0) {
+		memset(screen, 0xEE, sizeof(screen));
+	}
+
+	virtual void presentRect(const Common::Rect &r, const byte *src, uint pitch) {
+		TS_ASSERT(r.left >= 0 && r.top >= 0 && r.right <= kWidth && r.bottom <= kHeight);
+		for (int y = r.top; y < r.bottom; ++y)
+			memcpy(screen + y * kWidth + r.left, src + (y - r.top) * pitch, r.width());
+		pixels += r.width() * r.height();
+		++calls;
+	}
+};
+
+class CursorLayerTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = MockPresenter::kWidth,
+		kHeight = MockPresenter::kHeight,
+		kKeyColor = 0xFF
+	};
+
+	Graphics::Surface _frame;
+	Graphics::DirtyRectList _dirty;
+	byte _cursor[5 * 4];
+
+	// What the screen should look like: the frame with the cursor on top.
+	bool screenMatches(const MockPresenter &presenter, int cursorX, int cursorY, bool visible) {
+		for (int y = 0; y < kHeight; ++y) {
+			for (int x = 0; x < kWidth; ++x) {
+				byte expected = *(const byte *)_frame.getBasePtr(x, y);
+
+				const int cx = x - cursorX, cy = y - cursorY;
+				if (visible && cx >= 0 && cx < 5 && cy >= 0 && cy < 4 && _cursor[cy * 5 + cx] != kKeyColor)
+					expected = _cursor[cy * 5 + cx];
+
+				if (presenter.screen[y * kWidth + x] != expected)
+					return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	void setUp() {
+		_frame.create(kWidth, kHeight, Graphics::PixelFormat::createFormatCLUT8());
+		for (int y = 0; y < kHeight; ++y) {
+			for (int x = 0; x < kWidth; ++x)
+				*(byte *)_frame.getBasePtr(x, y) = (x + y * 3) & 0x7F;
+		}
+
+		// An arrow-ish shape with transparent pixels.
+		for (uint i = 0; i < sizeof(_cursor); ++i)
+			_cursor[i] = (i % 3 == 0) ? kKeyColor : 0x80 + i;
+
+		_dirty.setBounds(kWidth, kHeight);
+	}
+
+	void tearDown() {
+		_frame.free();
+	}
+
+	void test_first_frame() {
+		Graphics::CursorLayer layer;
+		MockPresenter presenter;
+
+		layer.setCursor(_cursor, 5, 4, 1, 1, kKeyColor);
+		layer.setPosition(10, 10);
+		TS_ASSERT(!layer.setVisible(true));
+
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+
+		TS_ASSERT(screenMatches(presenter, 9, 9, true));
+		TS_ASSERT_EQUALS(presenter.pixels, (uint32)(kWidth * kHeight));
+	}
+
+	void test_mouse_only_frames() {
+		Graphics::CursorLayer layer;
+		MockPresenter presenter;
+
+		layer.setCursor(_cursor, 5, 4, 0, 0, kKeyColor);
+		layer.setVisible(true);
+		layer.setPosition(20, 20);
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+
+		// Nothing changed at all.
+		presenter.pixels = 0;
+		layer.present(_frame, _dirty, 0, presenter);
+		TS_ASSERT_EQUALS(presenter.pixels, 0U);
+
+		// The cursor moves far: only its old and new areas are presented.
+		layer.setPosition(40, 30);
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+		TS_ASSERT_EQUALS(presenter.pixels, 2U * 5 * 4);
+		TS_ASSERT(screenMatches(presenter, 40, 30, true));
+
+		// A short move presents the union of both.
+		presenter.pixels = 0;
+		layer.setPosition(41, 31);
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+		TS_ASSERT_EQUALS(presenter.pixels, 6U * 5);
+		TS_ASSERT(screenMatches(presenter, 41, 31, true));
+
+		// Hiding restores the background.
+		layer.setVisible(false);
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+		TS_ASSERT(screenMatches(presenter, 41, 31, false));
+	}
+
+	void test_frame_is_not_modified() {
+		Graphics::CursorLayer layer;
+		MockPresenter presenter;
+
+		Graphics::Surface copy;
+		copy.copyFrom(_frame);
+
+		layer.setCursor(_cursor, 5, 4, 0, 0, kKeyColor);
+		layer.setVisible(true);
+		layer.setPosition(3, 3);
+		layer.present(_frame, _dirty, 0, presenter);
+
+		TS_ASSERT_EQUALS(memcmp(copy.getPixels(), _frame.getPixels(), kWidth * kHeight), 0);
+		copy.free();
+	}
+
+	void test_dirty_area_under_cursor() {
+		Graphics::CursorLayer layer;
+		MockPresenter presenter;
+
+		layer.setCursor(_cursor, 5, 4, 0, 0, kKeyColor);
+		layer.setVisible(true);
+		layer.setPosition(30, 10);
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+
+		// The game redraws a strip passing underneath the cursor.
+		for (int y = 0; y < kHeight; ++y) {
+			for (int x = 28; x < 36; ++x)
+				*(byte *)_frame.getBasePtr(x, y) = 0x11;
+		}
+		_dirty.addRect(28, 0, 8, kHeight);
+
+		presenter.pixels = presenter.calls = 0;
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+
+		TS_ASSERT(screenMatches(presenter, 30, 10, true));
+		TS_ASSERT_EQUALS(presenter.pixels, 8U * kHeight);
+	}
+
+	void test_clipping_and_image_change() {
+		Graphics::CursorLayer layer;
+		MockPresenter presenter;
+
+		layer.setCursor(_cursor, 5, 4, 2, 2, kKeyColor);
+		layer.setVisible(true);
+		layer.setPosition(kWidth - 1, 0);
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+
+		TS_ASSERT_EQUALS(layer.getRect(kWidth, kHeight), Common::Rect(kWidth - 3, 0, kWidth, 2));
+		TS_ASSERT(screenMatches(presenter, kWidth - 3, -2, true));
+
+		// Same position, new image.
+		for (uint i = 0; i < sizeof(_cursor); ++i)
+			_cursor[i] ^= 0x01;
+		layer.setCursor(_cursor, 5, 4, 2, 2, kKeyColor);
+
+		presenter.pixels = 0;
+		layer.present(_frame, _dirty, 0, presenter);
+		_dirty.clear();
+		TS_ASSERT_EQUALS(presenter.pixels, 3U * 2);
+		TS_ASSERT(screenMatches(presenter, kWidth - 3, -2, true));
+	}
+
+	void test_double_buffering() {
+		Graphics::CursorLayer layer(2);
+		MockPresenter presenters[2];
+		Graphics::DirtyRectList dirty[2];
+
+		for (int b = 0; b < 2; ++b)
+			dirty[b].setBounds(kWidth, kHeight);
+
+		layer.setCursor(_cursor, 5, 4, 0, 0, kKeyColor);
+		layer.setVisible(true);
+
+		// Each buffer has to lose the cursor where it last saw it, which
+		// is two positions back.
+		for (int frame = 0; frame < 6; ++frame) {
+			const int b = frame & 1;
+			layer.setPosition(frame * 7, frame * 5);
+			layer.present(_frame, dirty[b], b, presenters[b]);
+			dirty[b].clear();
+			TS_ASSERT(screenMatches(presenters[b], frame * 7, frame * 5, true));
+		}
+	}
+};
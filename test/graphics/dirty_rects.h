@@ -0,0 +1,137 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirty_rects.h"
+
+class DirtyRectListTestSuite : public CxxTest::TestSuite {
+public:
+	void test_empty() {
+		Graphics::DirtyRectList list;
+		list.setBounds(320, 200);
+		list.clear();
+
+		TS_ASSERT(list.empty());
+		TS_ASSERT(!list.isFull());
+		TS_ASSERT_EQUALS(list.getArea(), (uint32)0);
+	}
+
+	void test_set_bounds_marks_all() {
+		Graphics::DirtyRectList list;
+		list.setBounds(320, 200);
+
+		TS_ASSERT(list.isFull());
+		TS_ASSERT_EQUALS(list.size(), (uint)1);
+		TS_ASSERT_EQUALS(*list.begin(), Common::Rect(320, 200));
+		TS_ASSERT_EQUALS(list.getArea(), (uint32)(320 * 200));
+	}
+
+	void test_clip() {
+		Graphics::DirtyRectList list;
+		list.setBounds(320, 200);
+		list.clear();
+
+		list.addRect(Common::Rect(-10, -10, 10, 10));
+		TS_ASSERT_EQUALS(list.size(), (uint)1);
+		TS_ASSERT_EQUALS(*list.begin(), Common::Rect(0, 0, 10, 10));
+
+		list.clear();
+		list.addRect(Common::Rect(400, 0, 420, 10));
+		TS_ASSERT(list.empty());
+	}
+
+	void test_contained() {
+		Graphics::DirtyRectList list;
+		list.setBounds(320, 200);
+		list.clear();
+
+		list.addRect(10, 10, 40, 20);
+		list.addRect(15, 12, 5, 5);
+		TS_ASSERT_EQUALS(list.size(), (uint)1);
+		TS_ASSERT_EQUALS(*list.begin(), Common::Rect(10, 10, 50, 30));
+	}
+
+	void test_merge_adjacent() {
+		Graphics::DirtyRectList list;
+		list.setBounds(320, 200);
+		list.clear();
+
+		// Two neighbouring 8 pixel strips become one rectangle.
+		list.addRect(8, 0, 8, 144);
+		list.addRect(16, 0, 8, 144);
+		TS_ASSERT_EQUALS(list.size(), (uint)1);
+		TS_ASSERT_EQUALS(*list.begin(), Common::Rect(8, 0, 24, 144));
+		TS_ASSERT_EQUALS(list.getArea(), (uint32)(16 * 144));
+	}
+
+	void test_keep_distant() {
+		Graphics::DirtyRectList list;
+		list.setBounds(320, 200);
+		list.clear();
+
+		list.addRect(0, 0, 16, 16);
+		list.addRect(200, 150, 16, 16);
+		TS_ASSERT_EQUALS(list.size(), (uint)2);
+		TS_ASSERT_EQUALS(list.getArea(), (uint32)(2 * 16 * 16));
+	}
+
+	void test_cascading_merge() {
+		Graphics::DirtyRectList list;
+		list.setBounds(320, 200);
+		list.clear();
+
+		list.addRect(0, 0, 32, 8);
+		list.addRect(128, 0, 32, 8);
+		TS_ASSERT_EQUALS(list.size(), (uint)2);
+
+		// Bridges the gap, so all three end up in one rectangle.
+		list.addRect(32, 0, 96, 8);
+		TS_ASSERT_EQUALS(list.size(), (uint)1);
+		TS_ASSERT_EQUALS(*list.begin(), Common::Rect(0, 0, 160, 8));
+	}
+
+	void test_collapse_on_capacity() {
+		Graphics::DirtyRectList list(4);
+		list.setBounds(320, 200);
+		list.clear();
+
+		for (int i = 0; i < 5; ++i)
+			list.addRect(i * 60, i * 40, 4, 4);
+
+		TS_ASSERT(list.isFull());
+		TS_ASSERT_EQUALS(list.size(), (uint)1);
+		TS_ASSERT_EQUALS(*list.begin(), Common::Rect(320, 200));
+	}
+
+	void test_collapse_on_area() {
+		Graphics::DirtyRectList list;
+		list.setBounds(320, 200);
+		list.clear();
+
+		list.addRect(0, 0, 320, 100);
+		TS_ASSERT(!list.isFull());
+		list.addRect(0, 120, 320, 60);
+		TS_ASSERT(list.isFull());
+
+		// Nothing gets added once full.
+		list.addRect(0, 0, 1, 1);
+		TS_ASSERT_EQUALS(list.size(), (uint)1);
+	}
+
+	void test_per_buffer_replay() {
+		// Every change goes to both buffers, each buffer clears only its own.
+		Graphics::DirtyRectList buffers[2];
+		for (int i = 0; i < 2; ++i) {
+			buffers[i].setBounds(320, 200);
+			buffers[i].clear();
+		}
+
+		for (int i = 0; i < 2; ++i)
+			buffers[i].addRect(10, 10, 20, 20);
+		buffers[0].clear();
+
+		for (int i = 0; i < 2; ++i)
+			buffers[i].addRect(100, 100, 20, 20);
+
+		TS_ASSERT_EQUALS(buffers[0].size(), (uint)1);
+		TS_ASSERT_EQUALS(buffers[1].size(), (uint)2);
+	}
+};
@@ -3,16 +3,30 @@
 # Use the 'test' target to run them.
 # Edit TESTS and TESTLIBS to add more tests.
 #
+# Benchmarks use the same framework but are kept out of the regular
+# test run. Use the 'bench' target to run them.
+#
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h
+TEST_LIBS    := graphics/libgraphics.a audio/libaudio.a common/libcommon.a
+
+BENCHMARKS   := $(srcdir)/test/benchmarks/*.h
+BENCH_LIBS   := graphics/libgraphics.a audio/libaudio.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
 endif
 
+ifeq ($(ENABLE_SCUMM), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/scumm/*.h
+	BENCHMARKS += $(srcdir)/test/benchmarks/engines/scumm/*.h
+	# Ahead of the common libraries the engine code depends on.
+	TEST_LIBS := engines/scumm/libscumm.a $(TEST_LIBS)
+	BENCH_LIBS := engines/scumm/libscumm.a $(BENCH_LIBS)
+endif
+
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
 TEST_CFLAGS  := $(filter-out -flto%,$(CFLAGS)) -I$(srcdir)/test/cxxtest
@@ -42,8 +56,16 @@ test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+bench: test/bench_runner
+	./test/bench_runner
+test/bench_runner: test/bench_runner.cpp $(BENCH_LIBS)
+	$(QUIET_CXX)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -DFORBIDDEN_SYMBOL_ALLOW_ALL -o $@ $+ $(TEST_LDFLAGS)
+test/bench_runner.cpp: $(BENCHMARKS)
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/bench_runner.cpp test/bench_runner
 
-.PHONY: test clean-test
+.PHONY: test bench clean-test